@@ -74,6 +74,7 @@ check_includes(include_files_list)
 set(functions_list
     fmemopen
     fstatat
+    mmap
 )
 check_functions(functions_list)
 
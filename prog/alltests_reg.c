@@ -149,6 +149,7 @@ static const char *tests[] = {
                               "pdfio1_reg",
                               "pdfio2_reg",
                               "pdfseg_reg",
+                              "pipeline_reg",
                               "pixa1_reg",
                               "pixa2_reg",
                               "pixadisp_reg",
@@ -170,6 +171,7 @@ static const char *tests[] = {
                               "rankhisto_reg",
                               "rasterop_reg",
                               "rasteropip_reg",
+                              "recog_reg",
                               "rectangle_reg",
                               "rotate1_reg",
                               "rotate2_reg",
@@ -94,13 +94,13 @@ TestAll(L_REGPARAMS  *rp,
         PIX          *pixs,
         l_int32       symmetric)
 {
-l_int32  ok, same;
+l_int32  i, j, ok, same;
 char     sequence[512];
 PIX     *pixref;
 PIX     *pix1, *pix2, *pix3, *pix4, *pix5, *pix6;
 PIX     *pix7, *pix8, *pix9, *pix10, *pix11;
 PIX     *pix12, *pix13, *pix14;
-SEL     *sel;
+SEL     *sel, *sel1, *sel2;
 
     if (symmetric) {
             /* This works properly if there is an added border */
@@ -568,6 +568,59 @@ SEL     *sel;
     pixDestroy(&pix13);
     pixDestroy(&pix14);
 
+        /* Long line Sels, with the origin at different places.
+         * These are done by logarithmic decomposition; compare with
+         * the same lines in a Sel with an extra row or column of
+         * don't-cares, which is done with one rasterop per hit. */
+    fprintf(stderr, "  Testing long line sels\n");
+    for (i = 0; i < 4; i++) {
+        sel1 = selCreateBrick(1, 9 + 30 * i, 0, 7 * i, SEL_HIT);
+        sel2 = selCreateBrick(2, 9 + 30 * i, 0, 7 * i, SEL_HIT);
+        for (j = 0; j < 9 + 30 * i; j++)
+            selSetElement(sel2, 1, j, SEL_DONT_CARE);
+        pix1 = pixDilate(NULL, pixs, sel1);
+        pix2 = pixDilate(NULL, pixs, sel2);
+        pix3 = pixErode(NULL, pixs, sel1);
+        pix4 = pixErode(NULL, pixs, sel2);
+        pixEqual(pix1, pix2, &same);
+        if (!same) {
+            fprintf(stderr, "horiz dilation %d differs!\n", i); ok = FALSE;
+        }
+        pixEqual(pix3, pix4, &same);
+        if (!same) {
+            fprintf(stderr, "horiz erosion %d differs!\n", i); ok = FALSE;
+        }
+        pixDestroy(&pix1);
+        pixDestroy(&pix2);
+        pixDestroy(&pix3);
+        pixDestroy(&pix4);
+        selDestroy(&sel1);
+        selDestroy(&sel2);
+
+        sel1 = selCreateBrick(9 + 30 * i, 1, 4 + 23 * i, 0, SEL_HIT);
+        sel2 = selCreateBrick(9 + 30 * i, 2, 4 + 23 * i, 1, SEL_HIT);
+        for (j = 0; j < 9 + 30 * i; j++)
+            selSetElement(sel2, j, 0, SEL_DONT_CARE);
+        pix1 = pixDilate(NULL, pixs, sel1);
+        pix2 = pixDilate(NULL, pixs, sel2);
+        pix3 = pixErode(NULL, pixs, sel1);
+        pix4 = pixErode(NULL, pixs, sel2);
+        pixEqual(pix1, pix2, &same);
+        if (!same) {
+            fprintf(stderr, "vert dilation %d differs!\n", i); ok = FALSE;
+        }
+        pixEqual(pix3, pix4, &same);
+        if (!same) {
+            fprintf(stderr, "vert erosion %d differs!\n", i); ok = FALSE;
+        }
+        pixDestroy(&pix1);
+        pixDestroy(&pix2);
+        pixDestroy(&pix3);
+        pixDestroy(&pix4);
+        selDestroy(&sel1);
+        selDestroy(&sel2);
+    }
+
     regTestCompareValues(rp, TRUE, ok, 0);
     if (ok)
         fprintf(stderr, "  All morph tests OK!\n");
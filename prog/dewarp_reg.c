@@ -51,6 +51,7 @@ FPIX         *fpix1, *fpix2, *fpix3;
 NUMA         *nax, *nafit;
 PIX          *pixs, *pixn, *pixg, *pixd, *pixb, *pix1, *pixt1, *pixt2;
 PIX          *pixs2, *pixn2, *pixg2, *pixb2;
+PIXA         *pixa1, *pixa2;
 PTA          *pta, *ptad;
 PTAA         *ptaa1, *ptaa2;
 L_REGPARAMS  *rp;
@@ -201,6 +202,26 @@ L_REGPARAMS  *rp;
     pixDestroy(&pix1);
     pixDestroy(&pixt1);
 
+        /* Apply the model to pages 3, 4 and 5 together; pages 3 and 5
+         * share the ref model and page 4 has none */
+    pixa1 = pixaCreate(3);
+    for (i = 0; i < 3; i++)
+        pixaAddPix(pixa1, pixb2, L_COPY);
+    pixa2 = dewarpaApplyDisparityPixa(dewa2, pixa1, 3, 200, 0, 0);
+    dewarpaApplyDisparity(dewa2, 3, pixb2, 200, 0, 0, &pixd, NULL);
+    pixt1 = pixaGetPix(pixa2, 0, L_CLONE);
+    regTestComparePix(rp, pixd, pixt1);  /* 21 */
+    pixDestroy(&pixt1);
+    pixt1 = pixaGetPix(pixa2, 1, L_CLONE);
+    regTestComparePix(rp, pixb2, pixt1);  /* 22 */
+    pixDestroy(&pixt1);
+    pixt1 = pixaGetPix(pixa2, 2, L_CLONE);
+    regTestComparePix(rp, pixd, pixt1);  /* 23 */
+    pixDestroy(&pixt1);
+    pixDestroy(&pixd);
+    pixaDestroy(&pixa1);
+    pixaDestroy(&pixa2);
+
     dewarpaDestroy(&dewa1);
     dewarpaDestroy(&dewa2);
     pixDestroy(&pixs);
@@ -29,6 +29,9 @@
  *
  *   Compares graymorph results with special (3x1, 1x3, 3x3) cases
  *   against the general case.  Require exact equality.
+ *
+ *   Also compares the vertical operations with the horizontal ones
+ *   on the rotated image, again requiring exact equality.
  */
 
 #ifdef HAVE_CONFIG_H
@@ -40,7 +43,7 @@
 int main(int    argc,
          char **argv)
 {
-PIX          *pixs, *pix1, *pix2, *pixd;
+PIX          *pixs, *pixr, *pix1, *pix2, *pix3, *pixd;
 PIXA         *pixa;
 L_REGPARAMS  *rp;
 
@@ -148,6 +151,41 @@ L_REGPARAMS  *rp;
     pixDisplayWithTitle(pixd, 750, 100, "Closing", rp->display);
     pixDestroy(&pixd);
     pixaDestroy(&pixa);
+
+        /* Vertical vs. horizontal on the rotated image */
+    pixr = pixRotateOrth(pixs, 1);
+    pix1 = pixDilateGray(pixs, 1, 21);
+    pix2 = pixDilateGray(pixr, 21, 1);
+    pix3 = pixRotateOrth(pix2, 3);
+    regTestComparePix(rp, pix1, pix3);  /* 12 */
+    pixDestroy(&pix1);
+    pixDestroy(&pix2);
+    pixDestroy(&pix3);
+
+    pix1 = pixErodeGray(pixs, 1, 21);
+    pix2 = pixErodeGray(pixr, 21, 1);
+    pix3 = pixRotateOrth(pix2, 3);
+    regTestComparePix(rp, pix1, pix3);  /* 13 */
+    pixDestroy(&pix1);
+    pixDestroy(&pix2);
+    pixDestroy(&pix3);
+
+    pix1 = pixOpenGray(pixs, 5, 15);
+    pix2 = pixOpenGray(pixr, 15, 5);
+    pix3 = pixRotateOrth(pix2, 3);
+    regTestComparePix(rp, pix1, pix3);  /* 14 */
+    pixDestroy(&pix1);
+    pixDestroy(&pix2);
+    pixDestroy(&pix3);
+
+    pix1 = pixCloseGray3(pixs, 1, 3);
+    pix2 = pixCloseGray3(pixr, 3, 1);
+    pix3 = pixRotateOrth(pix2, 3);
+    regTestComparePix(rp, pix1, pix3);  /* 15 */
+    pixDestroy(&pix1);
+    pixDestroy(&pix2);
+    pixDestroy(&pix3);
+    pixDestroy(&pixr);
     pixDestroy(&pixs);
     return regTestCleanup(rp);
 }
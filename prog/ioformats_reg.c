@@ -34,7 +34,7 @@
  *
  *    This tests reading and writing of images in different formats
  *    It should work properly on input images of any depth, with
- *    and without colormaps.  There are 7 sections.
+ *    and without colormaps.  There are 8 sections.
  *
  *    Section 1. Test write/read with lossless and lossy compression, with
  *    and without colormaps.  The lossless results are tested for equality.
@@ -51,6 +51,10 @@
  *
  *    Section 7. Test header reading
  *
+ *    Section 8. Test reading a region of png and tiff images
+ *
+ *    Section 9. Test reading thumbnails
+ *
  *    This test requires the following external I/O libraries
  *        libjpeg, libtiff, libpng, libz
  *    and optionally tests these:
@@ -89,6 +93,9 @@ static l_int32 test_writemem(PIX *pixs, l_int32 format, char *psfile);
 static PIX *make_24_bpp_pix(PIX *pixs);
 static l_int32 get_header_data(const char *filename, l_int32 true_format);
 static const char *get_tiff_compression_name(l_int32 format);
+static void test_region(L_REGPARAMS *rp, const char *filename, BOX *box);
+static void test_thumbnail(L_REGPARAMS *rp, const char *filename,
+                           l_int32 maxw, l_int32 maxh);
 
 LEPT_DLL extern const char *ImageFileFormatExtensions[];
 
@@ -101,6 +108,7 @@ l_uint8      *data;
 l_int32       i, d, n, success, failure, same;
 l_int32       w, h, bps, spp, iscmap;
 size_t        size, nbytes;
+BOX          *box;
 PIX          *pix1, *pix2, *pix3, *pix4, *pix8, *pix16, *pix32;
 PIX          *pix, *pixt, *pixd;
 PIXA         *pixa;
@@ -615,6 +623,35 @@ part6:
             "\n  ******* Failure on reading headers *******\n\n");
     if (!success) failure = TRUE;
 
+    /* ---------------- Part 8: Read a region of the image ---------------- */
+    box = boxCreate(37, 21, 203, 151);
+    test_region(rp, FILE_1BPP, box);
+    test_region(rp, FILE_2BPP_C, box);
+    test_region(rp, FILE_4BPP, box);
+    test_region(rp, FILE_8BPP_1, box);
+    test_region(rp, FILE_16BPP, box);
+    test_region(rp, FILE_32BPP_ALPHA, box);
+    test_region(rp, FILE_CMAP_ALPHA, box);
+    test_region(rp, FILE_GRAY_ALPHA, box);
+    pix = pixRead(FILE_32BPP);
+    pixWrite("/tmp/lept/regout/region.png", pix, IFF_PNG);
+    pixWrite("/tmp/lept/regout/region.tif", pix, IFF_TIFF_ZIP);
+    test_region(rp, "/tmp/lept/regout/region.png", box);
+    test_region(rp, "/tmp/lept/regout/region.tif", box);
+    pixDestroy(&pix);
+    pix = pixRead(FILE_1BPP);
+    pixWrite("/tmp/lept/regout/region.png", pix, IFF_PNG);
+    test_region(rp, "/tmp/lept/regout/region.png", box);
+    pixDestroy(&pix);
+    boxDestroy(&box);
+
+    /* ------------------ Part 9: Read a thumbnail ------------------ */
+    test_thumbnail(rp, FILE_32BPP, 100, 80);
+    test_thumbnail(rp, FILE_1BPP, 100, 80);
+    test_thumbnail(rp, FILE_8BPP_1, 120, 120);
+    test_thumbnail(rp, FILE_16BPP, 100, 80);
+    test_thumbnail(rp, FILE_32BPP_ALPHA, 50, 200);
+
 #if  !HAVE_LIBPNG || !HAVE_LIBJPEG || !HAVE_LIBTIFF
 finish:
 #endif  /* !HAVE_LIBPNG || !HAVE_LIBJPEG || !HAVE_LIBTIFF */
@@ -902,3 +939,47 @@ get_tiff_compression_name(l_int32  format)
         fprintf(stderr, "format %d: not tiff\n", format);
     return tiff_compression_name;
 }
+
+
+static void
+test_region(L_REGPARAMS  *rp,
+            const char   *filename,
+            BOX          *box)
+{
+PIX  *pix1, *pix2, *pix3, *pix4, *pix5;
+
+    pix1 = pixRead(filename);
+    pix2 = pixClipRectangle(pix1, box, NULL);
+    pix3 = pixReadRegion(filename, box, 1);
+    regTestComparePix(rp, pix2, pix3);
+    pix4 = pixReduceForRead(pix2, 2);
+    pix5 = pixReadRegion(filename, box, 2);
+    regTestComparePix(rp, pix4, pix5);
+    pixDestroy(&pix1);
+    pixDestroy(&pix2);
+    pixDestroy(&pix3);
+    pixDestroy(&pix4);
+    pixDestroy(&pix5);
+}
+
+
+static void
+test_thumbnail(L_REGPARAMS  *rp,
+               const char   *filename,
+               l_int32       maxw,
+               l_int32       maxh)
+{
+l_int32  w, h, ws, hs;
+PIX     *pix;
+
+        /* The thumbnail fits and touches one of the bounds */
+    pixReadHeader(filename, NULL, &ws, &hs, NULL, NULL, NULL);
+    pix = pixReadThumbnail(filename, maxw, maxh);
+    pixGetDimensions(pix, &w, &h, NULL);
+    regTestCompareValues(rp, 1, (w <= maxw && h <= maxh), 0.0);
+    if ((l_float32)maxw / (l_float32)ws < (l_float32)maxh / (l_float32)hs)
+        regTestCompareValues(rp, maxw, w, 1.0);
+    else
+        regTestCompareValues(rp, maxh, h, 1.0);
+    pixDestroy(&pix);
+}
@@ -30,6 +30,8 @@
  *   Regression test for
  *       jbCorrelation
  *       jbRankhaus
+ *       jbPageCreate, jbAddPreparedPage
+ *   and checks that the projection prefilter doesn't change the classes.
  */
 
 #ifdef HAVE_CONFIG_H
@@ -49,10 +51,11 @@ static PIXA *PixaOutlineTemplates(PIXA *pixas, NUMA *na);
 int main(int    argc,
          char **argv)
 {
-l_int32      i, w, h;
+l_int32      i, w, h, same;
 BOX         *box;
-JBDATA      *data;
-JBCLASSER   *classer;
+JBDATA      *data, *data2;
+JBCLASSER   *classer, *classer2;
+JBPAGE      *page1, *page2;
 NUMA        *na;
 SARRAY      *sa;
 PIX         *pix1, *pix2;
@@ -162,6 +165,80 @@ L_REGPARAMS  *rp;
 
     /*--------------------------------------------------------------*/
 
+        /* Prepare both pages before classifying either of them, and
+         * verify that the result is the same as with jbAddPages() */
+    pix1 = pixRead("/tmp/lept/class/pix1.tif");
+    pix2 = pixRead("/tmp/lept/class/pix2.tif");
+    for (i = 0; i < 2; i++) {
+        if (i == 0) {
+            classer = jbCorrelationInit(COMPONENTS, 0, 0, 0.8, 0.6);
+            classer2 = jbCorrelationInit(COMPONENTS, 0, 0, 0.8, 0.6);
+        } else {
+            classer = jbRankHausInit(COMPONENTS, 0, 0, 2, 0.97);
+            classer2 = jbRankHausInit(COMPONENTS, 0, 0, 2, 0.97);
+        }
+        jbAddPages(classer, sa);
+        page1 = jbPageCreate(classer2, pix1);
+        page2 = jbPageCreate(classer2, pix2);
+        jbAddPreparedPage(classer2, page1);
+        jbAddPreparedPage(classer2, page2);
+        data = jbDataSave(classer);
+        data2 = jbDataSave(classer2);
+        if (!data || !data2) {
+            lept_stderr("Failure in jbclass_reg: jbdata not made\n");
+            rp->success = FALSE;
+        } else {
+            regTestComparePix(rp, data->pix, data2->pix);  /* 8, 11 */
+            numaSimilar(data->naclass, data2->naclass, 0.0, &same);
+            regTestCompareValues(rp, 1, same, 0.0);  /* 9, 12 */
+            ptaEqual(data->ptaul, data2->ptaul, &same);
+            regTestCompareValues(rp, 1, same, 0.0);  /* 10, 13 */
+        }
+        jbPageDestroy(&page1);
+        jbPageDestroy(&page2);
+        jbClasserDestroy(&classer);
+        jbClasserDestroy(&classer2);
+        jbDataDestroy(&data);
+        jbDataDestroy(&data2);
+    }
+    pixDestroy(&pix1);
+    pixDestroy(&pix2);
+
+    /*--------------------------------------------------------------*/
+
+        /* Verify that rejecting templates early with the projection
+         * test gives the same classes and templates as without it */
+    for (i = 0; i < 2; i++) {
+        if (i == 0) {
+            classer = jbCorrelationInit(COMPONENTS, 0, 0, 0.8, 0.6);
+            classer2 = jbCorrelationInit(COMPONENTS, 0, 0, 0.8, 0.6);
+        } else {
+            classer = jbRankHausInit(COMPONENTS, 0, 0, 2, 0.97);
+            classer2 = jbRankHausInit(COMPONENTS, 0, 0, 2, 0.97);
+        }
+        classer2->prefilter = 0;
+        jbAddPages(classer, sa);
+        jbAddPages(classer2, sa);
+        regTestCompareValues(rp, classer2->nclass, classer->nclass,
+                             0.0);  /* 14, 18 */
+        data = jbDataSave(classer);
+        data2 = jbDataSave(classer2);
+        if (!data || !data2) {
+            lept_stderr("Failure in jbclass_reg: jbdata not made\n");
+            rp->success = FALSE;
+        } else {
+            regTestComparePix(rp, data->pix, data2->pix);  /* 15, 19 */
+            numaSimilar(data->naclass, data2->naclass, 0.0, &same);
+            regTestCompareValues(rp, 1, same, 0.0);  /* 16, 20 */
+            ptaEqual(data->ptaul, data2->ptaul, &same);
+            regTestCompareValues(rp, 1, same, 0.0);  /* 17, 21 */
+        }
+        jbClasserDestroy(&classer);
+        jbClasserDestroy(&classer2);
+        jbDataDestroy(&data);
+        jbDataDestroy(&data2);
+    }
+
     sarrayDestroy(&sa);
     return regTestCleanup(rp);
 }
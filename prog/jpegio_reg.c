@@ -60,6 +60,7 @@ void DoJpegTest1(L_REGPARAMS *rp, const char *fname);
 void DoJpegTest2(L_REGPARAMS *rp, const char *fname);
 void DoJpegTest3(L_REGPARAMS *rp, const char *fname);
 void DoJpegTest4(L_REGPARAMS *rp, const char *fname);
+void DoJpegTest5(L_REGPARAMS *rp);
 
 
 int main(int    argc,
@@ -90,6 +91,7 @@ L_REGPARAMS  *rp;
     DoJpegTest3(rp, "lucasta.150.jpg");
     DoJpegTest3(rp, "tetons.jpg");
     DoJpegTest4(rp, "karen8.jpg");
+    DoJpegTest5(rp);
 
     return regTestCleanup(rp);
 }
@@ -264,3 +266,60 @@ PIX     *pixs;
 }
 
 
+
+    /* Encode and decode several images with reusable contexts */
+void DoJpegTest5(L_REGPARAMS  *rp)
+{
+char             *fnames[] = {"test8.jpg", "fish24.jpg", "karen8.jpg",
+                              "test24.jpg"};
+const l_uint8    *data2;
+l_uint8          *data1;
+l_uint8           junk[64];
+char             *text;
+l_int32           i;
+size_t            size1, size2;
+L_JPEG_DECODER   *dec;
+L_JPEG_ENCODER   *enc;
+PIX              *pixs, *pix1, *pix2;
+
+    enc = jpegEncoderCreate();
+    dec = jpegDecoderCreate();
+    for (i = 0; i < 4; i++) {
+        pixs = pixRead(fnames[i]);
+        pixSetText(pixs, fnames[i]);
+
+            /* The encoder gives the same data as the stateless writer */
+        pixWriteMemJpeg(&data1, &size1, pixs, 75, i % 2);
+        jpegEncoderEncode(enc, pixs, 75, i % 2, &data2, &size2);
+        regTestCompareStrings(rp, data1, size1, (l_uint8 *)data2, size2);
+
+            /* The decoder gives the same pix, including the comment */
+        pix1 = pixReadMemJpeg(data1, size1, 0, 1, NULL, 0);
+        pix2 = jpegDecoderDecode(dec, data2, size2, 0, 1, NULL, 0);
+        regTestComparePix(rp, pix1, pix2);
+        text = pixGetText(pix2);
+        regTestCompareStrings(rp, (l_uint8 *)fnames[i], strlen(fnames[i]),
+                              (l_uint8 *)text, (text) ? strlen(text) : 0);
+        pixDestroy(&pix1);
+        pixDestroy(&pix2);
+        lept_free(data1);
+        pixDestroy(&pixs);
+    }
+
+        /* After failing on bad data, the decoder is still usable */
+    memset(junk, 0x5a, sizeof(junk));
+    pix1 = jpegDecoderDecode(dec, junk, sizeof(junk), 0, 1, NULL, 0);
+    regTestCompareValues(rp, 1, (pix1 == NULL), 0.0);
+    pixs = pixRead("test8.jpg");
+    jpegEncoderEncode(enc, pixs, 75, 0, &data2, &size2);
+    pix1 = pixReadMemJpeg(data2, size2, 0, 2, NULL, 0);
+    pix2 = jpegDecoderDecode(dec, data2, size2, 0, 2, NULL, 0);
+    regTestComparePix(rp, pix1, pix2);
+    pixDestroy(&pix1);
+    pixDestroy(&pix2);
+    pixDestroy(&pixs);
+
+    jpegEncoderDestroy(&enc);
+    jpegDecoderDestroy(&dec);
+    return;
+}
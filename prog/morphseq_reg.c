@@ -29,6 +29,8 @@
  *
  *    Simple regression test for binary morph sequence (interpreter),
  *    showing display mode and rejection of invalid sequence components.
+ *    Also tests that compiled binary morph sequences give the same
+ *    result as the interpreter.
  */
 
 #ifdef HAVE_CONFIG_H
@@ -42,6 +44,7 @@
 #define  SEQUENCE3    "e3.3 + d3.3 + tw5.5"
 #define  SEQUENCE4    "O3.3 + C3.3"
 #define  SEQUENCE5    "O5.5 + C5.5"
+#define  SEQUENCE6    "b32 + e3.1 + e1.5 + e5.5 + c17.9 + d2.2 + d2.2"
 #define  BAD_SEQUENCE  "O1.+D8 + E2.4 + e.4 + r25 + R + R.5 + X + x5 + y7.3"
 
 #define  DISPLAY_SEPARATION   0   /* use 250 to get images displayed */
@@ -49,8 +52,11 @@
 int main(int    argc,
          char **argv)
 {
-PIX         *pixs, *pixg, *pixc, *pixd;
-static char  mainName[] = "morphseq_reg";
+l_int32       i, j, same, fail;
+const char   *sequence[3] = {SEQUENCE1, SEQUENCE2, SEQUENCE6};
+L_MORPHPROG  *prog;
+PIX          *pixs, *pixg, *pixc, *pixd, *pix1, *pix2;
+static char   mainName[] = "morphseq_reg";
 
     if (argc != 1)
         return ERROR_INT(" Syntax:  morphseq_reg", mainName, 1);
@@ -87,6 +93,32 @@ static char  mainName[] = "morphseq_reg";
     pixWrite("/tmp/lept/morphseq4.png", pixd, IFF_PNG);
     pixDestroy(&pixd);
 
+        /* Compiled, with the work buffers reused on the second run */
+    fail = FALSE;
+    pix1 = pixScale(pixs, 0.7, 0.7);
+    for (i = 0; i < 3; i++) {
+        prog = morphProgCreate(sequence[i]);
+        for (j = 0; j < 3; j++) {
+            pixc = (j == 1) ? pix1 : pixs;
+            pixd = pixMorphSequence(pixc, sequence[i], 0);
+            pix2 = morphProgRun(prog, pixc);
+            pixEqual(pixd, pix2, &same);
+            if (!same) {
+                fprintf(stderr, "Failure for compiled sequence %d\n", i + 1);
+                fail = TRUE;
+            }
+            pixDestroy(&pixd);
+            pixDestroy(&pix2);
+        }
+        if (i == 2 && morphProgGetCount(prog) != 5) {  /* e7.9 merged */
+            fprintf(stderr, "Failure: %d steps in compiled sequence 3\n",
+                    morphProgGetCount(prog));
+            fail = TRUE;
+        }
+        morphProgDestroy(&prog);
+    }
+    pixDestroy(&pix1);
+
         /* 8 bpp */
     pixg = pixScaleToGray(pixs, 0.25);
     pixd = pixGrayMorphSequence(pixg, SEQUENCE3, -5, 150);
@@ -117,5 +149,5 @@ static char  mainName[] = "morphseq_reg";
 
     pixDestroy(&pixg);
     pixDestroy(&pixs);
-    return 0;
+    return fail;
 }
@@ -30,6 +30,7 @@
  *   Tests tiff I/O for:
  *
  *       - multipage tiff read/write
+ *       - indexed random access to pages of multipage tiff
  *       - writing special tiff tags to file [not tested here]
  */
 
@@ -51,12 +52,13 @@ l_uint8      *data;
 char         *fname, *filename;
 const char   *str;
 char          buf[512];
-l_int32       i, n, npages, equal, success;
+l_int32       i, n, npages, equal, success, format;
 size_t        offset, size;
 FILE         *fp;
 PIX          *pix1, *pix2;
 PIXA         *pixa, *pixa1, *pixa2, *pixa3;
 SARRAY       *sa;
+L_TIFFINDEX  *tindex1, *tindex2;
 L_REGPARAMS  *rp;
 
 #if !defined(HAVE_LIBPNG)
@@ -319,6 +321,90 @@ L_REGPARAMS  *rp;
     regTestCompareFiles(rp, 18, 22);  /* 23 */
     pixaDestroy(&pixa);
 
+    /* ----------------  Test indexed random access  -----------------*/
+        /* Make an index, round-trip it through a sidecar file, and
+         * compare random-access and range reads with sequential reads */
+    pixa1 = pixaReadMultipageTiff("/tmp/lept/tiff/weasel8.tif");
+    n = pixaGetCount(pixa1);
+    tindex1 = tiffIndexCreate("/tmp/lept/tiff/weasel8.tif");
+    regTestCompareValues(rp, n, tiffIndexGetCount(tindex1), 0);  /* 24 */
+    tiffIndexWrite("/tmp/lept/tiff/weasel8.tif.idx", tindex1);
+    tindex2 = tiffIndexRead("/tmp/lept/tiff/weasel8.tif.idx");
+    tiffIndexWrite("/tmp/lept/tiff/weasel8.tif.idx2", tindex2);
+    filesAreIdentical("/tmp/lept/tiff/weasel8.tif.idx",
+                      "/tmp/lept/tiff/weasel8.tif.idx2", &equal);
+    regTestCompareValues(rp, TRUE, equal, 0);  /* 25 */
+    success = TRUE;
+    for (i = n - 1; i >= 0; i--) {  /* backwards */
+        pix1 = pixaGetPix(pixa1, i, L_CLONE);
+        pix2 = pixReadTiffIndexed("/tmp/lept/tiff/weasel8.tif", tindex2, i);
+        pixEqual(pix1, pix2, &equal);
+        if (!equal) success = FALSE;
+        pixDestroy(&pix1);
+        pixDestroy(&pix2);
+    }
+    regTestCompareValues(rp, TRUE, success, 0);  /* 26 */
+    pixa2 = pixaReadMultipageTiffRange("/tmp/lept/tiff/weasel8.tif", tindex2,
+                                       2, 3);
+    pixa3 = pixaReadMultipageTiffRange("/tmp/lept/tiff/weasel8.tif", NULL,
+                                       n - 2, 0);
+    regTestCompareValues(rp, 3, pixaGetCount(pixa2), 0);  /* 27 */
+    regTestCompareValues(rp, 2, pixaGetCount(pixa3), 0);  /* 28 */
+    success = TRUE;
+    for (i = 0; i < 3; i++) {
+        pix1 = pixaGetPix(pixa1, i + 2, L_CLONE);
+        pix2 = pixaGetPix(pixa2, i, L_CLONE);
+        pixEqual(pix1, pix2, &equal);
+        if (!equal) success = FALSE;
+        pixDestroy(&pix1);
+        pixDestroy(&pix2);
+    }
+    pix1 = pixaGetPix(pixa1, n - 1, L_CLONE);
+    pix2 = pixaGetPix(pixa3, 1, L_CLONE);
+    pixEqual(pix1, pix2, &equal);
+    if (!equal) success = FALSE;
+    pixDestroy(&pix1);
+    pixDestroy(&pix2);
+    regTestCompareValues(rp, TRUE, success, 0);  /* 29 */
+    tiffIndexDestroy(&tindex1);
+    tiffIndexDestroy(&tindex2);
+    pixaDestroy(&pixa1);
+    pixaDestroy(&pixa2);
+    pixaDestroy(&pixa3);
+
+        /* Random access to the last page of the 1000 page file */
+    startTimer();
+    tindex1 = tiffIndexCreate("/tmp/lept/tiff/junkm.tif");
+    pix1 = pixReadTiffIndexed("/tmp/lept/tiff/junkm.tif", tindex1, 999);
+    pix2 = pixRead("char.tif");
+    pixEqual(pix1, pix2, &equal);
+    regTestCompareValues(rp, TRUE, equal, 0);  /* 30 */
+    if (rp->display)
+        fprintf(stderr, "Time to index and read last page: %6.3f sec\n",
+                stopTimer());
+    pixDestroy(&pix1);
+    pixDestroy(&pix2);
+    tiffIndexDestroy(&tindex1);
+
+        /* The g4 pages can be copied to pdf without decoding;
+         * the flate pages can not */
+    tindex1 = tiffIndexCreate("/tmp/lept/tiff/weasel4");
+    n = tiffIndexGetCount(tindex1);
+    success = TRUE;
+    for (i = 0; i < n; i++) {
+        extractTiffPageCompressedData("/tmp/lept/tiff/weasel4", tindex1, i,
+                                      &format, &data, &size, NULL, NULL,
+                                      NULL, NULL);
+        if (format != IFF_TIFF_G4 || !data) success = FALSE;
+        lept_free(data);
+    }
+    regTestCompareValues(rp, TRUE, success, 0);  /* 31 */
+    extractTiffPageCompressedData("/tmp/lept/tiff/weasel8.tif", NULL, 1,
+                                  &format, &data, &size, NULL, NULL,
+                                  NULL, NULL);
+    regTestCompareValues(rp, IFF_UNKNOWN, format, 0);  /* 32 */
+    tiffIndexDestroy(&tindex1);
+
 
 #if 1    /* -----   test adding custom public tags to a tiff header ----- */
 {
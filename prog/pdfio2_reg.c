@@ -48,7 +48,9 @@ l_int32       w, h, same;
 size_t        nbytes;
 BOXA         *boxa1, *boxa2;
 L_BYTEA      *ba;
+L_PDF_WRITER *lpw;
 PIX          *pix1, *pix2, *pix3, *pix4, *pix5, *pix6;
+PIXA         *pixa1;
 L_REGPARAMS  *rp;
 
 #if !defined(HAVE_LIBPNG)
@@ -242,6 +244,41 @@ L_REGPARAMS  *rp;
     regTestCheckFile(rp, "/tmp/lept/pdf/file18.pdf");
     regTestCheckFile(rp, "/tmp/lept/pdf/file19.pdf");
 
+#if 1
+    /* ---------------- Test streaming multipage pdf output --------------- */
+    fprintf(stderr, "\n*** Writing a multipage pdf one page at a time\n");
+
+        /* Mix encoded pix with jpeg and g4 data taken from files */
+    lpw = pdfWriterOpen("/tmp/lept/pdf/stream1.pdf", "streaming");
+    pix1 = pixRead("weasel8.240c.png");
+    pdfWriterAddPix(lpw, pix1, L_FLATE_ENCODE, 0, 0);
+    pdfWriterAddFile(lpw, "marge.jpg", 0, 0);
+    pdfWriterAddFile(lpw, "feyn-fract.tif", 0, 0);
+    pdfWriterAddPix(lpw, pix1, L_JPEG_ENCODE, 50, 150);
+    regTestCompareValues(rp, 0, pdfWriterClose(&lpw), 0);
+    regTestCheckFile(rp, "/tmp/lept/pdf/stream1.pdf");
+
+        /* The pixa converter uses the same writer */
+    pix2 = pixRead("feyn-fract.tif");
+    pixa1 = pixaCreate(3);
+    pixaAddPix(pixa1, pix1, L_COPY);
+    pixaAddPix(pixa1, pix2, L_COPY);
+    pixaAddPix(pixa1, pix1, L_COPY);
+    pixaConvertToPdf(pixa1, 100, 1.0, 0, 0, "pixa",
+                     "/tmp/lept/pdf/stream2.pdf");
+    lpw = pdfWriterOpen("/tmp/lept/pdf/stream3.pdf", "pixa");
+    pdfWriterAddPix(lpw, pix1, L_DEFAULT_ENCODE, 0, 100);
+    pdfWriterAddPix(lpw, pix2, L_DEFAULT_ENCODE, 0, 100);
+    pdfWriterAddPix(lpw, pix1, L_DEFAULT_ENCODE, 0, 100);
+    pdfWriterClose(&lpw);
+    regTestCheckFile(rp, "/tmp/lept/pdf/stream2.pdf");
+    regTestCheckFile(rp, "/tmp/lept/pdf/stream3.pdf");
+    regTestCompareFiles(rp, 22, 23);
+    pixaDestroy(&pixa1);
+    pixDestroy(&pix1);
+    pixDestroy(&pix2);
+#endif
+
 #if 1
     /* ------------------ Test multipage pdf generation ----------------- */
     fprintf(stderr, "\n*** Writing multipage pdfs from single page pdfs\n");
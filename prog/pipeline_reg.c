@@ -0,0 +1,193 @@
+/*====================================================================*
+ -  Copyright (C) 2001 Leptonica.  All rights reserved.
+ -
+ -  Redistribution and use in source and binary forms, with or without
+ -  modification, are permitted provided that the following conditions
+ -  are met:
+ -  1. Redistributions of source code must retain the above copyright
+ -     notice, this list of conditions and the following disclaimer.
+ -  2. Redistributions in binary form must reproduce the above
+ -     copyright notice, this list of conditions and the following
+ -     disclaimer in the documentation and/or other materials
+ -     provided with the distribution.
+ -
+ -  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ -  ``AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ -  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ -  A PARTICULAR PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL ANY
+ -  CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ -  EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ -  PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ -  PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ -  OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ -  NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ -  SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *====================================================================*/
+
+/*
+ * pipeline_reg.c
+ *
+ *   Tests running a pipeline of operations in bands of rows:
+ *      (1) The result of pipelineRunPix() is the same as applying the
+ *          operations in sequence on the full image, for all band heights.
+ *      (2) Reading and writing tiff in bands with the tiff reader and
+ *          writer gives the same image and file as pixReadTiff() and
+ *          pixWriteTiff().
+ *      (3) The result of pipelineRunTiff() is the same as the result
+ *          of pipelineRunPix().
+ */
+
+#ifdef HAVE_CONFIG_H
+#include <config_auto.h>
+#endif  /* HAVE_CONFIG_H */
+
+#include "allheaders.h"
+
+static const l_int32  BandHeights[] = {1, 5, 16, 64, 100000};
+
+static PIX *ReadTiffInBands(const char *filename, l_int32 bandh);
+
+
+int main(int    argc,
+         char **argv)
+{
+l_int32         i, w, h, same;
+BOX            *box;
+L_PIPELINE     *pipe1, *pipe2;
+PIX            *pixs, *pixg, *pix1, *pix2, *pix3, *pix4, *pix5, *pix6;
+L_TIFF_WRITER  *writer;
+L_REGPARAMS    *rp;
+
+#if !defined(HAVE_LIBPNG) || !defined(HAVE_LIBTIFF)
+    L_ERROR("This test requires libpng and libtiff to run.\n",
+            "pipeline_reg");
+    exit(77);
+#endif
+
+    if (regTestSetup(argc, argv, &rp))
+        return 1;
+
+    lept_mkdir("lept/pipe");
+
+    /* ------------- Color to binary, with 2x reduction -------------- */
+    pixs = pixRead("marge.jpg");
+    pix1 = pixConvertRGBToGray(pixs, 0.0, 0.0, 0.0);
+    pix2 = pixBlockconv(pix1, 5, 7);
+    pix3 = pixThresholdToBinary(pix2, 128);
+    pix4 = pixCloseBrick(NULL, pix3, 5, 5);
+    pix5 = pixReduceRankBinary2(pix4, 2, NULL);
+    regTestWritePixAndCheck(rp, pix5, IFF_PNG);  /* 0 */
+    pipe1 = pipelineCreate();
+    pipelineAddConvertRGBToGray(pipe1, 0.0, 0.0, 0.0);
+    pipelineAddBlockconv(pipe1, 5, 7);
+    pipelineAddThresholdToBinary(pipe1, 128);
+    pipelineAddBrickMorph(pipe1, L_MORPH_CLOSE, 5, 5);
+    pipelineAddReduceRankBinary2(pipe1, 2);
+    for (i = 0; i < 5; i++) {
+        pix6 = pipelineRunPix(pipe1, pixs, BandHeights[i]);
+        regTestComparePix(rp, pix5, pix6);  /* 1 - 5 */
+        pixDestroy(&pix6);
+    }
+    pipelineDestroy(&pipe1);
+    pixDestroy(&pix1);
+    pixDestroy(&pix2);
+    pixDestroy(&pix3);
+    pixDestroy(&pix4);
+    pixDestroy(&pix5);
+    pixDestroy(&pixs);
+
+    /* ------- Binary to gray and back, with grayscale filtering ------ */
+    pixs = pixRead("feyn-fract.tif");
+    pix1 = pixScaleToGray3(pixs);
+    pix2 = pixRankFilter(pix1, 3, 6, 0.4);
+    pix3 = pixErodeGray(pix2, 5, 7);
+    pix4 = pixThresholdToBinary(pix3, 200);
+    pix5 = pixOpenBrick(NULL, pix4, 3, 9);
+    pix6 = pixScaleToGray2(pix5);
+    regTestWritePixAndCheck(rp, pix6, IFF_PNG);  /* 6 */
+    pipe2 = pipelineCreate();
+    pipelineAddScaleToGray(pipe2, 3);
+    pipelineAddRankFilter(pipe2, 3, 6, 0.4);
+    pipelineAddBrickMorph(pipe2, L_MORPH_ERODE, 5, 7);
+    pipelineAddThresholdToBinary(pipe2, 200);
+    pipelineAddBrickMorph(pipe2, L_MORPH_OPEN, 3, 9);
+    pipelineAddScaleToGray(pipe2, 2);
+    pixDestroy(&pix1);
+    for (i = 0; i < 5; i++) {
+        pix1 = pipelineRunPix(pipe2, pixs, BandHeights[i]);
+        regTestComparePix(rp, pix6, pix1);  /* 7 - 11 */
+        pixDestroy(&pix1);
+    }
+    pixDestroy(&pix2);
+    pixDestroy(&pix3);
+    pixDestroy(&pix4);
+    pixDestroy(&pix5);
+
+    /* ----------------- Read and write tiff in bands ----------------- */
+    pixWrite("/tmp/lept/pipe/feyn.tif", pixs, IFF_TIFF_G4);
+    pixg = pixRead("weasel8.png");
+    pixWrite("/tmp/lept/pipe/weasel.tif", pixg, IFF_TIFF_LZW);
+    pix1 = ReadTiffInBands("/tmp/lept/pipe/feyn.tif", 23);
+    regTestComparePix(rp, pixs, pix1);  /* 12 */
+    pixDestroy(&pix1);
+    pix1 = pixRead("/tmp/lept/pipe/weasel.tif");
+    pix2 = ReadTiffInBands("/tmp/lept/pipe/weasel.tif", 7);
+    regTestComparePix(rp, pix1, pix2);  /* 13 */
+    pixDestroy(&pix2);
+
+    pixGetDimensions(pix1, &w, &h, NULL);
+    writer = tiffWriterOpen("/tmp/lept/pipe/weasel2.tif", pix1, h,
+                            IFF_TIFF_ZIP);
+    for (i = 0; i < h; i += 10) {
+        box = boxCreate(0, i, w, 10);
+        pix2 = pixClipRectangle(pix1, box, NULL);
+        tiffWriterWriteRows(writer, pix2);
+        boxDestroy(&box);
+        pixDestroy(&pix2);
+    }
+    regTestCompareValues(rp, 0, tiffWriterClose(&writer), 0.0);  /* 14 */
+    pixWrite("/tmp/lept/pipe/weasel3.tif", pix1, IFF_TIFF_ZIP);
+    filesAreIdentical("/tmp/lept/pipe/weasel2.tif",
+                      "/tmp/lept/pipe/weasel3.tif", &same);
+    regTestCompareValues(rp, 1, same, 0.0);  /* 15 */
+    pixDestroy(&pix1);
+
+    /* --------------- Run the pipeline from tiff to tiff ------------- */
+    pipelineRunTiff(pipe2, "/tmp/lept/pipe/feyn.tif", 0,
+                    "/tmp/lept/pipe/feyn2.tif", IFF_TIFF_LZW, 16);
+    pix1 = pixRead("/tmp/lept/pipe/feyn2.tif");
+    regTestComparePix(rp, pix6, pix1);  /* 16 */
+    pixDestroy(&pix1);
+    pipelineDestroy(&pipe2);
+    pixDestroy(&pix6);
+    pixDestroy(&pixs);
+    pixDestroy(&pixg);
+    return regTestCleanup(rp);
+}
+
+
+    /* Reassemble an image that is read with a tiff reader in bands */
+static PIX *
+ReadTiffInBands(const char  *filename,
+                l_int32      bandh)
+{
+l_int32         w, h, d, y;
+L_TIFF_READER  *reader;
+PIX            *pixb, *pixd;
+
+    reader = tiffReaderOpen(filename, 0);
+    tiffReaderGetDimensions(reader, &w, &h, &d);
+    pixd = NULL;
+    for (y = 0; (pixb = tiffReaderReadRows(reader, bandh)) != NULL;
+         y += bandh) {
+        if (!pixd) {
+            pixd = pixCreate(w, h, d);
+            pixCopyColormap(pixd, pixb);
+            pixCopyResolution(pixd, pixb);
+        }
+        pixRasterop(pixd, 0, y, w, pixGetHeight(pixb), PIX_SRC, pixb, 0, 0);
+        pixDestroy(&pixb);
+    }
+    tiffReaderClose(&reader);
+    return pixd;
+}
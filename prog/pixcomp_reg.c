@@ -50,16 +50,18 @@ static void get_format_data(l_int32 i, l_uint8 *data, size_t size);
 int main(int    argc,
          char **argv)
 {
-l_uint8      *data1, *data2;
-l_int32       i;
-size_t        size1, size2;
-BOX          *box;
-PIX          *pix, *pix1, *pix2, *pix3;
-PIXA         *pixa, *pixa1;
-PIXC         *pixc, *pixc1, *pixc2;
-PIXAC        *pixac, *pixac1, *pixac2;
-L_REGPARAMS  *rp;
-SARRAY       *sa;
+l_uint8          *data1, *data2;
+l_int32           i, w, h, d, w2, h2, d2, y;
+size_t            size1, size2;
+BOX              *box;
+FILE             *fp;
+PIX              *pix, *pix1, *pix2, *pix3;
+PIXA             *pixa, *pixa1;
+PIXC             *pixc, *pixc1, *pixc2;
+PIXAC            *pixac, *pixac1, *pixac2;
+L_REGPARAMS      *rp;
+SARRAY           *sa;
+L_PIXAC_ARCHIVE  *parch;
 
     if (regTestSetup(argc, argv, &rp))
         return 1;
@@ -209,6 +211,104 @@ SARRAY       *sa;
     lept_free(data1);
     lept_free(data2);
 
+        /* Test the indexed archive, with appending and random access */
+    pixac = pixacompCreate(6);
+    pixac1 = pixacompCreate(3);
+    for (i = 0; i < 6; i++) {
+        pix1 = pixRead(fnames[i]);
+        box = boxCreate(10 * i, 20 * i, 50 + i, 60 + i);
+        pixacompAddPix(pixac, pix1, IFF_DEFAULT);
+        pixacompAddBox(pixac, box, L_COPY);
+        if (i < 3) {
+            pixacompAddPix(pixac1, pix1, IFF_DEFAULT);
+            pixacompAddBox(pixac1, box, L_COPY);
+        }
+        pixDestroy(&pix1);
+        boxDestroy(&box);
+    }
+    pixacompWriteArchive("/tmp/lept/comp/archive.pac", pixac1);
+    pixacompDestroy(&pixac1);
+    parch = pixacompArchiveOpen("/tmp/lept/comp/archive.pac", 1);
+    for (i = 3; i < 6; i++) {
+        pixc = pixacompGetPixcomp(pixac, i, L_NOCOPY);
+        box = pixacompGetBox(pixac, i, L_CLONE);
+        pixacompArchiveAddPixcomp(parch, pixc, box);
+        boxDestroy(&box);
+    }
+    pixacompArchiveClose(&parch);
+    parch = pixacompArchiveOpen("/tmp/lept/comp/archive.pac", 0);
+    regTestCompareValues(rp, 6, pixacompArchiveGetCount(parch), 0);  /* 16 */
+    for (i = 5; i >= 0; i--) {  /* 17 - 22 */
+        pix1 = pixacompGetPix(pixac, i);
+        pix2 = pixacompArchiveGetPix(parch, i);
+        regTestComparePix(rp, pix1, pix2);
+        pixDestroy(&pix1);
+        pixDestroy(&pix2);
+    }
+    pixacompArchiveGetPixDimensions(parch, 4, &w, &h, &d);
+    pixacompGetPixDimensions(pixac, 4, &w2, &h2, &d2);
+    regTestCompareValues(rp, w2 * h2 * d2, w * h * d, 0);  /* 23 */
+    box = pixacompArchiveGetBox(parch, 4);
+    boxGetGeometry(box, NULL, &y, NULL, NULL);
+    regTestCompareValues(rp, 80, y, 0);  /* 24 */
+    boxDestroy(&box);
+    pixacompArchiveClose(&parch);
+    pixac1 = pixacompReadArchive("/tmp/lept/comp/archive.pac");
+    pixacompWriteMem(&data1, &size1, pixac);
+    pixacompWriteMem(&data2, &size2, pixac1);
+    regTestCompareStrings(rp, data1, size1, data2, size2);  /* 25 */
+    lept_free(data1);
+    lept_free(data2);
+    pixacompDestroy(&pixac);
+    pixacompDestroy(&pixac1);
+
+        /* Entries without a box keep the boxes aligned with the pixcomps */
+    parch = pixacompArchiveCreate("/tmp/lept/comp/archive2.pac");
+    for (i = 0; i < 3; i++) {
+        pix1 = pixRead(fnames[i]);
+        box = (i == 1) ? boxCreate(5, 7, 30, 40) : NULL;
+        pixacompArchiveAddPix(parch, pix1, IFF_DEFAULT, box);
+        pixDestroy(&pix1);
+        boxDestroy(&box);
+    }
+    pixacompArchiveClose(&parch);
+    pixac1 = pixacompReadArchive("/tmp/lept/comp/archive2.pac");
+    regTestCompareValues(rp, 3, pixacompGetBoxaCount(pixac1), 0);  /* 26 */
+    box = pixacompGetBox(pixac1, 1, L_CLONE);
+    boxGetGeometry(box, NULL, &y, &w, NULL);
+    regTestCompareValues(rp, 7 * 30, y * w, 0);  /* 27 */
+    boxDestroy(&box);
+    box = pixacompGetBox(pixac1, 2, L_CLONE);
+    boxGetGeometry(box, NULL, NULL, &w, &h);
+    regTestCompareValues(rp, 0, w + h, 0);  /* 28 */
+    boxDestroy(&box);
+    pixacompWriteArchive("/tmp/lept/comp/archive3.pac", pixac1);
+    parch = pixacompArchiveOpen("/tmp/lept/comp/archive3.pac", 0);
+    box = pixacompArchiveGetBox(parch, 0);
+    regTestCompareValues(rp, 1, (box == NULL), 0);  /* 29 */
+    pixacompArchiveClose(&parch);
+
+        /* An interrupted append leaves the earlier archive readable */
+    fp = fopenWriteStream("/tmp/lept/comp/archive2.pac", "ab");
+    fprintf(fp, "partial record from an interrupted append");
+    fclose(fp);
+    parch = pixacompArchiveOpen("/tmp/lept/comp/archive2.pac", 0);
+    regTestCompareValues(rp, 3, pixacompArchiveGetCount(parch), 0);  /* 30 */
+    pixacompArchiveClose(&parch);
+    parch = pixacompArchiveOpen("/tmp/lept/comp/archive2.pac", 1);
+    pixc = pixacompGetPixcomp(pixac1, 0, L_NOCOPY);
+    pixacompArchiveAddPixcomp(parch, pixc, NULL);
+    pixacompArchiveClose(&parch);
+    parch = pixacompArchiveOpen("/tmp/lept/comp/archive2.pac", 0);
+    regTestCompareValues(rp, 4, pixacompArchiveGetCount(parch), 0);  /* 31 */
+    pix1 = pixacompGetPix(pixac1, 0);
+    pix2 = pixacompArchiveGetPix(parch, 3);
+    regTestComparePix(rp, pix1, pix2);  /* 32 */
+    pixDestroy(&pix1);
+    pixDestroy(&pix2);
+    pixacompArchiveClose(&parch);
+    pixacompDestroy(&pixac1);
+
     return regTestCleanup(rp);
 }
 
@@ -35,6 +35,7 @@
 #include <config_auto.h>
 #endif  /* HAVE_CONFIG_H */
 
+#include <string.h>
 #include "allheaders.h"
 
     /* Use this set */
@@ -56,13 +57,21 @@ int main(int    argc,
          char **argv)
 {
 char          buf[256];
-size_t        size;
-l_int32       i, w, h;
+size_t        size, size2;
+l_int32       i, w, h, compress, same;
 l_int32       format, bps, spp, iscmap, format2, w2, h2, bps2, spp2, iscmap2;
-l_uint8      *data;
+l_uint8      *data, *data2;
 l_uint32     *data32, *data32r;
 BOX          *box;
+BOXA         *boxa, *boxa2;
+BOXAA        *baa, *baa2;
+FILE         *fp;
+NUMA         *na, *na2;
+NUMAA        *naa, *naa2;
 PIX          *pixs, *pixt, *pixt2, *pixd;
+PIXA         *pixa, *pixa2;
+PTA          *pta, *pta2;
+PTAA         *ptaa, *ptaa2;
 L_REGPARAMS  *rp;
 
     if (regTestSetup(argc, argv, &rp))
@@ -124,6 +133,160 @@ L_REGPARAMS  *rp;
         lept_free(data);
     }
 
+            /* Test page-aligned spix, read both with a file mapping
+             * and by copying */
+    for (i = 0; i < nfiles; i++) {
+        pixs = pixRead(filename[i]);
+        snprintf(buf, sizeof(buf), "/tmp/lept/regout/paged.%d.spix", i);
+        fp = lept_fopen(buf, "wb");
+        pixWriteStreamSpixPaged(fp, pixs);
+        lept_fclose(fp);
+        pixd = pixReadSpixMapped(buf);
+        regTestComparePix(rp, pixs, pixd);  /* 3 * nfiles + 2 * i */
+        pixt = pixRead(buf);
+        regTestComparePix(rp, pixs, pixt);  /* 3 * nfiles + 2 * i + 1 */
+        pixDestroy(&pixt);
+
+            /* The mapping is private: changes are not seen in the file */
+        if (i == nfiles - 1) {
+            pixInvert(pixd, pixd);
+            pixt = pixReadSpixMapped(buf);
+            regTestComparePix(rp, pixs, pixt);  /* 5 * nfiles */
+            pixInvert(pixd, pixd);
+            pixTransferAllData(pixt, &pixd, 0, 0);  /* takes the mapping */
+            regTestComparePix(rp, pixs, pixt);  /* 5 * nfiles + 1 */
+            pixDestroy(&pixt);
+        }
+        pixDestroy(&pixs);
+        pixDestroy(&pixd);
+    }
+
+            /* Test binary serialization of numa, pta, boxa and pixa,
+             * and arrays of them, both uncompressed and compressed.
+             * Each result is compared with the original using the
+             * text serialization. */
+    pixs = pixRead("feyn-fract.tif");
+    boxa = pixConnComp(pixs, NULL, 8);
+    baa = boxaaCreate(2);
+    boxaaAddBoxa(baa, boxa, L_COPY);
+    boxaaAddBoxa(baa, boxa, L_COPY);
+    pta = ptaCreate(0);
+    for (i = 0; i < 1000; i++)
+        ptaAddPt(pta, 0.37 * i, 1.0 / (i + 1));
+    ptaa = ptaaCreate(2);
+    ptaaAddPta(ptaa, pta, L_COPY);
+    ptaaAddPta(ptaa, pta, L_COPY);
+    pixt = pixRead("karen8.jpg");
+    na = pixGetGrayHistogram(pixt, 1);
+    numaSetParameters(na, 0.5, 2.0);
+    naa = numaaCreate(2);
+    numaaAddNuma(naa, na, L_COPY);
+    numaaAddNuma(naa, na, L_COPY);
+    pixDestroy(&pixt);
+    pixa = pixaCreate(nfiles);
+    for (i = 0; i < nfiles; i++) {
+        pixt = pixRead(filename[i]);
+        pixSetText(pixt, filename[i]);
+        pixaAddPix(pixa, pixt, L_INSERT);
+        pixaAddBox(pixa, boxCreate(i, 2 * i, 10 + i, 20 + i), L_INSERT);
+    }
+    for (compress = 0; compress < 2; compress++) {
+        numaWriteMemBinary(&data, &size, na, compress);
+        na2 = numaReadMemBinary(data, size);
+        lept_free(data);
+        numaWriteMem(&data, &size, na);
+        numaWriteMem(&data2, &size2, na2);
+        regTestCompareStrings(rp, data, size, data2, size2);
+            /* 5 * nfiles + 2 + 7 * compress */
+        lept_free(data);
+        lept_free(data2);
+        numaDestroy(&na2);
+
+        numaaWriteMemBinary(&data, &size, naa, compress);
+        naa2 = numaaReadMemBinary(data, size);
+        lept_free(data);
+        numaaWriteMem(&data, &size, naa);
+        numaaWriteMem(&data2, &size2, naa2);
+        regTestCompareStrings(rp, data, size, data2, size2);
+            /* 5 * nfiles + 3 + 7 * compress */
+        lept_free(data);
+        lept_free(data2);
+        numaaDestroy(&naa2);
+
+        ptaWriteMemBinary(&data, &size, pta, compress);
+        pta2 = ptaReadMemBinary(data, size);
+        lept_free(data);
+        ptaWriteMem(&data, &size, pta, 0);
+        ptaWriteMem(&data2, &size2, pta2, 0);
+        regTestCompareStrings(rp, data, size, data2, size2);
+            /* 5 * nfiles + 4 + 7 * compress */
+        lept_free(data);
+        lept_free(data2);
+        ptaDestroy(&pta2);
+
+        ptaaWriteMemBinary(&data, &size, ptaa, compress);
+        ptaa2 = ptaaReadMemBinary(data, size);
+        lept_free(data);
+        ptaaWriteMem(&data, &size, ptaa, 0);
+        ptaaWriteMem(&data2, &size2, ptaa2, 0);
+        regTestCompareStrings(rp, data, size, data2, size2);
+            /* 5 * nfiles + 5 + 7 * compress */
+        lept_free(data);
+        lept_free(data2);
+        ptaaDestroy(&ptaa2);
+
+        boxaWriteMemBinary(&data, &size, boxa, compress);
+        boxa2 = boxaReadMemBinary(data, size);
+        lept_free(data);
+        boxaWriteMem(&data, &size, boxa);
+        boxaWriteMem(&data2, &size2, boxa2);
+        regTestCompareStrings(rp, data, size, data2, size2);
+            /* 5 * nfiles + 6 + 7 * compress */
+        lept_free(data);
+        lept_free(data2);
+        boxaDestroy(&boxa2);
+
+        boxaaWriteMemBinary(&data, &size, baa, compress);
+        baa2 = boxaaReadMemBinary(data, size);
+        lept_free(data);
+        boxaaWriteMem(&data, &size, baa);
+        boxaaWriteMem(&data2, &size2, baa2);
+        regTestCompareStrings(rp, data, size, data2, size2);
+            /* 5 * nfiles + 7 + 7 * compress */
+        lept_free(data);
+        lept_free(data2);
+        boxaaDestroy(&baa2);
+
+            /* Compare the pix, with their colormaps and text,
+             * and the boxa */
+        pixaWriteMemBinary(&data, &size, pixa, compress);
+        pixa2 = pixaReadMemBinary(data, size);
+        lept_free(data);
+        same = (pixaGetCount(pixa2) == nfiles) ? 1 : 0;
+        for (i = 0; same && i < nfiles; i++) {
+            pixt = pixaGetPix(pixa, i, L_CLONE);
+            pixt2 = pixaGetPix(pixa2, i, L_CLONE);
+            pixEqual(pixt, pixt2, &same);
+            if (same && strcmp(pixGetText(pixt), pixGetText(pixt2)))
+                same = 0;
+            pixDestroy(&pixt);
+            pixDestroy(&pixt2);
+        }
+        if (same)
+            boxaEqual(pixa->boxa, pixa2->boxa, 0, NULL, &same);
+        regTestCompareValues(rp, 1, same, 0);
+            /* 5 * nfiles + 8 + 7 * compress */
+        pixaDestroy(&pixa2);
+    }
+    pixDestroy(&pixs);
+    numaDestroy(&na);
+    numaaDestroy(&naa);
+    ptaDestroy(&pta);
+    ptaaDestroy(&ptaa);
+    boxaDestroy(&boxa);
+    boxaaDestroy(&baa);
+    pixaDestroy(&pixa);
+
 #if 0
         /* Do timing */
     for (i = 0; i < nfiles; i++) {
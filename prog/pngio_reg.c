@@ -43,6 +43,7 @@
 #include <config_auto.h>
 #endif  /* HAVE_CONFIG_H */
 
+#include <string.h>
 #include "allheaders.h"
 
     /* Needed for checking libraries */
@@ -66,6 +67,8 @@
 #define   FILE_GRAY_ALPHA    "test-gray-alpha.png"
 
 static l_int32 test_mem_png(const char *fname);
+static l_int32 test_filters_png(const char *fname);
+static l_int32 test_encoder_png(L_PNG_ENCODER *enc, const char *fname);
 static l_int32 get_header_data(const char *filename);
 static l_int32 test_1bpp_trans(L_REGPARAMS *rp);
 static l_int32 test_1bpp_color(L_REGPARAMS *rp);
@@ -79,8 +82,9 @@ LEPT_DLL extern const char *ImageFileFormatExtensions[];
 int main(int    argc,
          char **argv)
 {
-l_int32       success, failure;
-L_REGPARAMS  *rp;
+l_int32         success, failure;
+L_PNG_ENCODER  *enc;
+L_REGPARAMS    *rp;
 
 #if !defined(HAVE_LIBPNG)
     L_ERROR("This test requires libpng to run.\n", "pngio_reg");
@@ -175,7 +179,40 @@ L_REGPARAMS  *rp;
     }
     if (!success) failure = TRUE;
 
-    /* -------------- Part 4: Read header information -------------- */
+    /* ------------ Part 4: Test lossless r/w with row filters ------------ */
+    success = TRUE;
+    if (test_filters_png(FILE_8BPP)) success = FALSE;
+    if (test_filters_png(FILE_16BPP)) success = FALSE;
+    if (test_filters_png(FILE_32BPP)) success = FALSE;
+    if (test_filters_png(FILE_32BPP_ALPHA)) success = FALSE;
+    if (success) {
+        fprintf(stderr,
+            "\n  ****** Success on lossless r/w with row filters *****\n");
+    } else {
+        fprintf(stderr,
+            "\n  ******* Failure on r/w with row filters ******\n");
+    }
+    if (!success) failure = TRUE;
+
+    /* ------------ Part 5: Test lossless reusable encoder ------------ */
+    success = TRUE;
+    enc = pngEncoderCreate();
+    if (test_encoder_png(enc, FILE_32BPP)) success = FALSE;
+    if (test_encoder_png(enc, FILE_1BPP)) success = FALSE;
+    if (test_encoder_png(enc, FILE_8BPP_C)) success = FALSE;
+    if (test_encoder_png(enc, FILE_16BPP)) success = FALSE;
+    if (test_encoder_png(enc, FILE_32BPP_ALPHA)) success = FALSE;
+    pngEncoderDestroy(&enc);
+    if (success) {
+        fprintf(stderr,
+            "\n  ****** Success on lossless reusable encoder *****\n");
+    } else {
+        fprintf(stderr,
+            "\n  ******* Failure on reusable encoder ******\n");
+    }
+    if (!success) failure = TRUE;
+
+    /* -------------- Part 6: Read header information -------------- */
     success = TRUE;
     if (get_header_data(FILE_1BPP)) success = FALSE;
     if (get_header_data(FILE_2BPP)) success = FALSE;
@@ -247,6 +284,81 @@ PIX      *pixd = NULL;
     return (!same);
 }
 
+    /* Returns 1 on error */
+static l_int32
+test_filters_png(const char  *fname)
+{
+l_uint8  *data;
+l_int32   same, filter, error;
+size_t    size;
+PIX      *pixs, *pixd;
+
+    if ((pixs = pixRead(fname)) == NULL) {
+        fprintf(stderr, "Failure to read %s\n", fname);
+        return 1;
+    }
+    pixSetZlibCompression(pixs, 1);
+    error = FALSE;
+    for (filter = L_PNG_FILTER_NONE; filter <= L_PNG_FILTER_ALL; filter++) {
+        l_pngSetWriteFilter(filter);
+        data = NULL;
+        pixd = NULL;
+        if (pixWriteMem(&data, &size, pixs, IFF_PNG) == 0)
+            pixd = pixReadMem(data, size);
+        pixEqual(pixs, pixd, &same);
+        if (!pixd || !same) {
+            fprintf(stderr, "Filter %d write/read fail for file %s\n",
+                    filter, fname);
+            error = TRUE;
+        }
+        pixDestroy(&pixd);
+        lept_free(data);
+    }
+    l_pngSetWriteFilter(L_PNG_FILTER_DEFAULT);
+    pixDestroy(&pixs);
+    return error;
+}
+
+    /* Returns 1 on error */
+static l_int32
+test_encoder_png(L_PNG_ENCODER  *enc,
+                 const char     *fname)
+{
+const l_uint8  *data2;
+l_uint8        *data1;
+l_int32         same, error;
+size_t          size1, size2;
+PIX            *pixs, *pixd;
+
+    if ((pixs = pixRead(fname)) == NULL) {
+        fprintf(stderr, "Failure to read %s\n", fname);
+        return 1;
+    }
+    error = FALSE;
+    data1 = NULL;
+    pixd = NULL;
+    if (pixWriteMemPng(&data1, &size1, pixs, 0.0) ||
+        pngEncoderEncode(enc, pixs, 0.0, &data2, &size2)) {
+        fprintf(stderr, "Encoder write fail for file %s\n", fname);
+        error = TRUE;
+    } else {
+        if (size1 != size2 || memcmp(data1, data2, size1)) {
+            fprintf(stderr, "Encoder data differs for file %s\n", fname);
+            error = TRUE;
+        }
+        pixd = pixReadMemPng(data2, size2);
+        pixEqual(pixs, pixd, &same);
+        if (!pixd || !same) {
+            fprintf(stderr, "Encoder write/read fail for file %s\n", fname);
+            error = TRUE;
+        }
+    }
+    pixDestroy(&pixd);
+    lept_free(data1);
+    pixDestroy(&pixs);
+    return error;
+}
+
     /* Retrieve header data from file and from array in memory */
 static l_int32
 get_header_data(const char  *filename)
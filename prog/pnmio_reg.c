@@ -28,13 +28,14 @@
  * pnmio_reg.c
  *
  *   Tests read and write of both ascii and packed pnm, using
- *   pix with 1, 2, 4, 8 and 32 bpp.
+ *   pix with 1, 2, 4, 8 and 32 bpp, from files and memory.
  */
 
 #ifdef HAVE_CONFIG_H
 #include <config_auto.h>
 #endif  /* HAVE_CONFIG_H */
 
+#include <string.h>
 #include "allheaders.h"
 
 l_int32 main(l_int32  argc,
@@ -179,5 +180,33 @@ L_REGPARAMS  *rp;
     pixDestroy(&pix2);
     pixDestroy(&pix3);
 
+        /* Test reading from memory for ascii and packed data */
+    pix1 = pixRead("weasel8.png");
+    data = l_binaryRead("/tmp/lept/pnm/pix1.8.pnm", &size);
+    pix2 = pixReadMemPnm(data, size);
+    regTestComparePix(rp, pix1, pix2);  /* 12 */
+    lept_free(data);
+    pixDestroy(&pix2);
+    data = l_binaryRead("/tmp/lept/pnm/pix3.8.pnm", &size);
+    pix2 = pixReadMemPnm(data, size);
+    regTestComparePix(rp, pix1, pix2);  /* 13 */
+    lept_free(data);
+    pixDestroy(&pix1);
+    pixDestroy(&pix2);
+
+        /* Test ascii pbm with comments and without spaces between bits */
+    data = (l_uint8 *)stringNew("P1\n# comment\n5 2\n10110\n0 1 0 0\n1\n");
+    pix1 = pixReadMemPnm(data, strlen((char *)data));
+    pix2 = pixCreate(5, 2, 1);
+    pixSetPixel(pix2, 0, 0, 1);
+    pixSetPixel(pix2, 2, 0, 1);
+    pixSetPixel(pix2, 3, 0, 1);
+    pixSetPixel(pix2, 1, 1, 1);
+    pixSetPixel(pix2, 4, 1, 1);
+    regTestComparePix(rp, pix1, pix2);  /* 14 */
+    lept_free(data);
+    pixDestroy(&pix1);
+    pixDestroy(&pix2);
+
     return regTestCleanup(rp);
 }
@@ -0,0 +1,247 @@
+/*====================================================================*
+ -  Copyright (C) 2001 Leptonica.  All rights reserved.
+ -
+ -  Redistribution and use in source and binary forms, with or without
+ -  modification, are permitted provided that the following conditions
+ -  are met:
+ -  1. Redistributions of source code must retain the above copyright
+ -     notice, this list of conditions and the following disclaimer.
+ -  2. Redistributions in binary form must reproduce the above
+ -     copyright notice, this list of conditions and the following
+ -     disclaimer in the documentation and/or other materials
+ -     provided with the distribution.
+ -
+ -  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ -  ``AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ -  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ -  A PARTICULAR PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL ANY
+ -  CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ -  EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ -  PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ -  PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ -  OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ -  NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ -  SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *====================================================================*/
+
+/*
+ * recog_reg.c
+ *
+ *   Regression test for identifying characters with recog:
+ *      (1) recogIdentifyPixa(), which matches all the characters together,
+ *          gives the same index, score and text for each character as
+ *          recogIdentifyPix() on that character, and the same text and
+ *          scores as the original matcher.
+ *      (2) recogCorrelationBestChar() finds the same best character in
+ *          touching digits with and without debug output, where the
+ *          search over shifts is exhaustive, and the same as the
+ *          original search.
+ *      (3) recogDecode() splits the touching digits into the same
+ *          boxes, with the same templates and scores, as before the
+ *          row counts in the decoding array were shared with the
+ *          character search.
+ */
+
+#ifdef HAVE_CONFIG_H
+#include <config_auto.h>
+#endif  /* HAVE_CONFIG_H */
+
+#include <math.h>
+#include <string.h>
+#include "allheaders.h"
+
+    /* Identified text for digit_set01.pa - digit_set03.pa, and the sums
+     * of their scores, from matching one character at a time with
+     * recogIdentifyPix() before characters were matched together */
+static const char *DigitText[] = {
+    "000000000000000111111111111111222222222222222555333533533355"
+    "444444444444444555555555555555666656660666666777777777777777"
+    "888888888888683999990999999999",
+    "000000000900000111111111111111222222222222222333333333333333"
+    "444144444444414555555555555555666666666666666777777777777777"
+    "888888888888888999999999999999",
+    "000000000000000111111111111111222222222222222333333333333333"
+    "444444444444444555555555555555666666666666666777777777777777"
+    "888888888888888999999999999999"};
+static const l_float32  DigitScoreSum[] = {105.3550, 118.1251, 124.1877};
+
+    /* Touching digits in test01.pa, and the best character found in
+     * each by recogCorrelationBestChar() with the original search */
+static const l_int32  Touching[] = {17, 20, 21, 22, 23, 24};
+static const l_int32  BestX[] = {0, 1, 53, 54, 79, 1};
+static const l_int32  BestW[] = {23, 23, 26, 26, 28, 23};
+static const l_int32  BestIndex[] = {1, 1, 0, 0, 4, 1};
+static const l_float32  BestScore[] = {0.92267, 0.88535, 0.87720,
+                                       0.83953, 0.87653, 0.90354};
+
+    /* Boxes and template indices found by recogDecode() for the
+     * touching digits, one "x y w h index" for each digit, and the
+     * sums of their scores */
+static const char *DecodeText[] = {
+    "78 1 26 40 7\n53 1 23 40 1\n25 2 27 40 3\n0 1 23 40 1\n",
+    "79 3 26 43 7\n54 3 26 43 0\n26 3 27 43 3\n1 1 23 43 1\n",
+    "79 4 27 43 6\n53 3 26 43 0\n26 1 27 43 3\n0 0 23 42 1\n",
+    "79 6 27 43 5\n54 3 26 43 0\n27 1 27 43 3\n2 0 23 42 1\n",
+    "78 3 28 42 4\n53 3 26 42 0\n24 2 27 42 3\n0 0 23 40 1\n",
+    "81 3 27 42 3\n54 2 26 42 0\n26 2 27 42 3\n1 0 23 42 1\n"};
+static const l_float32  DecodeScoreSum[] = {3.47243, 3.72324, 3.76465,
+                                            3.40514, 3.38808, 3.76193};
+
+static PIX *GetBigComponent(PIX *pixs);
+
+
+int main(int    argc,
+         char **argv)
+{
+char         buf[256];
+char        *text, *str1, *str2;
+l_int32      i, j, n, index, index2, same, x, y, w, h;
+l_float32    score, score2, sum;
+BOX         *box1, *box2;
+BOXA        *boxa;
+NUMA        *naindex1, *naindex2, *nascore1, *nascore2;
+PIX         *pix1, *pix2, *pixdb;
+PIXA        *pixa1, *pixa2;
+SARRAY      *satext1, *satext2;
+L_RECOG     *recog;
+L_REGPARAMS  *rp;
+
+    if (regTestSetup(argc, argv, &rp))
+        return 1;
+
+    /* ------------------- Identify sets of digits ------------------- */
+    pixa1 = pixaRead("recog/digits/bootnum1.pa");
+    pixa2 = pixaRead("recog/digits/bootnum2.pa");
+    pixaJoin(pixa1, pixa2, 0, -1);
+    recog = recogCreateFromPixa(pixa1, 0, 40, 0, 128, 1);
+    pixaDestroy(&pixa1);
+    pixaDestroy(&pixa2);
+    for (i = 0; i < 3; i++) {
+        snprintf(buf, sizeof(buf), "recog/digits/digit_set%02d.pa", i + 1);
+        pixa1 = pixaRead(buf);
+        n = pixaGetCount(pixa1);
+        recogIdentifyPixa(recog, pixa1, NULL);
+        rchaExtract(recog->rcha, &naindex1, &nascore1, &satext1,
+                    NULL, NULL, NULL, NULL);
+
+            /* Identify each character separately */
+        naindex2 = numaCreate(n);
+        nascore2 = numaCreate(n);
+        satext2 = sarrayCreate(n);
+        for (j = 0; j < n; j++) {
+            pix1 = pixaGetPix(pixa1, j, L_CLONE);
+            recogIdentifyPix(recog, pix1, NULL);
+            rchExtract(recog->rch, &index, &score, &text,
+                       NULL, NULL, NULL, NULL);
+            numaAddNumber(naindex2, index);
+            numaAddNumber(nascore2, score);
+            sarrayAddString(satext2, text, L_INSERT);
+            pixDestroy(&pix1);
+        }
+        numaSimilar(naindex1, naindex2, 0.0, &same);
+        regTestCompareValues(rp, 1, same, 0.0);  /* 0, 5, 10 */
+        numaSimilar(nascore1, nascore2, 0.0, &same);
+        regTestCompareValues(rp, 1, same, 0.0);  /* 1, 6, 11 */
+        str1 = sarrayToString(satext1, 0);
+        str2 = sarrayToString(satext2, 0);
+        regTestCompareStrings(rp, (l_uint8 *)str1, strlen(str1),
+                              (l_uint8 *)str2, strlen(str2));  /* 2, 7, 12 */
+
+            /* Compare with the golden results */
+        regTestCompareStrings(rp, (l_uint8 *)DigitText[i],
+                              strlen(DigitText[i]), (l_uint8 *)str1,
+                              strlen(str1));  /* 3, 8, 13 */
+        numaGetSum(nascore1, &sum);
+        regTestCompareValues(rp, DigitScoreSum[i], sum,
+                             0.001);  /* 4, 9, 14 */
+        lept_free(str1);
+        lept_free(str2);
+        numaDestroy(&naindex1);
+        numaDestroy(&naindex2);
+        numaDestroy(&nascore1);
+        numaDestroy(&nascore2);
+        sarrayDestroy(&satext1);
+        sarrayDestroy(&satext2);
+        pixaDestroy(&pixa1);
+    }
+    recogDestroy(&recog);
+
+    /* --------------- Find the best character to split -------------- */
+    pixa1 = pixaRead("recog/sets/train01.pa");
+    recog = recogCreateFromPixa(pixa1, 0, 40, 0, 128, 1);
+    recogAverageSamples(&recog, 0);
+    pixaDestroy(&pixa1);
+    pixa2 = pixaRead("recog/sets/test01.pa");
+    for (i = 0; i < 6; i++) {
+        pix1 = pixaGetPix(pixa2, Touching[i], L_CLONE);
+        pix2 = GetBigComponent(pix1);
+        recogCorrelationBestChar(recog, pix2, &box1, &score, &index,
+                                 NULL, NULL);
+        recogCorrelationBestChar(recog, pix2, &box2, &score2, &index2,
+                                 NULL, &pixdb);
+        boxEqual(box1, box2, &same);
+        regTestCompareValues(rp, 1, same && index == index2,
+                             0.0);  /* 15, 18, ... 30 */
+        regTestCompareValues(rp, score2, score, 0.0);  /* 16, 19, ... 31 */
+
+            /* Compare with the golden results */
+        boxGetGeometry(box1, &x, NULL, &w, NULL);
+        regTestCompareValues(rp, 1, x == BestX[i] && w == BestW[i] &&
+                             index == BestIndex[i] &&
+                             fabs(score - BestScore[i]) < 0.0001,
+                             0.0);  /* 17, 20, ... 32 */
+        boxDestroy(&box1);
+        boxDestroy(&box2);
+        pixDestroy(&pixdb);
+        pixDestroy(&pix1);
+        pixDestroy(&pix2);
+    }
+
+    /* -------------------- Decode touching digits ------------------- */
+    for (i = 0; i < 6; i++) {
+        pix1 = pixaGetPix(pixa2, Touching[i], L_CLONE);
+        pix2 = GetBigComponent(pix1);
+        boxa = recogDecode(recog, pix2, 2, NULL);
+        n = boxaGetCount(boxa);
+        satext1 = sarrayCreate(n);
+        for (j = 0; j < n; j++) {
+            boxaGetBoxGeometry(boxa, j, &x, &y, &w, &h);
+            numaGetIValue(recog->did->natempl, j, &index);
+            snprintf(buf, sizeof(buf), "%d %d %d %d %d\n",
+                     x, y, w, h, index);
+            sarrayAddString(satext1, buf, L_COPY);
+        }
+        str1 = sarrayToString(satext1, 0);
+        regTestCompareStrings(rp, (l_uint8 *)DecodeText[i],
+                              strlen(DecodeText[i]), (l_uint8 *)str1,
+                              strlen(str1));  /* 33, 35, ... 43 */
+        numaGetSum(recog->did->nascore, &sum);
+        regTestCompareValues(rp, DecodeScoreSum[i], sum,
+                             0.0001);  /* 34, 36, ... 44 */
+        lept_free(str1);
+        sarrayDestroy(&satext1);
+        boxaDestroy(&boxa);
+        pixDestroy(&pix1);
+        pixDestroy(&pix2);
+    }
+    pixaDestroy(&pixa2);
+    recogDestroy(&recog);
+
+    return regTestCleanup(rp);
+}
+
+
+    /* Remove small components around the characters */
+static PIX *
+GetBigComponent(PIX  *pixs)
+{
+BOX  *box;
+PIX  *pix1, *pixd;
+
+    pix1 = pixMorphSequence(pixs, "c40.7 + o20.15 + d25.1", 0);
+    pixClipToForeground(pix1, NULL, &box);
+    pixd = pixClipRectangle(pixs, box, NULL);
+    pixDestroy(&pix1);
+    boxDestroy(&box);
+    return pixd;
+}
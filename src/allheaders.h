@@ -162,6 +162,34 @@ LEPT_DLL extern PIX * pixReduceBinary2 ( PIX *pixs, l_uint8 *intab );
 LEPT_DLL extern PIX * pixReduceRankBinaryCascade ( PIX *pixs, l_int32 level1, l_int32 level2, l_int32 level3, l_int32 level4 );
 LEPT_DLL extern PIX * pixReduceRankBinary2 ( PIX *pixs, l_int32 level, l_uint8 *intab );
 LEPT_DLL extern l_uint8 * makeSubsampleTab2x ( void );
+LEPT_DLL extern l_ok numaWriteBinary ( const char *filename, NUMA *na, l_int32 compress );
+LEPT_DLL extern l_ok numaWriteMemBinary ( l_uint8 **pdata, size_t *psize, NUMA *na, l_int32 compress );
+LEPT_DLL extern NUMA * numaReadBinary ( const char *filename );
+LEPT_DLL extern NUMA * numaReadMemBinary ( const l_uint8 *data, size_t size );
+LEPT_DLL extern l_ok numaaWriteBinary ( const char *filename, NUMAA *naa, l_int32 compress );
+LEPT_DLL extern l_ok numaaWriteMemBinary ( l_uint8 **pdata, size_t *psize, NUMAA *naa, l_int32 compress );
+LEPT_DLL extern NUMAA * numaaReadBinary ( const char *filename );
+LEPT_DLL extern NUMAA * numaaReadMemBinary ( const l_uint8 *data, size_t size );
+LEPT_DLL extern l_ok ptaWriteBinary ( const char *filename, PTA *pta, l_int32 compress );
+LEPT_DLL extern l_ok ptaWriteMemBinary ( l_uint8 **pdata, size_t *psize, PTA *pta, l_int32 compress );
+LEPT_DLL extern PTA * ptaReadBinary ( const char *filename );
+LEPT_DLL extern PTA * ptaReadMemBinary ( const l_uint8 *data, size_t size );
+LEPT_DLL extern l_ok ptaaWriteBinary ( const char *filename, PTAA *ptaa, l_int32 compress );
+LEPT_DLL extern l_ok ptaaWriteMemBinary ( l_uint8 **pdata, size_t *psize, PTAA *ptaa, l_int32 compress );
+LEPT_DLL extern PTAA * ptaaReadBinary ( const char *filename );
+LEPT_DLL extern PTAA * ptaaReadMemBinary ( const l_uint8 *data, size_t size );
+LEPT_DLL extern l_ok boxaWriteBinary ( const char *filename, BOXA *boxa, l_int32 compress );
+LEPT_DLL extern l_ok boxaWriteMemBinary ( l_uint8 **pdata, size_t *psize, BOXA *boxa, l_int32 compress );
+LEPT_DLL extern BOXA * boxaReadBinary ( const char *filename );
+LEPT_DLL extern BOXA * boxaReadMemBinary ( const l_uint8 *data, size_t size );
+LEPT_DLL extern l_ok boxaaWriteBinary ( const char *filename, BOXAA *baa, l_int32 compress );
+LEPT_DLL extern l_ok boxaaWriteMemBinary ( l_uint8 **pdata, size_t *psize, BOXAA *baa, l_int32 compress );
+LEPT_DLL extern BOXAA * boxaaReadBinary ( const char *filename );
+LEPT_DLL extern BOXAA * boxaaReadMemBinary ( const l_uint8 *data, size_t size );
+LEPT_DLL extern l_ok pixaWriteBinary ( const char *filename, PIXA *pixa, l_int32 compress );
+LEPT_DLL extern l_ok pixaWriteMemBinary ( l_uint8 **pdata, size_t *psize, PIXA *pixa, l_int32 compress );
+LEPT_DLL extern PIXA * pixaReadBinary ( const char *filename );
+LEPT_DLL extern PIXA * pixaReadMemBinary ( const l_uint8 *data, size_t size );
 LEPT_DLL extern PIX * pixBlend ( PIX *pixs1, PIX *pixs2, l_int32 x, l_int32 y, l_float32 fract );
 LEPT_DLL extern PIX * pixBlendMask ( PIX *pixd, PIX *pixs1, PIX *pixs2, l_int32 x, l_int32 y, l_float32 fract, l_int32 type );
 LEPT_DLL extern PIX * pixBlendGray ( PIX *pixd, PIX *pixs1, PIX *pixs2, l_int32 x, l_int32 y, l_float32 fract, l_int32 type, l_int32 transparent, l_uint32 transpix );
@@ -661,6 +689,7 @@ LEPT_DLL extern l_ok pixCorrelationScore ( PIX *pix1, PIX *pix2, l_int32 area1,
 LEPT_DLL extern l_int32 pixCorrelationScoreThresholded ( PIX *pix1, PIX *pix2, l_int32 area1, l_int32 area2, l_float32 delx, l_float32 dely, l_int32 maxdiffw, l_int32 maxdiffh, l_int32 *tab, l_int32 *downcount, l_float32 score_threshold );
 LEPT_DLL extern l_ok pixCorrelationScoreSimple ( PIX *pix1, PIX *pix2, l_int32 area1, l_int32 area2, l_float32 delx, l_float32 dely, l_int32 maxdiffw, l_int32 maxdiffh, l_int32 *tab, l_float32 *pscore );
 LEPT_DLL extern l_ok pixCorrelationScoreShifted ( PIX *pix1, PIX *pix2, l_int32 area1, l_int32 area2, l_int32 delx, l_int32 dely, l_int32 *tab, l_float32 *pscore );
+LEPT_DLL extern l_ok pixCorrelationCountShiftedRows ( PIX *pix1, PIX *pix2, l_int32 dely, l_int32 *tab, l_int32 *pcount );
 LEPT_DLL extern L_DEWARP * dewarpCreate ( PIX *pixs, l_int32 pageno );
 LEPT_DLL extern L_DEWARP * dewarpCreateRef ( l_int32 pageno, l_int32 refpage );
 LEPT_DLL extern void dewarpDestroy ( L_DEWARP **pdew );
@@ -695,6 +724,7 @@ LEPT_DLL extern l_ok dewarpFindHorizSlopeDisparity ( L_DEWARP *dew, PIX *pixb, l
 LEPT_DLL extern l_ok dewarpBuildLineModel ( L_DEWARP *dew, l_int32 opensize, const char *debugfile );
 LEPT_DLL extern l_ok dewarpaModelStatus ( L_DEWARPA *dewa, l_int32 pageno, l_int32 *pvsuccess, l_int32 *phsuccess );
 LEPT_DLL extern l_ok dewarpaApplyDisparity ( L_DEWARPA *dewa, l_int32 pageno, PIX *pixs, l_int32 grayin, l_int32 x, l_int32 y, PIX **ppixd, const char *debugfile );
+LEPT_DLL extern PIXA * dewarpaApplyDisparityPixa ( L_DEWARPA *dewa, PIXA *pixas, l_int32 firstpage, l_int32 grayin, l_int32 x, l_int32 y );
 LEPT_DLL extern l_ok dewarpaApplyDisparityBoxa ( L_DEWARPA *dewa, l_int32 pageno, PIX *pixs, BOXA *boxas, l_int32 mapdir, l_int32 x, l_int32 y, BOXA **pboxad, const char *debugfile );
 LEPT_DLL extern l_ok dewarpMinimize ( L_DEWARP *dew );
 LEPT_DLL extern l_ok dewarpPopulateFullRes ( L_DEWARP *dew, PIX *pix, l_int32 x, l_int32 y );
@@ -1063,6 +1093,9 @@ LEPT_DLL extern JBCLASSER * jbCorrelationInitWithoutComponents ( l_int32 compone
 LEPT_DLL extern l_ok jbAddPages ( JBCLASSER *classer, SARRAY *safiles );
 LEPT_DLL extern l_ok jbAddPage ( JBCLASSER *classer, PIX *pixs );
 LEPT_DLL extern l_ok jbAddPageComponents ( JBCLASSER *classer, PIX *pixs, BOXA *boxas, PIXA *pixas );
+LEPT_DLL extern JBPAGE * jbPageCreate ( JBCLASSER *classer, PIX *pixs );
+LEPT_DLL extern void jbPageDestroy ( JBPAGE **ppage );
+LEPT_DLL extern l_ok jbAddPreparedPage ( JBCLASSER *classer, JBPAGE *page );
 LEPT_DLL extern l_ok jbClassifyRankHaus ( JBCLASSER *classer, BOXA *boxa, PIXA *pixas );
 LEPT_DLL extern l_int32 pixHaustest ( PIX *pix1, PIX *pix2, PIX *pix3, PIX *pix4, l_float32 delx, l_float32 dely, l_int32 maxdiffw, l_int32 maxdiffh );
 LEPT_DLL extern l_int32 pixRankHaustest ( PIX *pix1, PIX *pix2, PIX *pix3, PIX *pix4, l_float32 delx, l_float32 dely, l_int32 maxdiffw, l_int32 maxdiffh, l_int32 area1, l_int32 area3, l_float32 rank, l_int32 *tab8 );
@@ -1103,6 +1136,12 @@ LEPT_DLL extern PIX * pixReadMemJpeg ( const l_uint8 *data, size_t size, l_int32
 LEPT_DLL extern l_ok readHeaderMemJpeg ( const l_uint8 *data, size_t size, l_int32 *pw, l_int32 *ph, l_int32 *pspp, l_int32 *pycck, l_int32 *pcmyk );
 LEPT_DLL extern l_ok readResolutionMemJpeg ( const l_uint8 *data, size_t size, l_int32 *pxres, l_int32 *pyres );
 LEPT_DLL extern l_ok pixWriteMemJpeg ( l_uint8 **pdata, size_t *psize, PIX *pix, l_int32 quality, l_int32 progressive );
+LEPT_DLL extern L_JPEG_ENCODER * jpegEncoderCreate ( void );
+LEPT_DLL extern void jpegEncoderDestroy ( L_JPEG_ENCODER **penc );
+LEPT_DLL extern l_ok jpegEncoderEncode ( L_JPEG_ENCODER *enc, PIX *pix, l_int32 quality, l_int32 progressive, const l_uint8 **pdata, size_t *psize );
+LEPT_DLL extern L_JPEG_DECODER * jpegDecoderCreate ( void );
+LEPT_DLL extern void jpegDecoderDestroy ( L_JPEG_DECODER **pdec );
+LEPT_DLL extern PIX * jpegDecoderDecode ( L_JPEG_DECODER *dec, const l_uint8 *data, size_t size, l_int32 cmflag, l_int32 reduction, l_int32 *pnwarn, l_int32 hint );
 LEPT_DLL extern l_ok pixSetChromaSampling ( PIX *pix, l_int32 sampling );
 LEPT_DLL extern L_KERNEL * kernelCreate ( l_int32 height, l_int32 width );
 LEPT_DLL extern void kernelDestroy ( L_KERNEL **pkel );
@@ -1227,6 +1266,10 @@ LEPT_DLL extern PIX * pixMorphCompSequence ( PIX *pixs, const char *sequence, l_
 LEPT_DLL extern PIX * pixMorphSequenceDwa ( PIX *pixs, const char *sequence, l_int32 dispsep );
 LEPT_DLL extern PIX * pixMorphCompSequenceDwa ( PIX *pixs, const char *sequence, l_int32 dispsep );
 LEPT_DLL extern l_int32 morphSequenceVerify ( SARRAY *sa );
+LEPT_DLL extern L_MORPHPROG * morphProgCreate ( const char *sequence );
+LEPT_DLL extern void morphProgDestroy ( L_MORPHPROG **pprog );
+LEPT_DLL extern l_int32 morphProgGetCount ( L_MORPHPROG *prog );
+LEPT_DLL extern PIX * morphProgRun ( L_MORPHPROG *prog, PIX *pixs );
 LEPT_DLL extern PIX * pixGrayMorphSequence ( PIX *pixs, const char *sequence, l_int32 dispsep, l_int32 dispy );
 LEPT_DLL extern PIX * pixColorMorphSequence ( PIX *pixs, const char *sequence, l_int32 dispsep, l_int32 dispy );
 LEPT_DLL extern NUMA * numaCreate ( l_int32 n );
@@ -1443,11 +1486,17 @@ LEPT_DLL extern l_ok concatenatePdfToData ( const char *dirname, const char *sub
 LEPT_DLL extern l_ok saConcatenatePdfToData ( SARRAY *sa, l_uint8 **pdata, size_t *pnbytes );
 LEPT_DLL extern l_ok pixConvertToPdfData ( PIX *pix, l_int32 type, l_int32 quality, l_uint8 **pdata, size_t *pnbytes, l_int32 x, l_int32 y, l_int32 res, const char *title, L_PDF_DATA **plpd, l_int32 position );
 LEPT_DLL extern l_ok ptraConcatenatePdfToData ( L_PTRA *pa_data, SARRAY *sa, l_uint8 **pdata, size_t *pnbytes );
+LEPT_DLL extern L_PDF_WRITER * pdfWriterOpen ( const char *fileout, const char *title );
+LEPT_DLL extern l_ok pdfWriterAddPix ( L_PDF_WRITER *lpw, PIX *pix, l_int32 type, l_int32 quality, l_int32 res );
+LEPT_DLL extern l_ok pdfWriterAddFile ( L_PDF_WRITER *lpw, const char *fname, l_int32 quality, l_int32 res );
+LEPT_DLL extern l_ok pdfWriterAddCIData ( L_PDF_WRITER *lpw, L_COMP_DATA *cid, l_int32 res );
+LEPT_DLL extern l_ok pdfWriterClose ( L_PDF_WRITER **plpw );
 LEPT_DLL extern l_ok convertTiffMultipageToPdf ( const char *filein, const char *fileout );
 LEPT_DLL extern l_ok l_generateCIDataForPdf ( const char *fname, PIX *pix, l_int32 quality, L_COMP_DATA **pcid );
 LEPT_DLL extern L_COMP_DATA * l_generateFlateDataPdf ( const char *fname, PIX *pixs );
 LEPT_DLL extern L_COMP_DATA * l_generateJpegData ( const char *fname, l_int32 ascii85flag );
 LEPT_DLL extern L_COMP_DATA * l_generateJpegDataMem ( l_uint8 *data, size_t nbytes, l_int32 ascii85flag );
+LEPT_DLL extern L_COMP_DATA * l_generateTiffPageData ( const char *fname, L_TIFFINDEX *tindex, l_int32 page );
 LEPT_DLL extern l_ok l_generateCIData ( const char *fname, l_int32 type, l_int32 quality, l_int32 ascii85, L_COMP_DATA **pcid );
 LEPT_DLL extern l_ok pixGenerateCIData ( PIX *pixs, l_int32 type, l_int32 quality, l_int32 ascii85, L_COMP_DATA **pcid );
 LEPT_DLL extern L_COMP_DATA * l_generateFlateData ( const char *fname, l_int32 ascii85flag );
@@ -1456,6 +1505,17 @@ LEPT_DLL extern l_ok cidConvertToPdfData ( L_COMP_DATA *cid, const char *title,
 LEPT_DLL extern void l_CIDataDestroy ( L_COMP_DATA **pcid );
 LEPT_DLL extern void l_pdfSetG4ImageMask ( l_int32 flag );
 LEPT_DLL extern void l_pdfSetDateAndVersion ( l_int32 flag );
+LEPT_DLL extern L_PIPELINE * pipelineCreate ( void );
+LEPT_DLL extern void pipelineDestroy ( L_PIPELINE **ppipe );
+LEPT_DLL extern l_ok pipelineAddReduceRankBinary2 ( L_PIPELINE *pipe, l_int32 level );
+LEPT_DLL extern l_ok pipelineAddScaleToGray ( L_PIPELINE *pipe, l_int32 factor );
+LEPT_DLL extern l_ok pipelineAddThresholdToBinary ( L_PIPELINE *pipe, l_int32 thresh );
+LEPT_DLL extern l_ok pipelineAddConvertRGBToGray ( L_PIPELINE *pipe, l_float32 rwt, l_float32 gwt, l_float32 bwt );
+LEPT_DLL extern l_ok pipelineAddBlockconv ( L_PIPELINE *pipe, l_int32 wc, l_int32 hc );
+LEPT_DLL extern l_ok pipelineAddRankFilter ( L_PIPELINE *pipe, l_int32 wf, l_int32 hf, l_float32 rank );
+LEPT_DLL extern l_ok pipelineAddBrickMorph ( L_PIPELINE *pipe, l_int32 type, l_int32 hsize, l_int32 vsize );
+LEPT_DLL extern PIX * pipelineRunPix ( L_PIPELINE *pipe, PIX *pixs, l_int32 bandh );
+LEPT_DLL extern l_ok pipelineRunTiff ( L_PIPELINE *pipe, const char *filein, l_int32 page, const char *fileout, l_int32 comptype, l_int32 bandh );
 LEPT_DLL extern void setPixMemoryManager ( alloc_fn allocator, dealloc_fn deallocator );
 LEPT_DLL extern PIX * pixCreate ( l_int32 width, l_int32 height, l_int32 depth );
 LEPT_DLL extern PIX * pixCreateNoInit ( l_int32 width, l_int32 height, l_int32 depth );
@@ -1510,6 +1570,7 @@ LEPT_DLL extern l_uint32 * pixGetData ( PIX *pix );
 LEPT_DLL extern l_int32 pixSetData ( PIX *pix, l_uint32 *data );
 LEPT_DLL extern l_uint32 * pixExtractData ( PIX *pixs );
 LEPT_DLL extern l_int32 pixFreeData ( PIX *pix );
+LEPT_DLL extern l_int32 pixSetMappedData ( PIX *pix, l_uint32 *data, l_uint8 *mapdata, size_t mapsize );
 LEPT_DLL extern void ** pixGetLinePtrs ( PIX *pix, l_int32 *psize );
 LEPT_DLL extern l_ok pixPrintStreamInfo ( FILE *fp, const PIX *pix, const char *text );
 LEPT_DLL extern l_ok pixGetPixel ( PIX *pix, l_int32 x, l_int32 y, l_uint32 *pval );
@@ -1922,6 +1983,18 @@ LEPT_DLL extern PIXAC * pixacompReadMem ( const l_uint8 *data, size_t size );
 LEPT_DLL extern l_ok pixacompWrite ( const char *filename, PIXAC *pixac );
 LEPT_DLL extern l_ok pixacompWriteStream ( FILE *fp, PIXAC *pixac );
 LEPT_DLL extern l_ok pixacompWriteMem ( l_uint8 **pdata, size_t *psize, PIXAC *pixac );
+LEPT_DLL extern L_PIXAC_ARCHIVE * pixacompArchiveCreate ( const char *filename );
+LEPT_DLL extern L_PIXAC_ARCHIVE * pixacompArchiveOpen ( const char *filename, l_int32 append );
+LEPT_DLL extern l_ok pixacompArchiveClose ( L_PIXAC_ARCHIVE **pparch );
+LEPT_DLL extern l_int32 pixacompArchiveGetCount ( L_PIXAC_ARCHIVE *parch );
+LEPT_DLL extern l_ok pixacompArchiveAddPix ( L_PIXAC_ARCHIVE *parch, PIX *pix, l_int32 comptype, BOX *box );
+LEPT_DLL extern l_ok pixacompArchiveAddPixcomp ( L_PIXAC_ARCHIVE *parch, PIXC *pixc, BOX *box );
+LEPT_DLL extern PIXC * pixacompArchiveGetPixcomp ( L_PIXAC_ARCHIVE *parch, l_int32 index );
+LEPT_DLL extern PIX * pixacompArchiveGetPix ( L_PIXAC_ARCHIVE *parch, l_int32 index );
+LEPT_DLL extern l_ok pixacompArchiveGetPixDimensions ( L_PIXAC_ARCHIVE *parch, l_int32 index, l_int32 *pw, l_int32 *ph, l_int32 *pd );
+LEPT_DLL extern BOX * pixacompArchiveGetBox ( L_PIXAC_ARCHIVE *parch, l_int32 index );
+LEPT_DLL extern l_ok pixacompWriteArchive ( const char *filename, PIXAC *pixac );
+LEPT_DLL extern PIXAC * pixacompReadArchive ( const char *filename );
 LEPT_DLL extern l_ok pixacompConvertToPdf ( PIXAC *pixac, l_int32 res, l_float32 scalefactor, l_int32 type, l_int32 quality, const char *title, const char *fileout );
 LEPT_DLL extern l_ok pixacompConvertToPdfData ( PIXAC *pixac, l_int32 res, l_float32 scalefactor, l_int32 type, l_int32 quality, const char *title, l_uint8 **pdata, size_t *pnbytes );
 LEPT_DLL extern l_ok pixacompFastConvertToPdfData ( PIXAC *pixac, const char *title, l_uint8 **pdata, size_t *pnbytes );
@@ -2003,6 +2076,7 @@ LEPT_DLL extern PIX * pixTilingGetTile ( PIXTILING *pt, l_int32 i, l_int32 j );
 LEPT_DLL extern l_ok pixTilingNoStripOnPaint ( PIXTILING *pt );
 LEPT_DLL extern l_ok pixTilingPaintTile ( PIX *pixd, l_int32 i, l_int32 j, PIX *pixs, PIXTILING *pt );
 LEPT_DLL extern PIX * pixReadStreamPng ( FILE *fp );
+LEPT_DLL extern PIX * pixReadStreamPngRegion ( FILE *fp, BOX *box );
 LEPT_DLL extern l_ok readHeaderPng ( const char *filename, l_int32 *pw, l_int32 *ph, l_int32 *pbps, l_int32 *pspp, l_int32 *piscmap );
 LEPT_DLL extern l_ok freadHeaderPng ( FILE *fp, l_int32 *pw, l_int32 *ph, l_int32 *pbps, l_int32 *pspp, l_int32 *piscmap );
 LEPT_DLL extern l_ok readHeaderMemPng ( const l_uint8 *data, size_t size, l_int32 *pw, l_int32 *ph, l_int32 *pbps, l_int32 *pspp, l_int32 *piscmap );
@@ -2013,8 +2087,12 @@ LEPT_DLL extern l_ok pixWritePng ( const char *filename, PIX *pix, l_float32 gam
 LEPT_DLL extern l_ok pixWriteStreamPng ( FILE *fp, PIX *pix, l_float32 gamma );
 LEPT_DLL extern l_ok pixSetZlibCompression ( PIX *pix, l_int32 compval );
 LEPT_DLL extern void l_pngSetReadStrip16To8 ( l_int32 flag );
+LEPT_DLL extern void l_pngSetWriteFilter ( l_int32 filter );
 LEPT_DLL extern PIX * pixReadMemPng ( const l_uint8 *filedata, size_t filesize );
 LEPT_DLL extern l_ok pixWriteMemPng ( l_uint8 **pfiledata, size_t *pfilesize, PIX *pix, l_float32 gamma );
+LEPT_DLL extern L_PNG_ENCODER * pngEncoderCreate ( void );
+LEPT_DLL extern void pngEncoderDestroy ( L_PNG_ENCODER **penc );
+LEPT_DLL extern l_ok pngEncoderEncode ( L_PNG_ENCODER *enc, PIX *pix, l_float32 gamma, const l_uint8 **pdata, size_t *psize );
 LEPT_DLL extern PIX * pixReadStreamPnm ( FILE *fp );
 LEPT_DLL extern l_ok readHeaderPnm ( const char *filename, l_int32 *pw, l_int32 *ph, l_int32 *pd, l_int32 *ptype, l_int32 *pbps, l_int32 *pspp );
 LEPT_DLL extern l_ok freadHeaderPnm ( FILE *fp, l_int32 *pw, l_int32 *ph, l_int32 *pd, l_int32 *ptype, l_int32 *pbps, l_int32 *pspp );
@@ -2232,6 +2310,9 @@ LEPT_DLL extern PIX * pixRead ( const char *filename );
 LEPT_DLL extern PIX * pixReadWithHint ( const char *filename, l_int32 hint );
 LEPT_DLL extern PIX * pixReadIndexed ( SARRAY *sa, l_int32 index );
 LEPT_DLL extern PIX * pixReadStream ( FILE *fp, l_int32 hint );
+LEPT_DLL extern PIX * pixReadRegion ( const char *filename, BOX *box, l_int32 reduction );
+LEPT_DLL extern PIX * pixReduceForRead ( PIX *pixs, l_int32 factor );
+LEPT_DLL extern PIX * pixReadThumbnail ( const char *filename, l_int32 maxw, l_int32 maxh );
 LEPT_DLL extern l_ok pixReadHeader ( const char *filename, l_int32 *pformat, l_int32 *pw, l_int32 *ph, l_int32 *pbps, l_int32 *pspp, l_int32 *piscmap );
 LEPT_DLL extern l_ok findFileFormat ( const char *filename, l_int32 *pformat );
 LEPT_DLL extern l_ok findFileFormatStream ( FILE *fp, l_int32 *pformat );
@@ -2556,13 +2637,16 @@ LEPT_DLL extern l_int32 pixFindSkewOrthogonalRange ( PIX *pixs, l_float32 *pangl
 LEPT_DLL extern l_ok pixFindDifferentialSquareSum ( PIX *pixs, l_float32 *psum );
 LEPT_DLL extern l_ok pixFindNormalizedSquareSum ( PIX *pixs, l_float32 *phratio, l_float32 *pvratio, l_float32 *pfract );
 LEPT_DLL extern PIX * pixReadStreamSpix ( FILE *fp );
+LEPT_DLL extern PIX * pixReadSpixMapped ( const char *filename );
 LEPT_DLL extern l_ok readHeaderSpix ( const char *filename, l_int32 *pwidth, l_int32 *pheight, l_int32 *pbps, l_int32 *pspp, l_int32 *piscmap );
 LEPT_DLL extern l_ok freadHeaderSpix ( FILE *fp, l_int32 *pwidth, l_int32 *pheight, l_int32 *pbps, l_int32 *pspp, l_int32 *piscmap );
 LEPT_DLL extern l_ok sreadHeaderSpix ( const l_uint32 *data, l_int32 *pwidth, l_int32 *pheight, l_int32 *pbps, l_int32 *pspp, l_int32 *piscmap );
 LEPT_DLL extern l_ok pixWriteStreamSpix ( FILE *fp, PIX *pix );
+LEPT_DLL extern l_ok pixWriteStreamSpixPaged ( FILE *fp, PIX *pix );
 LEPT_DLL extern PIX * pixReadMemSpix ( const l_uint8 *data, size_t size );
 LEPT_DLL extern l_ok pixWriteMemSpix ( l_uint8 **pdata, size_t *psize, PIX *pix );
 LEPT_DLL extern l_ok pixSerializeToMemory ( PIX *pixs, l_uint32 **pdata, size_t *pnbytes );
+LEPT_DLL extern l_ok pixSerializeToMemoryPaged ( PIX *pixs, l_uint32 **pdata, size_t *pnbytes );
 LEPT_DLL extern PIX * pixDeserializeFromMemory ( const l_uint32 *data, size_t nbytes );
 LEPT_DLL extern L_STACK * lstackCreate ( l_int32 n );
 LEPT_DLL extern void lstackDestroy ( L_STACK **plstack, l_int32 freeflag );
@@ -2603,15 +2687,33 @@ LEPT_DLL extern l_ok bmfGetStringWidth ( L_BMF *bmf, const char *textstr, l_int3
 LEPT_DLL extern SARRAY * splitStringToParagraphs ( char *textstr, l_int32 splitflag );
 LEPT_DLL extern PIX * pixReadTiff ( const char *filename, l_int32 n );
 LEPT_DLL extern PIX * pixReadStreamTiff ( FILE *fp, l_int32 n );
+LEPT_DLL extern PIX * pixReadStreamTiffRegion ( FILE *fp, l_int32 n, BOX *box );
+LEPT_DLL extern PIX * pixReadStreamTiffReduced ( FILE *fp, l_int32 minw, l_int32 minh );
 LEPT_DLL extern l_ok pixWriteTiff ( const char *filename, PIX *pix, l_int32 comptype, const char *modestr );
 LEPT_DLL extern l_ok pixWriteTiffCustom ( const char *filename, PIX *pix, l_int32 comptype, const char *modestr, NUMA *natags, SARRAY *savals, SARRAY *satypes, NUMA *nasizes );
 LEPT_DLL extern l_ok pixWriteStreamTiff ( FILE *fp, PIX *pix, l_int32 comptype );
 LEPT_DLL extern l_ok pixWriteStreamTiffWA ( FILE *fp, PIX *pix, l_int32 comptype, const char *modestr );
+LEPT_DLL extern L_TIFF_READER * tiffReaderOpen ( const char *filename, l_int32 n );
+LEPT_DLL extern void tiffReaderClose ( L_TIFF_READER **preader );
+LEPT_DLL extern l_ok tiffReaderGetDimensions ( L_TIFF_READER *reader, l_int32 *pw, l_int32 *ph, l_int32 *pd );
+LEPT_DLL extern PIX * tiffReaderReadRows ( L_TIFF_READER *reader, l_int32 nrows );
+LEPT_DLL extern L_TIFF_WRITER * tiffWriterOpen ( const char *filename, PIX *pixt, l_int32 h, l_int32 comptype );
+LEPT_DLL extern l_ok tiffWriterWriteRows ( L_TIFF_WRITER *writer, PIX *pix );
+LEPT_DLL extern l_ok tiffWriterClose ( L_TIFF_WRITER **pwriter );
 LEPT_DLL extern PIX * pixReadFromMultipageTiff ( const char *fname, size_t *poffset );
 LEPT_DLL extern PIXA * pixaReadMultipageTiff ( const char *filename );
 LEPT_DLL extern l_ok pixaWriteMultipageTiff ( const char *fname, PIXA *pixa );
 LEPT_DLL extern l_ok writeMultipageTiff ( const char *dirin, const char *substr, const char *fileout );
 LEPT_DLL extern l_ok writeMultipageTiffSA ( SARRAY *sa, const char *fileout );
+LEPT_DLL extern L_TIFFINDEX * tiffIndexCreate ( const char *filename );
+LEPT_DLL extern void tiffIndexDestroy ( L_TIFFINDEX **ptindex );
+LEPT_DLL extern l_int32 tiffIndexGetCount ( L_TIFFINDEX *tindex );
+LEPT_DLL extern L_TIFFINDEX * tiffIndexRead ( const char *filename );
+LEPT_DLL extern L_TIFFINDEX * tiffIndexReadStream ( FILE *fp );
+LEPT_DLL extern l_ok tiffIndexWrite ( const char *filename, L_TIFFINDEX *tindex );
+LEPT_DLL extern l_ok tiffIndexWriteStream ( FILE *fp, L_TIFFINDEX *tindex );
+LEPT_DLL extern PIX * pixReadTiffIndexed ( const char *filename, L_TIFFINDEX *tindex, l_int32 page );
+LEPT_DLL extern PIXA * pixaReadMultipageTiffRange ( const char *filename, L_TIFFINDEX *tindex, l_int32 start, l_int32 count );
 LEPT_DLL extern l_ok fprintTiffInfo ( FILE *fpout, const char *tiffile );
 LEPT_DLL extern l_ok tiffGetCount ( FILE *fp, l_int32 *pn );
 LEPT_DLL extern l_ok getTiffResolution ( FILE *fp, l_int32 *pxres, l_int32 *pyres );
@@ -2620,6 +2722,7 @@ LEPT_DLL extern l_ok freadHeaderTiff ( FILE *fp, l_int32 n, l_int32 *pw, l_int32
 LEPT_DLL extern l_ok readHeaderMemTiff ( const l_uint8 *cdata, size_t size, l_int32 n, l_int32 *pw, l_int32 *ph, l_int32 *pbps, l_int32 *pspp, l_int32 *pres, l_int32 *pcmap, l_int32 *pformat );
 LEPT_DLL extern l_ok findTiffCompression ( FILE *fp, l_int32 *pcomptype );
 LEPT_DLL extern l_ok extractG4DataFromFile ( const char *filein, l_uint8 **pdata, size_t *pnbytes, l_int32 *pw, l_int32 *ph, l_int32 *pminisblack );
+LEPT_DLL extern l_ok extractTiffPageCompressedData ( const char *filename, L_TIFFINDEX *tindex, l_int32 page, l_int32 *pcomptype, l_uint8 **pdata, size_t *pnbytes, l_int32 *pw, l_int32 *ph, l_int32 *pminisblack, l_int32 *pres );
 LEPT_DLL extern PIX * pixReadMemTiff ( const l_uint8 *cdata, size_t size, l_int32 n );
 LEPT_DLL extern PIX * pixReadMemFromMultipageTiff ( const l_uint8 *cdata, size_t size, size_t *poffset );
 LEPT_DLL extern PIXA * pixaReadMemMultipageTiff ( const l_uint8 *data, size_t size );
@@ -2687,6 +2790,8 @@ LEPT_DLL extern l_uint8 * l_binaryReadSelectStream ( FILE *fp, size_t start, siz
 LEPT_DLL extern l_ok l_binaryWrite ( const char *filename, const char *operation, const void *data, size_t nbytes );
 LEPT_DLL extern size_t nbytesInFile ( const char *filename );
 LEPT_DLL extern size_t fnbytesInFile ( FILE *fp );
+LEPT_DLL extern l_uint8 * l_binaryMapFile ( const char *filename, size_t *pnbytes );
+LEPT_DLL extern l_ok l_binaryUnmapFile ( l_uint8 *data, size_t nbytes );
 LEPT_DLL extern l_uint8 * l_binaryCopy ( const l_uint8 *datas, size_t size );
 LEPT_DLL extern l_ok l_binaryCompare ( const l_uint8 *data1, size_t size1, const l_uint8 *data2, size_t size2, l_int32 *psame );
 LEPT_DLL extern l_ok fileCopy ( const char *srcfile, const char *newfile );
@@ -2740,6 +2845,7 @@ LEPT_DLL extern l_ok pixaWriteStreamWebPAnim ( FILE *fp, PIXA *pixa, l_int32 loo
 LEPT_DLL extern l_ok pixaWriteMemWebPAnim ( l_uint8 **pencdata, size_t *pencsize, PIXA *pixa, l_int32 loopcount, l_int32 duration, l_int32 quality, l_int32 lossless );
 LEPT_DLL extern PIX * pixReadStreamWebP ( FILE *fp );
 LEPT_DLL extern PIX * pixReadMemWebP ( const l_uint8 *filedata, size_t filesize );
+LEPT_DLL extern PIX * pixReadMemWebPScaled ( const l_uint8 *filedata, size_t filesize, l_int32 wd, l_int32 hd );
 LEPT_DLL extern l_ok readHeaderWebP ( const char *filename, l_int32 *pw, l_int32 *ph, l_int32 *pspp );
 LEPT_DLL extern l_ok readHeaderMemWebP ( const l_uint8 *data, size_t size, l_int32 *pw, l_int32 *ph, l_int32 *pspp );
 LEPT_DLL extern l_ok pixWriteWebP ( const char *filename, PIX *pixs, l_int32 quality, l_int32 lossless );
@@ -56,6 +56,7 @@
 #include "imageio.h"
 #include "jbclass.h"
 #include "morph.h"
+#include "pipeline.h"
 #include "pix.h"
 #include "recog.h"
 #include "regutils.h"
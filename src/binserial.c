@@ -0,0 +1,1903 @@
+/*====================================================================*
+ -  Copyright (C) 2001 Leptonica.  All rights reserved.
+ -
+ -  Redistribution and use in source and binary forms, with or without
+ -  modification, are permitted provided that the following conditions
+ -  are met:
+ -  1. Redistributions of source code must retain the above copyright
+ -     notice, this list of conditions and the following disclaimer.
+ -  2. Redistributions in binary form must reproduce the above
+ -     copyright notice, this list of conditions and the following
+ -     disclaimer in the documentation and/or other materials
+ -     provided with the distribution.
+ -
+ -  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ -  ``AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ -  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ -  A PARTICULAR PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL ANY
+ -  CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ -  EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ -  PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ -  PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ -  OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ -  NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ -  SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *====================================================================*/
+
+/*!
+ * \file binserial.c
+ * <pre>
+ *
+ *    Binary serialization of numa, pta, boxa and pixa, and of arrays
+ *    of them.  This is much faster to write and read than the text
+ *    formats of numaWrite(), ptaWrite(), boxaWrite() and the png
+ *    encoding of pixaWrite().
+ *
+ *      Numa
+ *           l_ok        numaWriteBinary()
+ *           l_ok        numaWriteMemBinary()
+ *           NUMA       *numaReadBinary()
+ *           NUMA       *numaReadMemBinary()
+ *
+ *      Numaa
+ *           l_ok        numaaWriteBinary()
+ *           l_ok        numaaWriteMemBinary()
+ *           NUMAA      *numaaReadBinary()
+ *           NUMAA      *numaaReadMemBinary()
+ *
+ *      Pta
+ *           l_ok        ptaWriteBinary()
+ *           l_ok        ptaWriteMemBinary()
+ *           PTA        *ptaReadBinary()
+ *           PTA        *ptaReadMemBinary()
+ *
+ *      Ptaa
+ *           l_ok        ptaaWriteBinary()
+ *           l_ok        ptaaWriteMemBinary()
+ *           PTAA       *ptaaReadBinary()
+ *           PTAA       *ptaaReadMemBinary()
+ *
+ *      Boxa
+ *           l_ok        boxaWriteBinary()
+ *           l_ok        boxaWriteMemBinary()
+ *           BOXA       *boxaReadBinary()
+ *           BOXA       *boxaReadMemBinary()
+ *
+ *      Boxaa
+ *           l_ok        boxaaWriteBinary()
+ *           l_ok        boxaaWriteMemBinary()
+ *           BOXAA      *boxaaReadBinary()
+ *           BOXAA      *boxaaReadMemBinary()
+ *
+ *      Pixa
+ *           l_ok        pixaWriteBinary()
+ *           l_ok        pixaWriteMemBinary()
+ *           PIXA       *pixaReadBinary()
+ *           PIXA       *pixaReadMemBinary()
+ *
+ *      Static helpers
+ *           static l_uint8  *binaryCreate()
+ *           static l_int32   binaryFinish()
+ *           static l_int32   binaryReaderInit()
+ *           static l_int32   binaryReaderFinish()
+ *           static ...       binaryPut*(), binaryGet*()
+ *           static ...       numaBinarySize(), numaBinaryPut(),
+ *                            numaBinaryGet(), and the same for
+ *                            numaa, pta, ptaa, boxa, boxaa and pixa
+ *
+ *    The serialized data is a 24 byte header, followed by the payload:
+ *        "lbin"         (4 bytes) -- ID for the binary format
+ *        type           (4 bytes) -- "numa", "naa ", "pta ", "ptaa",
+ *                                    "boxa", "bxaa" or "pixa"
+ *        version        (4 bytes) -- currently 1
+ *        flags          (4 bytes) -- 1 if the payload is compressed
+ *        payload size   (8 bytes) -- before compression
+ *        payload
+ *    All numbers are written little-endian.  The payload size in the
+ *    header is a 64-bit value; all other numbers are 32-bit values,
+ *    and floats are written with their IEEE bit pattern.  The payloads are:
+ *        numa:  n, startx, delx, then n values
+ *        numaa: n, then n numa payloads
+ *        pta:   n, then n x values, then n y values
+ *        ptaa:  n, then n pta payloads
+ *        boxa:  n, then (x, y, w, h) for each of n boxes
+ *        boxaa: n, then n boxa payloads
+ *        pixa:  n, a boxa payload, then for each of n pix:
+ *                 w, h, d, spp, xres, yres, informat,
+ *                 ncolors in colormap, number of bytes of text,
+ *                 the colormap (4 bytes/color), the text padded
+ *                 with zeros to a multiple of 4 bytes,
+ *                 and the raster data (wpl * h 32-bit words).
+ *    On little-endian machines, arrays of floats and of raster words
+ *    are copied in a single operation.
+ *
+ *    Compression is optional and uses zlib.  It makes the data smaller
+ *    at some cost in speed.  If zlib is not available, the data is
+ *    written uncompressed.
+ * </pre>
+ */
+
+#ifdef HAVE_CONFIG_H
+#include <config_auto.h>
+#endif  /* HAVE_CONFIG_H */
+
+#include <string.h>
+#include "allheaders.h"
+
+    /* Version of the binary format, and size of its header in bytes */
+static const l_uint32  BinaryVersion = 1;
+static const size_t  BinHeaderSize = 24;
+
+    /* Bound on the number of items in an array */
+static const l_uint32  MaxArraySize = 100000000;   /* 100 million */
+
+    /* Bound on the total size of the payload */
+static const size_t  MaxPayloadSize = 2000000000;   /* 2 GB */
+
+    /* Cursor for reading a payload.  A read past the end of the
+     * data returns 0 and sets the error flag. */
+struct L_BinReader
+{
+    const l_uint8  *data;    /* payload                                */
+    size_t          size;    /* number of bytes in payload             */
+    size_t          pos;     /* location of the next byte to be read   */
+    l_int32         error;   /* set to 1 when reading past the end     */
+    l_uint8        *alloc;   /* uncompressed payload, to be freed      */
+};
+typedef struct L_BinReader  L_BINREADER;
+
+    /* Static functions */
+static l_uint8 *binaryCreate(size_t payloadsize);
+static l_int32 binaryFinish(const char *type, l_int32 compress,
+                            l_uint8 **pdata, size_t *psize);
+static l_int32 binaryReaderInit(L_BINREADER *br, const l_uint8 *data,
+                                size_t size, const char *type);
+static l_int32 binaryReaderFinish(L_BINREADER *br);
+static l_uint8 *binaryPutU32(l_uint8 *p, l_uint32 val);
+static l_uint8 *binaryPutF32(l_uint8 *p, l_float32 val);
+static l_uint8 *binaryPutU32Array(l_uint8 *p, const l_uint32 *ua,
+                                  size_t n);
+static l_uint32 binaryDecodeU32(const l_uint8 *p);
+static l_uint32 binaryGetU32(L_BINREADER *br);
+static l_float32 binaryGetF32(L_BINREADER *br);
+static void binaryGetU32Array(L_BINREADER *br, l_uint32 *ua, size_t n);
+static l_int32 binaryGetCount(L_BINREADER *br, size_t minbytes);
+static size_t numaBinarySize(NUMA *na);
+static l_uint8 *numaBinaryPut(l_uint8 *p, NUMA *na);
+static NUMA *numaBinaryGet(L_BINREADER *br);
+static size_t numaaBinarySize(NUMAA *naa);
+static l_uint8 *numaaBinaryPut(l_uint8 *p, NUMAA *naa);
+static NUMAA *numaaBinaryGet(L_BINREADER *br);
+static size_t ptaBinarySize(PTA *pta);
+static l_uint8 *ptaBinaryPut(l_uint8 *p, PTA *pta);
+static PTA *ptaBinaryGet(L_BINREADER *br);
+static size_t ptaaBinarySize(PTAA *ptaa);
+static l_uint8 *ptaaBinaryPut(l_uint8 *p, PTAA *ptaa);
+static PTAA *ptaaBinaryGet(L_BINREADER *br);
+static size_t boxaBinarySize(BOXA *boxa);
+static l_uint8 *boxaBinaryPut(l_uint8 *p, BOXA *boxa);
+static BOXA *boxaBinaryGet(L_BINREADER *br);
+static size_t boxaaBinarySize(BOXAA *baa);
+static l_uint8 *boxaaBinaryPut(l_uint8 *p, BOXAA *baa);
+static BOXAA *boxaaBinaryGet(L_BINREADER *br);
+static size_t pixaBinarySize(PIXA *pixa);
+static l_uint8 *pixaBinaryPut(l_uint8 *p, PIXA *pixa);
+static PIXA *pixaBinaryGet(L_BINREADER *br);
+
+
+/*---------------------------------------------------------------------*
+ *                                 Numa                                *
+ *---------------------------------------------------------------------*/
+/*!
+ * \brief   numaWriteBinary()
+ *
+ * \param[in]    filename
+ * \param[in]    na
+ * \param[in]    compress   1 to compress the payload; 0 otherwise
+ * \return  0 if OK, 1 on error
+ *
+ * <pre>
+ * Notes:
+ *      (1) See the file header for the binary format.  With %compress,
+ *          the payload is compressed with zlib.
+ * </pre>
+ */
+l_ok
+numaWriteBinary(const char  *filename,
+                NUMA        *na,
+                l_int32      compress)
+{
+l_int32   ret;
+l_uint8  *data;
+size_t    size;
+
+    PROCNAME("numaWriteBinary");
+
+    if (!filename)
+        return ERROR_INT("filename not defined", procName, 1);
+    if (!na)
+        return ERROR_INT("na not defined", procName, 1);
+
+    if (numaWriteMemBinary(&data, &size, na, compress))
+        return ERROR_INT("data not made", procName, 1);
+    ret = l_binaryWrite(filename, "w", data, size);
+    LEPT_FREE(data);
+    if (ret)
+        return ERROR_INT("data not written", procName, 1);
+    return 0;
+}
+
+
+/*!
+ * \brief   numaWriteMemBinary()
+ *
+ * \param[out]   pdata      serialized data
+ * \param[out]   psize      size of serialized data
+ * \param[in]    na
+ * \param[in]    compress   1 to compress the payload; 0 otherwise
+ * \return  0 if OK, 1 on error
+ */
+l_ok
+numaWriteMemBinary(l_uint8  **pdata,
+                   size_t    *psize,
+                   NUMA      *na,
+                   l_int32    compress)
+{
+size_t  size;
+
+    PROCNAME("numaWriteMemBinary");
+
+    if (pdata) *pdata = NULL;
+    if (psize) *psize = 0;
+    if (!pdata || !psize)
+        return ERROR_INT("&data and &size not both defined", procName, 1);
+    if (!na)
+        return ERROR_INT("na not defined", procName, 1);
+
+    size = numaBinarySize(na);
+    if (size > MaxPayloadSize)
+        return ERROR_INT("na is too large", procName, 1);
+    if ((*pdata = binaryCreate(size)) == NULL)
+        return ERROR_INT("data not made", procName, 1);
+    numaBinaryPut(*pdata + BinHeaderSize, na);
+    *psize = BinHeaderSize + size;
+    return binaryFinish("numa", compress, pdata, psize);
+}
+
+
+/*!
+ * \brief   numaReadBinary()
+ *
+ * \param[in]    filename
+ * \return  na, or NULL on error
+ */
+NUMA *
+numaReadBinary(const char  *filename)
+{
+l_uint8  *data;
+size_t    size;
+NUMA     *na;
+
+    PROCNAME("numaReadBinary");
+
+    if (!filename)
+        return (NUMA *)ERROR_PTR("filename not defined", procName, NULL);
+
+    if ((data = l_binaryRead(filename, &size)) == NULL)
+        return (NUMA *)ERROR_PTR("data not read", procName, NULL);
+    na = numaReadMemBinary(data, size);
+    LEPT_FREE(data);
+    if (!na)
+        return (NUMA *)ERROR_PTR("na not made", procName, NULL);
+    return na;
+}
+
+
+/*!
+ * \brief   numaReadMemBinary()
+ *
+ * \param[in]    data    serialized numa
+ * \param[in]    size    of data, in bytes
+ * \return  na, or NULL on error
+ */
+NUMA *
+numaReadMemBinary(const l_uint8  *data,
+                  size_t          size)
+{
+NUMA        *na;
+L_BINREADER  br;
+
+    PROCNAME("numaReadMemBinary");
+
+    if (!data)
+        return (NUMA *)ERROR_PTR("data not defined", procName, NULL);
+
+    if (binaryReaderInit(&br, data, size, "numa"))
+        return (NUMA *)ERROR_PTR("invalid binary data", procName, NULL);
+    na = numaBinaryGet(&br);
+    if (binaryReaderFinish(&br))
+        numaDestroy(&na);
+    if (!na)
+        return (NUMA *)ERROR_PTR("na not made", procName, NULL);
+    return na;
+}
+
+
+/*---------------------------------------------------------------------*
+ *                                Numaa                                *
+ *---------------------------------------------------------------------*/
+/*!
+ * \brief   numaaWriteBinary()
+ *
+ * \param[in]    filename
+ * \param[in]    naa
+ * \param[in]    compress   1 to compress the payload; 0 otherwise
+ * \return  0 if OK, 1 on error
+ */
+l_ok
+numaaWriteBinary(const char  *filename,
+                 NUMAA       *naa,
+                 l_int32      compress)
+{
+l_int32   ret;
+l_uint8  *data;
+size_t    size;
+
+    PROCNAME("numaaWriteBinary");
+
+    if (!filename)
+        return ERROR_INT("filename not defined", procName, 1);
+    if (!naa)
+        return ERROR_INT("naa not defined", procName, 1);
+
+    if (numaaWriteMemBinary(&data, &size, naa, compress))
+        return ERROR_INT("data not made", procName, 1);
+    ret = l_binaryWrite(filename, "w", data, size);
+    LEPT_FREE(data);
+    if (ret)
+        return ERROR_INT("data not written", procName, 1);
+    return 0;
+}
+
+
+/*!
+ * \brief   numaaWriteMemBinary()
+ *
+ * \param[out]   pdata      serialized data
+ * \param[out]   psize      size of serialized data
+ * \param[in]    naa
+ * \param[in]    compress   1 to compress the payload; 0 otherwise
+ * \return  0 if OK, 1 on error
+ */
+l_ok
+numaaWriteMemBinary(l_uint8  **pdata,
+                    size_t    *psize,
+                    NUMAA     *naa,
+                    l_int32    compress)
+{
+size_t  size;
+
+    PROCNAME("numaaWriteMemBinary");
+
+    if (pdata) *pdata = NULL;
+    if (psize) *psize = 0;
+    if (!pdata || !psize)
+        return ERROR_INT("&data and &size not both defined", procName, 1);
+    if (!naa)
+        return ERROR_INT("naa not defined", procName, 1);
+
+    size = numaaBinarySize(naa);
+    if (size > MaxPayloadSize)
+        return ERROR_INT("naa is too large", procName, 1);
+    if ((*pdata = binaryCreate(size)) == NULL)
+        return ERROR_INT("data not made", procName, 1);
+    numaaBinaryPut(*pdata + BinHeaderSize, naa);
+    *psize = BinHeaderSize + size;
+    return binaryFinish("naa ", compress, pdata, psize);
+}
+
+
+/*!
+ * \brief   numaaReadBinary()
+ *
+ * \param[in]    filename
+ * \return  naa, or NULL on error
+ */
+NUMAA *
+numaaReadBinary(const char  *filename)
+{
+l_uint8  *data;
+size_t    size;
+NUMAA    *naa;
+
+    PROCNAME("numaaReadBinary");
+
+    if (!filename)
+        return (NUMAA *)ERROR_PTR("filename not defined", procName, NULL);
+
+    if ((data = l_binaryRead(filename, &size)) == NULL)
+        return (NUMAA *)ERROR_PTR("data not read", procName, NULL);
+    naa = numaaReadMemBinary(data, size);
+    LEPT_FREE(data);
+    if (!naa)
+        return (NUMAA *)ERROR_PTR("naa not made", procName, NULL);
+    return naa;
+}
+
+
+/*!
+ * \brief   numaaReadMemBinary()
+ *
+ * \param[in]    data    serialized numaa
+ * \param[in]    size    of data, in bytes
+ * \return  naa, or NULL on error
+ */
+NUMAA *
+numaaReadMemBinary(const l_uint8  *data,
+                   size_t          size)
+{
+NUMAA       *naa;
+L_BINREADER  br;
+
+    PROCNAME("numaaReadMemBinary");
+
+    if (!data)
+        return (NUMAA *)ERROR_PTR("data not defined", procName, NULL);
+
+    if (binaryReaderInit(&br, data, size, "naa "))
+        return (NUMAA *)ERROR_PTR("invalid binary data", procName, NULL);
+    naa = numaaBinaryGet(&br);
+    if (binaryReaderFinish(&br))
+        numaaDestroy(&naa);
+    if (!naa)
+        return (NUMAA *)ERROR_PTR("naa not made", procName, NULL);
+    return naa;
+}
+
+
+/*---------------------------------------------------------------------*
+ *                                 Pta                                 *
+ *---------------------------------------------------------------------*/
+/*!
+ * \brief   ptaWriteBinary()
+ *
+ * \param[in]    filename
+ * \param[in]    pta
+ * \param[in]    compress   1 to compress the payload; 0 otherwise
+ * \return  0 if OK, 1 on error
+ */
+l_ok
+ptaWriteBinary(const char  *filename,
+               PTA         *pta,
+               l_int32      compress)
+{
+l_int32   ret;
+l_uint8  *data;
+size_t    size;
+
+    PROCNAME("ptaWriteBinary");
+
+    if (!filename)
+        return ERROR_INT("filename not defined", procName, 1);
+    if (!pta)
+        return ERROR_INT("pta not defined", procName, 1);
+
+    if (ptaWriteMemBinary(&data, &size, pta, compress))
+        return ERROR_INT("data not made", procName, 1);
+    ret = l_binaryWrite(filename, "w", data, size);
+    LEPT_FREE(data);
+    if (ret)
+        return ERROR_INT("data not written", procName, 1);
+    return 0;
+}
+
+
+/*!
+ * \brief   ptaWriteMemBinary()
+ *
+ * \param[out]   pdata      serialized data
+ * \param[out]   psize      size of serialized data
+ * \param[in]    pta
+ * \param[in]    compress   1 to compress the payload; 0 otherwise
+ * \return  0 if OK, 1 on error
+ */
+l_ok
+ptaWriteMemBinary(l_uint8  **pdata,
+                  size_t    *psize,
+                  PTA       *pta,
+                  l_int32    compress)
+{
+size_t  size;
+
+    PROCNAME("ptaWriteMemBinary");
+
+    if (pdata) *pdata = NULL;
+    if (psize) *psize = 0;
+    if (!pdata || !psize)
+        return ERROR_INT("&data and &size not both defined", procName, 1);
+    if (!pta)
+        return ERROR_INT("pta not defined", procName, 1);
+
+    size = ptaBinarySize(pta);
+    if (size > MaxPayloadSize)
+        return ERROR_INT("pta is too large", procName, 1);
+    if ((*pdata = binaryCreate(size)) == NULL)
+        return ERROR_INT("data not made", procName, 1);
+    ptaBinaryPut(*pdata + BinHeaderSize, pta);
+    *psize = BinHeaderSize + size;
+    return binaryFinish("pta ", compress, pdata, psize);
+}
+
+
+/*!
+ * \brief   ptaReadBinary()
+ *
+ * \param[in]    filename
+ * \return  pta, or NULL on error
+ */
+PTA *
+ptaReadBinary(const char  *filename)
+{
+l_uint8  *data;
+size_t    size;
+PTA      *pta;
+
+    PROCNAME("ptaReadBinary");
+
+    if (!filename)
+        return (PTA *)ERROR_PTR("filename not defined", procName, NULL);
+
+    if ((data = l_binaryRead(filename, &size)) == NULL)
+        return (PTA *)ERROR_PTR("data not read", procName, NULL);
+    pta = ptaReadMemBinary(data, size);
+    LEPT_FREE(data);
+    if (!pta)
+        return (PTA *)ERROR_PTR("pta not made", procName, NULL);
+    return pta;
+}
+
+
+/*!
+ * \brief   ptaReadMemBinary()
+ *
+ * \param[in]    data    serialized pta
+ * \param[in]    size    of data, in bytes
+ * \return  pta, or NULL on error
+ */
+PTA *
+ptaReadMemBinary(const l_uint8  *data,
+                 size_t          size)
+{
+PTA         *pta;
+L_BINREADER  br;
+
+    PROCNAME("ptaReadMemBinary");
+
+    if (!data)
+        return (PTA *)ERROR_PTR("data not defined", procName, NULL);
+
+    if (binaryReaderInit(&br, data, size, "pta "))
+        return (PTA *)ERROR_PTR("invalid binary data", procName, NULL);
+    pta = ptaBinaryGet(&br);
+    if (binaryReaderFinish(&br))
+        ptaDestroy(&pta);
+    if (!pta)
+        return (PTA *)ERROR_PTR("pta not made", procName, NULL);
+    return pta;
+}
+
+
+/*---------------------------------------------------------------------*
+ *                                 Ptaa                                *
+ *---------------------------------------------------------------------*/
+/*!
+ * \brief   ptaaWriteBinary()
+ *
+ * \param[in]    filename
+ * \param[in]    ptaa
+ * \param[in]    compress   1 to compress the payload; 0 otherwise
+ * \return  0 if OK, 1 on error
+ */
+l_ok
+ptaaWriteBinary(const char  *filename,
+                PTAA        *ptaa,
+                l_int32      compress)
+{
+l_int32   ret;
+l_uint8  *data;
+size_t    size;
+
+    PROCNAME("ptaaWriteBinary");
+
+    if (!filename)
+        return ERROR_INT("filename not defined", procName, 1);
+    if (!ptaa)
+        return ERROR_INT("ptaa not defined", procName, 1);
+
+    if (ptaaWriteMemBinary(&data, &size, ptaa, compress))
+        return ERROR_INT("data not made", procName, 1);
+    ret = l_binaryWrite(filename, "w", data, size);
+    LEPT_FREE(data);
+    if (ret)
+        return ERROR_INT("data not written", procName, 1);
+    return 0;
+}
+
+
+/*!
+ * \brief   ptaaWriteMemBinary()
+ *
+ * \param[out]   pdata      serialized data
+ * \param[out]   psize      size of serialized data
+ * \param[in]    ptaa
+ * \param[in]    compress   1 to compress the payload; 0 otherwise
+ * \return  0 if OK, 1 on error
+ */
+l_ok
+ptaaWriteMemBinary(l_uint8  **pdata,
+                   size_t    *psize,
+                   PTAA      *ptaa,
+                   l_int32    compress)
+{
+size_t  size;
+
+    PROCNAME("ptaaWriteMemBinary");
+
+    if (pdata) *pdata = NULL;
+    if (psize) *psize = 0;
+    if (!pdata || !psize)
+        return ERROR_INT("&data and &size not both defined", procName, 1);
+    if (!ptaa)
+        return ERROR_INT("ptaa not defined", procName, 1);
+
+    size = ptaaBinarySize(ptaa);
+    if (size > MaxPayloadSize)
+        return ERROR_INT("ptaa is too large", procName, 1);
+    if ((*pdata = binaryCreate(size)) == NULL)
+        return ERROR_INT("data not made", procName, 1);
+    ptaaBinaryPut(*pdata + BinHeaderSize, ptaa);
+    *psize = BinHeaderSize + size;
+    return binaryFinish("ptaa", compress, pdata, psize);
+}
+
+
+/*!
+ * \brief   ptaaReadBinary()
+ *
+ * \param[in]    filename
+ * \return  ptaa, or NULL on error
+ */
+PTAA *
+ptaaReadBinary(const char  *filename)
+{
+l_uint8  *data;
+size_t    size;
+PTAA     *ptaa;
+
+    PROCNAME("ptaaReadBinary");
+
+    if (!filename)
+        return (PTAA *)ERROR_PTR("filename not defined", procName, NULL);
+
+    if ((data = l_binaryRead(filename, &size)) == NULL)
+        return (PTAA *)ERROR_PTR("data not read", procName, NULL);
+    ptaa = ptaaReadMemBinary(data, size);
+    LEPT_FREE(data);
+    if (!ptaa)
+        return (PTAA *)ERROR_PTR("ptaa not made", procName, NULL);
+    return ptaa;
+}
+
+
+/*!
+ * \brief   ptaaReadMemBinary()
+ *
+ * \param[in]    data    serialized ptaa
+ * \param[in]    size    of data, in bytes
+ * \return  ptaa, or NULL on error
+ */
+PTAA *
+ptaaReadMemBinary(const l_uint8  *data,
+                  size_t          size)
+{
+PTAA        *ptaa;
+L_BINREADER  br;
+
+    PROCNAME("ptaaReadMemBinary");
+
+    if (!data)
+        return (PTAA *)ERROR_PTR("data not defined", procName, NULL);
+
+    if (binaryReaderInit(&br, data, size, "ptaa"))
+        return (PTAA *)ERROR_PTR("invalid binary data", procName, NULL);
+    ptaa = ptaaBinaryGet(&br);
+    if (binaryReaderFinish(&br))
+        ptaaDestroy(&ptaa);
+    if (!ptaa)
+        return (PTAA *)ERROR_PTR("ptaa not made", procName, NULL);
+    return ptaa;
+}
+
+
+/*---------------------------------------------------------------------*
+ *                                 Boxa                                *
+ *---------------------------------------------------------------------*/
+/*!
+ * \brief   boxaWriteBinary()
+ *
+ * \param[in]    filename
+ * \param[in]    boxa
+ * \param[in]    compress   1 to compress the payload; 0 otherwise
+ * \return  0 if OK, 1 on error
+ */
+l_ok
+boxaWriteBinary(const char  *filename,
+                BOXA        *boxa,
+                l_int32      compress)
+{
+l_int32   ret;
+l_uint8  *data;
+size_t    size;
+
+    PROCNAME("boxaWriteBinary");
+
+    if (!filename)
+        return ERROR_INT("filename not defined", procName, 1);
+    if (!boxa)
+        return ERROR_INT("boxa not defined", procName, 1);
+
+    if (boxaWriteMemBinary(&data, &size, boxa, compress))
+        return ERROR_INT("data not made", procName, 1);
+    ret = l_binaryWrite(filename, "w", data, size);
+    LEPT_FREE(data);
+    if (ret)
+        return ERROR_INT("data not written", procName, 1);
+    return 0;
+}
+
+
+/*!
+ * \brief   boxaWriteMemBinary()
+ *
+ * \param[out]   pdata      serialized data
+ * \param[out]   psize      size of serialized data
+ * \param[in]    boxa
+ * \param[in]    compress   1 to compress the payload; 0 otherwise
+ * \return  0 if OK, 1 on error
+ */
+l_ok
+boxaWriteMemBinary(l_uint8  **pdata,
+                   size_t    *psize,
+                   BOXA      *boxa,
+                   l_int32    compress)
+{
+size_t  size;
+
+    PROCNAME("boxaWriteMemBinary");
+
+    if (pdata) *pdata = NULL;
+    if (psize) *psize = 0;
+    if (!pdata || !psize)
+        return ERROR_INT("&data and &size not both defined", procName, 1);
+    if (!boxa)
+        return ERROR_INT("boxa not defined", procName, 1);
+
+    size = boxaBinarySize(boxa);
+    if (size > MaxPayloadSize)
+        return ERROR_INT("boxa is too large", procName, 1);
+    if ((*pdata = binaryCreate(size)) == NULL)
+        return ERROR_INT("data not made", procName, 1);
+    boxaBinaryPut(*pdata + BinHeaderSize, boxa);
+    *psize = BinHeaderSize + size;
+    return binaryFinish("boxa", compress, pdata, psize);
+}
+
+
+/*!
+ * \brief   boxaReadBinary()
+ *
+ * \param[in]    filename
+ * \return  boxa, or NULL on error
+ */
+BOXA *
+boxaReadBinary(const char  *filename)
+{
+l_uint8  *data;
+size_t    size;
+BOXA     *boxa;
+
+    PROCNAME("boxaReadBinary");
+
+    if (!filename)
+        return (BOXA *)ERROR_PTR("filename not defined", procName, NULL);
+
+    if ((data = l_binaryRead(filename, &size)) == NULL)
+        return (BOXA *)ERROR_PTR("data not read", procName, NULL);
+    boxa = boxaReadMemBinary(data, size);
+    LEPT_FREE(data);
+    if (!boxa)
+        return (BOXA *)ERROR_PTR("boxa not made", procName, NULL);
+    return boxa;
+}
+
+
+/*!
+ * \brief   boxaReadMemBinary()
+ *
+ * \param[in]    data    serialized boxa
+ * \param[in]    size    of data, in bytes
+ * \return  boxa, or NULL on error
+ */
+BOXA *
+boxaReadMemBinary(const l_uint8  *data,
+                  size_t          size)
+{
+BOXA        *boxa;
+L_BINREADER  br;
+
+    PROCNAME("boxaReadMemBinary");
+
+    if (!data)
+        return (BOXA *)ERROR_PTR("data not defined", procName, NULL);
+
+    if (binaryReaderInit(&br, data, size, "boxa"))
+        return (BOXA *)ERROR_PTR("invalid binary data", procName, NULL);
+    boxa = boxaBinaryGet(&br);
+    if (binaryReaderFinish(&br))
+        boxaDestroy(&boxa);
+    if (!boxa)
+        return (BOXA *)ERROR_PTR("boxa not made", procName, NULL);
+    return boxa;
+}
+
+
+/*---------------------------------------------------------------------*
+ *                                Boxaa                                *
+ *---------------------------------------------------------------------*/
+/*!
+ * \brief   boxaaWriteBinary()
+ *
+ * \param[in]    filename
+ * \param[in]    baa
+ * \param[in]    compress   1 to compress the payload; 0 otherwise
+ * \return  0 if OK, 1 on error
+ */
+l_ok
+boxaaWriteBinary(const char  *filename,
+                 BOXAA       *baa,
+                 l_int32      compress)
+{
+l_int32   ret;
+l_uint8  *data;
+size_t    size;
+
+    PROCNAME("boxaaWriteBinary");
+
+    if (!filename)
+        return ERROR_INT("filename not defined", procName, 1);
+    if (!baa)
+        return ERROR_INT("baa not defined", procName, 1);
+
+    if (boxaaWriteMemBinary(&data, &size, baa, compress))
+        return ERROR_INT("data not made", procName, 1);
+    ret = l_binaryWrite(filename, "w", data, size);
+    LEPT_FREE(data);
+    if (ret)
+        return ERROR_INT("data not written", procName, 1);
+    return 0;
+}
+
+
+/*!
+ * \brief   boxaaWriteMemBinary()
+ *
+ * \param[out]   pdata      serialized data
+ * \param[out]   psize      size of serialized data
+ * \param[in]    baa
+ * \param[in]    compress   1 to compress the payload; 0 otherwise
+ * \return  0 if OK, 1 on error
+ */
+l_ok
+boxaaWriteMemBinary(l_uint8  **pdata,
+                    size_t    *psize,
+                    BOXAA     *baa,
+                    l_int32    compress)
+{
+size_t  size;
+
+    PROCNAME("boxaaWriteMemBinary");
+
+    if (pdata) *pdata = NULL;
+    if (psize) *psize = 0;
+    if (!pdata || !psize)
+        return ERROR_INT("&data and &size not both defined", procName, 1);
+    if (!baa)
+        return ERROR_INT("baa not defined", procName, 1);
+
+    size = boxaaBinarySize(baa);
+    if (size > MaxPayloadSize)
+        return ERROR_INT("baa is too large", procName, 1);
+    if ((*pdata = binaryCreate(size)) == NULL)
+        return ERROR_INT("data not made", procName, 1);
+    boxaaBinaryPut(*pdata + BinHeaderSize, baa);
+    *psize = BinHeaderSize + size;
+    return binaryFinish("bxaa", compress, pdata, psize);
+}
+
+
+/*!
+ * \brief   boxaaReadBinary()
+ *
+ * \param[in]    filename
+ * \return  baa, or NULL on error
+ */
+BOXAA *
+boxaaReadBinary(const char  *filename)
+{
+l_uint8  *data;
+size_t    size;
+BOXAA    *baa;
+
+    PROCNAME("boxaaReadBinary");
+
+    if (!filename)
+        return (BOXAA *)ERROR_PTR("filename not defined", procName, NULL);
+
+    if ((data = l_binaryRead(filename, &size)) == NULL)
+        return (BOXAA *)ERROR_PTR("data not read", procName, NULL);
+    baa = boxaaReadMemBinary(data, size);
+    LEPT_FREE(data);
+    if (!baa)
+        return (BOXAA *)ERROR_PTR("baa not made", procName, NULL);
+    return baa;
+}
+
+
+/*!
+ * \brief   boxaaReadMemBinary()
+ *
+ * \param[in]    data    serialized boxaa
+ * \param[in]    size    of data, in bytes
+ * \return  baa, or NULL on error
+ */
+BOXAA *
+boxaaReadMemBinary(const l_uint8  *data,
+                   size_t          size)
+{
+BOXAA       *baa;
+L_BINREADER  br;
+
+    PROCNAME("boxaaReadMemBinary");
+
+    if (!data)
+        return (BOXAA *)ERROR_PTR("data not defined", procName, NULL);
+
+    if (binaryReaderInit(&br, data, size, "bxaa"))
+        return (BOXAA *)ERROR_PTR("invalid binary data", procName, NULL);
+    baa = boxaaBinaryGet(&br);
+    if (binaryReaderFinish(&br))
+        boxaaDestroy(&baa);
+    if (!baa)
+        return (BOXAA *)ERROR_PTR("baa not made", procName, NULL);
+    return baa;
+}
+
+
+/*---------------------------------------------------------------------*
+ *                                 Pixa                                *
+ *---------------------------------------------------------------------*/
+/*!
+ * \brief   pixaWriteBinary()
+ *
+ * \param[in]    filename
+ * \param[in]    pixa
+ * \param[in]    compress   1 to compress the payload; 0 otherwise
+ * \return  0 if OK, 1 on error
+ *
+ * <pre>
+ * Notes:
+ *      (1) The raster data of each pix is written uncompressed, unless
+ *          %compress is set.  The boxa, colormaps, text, resolution
+ *          and input format are also written.
+ * </pre>
+ */
+l_ok
+pixaWriteBinary(const char  *filename,
+                PIXA        *pixa,
+                l_int32      compress)
+{
+l_int32   ret;
+l_uint8  *data;
+size_t    size;
+
+    PROCNAME("pixaWriteBinary");
+
+    if (!filename)
+        return ERROR_INT("filename not defined", procName, 1);
+    if (!pixa)
+        return ERROR_INT("pixa not defined", procName, 1);
+
+    if (pixaWriteMemBinary(&data, &size, pixa, compress))
+        return ERROR_INT("data not made", procName, 1);
+    ret = l_binaryWrite(filename, "w", data, size);
+    LEPT_FREE(data);
+    if (ret)
+        return ERROR_INT("data not written", procName, 1);
+    return 0;
+}
+
+
+/*!
+ * \brief   pixaWriteMemBinary()
+ *
+ * \param[out]   pdata      serialized data
+ * \param[out]   psize      size of serialized data
+ * \param[in]    pixa
+ * \param[in]    compress   1 to compress the payload; 0 otherwise
+ * \return  0 if OK, 1 on error
+ */
+l_ok
+pixaWriteMemBinary(l_uint8  **pdata,
+                   size_t    *psize,
+                   PIXA      *pixa,
+                   l_int32    compress)
+{
+size_t  size;
+
+    PROCNAME("pixaWriteMemBinary");
+
+    if (pdata) *pdata = NULL;
+    if (psize) *psize = 0;
+    if (!pdata || !psize)
+        return ERROR_INT("&data and &size not both defined", procName, 1);
+    if (!pixa)
+        return ERROR_INT("pixa not defined", procName, 1);
+
+    size = pixaBinarySize(pixa);
+    if (size > MaxPayloadSize)
+        return ERROR_INT("pixa is too large", procName, 1);
+    if ((*pdata = binaryCreate(size)) == NULL)
+        return ERROR_INT("data not made", procName, 1);
+    pixaBinaryPut(*pdata + BinHeaderSize, pixa);
+    *psize = BinHeaderSize + size;
+    return binaryFinish("pixa", compress, pdata, psize);
+}
+
+
+/*!
+ * \brief   pixaReadBinary()
+ *
+ * \param[in]    filename
+ * \return  pixa, or NULL on error
+ */
+PIXA *
+pixaReadBinary(const char  *filename)
+{
+l_uint8  *data;
+size_t    size;
+PIXA     *pixa;
+
+    PROCNAME("pixaReadBinary");
+
+    if (!filename)
+        return (PIXA *)ERROR_PTR("filename not defined", procName, NULL);
+
+    if ((data = l_binaryRead(filename, &size)) == NULL)
+        return (PIXA *)ERROR_PTR("data not read", procName, NULL);
+    pixa = pixaReadMemBinary(data, size);
+    LEPT_FREE(data);
+    if (!pixa)
+        return (PIXA *)ERROR_PTR("pixa not made", procName, NULL);
+    return pixa;
+}
+
+
+/*!
+ * \brief   pixaReadMemBinary()
+ *
+ * \param[in]    data    serialized pixa
+ * \param[in]    size    of data, in bytes
+ * \return  pixa, or NULL on error
+ */
+PIXA *
+pixaReadMemBinary(const l_uint8  *data,
+                  size_t          size)
+{
+PIXA        *pixa;
+L_BINREADER  br;
+
+    PROCNAME("pixaReadMemBinary");
+
+    if (!data)
+        return (PIXA *)ERROR_PTR("data not defined", procName, NULL);
+
+    if (binaryReaderInit(&br, data, size, "pixa"))
+        return (PIXA *)ERROR_PTR("invalid binary data", procName, NULL);
+    pixa = pixaBinaryGet(&br);
+    if (binaryReaderFinish(&br))
+        pixaDestroy(&pixa);
+    if (!pixa)
+        return (PIXA *)ERROR_PTR("pixa not made", procName, NULL);
+    return pixa;
+}
+
+/*---------------------------------------------------------------------*
+ *                   Static helpers: header and payload                *
+ *---------------------------------------------------------------------*/
+/*!
+ * \brief   binaryCreate()
+ *
+ * \param[in]    payloadsize    number of bytes in the payload
+ * \return  zeroed array for the header and payload, or NULL on error
+ */
+static l_uint8 *
+binaryCreate(size_t  payloadsize)
+{
+    return (l_uint8 *)LEPT_CALLOC(BinHeaderSize + payloadsize,
+                                  sizeof(l_uint8));
+}
+
+
+/*!
+ * \brief   binaryFinish()
+ *
+ * \param[in]       type       4 character type id
+ * \param[in]       compress   1 to compress the payload; 0 otherwise
+ * \param[in,out]   pdata      header and payload
+ * \param[in,out]   psize      number of bytes in data
+ * \return  0 if OK, 1 on error
+ *
+ * <pre>
+ * Notes:
+ *      (1) This writes the header.  If the payload is compressed,
+ *          the input data is freed and replaced.
+ *      (2) On error, the data is freed.
+ * </pre>
+ */
+static l_int32
+binaryFinish(const char  *type,
+             l_int32      compress,
+             l_uint8    **pdata,
+             size_t      *psize)
+{
+l_uint8  *data, *cdata, *datac;
+size_t    psize64, csize;
+
+    PROCNAME("binaryFinish");
+
+    data = *pdata;
+    psize64 = *psize - BinHeaderSize;
+    memcpy(data, "lbin", 4);
+    memcpy(data + 4, type, 4);
+    binaryPutU32(data + 8, BinaryVersion);
+    binaryPutU32(data + 12, 0);
+    binaryPutU32(data + 16, (l_uint32)(psize64 & 0xffffffff));
+    binaryPutU32(data + 20, (l_uint32)((l_uint64)psize64 >> 32));
+    if (!compress)
+        return 0;
+
+    if ((cdata = zlibCompress(data + BinHeaderSize, psize64, &csize))
+         == NULL) {
+        L_WARNING("compression failed; data is not compressed\n", procName);
+        return 0;
+    }
+    if ((datac = (l_uint8 *)LEPT_CALLOC(BinHeaderSize + csize,
+                                        sizeof(l_uint8))) == NULL) {
+        LEPT_FREE(cdata);
+        LEPT_FREE(*pdata);
+        *psize = 0;
+        return ERROR_INT("datac not made", procName, 1);
+    }
+    memcpy(datac, data, BinHeaderSize);
+    binaryPutU32(datac + 12, 1);
+    memcpy(datac + BinHeaderSize, cdata, csize);
+    LEPT_FREE(cdata);
+    LEPT_FREE(*pdata);
+    *pdata = datac;
+    *psize = BinHeaderSize + csize;
+    return 0;
+}
+
+
+/*!
+ * \brief   binaryReaderInit()
+ *
+ * \param[in]    br      reader to be initialized
+ * \param[in]    data    header and payload
+ * \param[in]    size    number of bytes in data
+ * \param[in]    type    4 character type id that is expected
+ * \return  0 if OK, 1 on error
+ *
+ * <pre>
+ * Notes:
+ *      (1) An uncompressed payload is read in place.  A compressed
+ *          payload is uncompressed into br->alloc, which is freed by
+ *          binaryReaderFinish().
+ * </pre>
+ */
+static l_int32
+binaryReaderInit(L_BINREADER    *br,
+                 const l_uint8  *data,
+                 size_t          size,
+                 const char     *type)
+{
+l_uint8   *udata;
+l_uint32   version, flags, lo, hi;
+size_t     psize, usize;
+
+    PROCNAME("binaryReaderInit");
+
+    memset(br, 0, sizeof(L_BINREADER));
+    if (size < BinHeaderSize)
+        return ERROR_INT("data too small", procName, 1);
+    if (memcmp(data, "lbin", 4) != 0)
+        return ERROR_INT("not binary serialized data", procName, 1);
+    if (memcmp(data + 4, type, 4) != 0) {
+        L_ERROR("data is not of type '%.4s'\n", procName, type);
+        return 1;
+    }
+    version = binaryDecodeU32(data + 8);
+    flags = binaryDecodeU32(data + 12);
+    lo = binaryDecodeU32(data + 16);
+    hi = binaryDecodeU32(data + 20);
+    if (version != BinaryVersion)
+        return ERROR_INT("invalid version", procName, 1);
+    if (flags > 1)
+        return ERROR_INT("invalid flags", procName, 1);
+    if (hi != 0 || lo > MaxPayloadSize)
+        return ERROR_INT("payload too large", procName, 1);
+    psize = lo;
+
+    if (flags == 0) {
+        if (size - BinHeaderSize != psize)
+            return ERROR_INT("invalid payload size", procName, 1);
+        br->data = data + BinHeaderSize;
+        br->size = psize;
+        return 0;
+    }
+
+    udata = zlibUncompress((l_uint8 *)data + BinHeaderSize,
+                           size - BinHeaderSize, &usize);
+    if (!udata)
+        return ERROR_INT("payload not uncompressed", procName, 1);
+    if (usize != psize) {
+        LEPT_FREE(udata);
+        return ERROR_INT("invalid payload size", procName, 1);
+    }
+    br->data = br->alloc = udata;
+    br->size = usize;
+    return 0;
+}
+
+
+/*!
+ * \brief   binaryReaderFinish()
+ *
+ * \param[in]    br
+ * \return  0 if the entire payload was read without error, 1 otherwise
+ */
+static l_int32
+binaryReaderFinish(L_BINREADER  *br)
+{
+    PROCNAME("binaryReaderFinish");
+
+    LEPT_FREE(br->alloc);
+    br->alloc = NULL;
+    if (br->error)
+        return ERROR_INT("payload is truncated or invalid", procName, 1);
+    if (br->pos != br->size)
+        return ERROR_INT("extra bytes in payload", procName, 1);
+    return 0;
+}
+
+
+/*---------------------------------------------------------------------*
+ *                  Static helpers: numbers and arrays                 *
+ *---------------------------------------------------------------------*/
+static l_uint8 *
+binaryPutU32(l_uint8   *p,
+             l_uint32   val)
+{
+    p[0] = val & 0xff;
+    p[1] = (val >> 8) & 0xff;
+    p[2] = (val >> 16) & 0xff;
+    p[3] = (val >> 24) & 0xff;
+    return p + 4;
+}
+
+
+static l_uint8 *
+binaryPutF32(l_uint8    *p,
+             l_float32   val)
+{
+l_uint32  uval;
+
+    memcpy(&uval, &val, 4);
+    return binaryPutU32(p, uval);
+}
+
+
+    /* This is also used for arrays of floats, which have the same size */
+static l_uint8 *
+binaryPutU32Array(l_uint8         *p,
+                  const l_uint32  *ua,
+                  size_t           n)
+{
+#ifdef L_BIG_ENDIAN
+size_t  i;
+
+    for (i = 0; i < n; i++)
+        p = binaryPutU32(p, ua[i]);
+    return p;
+#else
+    if (n > 0) memcpy(p, ua, 4 * n);
+    return p + 4 * n;
+#endif  /* L_BIG_ENDIAN */
+}
+
+
+static l_uint32
+binaryDecodeU32(const l_uint8  *p)
+{
+    return (l_uint32)p[0] | ((l_uint32)p[1] << 8) |
+           ((l_uint32)p[2] << 16) | ((l_uint32)p[3] << 24);
+}
+
+
+static l_uint32
+binaryGetU32(L_BINREADER  *br)
+{
+l_uint32  val;
+
+    if (br->error || br->size - br->pos < 4) {
+        br->error = 1;
+        return 0;
+    }
+    val = binaryDecodeU32(br->data + br->pos);
+    br->pos += 4;
+    return val;
+}
+
+
+static l_float32
+binaryGetF32(L_BINREADER  *br)
+{
+l_uint32   uval;
+l_float32  val;
+
+    uval = binaryGetU32(br);
+    memcpy(&val, &uval, 4);
+    return val;
+}
+
+
+    /* This is also used for arrays of floats, which have the same size */
+static void
+binaryGetU32Array(L_BINREADER  *br,
+                  l_uint32     *ua,
+                  size_t        n)
+{
+#ifdef L_BIG_ENDIAN
+size_t  i;
+#endif  /* L_BIG_ENDIAN */
+
+    if (br->error || (br->size - br->pos) / 4 < n) {
+        br->error = 1;
+        return;
+    }
+#ifdef L_BIG_ENDIAN
+    for (i = 0; i < n; i++)
+        ua[i] = binaryGetU32(br);
+#else
+    if (n > 0) memcpy(ua, br->data + br->pos, 4 * n);
+    br->pos += 4 * n;
+#endif  /* L_BIG_ENDIAN */
+}
+
+
+/*!
+ * \brief   binaryGetCount()
+ *
+ * \param[in]    br
+ * \param[in]    minbytes   minimum number of bytes needed for each item
+ * \return  count, or 0 on error
+ *
+ * <pre>
+ * Notes:
+ *      (1) This reads the number of items in an array, and checks that
+ *          it is not larger than the remaining payload allows, so that
+ *          invalid data can not cause a large allocation.
+ * </pre>
+ */
+static l_int32
+binaryGetCount(L_BINREADER  *br,
+               size_t        minbytes)
+{
+l_uint32  n;
+
+    n = binaryGetU32(br);
+    if (br->error)
+        return 0;
+    if (n > MaxArraySize || n * minbytes > br->size - br->pos) {
+        br->error = 1;
+        return 0;
+    }
+    return n;
+}
+
+
+/*---------------------------------------------------------------------*
+ *              Static helpers: numa, pta and boxa payloads            *
+ *---------------------------------------------------------------------*/
+static size_t
+numaBinarySize(NUMA  *na)
+{
+    return 12 + 4 * (size_t)numaGetCount(na);
+}
+
+
+static l_uint8 *
+numaBinaryPut(l_uint8  *p,
+              NUMA     *na)
+{
+l_int32    n;
+l_float32  startx, delx;
+
+    n = numaGetCount(na);
+    numaGetParameters(na, &startx, &delx);
+    p = binaryPutU32(p, n);
+    p = binaryPutF32(p, startx);
+    p = binaryPutF32(p, delx);
+    return binaryPutU32Array(p, (l_uint32 *)numaGetFArray(na, L_NOCOPY), n);
+}
+
+
+static NUMA *
+numaBinaryGet(L_BINREADER  *br)
+{
+l_int32    n;
+l_float32  startx, delx;
+NUMA      *na;
+
+    n = binaryGetCount(br, 4);
+    startx = binaryGetF32(br);
+    delx = binaryGetF32(br);
+    if (br->error)
+        return NULL;
+    na = numaCreate(n);
+    numaSetCount(na, n);
+    numaSetParameters(na, startx, delx);
+    binaryGetU32Array(br, (l_uint32 *)numaGetFArray(na, L_NOCOPY), n);
+    if (br->error)
+        numaDestroy(&na);
+    return na;
+}
+
+
+static size_t
+numaaBinarySize(NUMAA  *naa)
+{
+l_int32  i, n;
+size_t   size;
+NUMA    *na;
+
+    n = numaaGetCount(naa);
+    for (i = 0, size = 4; i < n; i++) {
+        na = numaaGetNuma(naa, i, L_CLONE);
+        size += (na) ? numaBinarySize(na) : 12;
+        numaDestroy(&na);
+    }
+    return size;
+}
+
+
+    /* A missing numa is written as an empty one */
+static l_uint8 *
+numaaBinaryPut(l_uint8  *p,
+               NUMAA    *naa)
+{
+l_int32  i, n;
+NUMA    *na;
+
+    n = numaaGetCount(naa);
+    p = binaryPutU32(p, n);
+    for (i = 0; i < n; i++) {
+        if ((na = numaaGetNuma(naa, i, L_CLONE)) != NULL) {
+            p = numaBinaryPut(p, na);
+            numaDestroy(&na);
+        } else {
+            p = binaryPutU32(p, 0);
+            p = binaryPutF32(p, 0.0);
+            p = binaryPutF32(p, 1.0);
+        }
+    }
+    return p;
+}
+
+
+static NUMAA *
+numaaBinaryGet(L_BINREADER  *br)
+{
+l_int32  i, n;
+NUMA    *na;
+NUMAA   *naa;
+
+    n = binaryGetCount(br, 12);
+    if (br->error)
+        return NULL;
+    naa = numaaCreate(n);
+    for (i = 0; i < n; i++) {
+        if ((na = numaBinaryGet(br)) == NULL) {
+            numaaDestroy(&naa);
+            return NULL;
+        }
+        numaaAddNuma(naa, na, L_INSERT);
+    }
+    return naa;
+}
+
+
+static size_t
+ptaBinarySize(PTA  *pta)
+{
+    return 4 + 8 * (size_t)ptaGetCount(pta);
+}
+
+
+static l_uint8 *
+ptaBinaryPut(l_uint8  *p,
+             PTA      *pta)
+{
+l_int32  n;
+
+    n = ptaGetCount(pta);
+    p = binaryPutU32(p, n);
+    p = binaryPutU32Array(p, (l_uint32 *)pta->x, n);
+    return binaryPutU32Array(p, (l_uint32 *)pta->y, n);
+}
+
+
+static PTA *
+ptaBinaryGet(L_BINREADER  *br)
+{
+l_int32  n;
+PTA     *pta;
+
+    n = binaryGetCount(br, 8);
+    if (br->error)
+        return NULL;
+    pta = ptaCreate(n);
+    binaryGetU32Array(br, (l_uint32 *)pta->x, n);
+    binaryGetU32Array(br, (l_uint32 *)pta->y, n);
+    pta->n = n;
+    if (br->error)
+        ptaDestroy(&pta);
+    return pta;
+}
+
+
+static size_t
+ptaaBinarySize(PTAA  *ptaa)
+{
+l_int32  i, n;
+size_t   size;
+PTA     *pta;
+
+    n = ptaaGetCount(ptaa);
+    for (i = 0, size = 4; i < n; i++) {
+        pta = ptaaGetPta(ptaa, i, L_CLONE);
+        size += (pta) ? ptaBinarySize(pta) : 4;
+        ptaDestroy(&pta);
+    }
+    return size;
+}
+
+
+    /* A missing pta is written as an empty one */
+static l_uint8 *
+ptaaBinaryPut(l_uint8  *p,
+              PTAA     *ptaa)
+{
+l_int32  i, n;
+PTA     *pta;
+
+    n = ptaaGetCount(ptaa);
+    p = binaryPutU32(p, n);
+    for (i = 0; i < n; i++) {
+        if ((pta = ptaaGetPta(ptaa, i, L_CLONE)) != NULL) {
+            p = ptaBinaryPut(p, pta);
+            ptaDestroy(&pta);
+        } else {
+            p = binaryPutU32(p, 0);
+        }
+    }
+    return p;
+}
+
+
+static PTAA *
+ptaaBinaryGet(L_BINREADER  *br)
+{
+l_int32  i, n;
+PTA     *pta;
+PTAA    *ptaa;
+
+    n = binaryGetCount(br, 4);
+    if (br->error)
+        return NULL;
+    ptaa = ptaaCreate(n);
+    for (i = 0; i < n; i++) {
+        if ((pta = ptaBinaryGet(br)) == NULL) {
+            ptaaDestroy(&ptaa);
+            return NULL;
+        }
+        ptaaAddPta(ptaa, pta, L_INSERT);
+    }
+    return ptaa;
+}
+
+
+static size_t
+boxaBinarySize(BOXA  *boxa)
+{
+    return 4 + 16 * (size_t)boxaGetCount(boxa);
+}
+
+
+static l_uint8 *
+boxaBinaryPut(l_uint8  *p,
+              BOXA     *boxa)
+{
+l_int32  i, n, x, y, w, h;
+
+    n = boxaGetCount(boxa);
+    p = binaryPutU32(p, n);
+    for (i = 0; i < n; i++) {
+        boxaGetBoxGeometry(boxa, i, &x, &y, &w, &h);
+        p = binaryPutU32(p, x);
+        p = binaryPutU32(p, y);
+        p = binaryPutU32(p, w);
+        p = binaryPutU32(p, h);
+    }
+    return p;
+}
+
+
+static BOXA *
+boxaBinaryGet(L_BINREADER  *br)
+{
+l_int32  i, n, x, y, w, h;
+BOX     *box;
+BOXA    *boxa;
+
+    n = binaryGetCount(br, 16);
+    if (br->error)
+        return NULL;
+    boxa = boxaCreate(n);
+    for (i = 0; i < n; i++) {
+        x = (l_int32)binaryGetU32(br);
+        y = (l_int32)binaryGetU32(br);
+        w = (l_int32)binaryGetU32(br);
+        h = (l_int32)binaryGetU32(br);
+        if (br->error || (box = boxCreate(x, y, w, h)) == NULL) {
+            br->error = 1;
+            boxaDestroy(&boxa);
+            return NULL;
+        }
+        boxaAddBox(boxa, box, L_INSERT);
+    }
+    return boxa;
+}
+
+
+static size_t
+boxaaBinarySize(BOXAA  *baa)
+{
+l_int32  i, n;
+size_t   size;
+BOXA    *boxa;
+
+    n = boxaaGetCount(baa);
+    for (i = 0, size = 4; i < n; i++) {
+        boxa = boxaaGetBoxa(baa, i, L_CLONE);
+        size += (boxa) ? boxaBinarySize(boxa) : 4;
+        boxaDestroy(&boxa);
+    }
+    return size;
+}
+
+
+    /* A missing boxa is written as an empty one */
+static l_uint8 *
+boxaaBinaryPut(l_uint8  *p,
+               BOXAA    *baa)
+{
+l_int32  i, n;
+BOXA    *boxa;
+
+    n = boxaaGetCount(baa);
+    p = binaryPutU32(p, n);
+    for (i = 0; i < n; i++) {
+        if ((boxa = boxaaGetBoxa(baa, i, L_CLONE)) != NULL) {
+            p = boxaBinaryPut(p, boxa);
+            boxaDestroy(&boxa);
+        } else {
+            p = binaryPutU32(p, 0);
+        }
+    }
+    return p;
+}
+
+
+static BOXAA *
+boxaaBinaryGet(L_BINREADER  *br)
+{
+l_int32  i, n;
+BOXA    *boxa;
+BOXAA   *baa;
+
+    n = binaryGetCount(br, 4);
+    if (br->error)
+        return NULL;
+    baa = boxaaCreate(n);
+    for (i = 0; i < n; i++) {
+        if ((boxa = boxaBinaryGet(br)) == NULL) {
+            boxaaDestroy(&baa);
+            return NULL;
+        }
+        boxaaAddBoxa(baa, boxa, L_INSERT);
+    }
+    return baa;
+}
+
+
+/*---------------------------------------------------------------------*
+ *                     Static helpers: pixa payload                    *
+ *---------------------------------------------------------------------*/
+static size_t
+pixaBinarySize(PIXA  *pixa)
+{
+l_int32   i, n, ncolors;
+size_t    size, textlen;
+char     *text;
+PIX      *pix;
+PIXCMAP  *cmap;
+
+    n = pixaGetCount(pixa);
+    size = 4 + boxaBinarySize(pixa->boxa);
+    for (i = 0; i < n; i++) {
+        pix = pixaGetPix(pixa, i, L_CLONE);
+        cmap = pixGetColormap(pix);
+        ncolors = (cmap) ? pixcmapGetCount(cmap) : 0;
+        text = pixGetText(pix);
+        textlen = (text) ? strlen(text) : 0;
+        size += 36 + 4 * ncolors + 4 * ((textlen + 3) / 4) +
+                4 * (size_t)pixGetWpl(pix) * pixGetHeight(pix);
+        pixDestroy(&pix);
+    }
+    return size;
+}
+
+
+static l_uint8 *
+pixaBinaryPut(l_uint8  *p,
+              PIXA     *pixa)
+{
+l_int32   i, n, w, h, d, ncolors, xres, yres;
+size_t    textlen;
+char     *text;
+l_uint8  *cdata;
+PIX      *pix;
+PIXCMAP  *cmap;
+
+    n = pixaGetCount(pixa);
+    p = binaryPutU32(p, n);
+    p = boxaBinaryPut(p, pixa->boxa);
+    for (i = 0; i < n; i++) {
+        pix = pixaGetPix(pixa, i, L_CLONE);
+        pixGetDimensions(pix, &w, &h, &d);
+        pixGetResolution(pix, &xres, &yres);
+        cmap = pixGetColormap(pix);
+        text = pixGetText(pix);
+        textlen = (text) ? strlen(text) : 0;
+        cdata = NULL;
+        ncolors = 0;
+        if (cmap) pixcmapSerializeToMemory(cmap, 4, &ncolors, &cdata);
+        p = binaryPutU32(p, w);
+        p = binaryPutU32(p, h);
+        p = binaryPutU32(p, d);
+        p = binaryPutU32(p, pixGetSpp(pix));
+        p = binaryPutU32(p, xres);
+        p = binaryPutU32(p, yres);
+        p = binaryPutU32(p, pixGetInputFormat(pix));
+        p = binaryPutU32(p, ncolors);
+        p = binaryPutU32(p, textlen);
+        if (ncolors > 0) {
+            memcpy(p, cdata, 4 * ncolors);
+            p += 4 * ncolors;
+        }
+        if (textlen > 0) {
+            memcpy(p, text, textlen);  /* padding is already zeroed */
+            p += 4 * ((textlen + 3) / 4);
+        }
+        p = binaryPutU32Array(p, pixGetData(pix),
+                              (size_t)pixGetWpl(pix) * h);
+        LEPT_FREE(cdata);
+        pixDestroy(&pix);
+    }
+    return p;
+}
+
+
+static PIXA *
+pixaBinaryGet(L_BINREADER  *br)
+{
+char     *text;
+l_int32   i, n, w, h, d, spp, xres, yres, informat, ncolors;
+l_uint32  textlen;
+l_int64   wpl, avail;
+BOXA     *boxa;
+PIX      *pix;
+PIXA     *pixa;
+PIXCMAP  *cmap;
+
+    n = binaryGetCount(br, 40);
+    if (br->error || (boxa = boxaBinaryGet(br)) == NULL)
+        return NULL;
+    pixa = pixaCreate(n);
+    pixaSetBoxa(pixa, boxa, L_INSERT);
+    for (i = 0; i < n; i++) {
+        w = (l_int32)binaryGetU32(br);
+        h = (l_int32)binaryGetU32(br);
+        d = (l_int32)binaryGetU32(br);
+        spp = (l_int32)binaryGetU32(br);
+        xres = (l_int32)binaryGetU32(br);
+        yres = (l_int32)binaryGetU32(br);
+        informat = (l_int32)binaryGetU32(br);
+        ncolors = (l_int32)binaryGetU32(br);
+        textlen = binaryGetU32(br);
+        if (br->error)
+            break;
+
+            /* Make sure the data is there before allocating the pix */
+        wpl = ((l_int64)w * d + 31) / 32;
+        avail = (l_int64)(br->size - br->pos);
+        if (w <= 0 || h <= 0 || d <= 0 || d > 32 ||
+            ncolors < 0 || ncolors > 256 || textlen > avail ||
+            4 * (wpl * h + ncolors) + 4 * (((l_int64)textlen + 3) / 4) >
+                avail) {
+            br->error = 1;
+            break;
+        }
+        if ((pix = pixCreateNoInit(w, h, d)) == NULL) {
+            br->error = 1;
+            break;
+        }
+        pixSetSpp(pix, spp);
+        pixSetResolution(pix, xres, yres);
+        pixSetInputFormat(pix, informat);
+        if (ncolors > 0) {
+            cmap = pixcmapDeserializeFromMemory(
+                       (l_uint8 *)br->data + br->pos, 4, ncolors);
+            br->pos += 4 * ncolors;
+            if (!cmap || pixSetColormap(pix, cmap)) {
+                pixDestroy(&pix);
+                br->error = 1;
+                break;
+            }
+        }
+        if (textlen > 0) {
+            text = (char *)LEPT_CALLOC(textlen + 1, sizeof(char));
+            memcpy(text, br->data + br->pos, textlen);
+            pixSetText(pix, text);
+            LEPT_FREE(text);
+            br->pos += 4 * ((textlen + 3) / 4);
+        }
+        binaryGetU32Array(br, pixGetData(pix), (size_t)wpl * h);
+        pixaAddPix(pixa, pix, L_INSERT);
+    }
+
+    if (br->error)
+        pixaDestroy(&pixa);
+    return pixa;
+}
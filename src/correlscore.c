@@ -37,6 +37,7 @@
  *     Simple 2 pix correlators
  *         l_int32     pixCorrelationScoreSimple()
  *         l_int32     pixCorrelationScoreShifted()
+ *         l_int32     pixCorrelationCountShiftedRows()
  *
  *     There are other, more application-oriented functions, that
  *     compute the correlation between two binary images, taking into
@@ -881,3 +882,85 @@ PIX     *pixt;
                ((l_float32)area1 * (l_float32)area2);
     return 0;
 }
+
+
+/*!
+ * \brief   pixCorrelationCountShiftedRows()
+ *
+ * \param[in]    pix1     1 bpp
+ * \param[in]    pix2     1 bpp; same wpl as pix1
+ * \param[in]    dely     y translation of pix2 relative to pix1
+ * \param[in]    tab      sum tab for byte
+ * \param[out]   pcount   number of ON pixels in the AND
+ * \return  0 if OK, 1 on error
+ *
+ * <pre>
+ * Notes:
+ *      (1) This counts the ON pixels in the AND of pix1 and pix2,
+ *          when pix2 is shifted down by %dely with respect to pix1.
+ *          Rows of pix2 that are shifted outside pix1 do not contribute.
+ *      (2) The rows are ANDed a word at a time, without any horizontal
+ *          shift, so pix1 and pix2 must have the same wpl.  If the pad
+ *          bits of either image are 0, the pad bits of the other are
+ *          ignored.  The count is then the same as with
+ *              pixt = pixCreateTemplate(pix1);
+ *              pixRasterop(pixt, 0, dely, w2, h2, PIX_SRC, pix2, 0, 0);
+ *              pixRasterop(pixt, 0, 0, w1, h1, PIX_SRC & PIX_DST,
+ *                          pix1, 0, 0);
+ *              pixCountPixels(pixt, &count, tab);
+ *          but no images are made or cleared.
+ *      (3) This is used in recog to compare a template with a window
+ *          of an image at a sequence of vertical shifts, where the
+ *          window has been blitted into pix1 with its left edge on
+ *          a word boundary.
+ * </pre>
+ */
+l_ok
+pixCorrelationCountShiftedRows(PIX      *pix1,
+                               PIX      *pix2,
+                               l_int32   dely,
+                               l_int32  *tab,
+                               l_int32  *pcount)
+{
+l_int32    h1, h2, wpl, y, k, ystart, yend, count;
+l_uint32   andw;
+l_uint32  *data1, *data2, *line1, *line2;
+
+    PROCNAME("pixCorrelationCountShiftedRows");
+
+    if (!pcount)
+        return ERROR_INT("&count not defined", procName, 1);
+    *pcount = 0;
+    if (!pix1 || pixGetDepth(pix1) != 1)
+        return ERROR_INT("pix1 undefined or not 1 bpp", procName, 1);
+    if (!pix2 || pixGetDepth(pix2) != 1)
+        return ERROR_INT("pix2 undefined or not 1 bpp", procName, 1);
+    if (!tab)
+        return ERROR_INT("tab not defined", procName, 1);
+    wpl = pixGetWpl(pix1);
+    if (pixGetWpl(pix2) != wpl)
+        return ERROR_INT("pix1 and pix2 wpl differ", procName, 1);
+
+    h1 = pixGetHeight(pix1);
+    h2 = pixGetHeight(pix2);
+    data1 = pixGetData(pix1);
+    data2 = pixGetData(pix2);
+    ystart = L_MAX(0, -dely);
+    yend = L_MIN(h2, h1 - dely);
+    count = 0;
+    for (y = ystart; y < yend; y++) {
+        line1 = data1 + (y + dely) * wpl;
+        line2 = data2 + y * wpl;
+        for (k = 0; k < wpl; k++) {
+            andw = line1[k] & line2[k];
+            if (andw) {
+                count += tab[andw & 0xff] +
+                    tab[(andw >> 8) & 0xff] +
+                    tab[(andw >> 16) & 0xff] +
+                    tab[andw >> 24];
+            }
+        }
+    }
+    *pcount = count;
+    return 0;
+}
@@ -32,9 +32,12 @@
  *
  *      Apply disparity array to pix
  *          l_int32            dewarpaApplyDisparity()
+ *          PIXA              *dewarpaApplyDisparityPixa()
+ *          static l_int32     dewarpaApplyPage()
  *          static l_int32     dewarpaApplyInit()
  *          static PIX        *pixApplyVertDisparity()
  *          static PIX        *pixApplyHorizDisparity()
+ *          static PIX        *pixApplyVertAndHorizDisparity()
  *
  *      Apply disparity array to boxa
  *          l_int32            dewarpaApplyDisparityBoxa()
@@ -58,11 +61,17 @@
 #include <math.h>
 #include "allheaders.h"
 
+static l_int32 dewarpaApplyPage(L_DEWARPA *dewa, l_int32 pageno, PIX *pixs,
+                                l_int32 grayin, l_int32 x, l_int32 y,
+                                PIX **ppixd, L_DEWARP **pdew,
+                                const char *debugfile);
 static l_int32 dewarpaApplyInit(L_DEWARPA *dewa, l_int32 pageno, PIX *pixs,
                                 l_int32 x, l_int32 y, L_DEWARP **pdew,
                                 const char *debugfile);
 static PIX *pixApplyVertDisparity(L_DEWARP *dew, PIX *pixs, l_int32 grayin);
 static PIX * pixApplyHorizDisparity(L_DEWARP *dew, PIX *pixs, l_int32 grayin);
+static PIX *pixApplyVertAndHorizDisparity(L_DEWARP *dew, PIX *pixs,
+                                          l_int32 grayin);
 static BOXA *boxaApplyDisparity(L_DEWARP *dew, BOXA *boxa, l_int32 direction,
                                 l_int32 mapdir);
 
@@ -122,8 +131,8 @@ dewarpaApplyDisparity(L_DEWARPA   *dewa,
                       PIX        **ppixd,
                       const char  *debugfile)
 {
-L_DEWARP  *dew1, *dew;
-PIX       *pixv, *pixh;
+l_int32    ret;
+L_DEWARP  *dew;
 
     PROCNAME("dewarpaApplyDisparity");
 
@@ -137,15 +146,203 @@ PIX       *pixv, *pixh;
         grayin = 255;
     }
 
+    ret = dewarpaApplyPage(dewa, pageno, pixs, grayin, x, y, ppixd, &dew,
+                           debugfile);
+
+        /* Get rid of the large full res disparity arrays */
+    if (dew)
+        dewarpMinimize(dew);
+    return ret;
+}
+
+
+/*!
+ * \brief   dewarpaApplyDisparityPixa()
+ *
+ * \param[in]    dewa
+ * \param[in]    pixas       images to be modified; each can be 1, 8 or 32 bpp
+ * \param[in]    firstpage   page number of the first image in %pixas
+ * \param[in]    grayin      gray value, from 0 to 255, for pixels brought in;
+ *                           use -1 to use pixels on the boundary of pixs
+ * \param[in]    x, y        origin for generation of disparity arrays
+ * \return  pixad   disparity corrected images, or NULL on error
+ *
+ * <pre>
+ * Notes:
+ *      (1) This applies the disparity arrays to a set of page images,
+ *          where the image at index i in %pixas is page %firstpage + i.
+ *          The result for each page is identical to what is returned
+ *          by dewarpaApplyDisparity().
+ *      (2) Pages with no model or ref model, and pages that fail, are
+ *          returned as a clone of the input image.
+ *      (3) The expensive part of applying a model is building its full
+ *          resolution disparity arrays from the sampled ones.
+ *          dewarpaApplyDisparity() discards them after each page, so
+ *          every page that uses a ref model rebuilds them.  Here they
+ *          are kept for as long as later pages use the same model, and
+ *          are rebuilt only when the image size changes.  A model is
+ *          minimized after the last page that uses it, so the memory
+ *          held at any time is about 16 bytes per pixel for each
+ *          model still in use.
+ *      (4) If the models and ref models have not been validated, this
+ *          will do so by calling dewarpaInsertRefModels().
+ * </pre>
+ */
+PIXA *
+dewarpaApplyDisparityPixa(L_DEWARPA  *dewa,
+                          PIXA       *pixas,
+                          l_int32     firstpage,
+                          l_int32     grayin,
+                          l_int32     x,
+                          l_int32     y)
+{
+l_int32    i, n, pageno, w, h;
+l_int32   *modelpage, *lastuse, *fullw, *fullh;
+L_DEWARP  *dew1, *dew;
+PIX       *pixs, *pixd;
+PIXA      *pixad;
+
+    PROCNAME("dewarpaApplyDisparityPixa");
+
+    if (!dewa)
+        return (PIXA *)ERROR_PTR("dewa not defined", procName, NULL);
+    if (!pixas)
+        return (PIXA *)ERROR_PTR("pixas not defined", procName, NULL);
+    if (firstpage < 0)
+        return (PIXA *)ERROR_PTR("invalid firstpage", procName, NULL);
+    if (grayin > 255) {
+        L_WARNING("invalid grayin = %d; clipping at 255\n", procName, grayin);
+        grayin = 255;
+    }
+
+    if (dewa->modelsready == FALSE)
+        dewarpaInsertRefModels(dewa, 0, 0);
+
+        /* Find the model used by each page, and the last page using
+         * each model.  The size of the full res arrays currently held
+         * by each model is kept in %fullw and %fullh; a width of 0
+         * means we have not yet used it, and -1 that the arrays were
+         * present on entry and may not have been made for this size. */
+    n = pixaGetCount(pixas);
+    modelpage = (l_int32 *)LEPT_CALLOC(n + 1, sizeof(l_int32));
+    lastuse = (l_int32 *)LEPT_CALLOC(dewa->maxpage + 1, sizeof(l_int32));
+    fullw = (l_int32 *)LEPT_CALLOC(dewa->maxpage + 1, sizeof(l_int32));
+    fullh = (l_int32 *)LEPT_CALLOC(dewa->maxpage + 1, sizeof(l_int32));
+    for (i = 0; i < n; i++) {
+        modelpage[i] = -1;
+        pageno = firstpage + i;
+        if (pageno > dewa->maxpage ||
+            (dew1 = dewarpaGetDewarp(dewa, pageno)) == NULL)
+            continue;
+        dew = (dew1->hasref) ? dewarpaGetDewarp(dewa, dew1->refpage) : dew1;
+        if (!dew) continue;
+        modelpage[i] = dew->pageno;
+        lastuse[dew->pageno] = i;
+    }
+
+    pixad = pixaCreate(n);
+    for (i = 0; i < n; i++) {
+        pixs = pixaGetPix(pixas, i, L_CLONE);
+        if (modelpage[i] < 0) {
+            pixaAddPix(pixad, pixs, L_INSERT);
+            continue;
+        }
+
+            /* Remake the full res arrays if the size has changed */
+        pageno = modelpage[i];
+        dew = dewarpaGetDewarp(dewa, pageno);
+        pixGetDimensions(pixs, &w, &h, NULL);
+        if (fullw[pageno] == 0) {
+            fullw[pageno] = (dew->fullvdispar) ? -1 : w;
+            fullh[pageno] = h;
+        } else if (fullw[pageno] != w || fullh[pageno] != h) {
+            fpixDestroy(&dew->fullvdispar);
+            fpixDestroy(&dew->fullhdispar);
+            fullw[pageno] = w;
+            fullh[pageno] = h;
+        }
+
+        pixd = pixClone(pixs);
+        if (dewarpaApplyPage(dewa, firstpage + i, pixs, grayin, x, y,
+                             &pixd, &dew, NULL))
+            L_ERROR("disparity not applied to page %d\n", procName,
+                    firstpage + i);
+        pixaAddPix(pixad, pixd, L_INSERT);
+        pixDestroy(&pixs);
+
+            /* Get rid of the full res arrays after their last use */
+        if (dew && lastuse[pageno] == i)
+            dewarpMinimize(dew);
+    }
+
+    LEPT_FREE(modelpage);
+    LEPT_FREE(lastuse);
+    LEPT_FREE(fullw);
+    LEPT_FREE(fullh);
+    return pixad;
+}
+
+
+/*!
+ * \brief   dewarpaApplyPage()
+ *
+ * \param[in]    dewa
+ * \param[in]    pageno      of page model to be used; may be a ref model
+ * \param[in]    pixs        image to be modified; can be 1, 8 or 32 bpp
+ * \param[in]    grayin      gray value, from 0 to 255, for pixels brought in;
+ *                           use -1 to use pixels on the boundary of pixs
+ * \param[in]    x, y        origin for generation of disparity arrays
+ * \param[in,out] ppixd      input clone of pixs; disparity corrected image
+ * \param[out]   pdew        dew whose full res arrays were used;
+ *                           null if no model was found
+ * \param[in]    debugfile   use NULL to skip writing this
+ * \return  0 if OK, 1 on error no models or ref models available
+ *
+ * <pre>
+ * Notes:
+ *      (1) This does the work of dewarpaApplyDisparity(), leaving the
+ *          full res disparity arrays in the returned %dew.  The caller
+ *          is responsible for calling dewarpMinimize() on it.
+ * </pre>
+ */
+static l_int32
+dewarpaApplyPage(L_DEWARPA   *dewa,
+                 l_int32      pageno,
+                 PIX         *pixs,
+                 l_int32      grayin,
+                 l_int32      x,
+                 l_int32      y,
+                 PIX        **ppixd,
+                 L_DEWARP   **pdew,
+                 const char  *debugfile)
+{
+L_DEWARP  *dew1, *dew;
+PIX       *pixv, *pixh;
+
+    PROCNAME("dewarpaApplyPage");
+
+    *pdew = NULL;
+
         /* Find the appropriate dew to use and fully populate its array(s) */
     if (dewarpaApplyInit(dewa, pageno, pixs, x, y, &dew, debugfile))
         return ERROR_INT("no model available", procName, 1);
+    *pdew = dew;
+
+        /* If both corrections are to be made and the intermediate
+         * image is not wanted for debugging, do them in one pass */
+    if (!debugfile && dewa->useboth && dew->hsuccess && !dew->skip_horiz &&
+        dew->hvalid && dew->fullhdispar) {
+        if ((pixh = pixApplyVertAndHorizDisparity(dew, pixs, grayin))
+            != NULL) {
+            pixDestroy(ppixd);
+            *ppixd = pixh;
+            return 0;
+        }
+    }
 
         /* Correct for vertical disparity and save the result */
-    if ((pixv = pixApplyVertDisparity(dew, pixs, grayin)) == NULL) {
-        dewarpMinimize(dew);
+    if ((pixv = pixApplyVertDisparity(dew, pixs, grayin)) == NULL)
         return ERROR_INT("pixv not made", procName, 1);
-    }
     pixDestroy(ppixd);
     *ppixd = pixv;
     if (debugfile) {
@@ -183,9 +380,6 @@ PIX       *pixv, *pixh;
         lept_stderr("pdf file: %s\n", debugfile);
     }
 
-        /* Get rid of the large full res disparity arrays */
-    dewarpMinimize(dew);
-
     return 0;
 }
 
@@ -504,6 +698,104 @@ PIX        *pixd;
 }
 
 
+/*!
+ * \brief   pixApplyVertAndHorizDisparity()
+ *
+ * \param[in]    dew
+ * \param[in]    pixs     1, 8 or 32 bpp
+ * \param[in]    grayin   gray value, from 0 to 255, for pixels brought in;
+ *                        use -1 to use pixels on the boundary of pixs
+ * \return  pixd   modified to remove vertical and horizontal disparity,
+ *                 or NULL on error
+ *
+ * <pre>
+ * Notes:
+ *      (1) This gives the same result as pixApplyVertDisparity()
+ *          followed by pixApplyHorizDisparity(), in a single pass
+ *          and without making the intermediate image.
+ *      (2) Each dest pixel (i,j) first finds its column jsrc in the
+ *          vertically corrected image from the horizontal disparity
+ *          at (i,j).  That pixel came from row isrc of pixs, given by
+ *          the vertical disparity at (i,jsrc).  If either source is
+ *          outside the image, the pixel is left at %grayin.
+ * </pre>
+ */
+static PIX *
+pixApplyVertAndHorizDisparity(L_DEWARP  *dew,
+                              PIX       *pixs,
+                              l_int32    grayin)
+{
+l_int32     i, j, w, h, d, fw, fh, wpld, wplv, wplh, isrc, jsrc, val8;
+l_uint32   *datad, *lined;
+l_float32  *datav, *datah, *linev, *lineh;
+void      **lineptrs;
+FPIX       *fpixv, *fpixh;
+PIX        *pixd;
+
+    PROCNAME("pixApplyVertAndHorizDisparity");
+
+    if (!dew)
+        return (PIX *)ERROR_PTR("dew not defined", procName, NULL);
+    if (!pixs)
+        return (PIX *)ERROR_PTR("pixs not defined", procName, NULL);
+    pixGetDimensions(pixs, &w, &h, &d);
+    if (d != 1 && d != 8 && d != 32)
+        return (PIX *)ERROR_PTR("pix not 1, 8 or 32 bpp", procName, NULL);
+    if ((fpixv = dew->fullvdispar) == NULL)
+        return (PIX *)ERROR_PTR("fullvdispar not defined", procName, NULL);
+    if ((fpixh = dew->fullhdispar) == NULL)
+        return (PIX *)ERROR_PTR("fullhdispar not defined", procName, NULL);
+    fpixGetDimensions(fpixv, &fw, &fh);
+    if (fw < w || fh < h)
+        return (PIX *)ERROR_PTR("invalid fpixv size", procName, NULL);
+    fpixGetDimensions(fpixh, &fw, &fh);
+    if (fw < w || fh < h)
+        return (PIX *)ERROR_PTR("invalid fpixh size", procName, NULL);
+
+        /* Two choices for requested pixels outside pixs: (1) use pixels'
+         * from the boundary of pixs; use white or light gray pixels. */
+    pixd = pixCreateTemplate(pixs);
+    if (grayin >= 0)
+        pixSetAllGray(pixd, grayin);
+    datad = pixGetData(pixd);
+    datav = fpixGetData(fpixv);
+    datah = fpixGetData(fpixh);
+    wpld = pixGetWpl(pixd);
+    wplv = fpixGetWpl(fpixv);
+    wplh = fpixGetWpl(fpixh);
+    lineptrs = pixGetLinePtrs(pixs, NULL);
+    for (i = 0; i < h; i++) {
+        lined = datad + i * wpld;
+        linev = datav + i * wplv;
+        lineh = datah + i * wplh;
+        for (j = 0; j < w; j++) {
+            jsrc = (l_int32)(j - lineh[j] + 0.5);
+            if (grayin < 0)  /* use value at boundary if outside */
+                jsrc = L_MIN(L_MAX(jsrc, 0), w - 1);
+            else if (jsrc < 0 || jsrc >= w)  /* remains gray */
+                continue;
+            isrc = (l_int32)(i - linev[jsrc] + 0.5);
+            if (grayin < 0)
+                isrc = L_MIN(L_MAX(isrc, 0), h - 1);
+            else if (isrc < 0 || isrc >= h)
+                continue;
+            if (d == 1) {
+                if (GET_DATA_BIT(lineptrs[isrc], jsrc))
+                    SET_DATA_BIT(lined, j);
+            } else if (d == 8) {
+                val8 = GET_DATA_BYTE(lineptrs[isrc], jsrc);
+                SET_DATA_BYTE(lined, j, val8);
+            } else {  /* d == 32 */
+                lined[j] = GET_DATA_FOUR_BYTES(lineptrs[isrc], jsrc);
+            }
+        }
+    }
+
+    LEPT_FREE(lineptrs);
+    return pixd;
+}
+
+
 /*----------------------------------------------------------------------*
  *                 Apply warping disparity array to boxa                *
  *----------------------------------------------------------------------*/
@@ -812,12 +1104,12 @@ FPIX       *fpixt1, *fpixt2;
         /* Destroy the existing arrays if they are too small */
     if (dew->fullvdispar) {
         fpixGetDimensions(dew->fullvdispar, &fw, &fh);
-        if (width > fw || height > fw)
+        if (width > fw || height > fh)
             fpixDestroy(&dew->fullvdispar);
     }
     if (dew->fullhdispar) {
         fpixGetDimensions(dew->fullhdispar, &fw, &fh);
-        if (width > fw || height > fw)
+        if (width > fw || height > fh)
             fpixDestroy(&dew->fullhdispar);
     }
 
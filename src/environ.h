@@ -185,6 +185,15 @@ typedef uintptr_t l_uintptr_t;
 #define  HAVE_FSTATAT     0
 #endif /* ! HAVE_CONFIG_H */
 
+/*-------------------------------------------------------------------------*
+ * mmap() is used to read spix files without copying the raster data.      *
+ * It is not available on Windows.  Without a configuration step, set      *
+ * the default value to 0; the file is then read into memory instead.      *
+ *-------------------------------------------------------------------------*/
+#if !defined(HAVE_CONFIG_H)
+#define  HAVE_MMAP        0
+#endif /* ! HAVE_CONFIG_H */
+
 /*--------------------------------------------------------------------*
  * It is desirable on Windows to have all temp files written to the same
  * subdirectory of the Windows <Temp> directory, because files under <Temp>
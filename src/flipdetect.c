@@ -44,8 +44,10 @@
  *          l_int32      pixMirrorDetect()
  *          l_int32      pixMirrorDetectDwa()
  *
- *      Static debug helper
- *          void         pixDebugFlipDetect()
+ *      Static helpers
+ *          static l_int32  pixHMTPair()
+ *          static l_int32  selHasSharedElement()
+ *          static void     pixDebugFlipDetect()
  *
  *  ===================================================================
  *
@@ -244,7 +246,10 @@ static const l_float32  DefaultMinUpDownRatio = 2.5;
 static const l_int32  DefaultMinMirrorFlipCount = 100;
 static const l_float32  DefaultMinMirrorFlipConf = 5.0;
 
-    /* Static debug function */
+    /* Static functions */
+static l_int32 pixHMTPair(PIX *pixs, SEL *sel1, SEL *sel2, PIX **ppix1,
+                          PIX **ppix2);
+static l_int32 selHasSharedElement(SEL *sel, SEL *selo, l_int32 i, l_int32 j);
 static void pixDebugFlipDetect(const char *filename, PIX *pixs,
                                PIX *pixhm, l_int32 enable);
 
@@ -656,8 +661,7 @@ SEL       *sel1, *sel2, *sel3, *sel4;
         /* Find the ascenders and optionally filter with pixm.
          * For an explanation of the procedure used for counting the result
          * of the HMT, see comments at the beginning of this function. */
-    pix1 = pixHMT(NULL, pix0, sel1);
-    pix2 = pixHMT(NULL, pix0, sel2);
+    pixHMTPair(pix0, sel1, sel2, &pix1, &pix2);
     pixOr(pix1, pix1, pix2);
     if (pixm)
         pixAnd(pix1, pix1, pixm);
@@ -669,8 +673,7 @@ SEL       *sel1, *sel2, *sel3, *sel4;
     pixDestroy(&pix3);
 
         /* Find the ascenders and optionally filter with pixm. */
-    pix1 = pixHMT(NULL, pix0, sel3);
-    pix2 = pixHMT(NULL, pix0, sel4);
+    pixHMTPair(pix0, sel3, sel4, &pix1, &pix2);
     pixOr(pix1, pix1, pix2);
     if (pixm)
         pixAnd(pix1, pix1, pixm);
@@ -1007,16 +1010,14 @@ SEL       *sel1, *sel2;
     pixOr(pix0, pix0, pixs);
     pixDestroy(&pix3);
 
-        /* Filter the right-facing characters. */
-    pix1 = pixHMT(NULL, pix0, sel1);
+        /* Filter the right-facing and left-facing characters. */
+    pixHMTPair(pix0, sel1, sel2, &pix1, &pix2);
     pix3 = pixReduceRankBinaryCascade(pix1, 1, 1, 0, 0);
     pixCountPixels(pix3, &count1, NULL);
     pixDebugFlipDetect("/tmp/lept/orient/right.png", pixs, pix1, debug);
     pixDestroy(&pix1);
     pixDestroy(&pix3);
 
-        /* Filter the left-facing characters. */
-    pix2 = pixHMT(NULL, pix0, sel2);
     pix3 = pixReduceRankBinaryCascade(pix2, 1, 1, 0, 0);
     pixCountPixels(pix3, &count2, NULL);
     pixDebugFlipDetect("/tmp/lept/orient/left.png", pixs, pix2, debug);
@@ -1134,8 +1135,140 @@ PIX       *pix0, *pix1, *pix2, *pix3;
 
 
 /*----------------------------------------------------------------*
- *                        Static debug helper                     *
+ *                          Static helpers                        *
  *----------------------------------------------------------------*/
+/*!
+ * \brief   pixHMTPair()
+ *
+ * \param[in]    pixs      1 bpp
+ * \param[in]    sel1      first hit-miss sel
+ * \param[in]    sel2      second hit-miss sel
+ * \param[out]   ppix1     hit-miss transform of pixs with sel1
+ * \param[out]   ppix2     hit-miss transform of pixs with sel2
+ * \return  0 if OK, 1 on error
+ *
+ * <pre>
+ * Notes:
+ *      (1) The pairs of text sels used here differ in only a few
+ *          elements, relative to their origins.  The elements shared
+ *          by both sels are applied once, and a copy of that result
+ *          is finished with the remaining elements of each sel.
+ *      (2) Each output is the same as that of pixHMT() with its sel,
+ *          including the clearing of pixels near the image edges.
+ * </pre>
+ */
+static l_int32
+pixHMTPair(PIX   *pixs,
+           SEL   *sel1,
+           SEL   *sel2,
+           PIX  **ppix1,
+           PIX  **ppix2)
+{
+l_int32  i, j, k, w, h, sx, sy, cx, cy, type;
+l_int32  xp, yp, xn, yn;
+PIX     *pixc, *pixd;
+SEL     *sel, *selo;
+
+    PROCNAME("pixHMTPair");
+
+    if (ppix1) *ppix1 = NULL;
+    if (ppix2) *ppix2 = NULL;
+    if (!ppix1 || !ppix2)
+        return ERROR_INT("&pix1 and &pix2 not both defined", procName, 1);
+    if (!pixs || pixGetDepth(pixs) != 1)
+        return ERROR_INT("pixs not defined or not 1 bpp", procName, 1);
+    if (!sel1 || !sel2)
+        return ERROR_INT("sel1 and sel2 not both defined", procName, 1);
+
+        /* Apply the elements shared by both sels */
+    pixGetDimensions(pixs, &w, &h, NULL);
+    pixc = pixCreateTemplate(pixs);
+    pixSetAll(pixc);
+    selGetParameters(sel1, &sy, &sx, &cy, &cx);
+    for (i = 0; i < sy; i++) {
+        for (j = 0; j < sx; j++) {
+            if (!selHasSharedElement(sel1, sel2, i, j))
+                continue;
+            if (sel1->data[i][j] == SEL_HIT)
+                pixRasterop(pixc, cx - j, cy - i, w, h, PIX_SRC & PIX_DST,
+                            pixs, 0, 0);
+            else
+                pixRasterop(pixc, cx - j, cy - i, w, h,
+                            PIX_NOT(PIX_SRC) & PIX_DST, pixs, 0, 0);
+        }
+    }
+
+        /* Finish each transform with the rest of its sel */
+    for (k = 0; k < 2; k++) {
+        sel = (k == 0) ? sel1 : sel2;
+        selo = (k == 0) ? sel2 : sel1;
+        pixd = (k == 0) ? pixCopy(NULL, pixc) : pixc;
+        selGetParameters(sel, &sy, &sx, &cy, &cx);
+        for (i = 0; i < sy; i++) {
+            for (j = 0; j < sx; j++) {
+                type = sel->data[i][j];
+                if (type == SEL_DONT_CARE)
+                    continue;
+                if (selHasSharedElement(sel, selo, i, j))
+                    continue;
+                if (type == SEL_HIT)
+                    pixRasterop(pixd, cx - j, cy - i, w, h, PIX_SRC & PIX_DST,
+                                pixs, 0, 0);
+                else
+                    pixRasterop(pixd, cx - j, cy - i, w, h,
+                                PIX_NOT(PIX_SRC) & PIX_DST, pixs, 0, 0);
+            }
+        }
+
+            /* Clear near edges, as in pixHMT() */
+        selFindMaxTranslations(sel, &xp, &yp, &xn, &yn);
+        if (xp > 0)
+            pixRasterop(pixd, 0, 0, xp, h, PIX_CLR, NULL, 0, 0);
+        if (xn > 0)
+            pixRasterop(pixd, w - xn, 0, xn, h, PIX_CLR, NULL, 0, 0);
+        if (yp > 0)
+            pixRasterop(pixd, 0, 0, w, yp, PIX_CLR, NULL, 0, 0);
+        if (yn > 0)
+            pixRasterop(pixd, 0, h - yn, w, yn, PIX_CLR, NULL, 0, 0);
+        if (k == 0)
+            *ppix1 = pixd;
+        else
+            *ppix2 = pixd;
+    }
+
+    return 0;
+}
+
+
+/*!
+ * \brief   selHasSharedElement()
+ *
+ * \param[in]    sel      hit-miss sel
+ * \param[in]    selo     other hit-miss sel
+ * \param[in]    i, j     row and column of an element of %sel
+ * \return  1 if the element is a hit or miss and %selo has the same
+ *              type of element at the same offset from its origin;
+ *              0 otherwise
+ */
+static l_int32
+selHasSharedElement(SEL     *sel,
+                    SEL     *selo,
+                    l_int32  i,
+                    l_int32  j)
+{
+l_int32  type, io, jo;
+
+    type = sel->data[i][j];
+    if (type != SEL_HIT && type != SEL_MISS)
+        return 0;
+    io = i - sel->cy + selo->cy;
+    jo = j - sel->cx + selo->cx;
+    if (io < 0 || io >= selo->sy || jo < 0 || jo >= selo->sx)
+        return 0;
+    return (selo->data[io][jo] == type);
+}
+
+
 /*
  * \brief   pixDebugFlipDetect()
  *
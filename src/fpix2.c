@@ -921,9 +921,11 @@ FPIX *
 fpixScaleByInteger(FPIX    *fpixs,
                    l_int32  factor)
 {
-l_int32     i, j, k, m, ws, hs, wd, hd, wpls, wpld;
-l_float32   val0, val1, val2, val3;
-l_float32  *datas, *datad, *lines, *lined, *fract;
+l_int32     i, j, k, m, x, ws, hs, wd, hd, wpls, wpld;
+l_float32   val0, val1, val2, val3, fk;
+l_float32  *datas, *datad, *lines, *lined, *fract, *prod1, *prod3;
+l_float64   wk;
+l_float64  *prod0, *prod2;
 FPIX       *fpixd;
 
     PROCNAME("fpixScaleByInteger");
@@ -942,6 +944,22 @@ FPIX       *fpixd;
     fract = (l_float32 *)LEPT_CALLOC(factor, sizeof(l_float32));
     for (i = 0; i < factor; i++)
         fract[i] = i / (l_float32)factor;
+
+        /* For each row of src blocks, the products of the four corner
+         * values with their horizontal weights are the same on every
+         * row of the block.  Make them once, and then make each dest
+         * row with the vertical weights.  The products are formed with
+         * the same precision and in the same order as in the bilinear
+         * expression
+         *     val0 * (1.0 - fract[m]) * (1.0 - fract[k]) +
+         *     val1 * fract[m] * (1.0 - fract[k]) +
+         *     val2 * (1.0 - fract[m]) * fract[k] +
+         *     val3 * fract[m] * fract[k]
+         * so the result is unchanged. */
+    prod0 = (l_float64 *)LEPT_CALLOC(wd, sizeof(l_float64));
+    prod1 = (l_float32 *)LEPT_CALLOC(wd, sizeof(l_float32));
+    prod2 = (l_float64 *)LEPT_CALLOC(wd, sizeof(l_float64));
+    prod3 = (l_float32 *)LEPT_CALLOC(wd, sizeof(l_float32));
     for (i = 0; i < hs - 1; i++) {
         lines = datas + i * wpls;
         for (j = 0; j < ws - 1; j++) {
@@ -949,18 +967,28 @@ FPIX       *fpixd;
             val1 = lines[j + 1];
             val2 = lines[wpls + j];
             val3 = lines[wpls + j + 1];
-            for (k = 0; k < factor; k++) {  /* rows of sub-block */
-                lined = datad + (i * factor + k) * wpld;
-                for (m = 0; m < factor; m++) {  /* cols of sub-block */
-                     lined[j * factor + m] =
-                            val0 * (1.0 - fract[m]) * (1.0 - fract[k]) +
-                            val1 * fract[m] * (1.0 - fract[k]) +
-                            val2 * (1.0 - fract[m]) * fract[k] +
-                            val3 * fract[m] * fract[k];
-                }
+            for (m = 0; m < factor; m++) {  /* cols of sub-block */
+                x = j * factor + m;
+                prod0[x] = val0 * (1.0 - fract[m]);
+                prod1[x] = val1 * fract[m];
+                prod2[x] = val2 * (1.0 - fract[m]);
+                prod3[x] = val3 * fract[m];
+            }
+        }
+        for (k = 0; k < factor; k++) {  /* rows of sub-block */
+            lined = datad + (i * factor + k) * wpld;
+            fk = fract[k];
+            wk = 1.0 - fk;
+            for (x = 0; x < wd - 1; x++) {
+                lined[x] = prod0[x] * wk + prod1[x] * wk +
+                           prod2[x] * fk + prod3[x] * fk;
             }
         }
     }
+    LEPT_FREE(prod0);
+    LEPT_FREE(prod1);
+    LEPT_FREE(prod2);
+    LEPT_FREE(prod3);
 
         /* Do the right-most column of fpixd, skipping LR corner */
     for (i = 0; i < hs - 1; i++) {
@@ -123,6 +123,7 @@
 #include <config_auto.h>
 #endif  /* HAVE_CONFIG_H */
 
+#include <string.h>
 #include "allheaders.h"
 
     /* Special static operations for 3x1, 1x3 and 3x3 structuring elements */
@@ -222,7 +223,7 @@ PIX       *pixb, *pixt, *pixd;
     wplb = pixGetWpl(pixb);
     wplt = pixGetWpl(pixt);
 
-    buffer = (l_uint8 *)LEPT_CALLOC(L_MAX(w, h), sizeof(l_uint8));
+    buffer = (l_uint8 *)LEPT_CALLOC(4 * wplb, sizeof(l_uint8));
     maxsize = L_MAX(hsize, vsize);
     minarray = (l_uint8 *)LEPT_CALLOC(2 * maxsize, sizeof(l_uint8));
     if (!buffer || !minarray) {
@@ -338,7 +339,7 @@ PIX       *pixb, *pixt, *pixd;
     wplb = pixGetWpl(pixb);
     wplt = pixGetWpl(pixt);
 
-    buffer = (l_uint8 *)LEPT_CALLOC(L_MAX(w, h), sizeof(l_uint8));
+    buffer = (l_uint8 *)LEPT_CALLOC(4 * wplb, sizeof(l_uint8));
     maxsize = L_MAX(hsize, vsize);
     maxarray = (l_uint8 *)LEPT_CALLOC(2 * maxsize, sizeof(l_uint8));
     if (!buffer || !maxarray) {
@@ -455,7 +456,7 @@ PIX       *pixb, *pixt, *pixd;
     wplb = pixGetWpl(pixb);
     wplt = pixGetWpl(pixt);
 
-    buffer = (l_uint8 *)LEPT_CALLOC(L_MAX(w, h), sizeof(l_uint8));
+    buffer = (l_uint8 *)LEPT_CALLOC(4 * wplb, sizeof(l_uint8));
     maxsize = L_MAX(hsize, vsize);
     array = (l_uint8 *)LEPT_CALLOC(2 * maxsize, sizeof(l_uint8));
     if (!buffer || !array) {
@@ -587,7 +588,7 @@ PIX       *pixb, *pixt, *pixd;
     wplb = pixGetWpl(pixb);
     wplt = pixGetWpl(pixt);
 
-    buffer = (l_uint8 *)LEPT_CALLOC(L_MAX(w, h), sizeof(l_uint8));
+    buffer = (l_uint8 *)LEPT_CALLOC(4 * wplb, sizeof(l_uint8));
     maxsize = L_MAX(hsize, vsize);
     array = (l_uint8 *)LEPT_CALLOC(2 * maxsize, sizeof(l_uint8));
     if (!buffer || !array) {
@@ -776,17 +777,18 @@ PIX       *pixd;
  * Notes:
  *      (1) Special case for vertical 1x3 brick Sel;
  *          also used as the second step for the 3x3 brick Sel.
- *      (2) Surprisingly, this is faster than setting up the
- *          lineptrs array and accessing into it; e.g.,
- *              val4 = GET_DATA_BYTE(lines8[i + 3], j);
+ *      (2) This works on full rows of bytes, because the byte order
+ *          within a word does not matter for a vertical operation.
+ *          The inner loop is simple enough to be vectorized.
  * </pre>
  */
 static PIX *
 pixErodeGray3v(PIX  *pixs)
 {
-l_uint32  *datas, *datad, *linesi, *linedi;
-l_int32    w, h, wpl, i, j;
-l_int32    val0, val1, val2, val3, val4, val5, val6, val7, val8, val9, minval;
+l_uint8   *bytes0, *bytes1, *bytes2, *byted;
+l_uint32  *datas, *datad;
+l_int32    h, wpl, nbytes, i, j;
+l_uint8    minval;
 PIX       *pixd;
 
     PROCNAME("pixErodeGray3v");
@@ -797,36 +799,19 @@ PIX       *pixd;
         return (PIX *)ERROR_PTR("pixs not 8 bpp", procName, NULL);
 
     pixd = pixCreateTemplate(pixs);
-    pixGetDimensions(pixs, &w, &h, NULL);
+    h = pixGetHeight(pixs);
     datas = pixGetData(pixs);
     datad = pixGetData(pixd);
     wpl = pixGetWpl(pixs);
-    for (j = 0; j < w; j++) {
-        for (i = 1; i < h - 8; i += 8) {
-            linesi = datas + i * wpl;
-            linedi = datad + i * wpl;
-            val0 = GET_DATA_BYTE(linesi - wpl, j);
-            val1 = GET_DATA_BYTE(linesi, j);
-            val2 = GET_DATA_BYTE(linesi + wpl, j);
-            val3 = GET_DATA_BYTE(linesi + 2 * wpl, j);
-            val4 = GET_DATA_BYTE(linesi + 3 * wpl, j);
-            val5 = GET_DATA_BYTE(linesi + 4 * wpl, j);
-            val6 = GET_DATA_BYTE(linesi + 5 * wpl, j);
-            val7 = GET_DATA_BYTE(linesi + 6 * wpl, j);
-            val8 = GET_DATA_BYTE(linesi + 7 * wpl, j);
-            val9 = GET_DATA_BYTE(linesi + 8 * wpl, j);
-            minval = L_MIN(val1, val2);
-            SET_DATA_BYTE(linedi, j, L_MIN(val0, minval));
-            SET_DATA_BYTE(linedi + wpl, j, L_MIN(minval, val3));
-            minval = L_MIN(val3, val4);
-            SET_DATA_BYTE(linedi + 2 * wpl, j, L_MIN(val2, minval));
-            SET_DATA_BYTE(linedi + 3 * wpl, j, L_MIN(minval, val5));
-            minval = L_MIN(val5, val6);
-            SET_DATA_BYTE(linedi + 4 * wpl, j, L_MIN(val4, minval));
-            SET_DATA_BYTE(linedi + 5 * wpl, j, L_MIN(minval, val7));
-            minval = L_MIN(val7, val8);
-            SET_DATA_BYTE(linedi + 6 * wpl, j, L_MIN(val6, minval));
-            SET_DATA_BYTE(linedi + 7 * wpl, j, L_MIN(minval, val9));
+    nbytes = 4 * wpl;
+    for (i = 1; i < h - 1; i++) {
+        bytes0 = (l_uint8 *)(datas + (i - 1) * wpl);
+        bytes1 = bytes0 + nbytes;
+        bytes2 = bytes1 + nbytes;
+        byted = (l_uint8 *)(datad + i * wpl);
+        for (j = 0; j < nbytes; j++) {
+            minval = L_MIN(bytes0[j], bytes1[j]);
+            byted[j] = L_MIN(minval, bytes2[j]);
         }
     }
     return pixd;
@@ -962,14 +947,16 @@ PIX       *pixd;
  * Notes:
  *      (1) Special case for vertical 1x3 brick Sel;
  *          also used as the second step for the 3x3 brick Sel.
+ *      (2) See notes in pixErodeGray3v().
  * </pre>
  */
 static PIX *
 pixDilateGray3v(PIX  *pixs)
 {
-l_uint32  *datas, *datad, *linesi, *linedi;
-l_int32    w, h, wpl, i, j;
-l_int32    val0, val1, val2, val3, val4, val5, val6, val7, val8, val9, maxval;
+l_uint8   *bytes0, *bytes1, *bytes2, *byted;
+l_uint32  *datas, *datad;
+l_int32    h, wpl, nbytes, i, j;
+l_uint8    maxval;
 PIX       *pixd;
 
     PROCNAME("pixDilateGray3v");
@@ -980,36 +967,19 @@ PIX       *pixd;
         return (PIX *)ERROR_PTR("pixs not 8 bpp", procName, NULL);
 
     pixd = pixCreateTemplate(pixs);
-    pixGetDimensions(pixs, &w, &h, NULL);
+    h = pixGetHeight(pixs);
     datas = pixGetData(pixs);
     datad = pixGetData(pixd);
     wpl = pixGetWpl(pixs);
-    for (j = 0; j < w; j++) {
-        for (i = 1; i < h - 8; i += 8) {
-            linesi = datas + i * wpl;
-            linedi = datad + i * wpl;
-            val0 = GET_DATA_BYTE(linesi - wpl, j);
-            val1 = GET_DATA_BYTE(linesi, j);
-            val2 = GET_DATA_BYTE(linesi + wpl, j);
-            val3 = GET_DATA_BYTE(linesi + 2 * wpl, j);
-            val4 = GET_DATA_BYTE(linesi + 3 * wpl, j);
-            val5 = GET_DATA_BYTE(linesi + 4 * wpl, j);
-            val6 = GET_DATA_BYTE(linesi + 5 * wpl, j);
-            val7 = GET_DATA_BYTE(linesi + 6 * wpl, j);
-            val8 = GET_DATA_BYTE(linesi + 7 * wpl, j);
-            val9 = GET_DATA_BYTE(linesi + 8 * wpl, j);
-            maxval = L_MAX(val1, val2);
-            SET_DATA_BYTE(linedi, j, L_MAX(val0, maxval));
-            SET_DATA_BYTE(linedi + wpl, j, L_MAX(maxval, val3));
-            maxval = L_MAX(val3, val4);
-            SET_DATA_BYTE(linedi + 2 * wpl, j, L_MAX(val2, maxval));
-            SET_DATA_BYTE(linedi + 3 * wpl, j, L_MAX(maxval, val5));
-            maxval = L_MAX(val5, val6);
-            SET_DATA_BYTE(linedi + 4 * wpl, j, L_MAX(val4, maxval));
-            SET_DATA_BYTE(linedi + 5 * wpl, j, L_MAX(maxval, val7));
-            maxval = L_MAX(val7, val8);
-            SET_DATA_BYTE(linedi + 6 * wpl, j, L_MAX(val6, maxval));
-            SET_DATA_BYTE(linedi + 7 * wpl, j, L_MAX(maxval, val9));
+    nbytes = 4 * wpl;
+    for (i = 1; i < h - 1; i++) {
+        bytes0 = (l_uint8 *)(datas + (i - 1) * wpl);
+        bytes1 = bytes0 + nbytes;
+        bytes2 = bytes1 + nbytes;
+        byted = (l_uint8 *)(datad + i * wpl);
+        for (j = 0; j < nbytes; j++) {
+            maxval = L_MAX(bytes0[j], bytes1[j]);
+            byted[j] = L_MAX(maxval, bytes2[j]);
         }
     }
     return pixd;
@@ -1163,7 +1133,8 @@ PIX  *pixt, *pixb, *pixbd, *pixd;
  * \param[in]    wpls        words/line of src
  * \param[in]    size        full length of SEL; restricted to odd numbers
  * \param[in]    direction   L_HORIZ or L_VERT
- * \param[in]    buffer      holds full line or column of src image pixels
+ * \param[in]    buffer      holds full line of src image pixels, or
+ *                           the forward partial results for a row
  * \param[in]    maxarray    array of dimension 2*size+1
  * \return  void
  *
@@ -1179,6 +1150,11 @@ PIX  *pixt, *pixb, *pixbd, *pixd;
  *            This allows full processing over the actual image; at
  *            the end the border is removed.
  *        (2) Uses algorithm of van Herk, Gil and Werman
+ *        (3) For the vertical operation, the partial maxima are computed
+ *            for a full row at a time, rather than for a column.  This
+ *            accesses the image data sequentially, and the inner loops
+ *            over the bytes in a row are simple enough to be vectorized
+ *            by the compiler.
  * </pre>
  */
 static void
@@ -1194,8 +1170,9 @@ dilateGrayLow(l_uint32  *datad,
               l_uint8   *maxarray)
 {
 l_int32    i, j, k;
-l_int32    hsize, nsteps, startmax, startx, starty;
+l_int32    hsize, nsteps, nbytes, startmax, startx, starty;
 l_uint8    maxval;
+l_uint8   *bytes, *byted, *bytep;
 l_uint32  *lines, *lined;
 
     if (direction == L_HORIZ) {
@@ -1231,35 +1208,37 @@ l_uint32  *lines, *lined;
             }
         }
     } else {  /* direction == L_VERT */
+            /* Process full rows of bytes.  The byte order within
+             * a word does not matter for a vertical operation. */
         hsize = size / 2;
         nsteps = (h - 2 * hsize) / size;
-        for (j = 0; j < w; j++) {
-                /* fill buffer with pixels in byte order */
-            for (i = 0; i < h; i++) {
-                lines = datas + i * wpls;
-                buffer[i] = GET_DATA_BYTE(lines, j);
+        nbytes = 4 * L_MIN(wpls, wpld);
+        for (i = 0; i < nsteps; i++) {
+            startmax = (i + 1) * size - 1;
+            starty = hsize + i * size;
+
+                /* the backward partial maxima go directly to dest */
+            bytes = (l_uint8 *)(datas + startmax * wpls);
+            byted = (l_uint8 *)(datad + (starty + size - 1) * wpld);
+            memcpy(byted, bytes, nbytes);
+            for (k = 1; k < size; k++) {
+                bytes = (l_uint8 *)(datas + (startmax - k) * wpls);
+                bytep = byted;
+                byted = (l_uint8 *)(datad + (starty + size - 1 - k) * wpld);
+                for (j = 0; j < nbytes; j++)
+                    byted[j] = L_MAX(bytep[j], bytes[j]);
             }
 
-            for (i = 0; i < nsteps; i++) {
-                    /* refill the minarray */
-                startmax = (i + 1) * size - 1;
-                maxarray[size - 1] = buffer[startmax];
-                for (k = 1; k < size; k++) {
-                    maxarray[size - 1 - k] =
-                        L_MAX(maxarray[size - k], buffer[startmax - k]);
-                    maxarray[size - 1 + k] =
-                        L_MAX(maxarray[size + k - 2], buffer[startmax + k]);
-                }
-
-                    /* compute dilation values */
-                starty = hsize + i * size;
-                lined = datad + starty * wpld;
-                SET_DATA_BYTE(lined, j, maxarray[0]);
-                SET_DATA_BYTE(lined + (size - 1) * wpld, j,
-                        maxarray[2 * size - 2]);
-                for (k = 1; k < size - 1; k++) {
-                    maxval = L_MAX(maxarray[k], maxarray[k + size - 1]);
-                    SET_DATA_BYTE(lined + wpld * k, j, maxval);
+                /* accumulate the forward partial maxima in buffer,
+                 * and combine with the backward ones for the
+                 * dilation values */
+            memcpy(buffer, datas + startmax * wpls, nbytes);
+            for (k = 1; k < size; k++) {
+                bytes = (l_uint8 *)(datas + (startmax + k) * wpls);
+                byted = (l_uint8 *)(datad + (starty + k) * wpld);
+                for (j = 0; j < nbytes; j++) {
+                    buffer[j] = L_MAX(buffer[j], bytes[j]);
+                    byted[j] = L_MAX(byted[j], buffer[j]);
                 }
             }
         }
@@ -1279,7 +1258,8 @@ l_uint32  *lines, *lined;
  * \param[in]    wpls        words/line of src
  * \param[in]    size        full length of SEL; restricted to odd numbers
  * \param[in]    direction   L_HORIZ or L_VERT
- * \param[in]    buffer      holds full line or column of src image pixels
+ * \param[in]    buffer      holds full line of src image pixels, or
+ *                           the forward partial results for a row
  * \param[in]    minarray    array of dimension 2*size+1
  * \return  void
  *
@@ -1301,8 +1281,9 @@ erodeGrayLow(l_uint32  *datad,
              l_uint8   *minarray)
 {
 l_int32    i, j, k;
-l_int32    hsize, nsteps, startmin, startx, starty;
+l_int32    hsize, nsteps, nbytes, startmin, startx, starty;
 l_uint8    minval;
+l_uint8   *bytes, *byted, *bytep;
 l_uint32  *lines, *lined;
 
     if (direction == L_HORIZ) {
@@ -1338,35 +1319,37 @@ l_uint32  *lines, *lined;
             }
         }
     } else {  /* direction == L_VERT */
+            /* Process full rows of bytes.  The byte order within
+             * a word does not matter for a vertical operation. */
         hsize = size / 2;
         nsteps = (h - 2 * hsize) / size;
-        for (j = 0; j < w; j++) {
-                /* fill buffer with pixels in byte order */
-            for (i = 0; i < h; i++) {
-                lines = datas + i * wpls;
-                buffer[i] = GET_DATA_BYTE(lines, j);
+        nbytes = 4 * L_MIN(wpls, wpld);
+        for (i = 0; i < nsteps; i++) {
+            startmin = (i + 1) * size - 1;
+            starty = hsize + i * size;
+
+                /* the backward partial minima go directly to dest */
+            bytes = (l_uint8 *)(datas + startmin * wpls);
+            byted = (l_uint8 *)(datad + (starty + size - 1) * wpld);
+            memcpy(byted, bytes, nbytes);
+            for (k = 1; k < size; k++) {
+                bytes = (l_uint8 *)(datas + (startmin - k) * wpls);
+                bytep = byted;
+                byted = (l_uint8 *)(datad + (starty + size - 1 - k) * wpld);
+                for (j = 0; j < nbytes; j++)
+                    byted[j] = L_MIN(bytep[j], bytes[j]);
             }
 
-            for (i = 0; i < nsteps; i++) {
-                    /* refill the minarray */
-                startmin = (i + 1) * size - 1;
-                minarray[size - 1] = buffer[startmin];
-                for (k = 1; k < size; k++) {
-                    minarray[size - 1 - k] =
-                        L_MIN(minarray[size - k], buffer[startmin - k]);
-                    minarray[size - 1 + k] =
-                        L_MIN(minarray[size + k - 2], buffer[startmin + k]);
-                }
-
-                    /* compute erosion values */
-                starty = hsize + i * size;
-                lined = datad + starty * wpld;
-                SET_DATA_BYTE(lined, j, minarray[0]);
-                SET_DATA_BYTE(lined + (size - 1) * wpld, j,
-                        minarray[2 * size - 2]);
-                for (k = 1; k < size - 1; k++) {
-                    minval = L_MIN(minarray[k], minarray[k + size - 1]);
-                    SET_DATA_BYTE(lined + wpld * k, j, minval);
+                /* accumulate the forward partial minima in buffer,
+                 * and combine with the backward ones for the
+                 * erosion values */
+            memcpy(buffer, datas + startmin * wpls, nbytes);
+            for (k = 1; k < size; k++) {
+                bytes = (l_uint8 *)(datas + (startmin + k) * wpls);
+                byted = (l_uint8 *)(datad + (starty + k) * wpld);
+                for (j = 0; j < nbytes; j++) {
+                    buffer[j] = L_MIN(buffer[j], bytes[j]);
+                    byted[j] = L_MIN(byted[j], buffer[j]);
                 }
             }
         }
@@ -141,6 +141,22 @@ enum {
 };
 
 
+/* --------------------------------------------------------------- *
+ *                     Row filters in png writer                   *
+ * --------------------------------------------------------------- */
+
+/*! Png Filters */
+enum {
+    L_PNG_FILTER_DEFAULT = 0,  /*!< libpng default; adaptive for >= 8 bps */
+    L_PNG_FILTER_NONE = 1,     /*!< no filtering; fastest                 */
+    L_PNG_FILTER_SUB = 2,      /*!< difference with pixel to the left     */
+    L_PNG_FILTER_UP = 3,       /*!< difference with pixel above           */
+    L_PNG_FILTER_AVG = 4,      /*!< difference with average of left, up   */
+    L_PNG_FILTER_PAETH = 5,    /*!< difference with Paeth predictor       */
+    L_PNG_FILTER_ALL = 6       /*!< adaptive choice of filter for each row */
+};
+
+
 /* --------------------------------------------------------------- *
  *                    Pdf formatted encoding types                 *
  * --------------------------------------------------------------- */
@@ -241,4 +257,80 @@ struct L_Pdf_Data
 typedef struct L_Pdf_Data  L_PDF_DATA;
 
 
+/* ------------------------------------------------------------------------- *
+ *                       Streaming multipage pdf output                      *
+ * ------------------------------------------------------------------------- */
+/*
+ *  This writes a multipage pdf to file one page at a time.  Only the
+ *  object locations and the page object numbers are kept; the Pages
+ *  object (object 3) and the xref trailer are written at the end.
+ */
+
+/*! Streaming pdf writer */
+struct L_Pdf_Writer
+{
+    FILE              *fp;           /*!< output file stream                  */
+    char              *title;        /*!< [optional] pdf title                */
+    size_t             nbytes;       /*!< number of bytes written so far      */
+    l_int32            npages;       /*!< number of pages written             */
+    l_int32            nobj;         /*!< next object number to be assigned   */
+    l_int32            error;        /*!< set if a write to the stream fails  */
+    struct L_Dna      *objloc;       /*!< location of each pdf object         */
+    struct Numa       *napage;       /*!< object number of each Page object   */
+};
+typedef struct L_Pdf_Writer  L_PDF_WRITER;
+
+
+/* ------------------------------------------------------------------------- *
+ *                         Multipage tiff page index                         *
+ * ------------------------------------------------------------------------- */
+/*
+ *  This holds the file offset of each image file directory (IFD) in
+ *  a multipage tiff file, so that any page can be located without
+ *  walking the chain of directories from the beginning of the file.
+ *  The size of the tiff file is stored to detect a stale index.
+ */
+
+#define  TIFF_INDEX_VERSION_NUMBER    1
+
+/*! Multipage tiff page index */
+struct L_Tiff_Index
+{
+    size_t             filesize;     /*!< size of the indexed tiff file       */
+    struct L_Dna      *offsets;      /*!< file offset of the IFD of each page */
+};
+typedef struct L_Tiff_Index  L_TIFFINDEX;
+
+/*
+ *  Readers and writers of tiff images in bands of rows, for images
+ *  too large to hold in memory.  They hold libtiff handles, so they
+ *  are opaque and defined in tiffio.c.
+ */
+typedef struct L_Tiff_Reader  L_TIFF_READER;
+typedef struct L_Tiff_Writer  L_TIFF_WRITER;
+
+
+/* ------------------------------------------------------------------------- *
+ *                      Reusable jpeg and png codec contexts                 *
+ * ------------------------------------------------------------------------- */
+/*
+ *  These keep codec state and output buffers between images, for
+ *  encoding and decoding many images in memory.  The jpeg contexts
+ *  hold libjpeg structs, so they are opaque and defined in jpegio.c.
+ *  Each context may be used by only one thread at a time.
+ */
+
+typedef struct L_Jpeg_Encoder  L_JPEG_ENCODER;
+typedef struct L_Jpeg_Decoder  L_JPEG_DECODER;
+
+/*! Reusable png encoder */
+struct L_Png_Encoder
+{
+    l_uint8           *data;         /*!< output buffer                       */
+    size_t             size;         /*!< allocated size of output buffer     */
+    size_t             nbytes;       /*!< bytes of png data in the buffer     */
+};
+typedef struct L_Png_Encoder  L_PNG_ENCODER;
+
+
 #endif  /* LEPTONICA_IMAGEIO_H */
@@ -44,16 +44,23 @@
  *         l_int32     jbAddPages()
  *         l_int32     jbAddPage()
  *         l_int32     jbAddPageComponents()
+ *         JBPAGE     *jbPageCreate()
+ *         void        jbPageDestroy()
+ *         l_int32     jbAddPreparedPage()
+ *         static JBPAGE  *jbPageCreateFromComponents()
+ *         static l_int32  jbClassifyPage()
  *
  *     Rank hausdorff classifier
  *
  *         l_int32     jbClassifyRankHaus()
+ *         static l_int32  jbClassifyRankHausPage()
  *         l_int32     pixHaustest()
  *         l_int32     pixRankHaustest()
  *
  *     Binary correlation classifier
  *
  *         l_int32     jbClassifyCorrelation()
+ *         static l_int32  jbClassifyCorrelationPage()
  *
  *     Determine the image components we start with
  *
@@ -87,6 +94,12 @@
  *         static l_int32    findSimilarSizedTemplatesNext()
  *         static void       findSimilarSizedTemplatesDestroy()
  *         static l_int32    finalPositioningForAlignment()
+ *         static void       jbGetProjections()
+ *         static void       jbAddTemplateProjections()
+ *         static l_int32    jbCorrelationMayMatch()
+ *         static l_int32    jbHausMayMatch()
+ *         static l_int32    projectionOverlap()
+ *         static l_int32    projectionExcess()
  *
  *     Note: this is NOT an implementation of the JPEG jbig2
  *     proposed standard encoder, the specifications for which
@@ -254,12 +267,34 @@ static JBCLASSER * jbCorrelationInitInternal(l_int32 components,
                        l_float32 weightfactor, l_int32 keep_components);
 
     /* Static helper functions */
+static JBPAGE *jbPageCreateFromComponents(l_int32 method, l_int32 size,
+                                          PIX *pixs, BOXA *boxa, PIXA *pixa);
+static l_int32 jbClassifyPage(JBCLASSER *classer, JBPAGE *page);
+static l_int32 jbClassifyRankHausPage(JBCLASSER *classer, JBPAGE *page);
+static l_int32 jbClassifyCorrelationPage(JBCLASSER *classer, JBPAGE *page);
 static JBFINDCTX * findSimilarSizedTemplatesInit(JBCLASSER *classer, PIX *pixs);
 static l_int32 findSimilarSizedTemplatesNext(JBFINDCTX *context);
 static void findSimilarSizedTemplatesDestroy(JBFINDCTX **pcontext);
 static l_int32 finalPositioningForAlignment(PIX *pixs, l_int32 x, l_int32 y,
                              l_int32 idelx, l_int32 idely, PIX *pixt,
                              l_int32 *sumtab, l_int32 *pdx, l_int32 *pdy);
+static void jbGetProjections(PIXA *pixa, l_int32 *tab8, NUMAA **pnaarow,
+                             NUMAA **pnaacol);
+static void jbAddTemplateProjections(JBCLASSER *classer, NUMA *narow,
+                                     NUMA *nacol, NUMA *narowd,
+                                     NUMA *nacold);
+static l_int32 jbCorrelationMayMatch(JBCLASSER *classer, l_int32 iclass,
+                             NUMA *narow, NUMA *nacol, l_int32 area1,
+                             l_int32 area2, l_float32 delx, l_float32 dely,
+                             l_float32 score_threshold);
+static l_int32 jbHausMayMatch(JBCLASSER *classer, l_int32 iclass,
+                              NUMA *narow1, NUMA *nacol1, NUMA *narow2,
+                              NUMA *nacol2, l_float32 delx, l_float32 dely,
+                              l_int32 thresh1, l_int32 thresh3);
+static l_int32 projectionOverlap(l_float32 *fa1, l_int32 n1, l_float32 *fa2,
+                                 l_int32 n2, l_int32 shift);
+static l_int32 projectionExcess(l_float32 *fa1, l_int32 n1, l_float32 *fa2,
+                                l_int32 n2, l_int32 shift);
 
 #ifndef NO_CONSOLE_IO
 #define  DEBUG_CORRELATION_SCORE   0
@@ -441,6 +476,8 @@ JBCLASSER  *classer;
  * Notes:
  *      (1) jbclasser makes a copy of the array of file names.
  *      (2) The caller is still responsible for destroying the input array.
+ *      (3) To prepare several pages at once, use jbPageCreate() and
+ *          jbAddPreparedPage() instead.
  * </pre>
  */
 l_ok
@@ -468,6 +505,7 @@ PIX     *pix;
         }
         if (pixGetDepth(pix) != 1) {
             L_WARNING("image file %d not 1 bpp\n", procName, i);
+            pixDestroy(&pix);
             continue;
         }
         jbAddPage(classer, pix);
@@ -489,8 +527,8 @@ l_ok
 jbAddPage(JBCLASSER  *classer,
           PIX        *pixs)
 {
-BOXA  *boxas;
-PIXA  *pixas;
+l_int32  ret;
+JBPAGE  *page;
 
     PROCNAME("jbAddPage");
 
@@ -499,19 +537,13 @@ PIXA  *pixas;
     if (!pixs || pixGetDepth(pixs) != 1)
         return ERROR_INT("pixs not defined or not 1 bpp", procName, 1);
 
-    classer->w = pixGetWidth(pixs);
-    classer->h = pixGetHeight(pixs);
-
         /* Get the appropriate components and their bounding boxes */
-    if (jbGetComponents(pixs, classer->components, classer->maxwidth,
-                        classer->maxheight, &boxas, &pixas)) {
+    if ((page = jbPageCreate(classer, pixs)) == NULL)
         return ERROR_INT("components not made", procName, 1);
-    }
 
-    jbAddPageComponents(classer, pixs, boxas, pixas);
-    boxaDestroy(&boxas);
-    pixaDestroy(&pixas);
-    return 0;
+    ret = jbAddPreparedPage(classer, page);
+    jbPageDestroy(&page);
+    return ret;
 }
 
 
@@ -536,7 +568,8 @@ jbAddPageComponents(JBCLASSER  *classer,
                     BOXA       *boxas,
                     PIXA       *pixas)
 {
-l_int32  n;
+l_int32  ret;
+JBPAGE  *page;
 
     PROCNAME("jbAddPageComponents");
 
@@ -545,9 +578,303 @@ l_int32  n;
     if (!pixs)
         return ERROR_INT("pix not defined", procName, 1);
 
+    if ((page = jbPageCreateFromComponents(classer->method,
+                      classer->sizehaus, pixs, boxas, pixas)) == NULL)
+        return ERROR_INT("page not made", procName, 1);
+    ret = jbClassifyPage(classer, page);
+    jbPageDestroy(&page);
+    return ret;
+}
+
+
+/*!
+ * \brief   jbPageCreate()
+ *
+ * \param[in]    jbclasser
+ * \param[in]    pixs      input page, 1 bpp
+ * \return  page, or NULL on error
+ *
+ * <pre>
+ * Notes:
+ *      (1) This finds the components of the page, and computes everything
+ *          needed to classify them that does not depend on the templates:
+ *          the bordered (and for rank hausdorff, dilated) components,
+ *          with their centroids, fg areas, and fg counts in each row
+ *          and column.
+ *      (2) Only the parameters of the classer are read, and the page
+ *          shares no data with the classer or with other pages.  So
+ *          pages can be prepared concurrently, for example by one
+ *          thread for each page.  They must then be classified with
+ *          jbAddPreparedPage(), one at a time and in page order.  The
+ *          result is then identical to that of jbAddPage() on each
+ *          page in turn.
+ * </pre>
+ */
+JBPAGE *
+jbPageCreate(JBCLASSER  *classer,
+             PIX        *pixs)
+{
+BOXA    *boxa;
+PIXA    *pixa;
+JBPAGE  *page;
+
+    PROCNAME("jbPageCreate");
+
+    if (!classer)
+        return (JBPAGE *)ERROR_PTR("classer not defined", procName, NULL);
+    if (!pixs || pixGetDepth(pixs) != 1)
+        return (JBPAGE *)ERROR_PTR("pixs not defined or not 1 bpp",
+                                   procName, NULL);
+
+    if (jbGetComponents(pixs, classer->components, classer->maxwidth,
+                        classer->maxheight, &boxa, &pixa))
+        return (JBPAGE *)ERROR_PTR("components not made", procName, NULL);
+
+    page = jbPageCreateFromComponents(classer->method, classer->sizehaus,
+                                      pixs, boxa, pixa);
+    boxaDestroy(&boxa);
+    pixaDestroy(&pixa);
+    return page;
+}
+
+
+/*!
+ * \brief   jbPageDestroy()
+ *
+ * \param[in,out]   ppage   will be set to null before returning
+ * \return  void
+ */
+void
+jbPageDestroy(JBPAGE  **ppage)
+{
+l_int32  i, n;
+JBPAGE  *page;
+
+    if (!ppage)
+        return;
+    if ((page = *ppage) == NULL)
+        return;
+
+    if (page->pixrowcts) {
+        n = pixaGetCount(page->pixa1);
+        for (i = 0; i < n; i++)
+            LEPT_FREE(page->pixrowcts[i]);
+        LEPT_FREE(page->pixrowcts);
+    }
+    pixDestroy(&page->pix);
+    boxaDestroy(&page->boxa);
+    pixaDestroy(&page->pixa);
+    pixaDestroy(&page->pixa1);
+    pixaDestroy(&page->pixa2);
+    ptaDestroy(&page->pta);
+    numaDestroy(&page->nafg);
+    numaaDestroy(&page->naarow1);
+    numaaDestroy(&page->naacol1);
+    numaaDestroy(&page->naarow2);
+    numaaDestroy(&page->naacol2);
+    LEPT_FREE(page);
+    *ppage = NULL;
+}
+
+
+/*!
+ * \brief   jbAddPreparedPage()
+ *
+ * \param[in]    jbclasser
+ * \param[in]    page      made by jbPageCreate() with the same classer
+ * \return  0 if OK; 1 on error
+ *
+ * <pre>
+ * Notes:
+ *      (1) This classifies the components of the page and adds them
+ *          to the classer.  Pages must be added in order.
+ *      (2) The page is not changed, and must still be destroyed by
+ *          the caller.
+ * </pre>
+ */
+l_ok
+jbAddPreparedPage(JBCLASSER  *classer,
+                  JBPAGE     *page)
+{
+    PROCNAME("jbAddPreparedPage");
+
+    if (!classer)
+        return ERROR_INT("classer not defined", procName, 1);
+    if (!page || !page->pix)
+        return ERROR_INT("page not defined", procName, 1);
+
+    classer->w = pixGetWidth(page->pix);
+    classer->h = pixGetHeight(page->pix);
+    return jbClassifyPage(classer, page);
+}
+
+
+/*!
+ * \brief   jbPageCreateFromComponents()
+ *
+ * \param[in]    method    JB_RANKHAUS, JB_CORRELATION
+ * \param[in]    size      of Sel for dilation; use 0 for correlation
+ * \param[in]    pixs      [optional] input page
+ * \param[in]    boxa      [optional] b.b. of components for this page
+ * \param[in]    pixa      [optional] components for this page
+ * \return  page, or NULL on error
+ *
+ * <pre>
+ * Notes:
+ *      (1) The input page and components are cloned.  If there are no
+ *          components, nothing else is computed.
+ *      (2) For correlation, the fg count below each row of each
+ *          bordered component is also saved; this allows
+ *          pixCorrelationScoreThresholded() to abort early if a match
+ *          is impossible.
+ * </pre>
+ */
+static JBPAGE *
+jbPageCreateFromComponents(l_int32  method,
+                           l_int32  size,
+                           PIX     *pixs,
+                           BOXA    *boxa,
+                           PIXA    *pixa)
+{
+l_int32     n, i, x, y, wpl, rowcount, downcount;
+l_int32    *sumtab, *centtab;
+l_uint32   *row, word;
+l_uint8     byte;
+l_float32   xsum, ysum;
+PIX        *pix, *pix1, *pix2;
+SEL        *sel;
+JBPAGE     *page;
+
+    PROCNAME("jbPageCreateFromComponents");
+
+    page = (JBPAGE *)LEPT_CALLOC(1, sizeof(JBPAGE));
+    if (pixs)
+        page->pix = pixClone(pixs);
+    if (boxa)
+        page->boxa = boxaCopy(boxa, L_CLONE);
+    if (pixa)
+        page->pixa = pixaCopy(pixa, L_CLONE);
+    if (!boxa || !pixa || (n = pixaGetCount(pixa)) <= 0)
+        return page;
+
+        /* Generate the bordered pixa, which contains all the
+         * input components.  */
+    page->pixa1 = pixaCreate(n);
+    for (i = 0; i < n; i++) {
+        pix = pixaGetPix(pixa, i, L_CLONE);
+        pix1 = pixAddBorderGeneral(pix, JB_ADDED_PIXELS, JB_ADDED_PIXELS,
+                    JB_ADDED_PIXELS, JB_ADDED_PIXELS, 0);
+        pixaAddPix(page->pixa1, pix1, L_INSERT);
+        pixDestroy(&pix);
+    }
+    sumtab = makePixelSumTab8();
+
+    if (method == JB_RANKHAUS) {
+            /* Dilate the bordered components, and get the centroids
+             * of the bordered components, relative to the UL corner
+             * of each pix.  */
+        sel = selCreateBrick(size, size, size / 2, size / 2, SEL_HIT);
+        page->pixa2 = pixaCreate(n);
+        for (i = 0; i < n; i++) {
+            pix1 = pixaGetPix(page->pixa1, i, L_CLONE);
+            pix2 = pixDilate(NULL, pix1, sel);
+            pixaAddPix(page->pixa2, pix2, L_INSERT);
+            pixDestroy(&pix1);
+        }
+        selDestroy(&sel);
+        page->pta = pixaCentroids(page->pixa1);
+        if ((page->nafg = pixaCountPixels(pixa)) == NULL) {
+            LEPT_FREE(sumtab);
+            jbPageDestroy(&page);
+            return (JBPAGE *)ERROR_PTR("fg counting failed", procName, NULL);
+        }
+        jbGetProjections(page->pixa1, sumtab, &page->naarow1,
+                         &page->naacol1);
+        jbGetProjections(page->pixa2, sumtab, &page->naarow2,
+                         &page->naacol2);
+        LEPT_FREE(sumtab);
+        return page;
+    }
+
+        /* Count the "1" pixels in each row of the pix in pixa1.
+         * This loop merges three calculations: the total number
+         * of "1" pixels, the number of "1" pixels in each row, and
+         * the centroid.  The centroids are relative to the UL corner of
+         * each (bordered) pix.  The pixrowcts[i][y] are the total number
+         * of fg pixels in pixa[i] below row y. */
+    centtab = makePixelCentroidTab8();
+    page->pta = ptaCreate(n);
+    page->nafg = numaCreate(n);
+    page->pixrowcts = (l_int32 **)LEPT_CALLOC(n, sizeof(l_int32 *));
+    for (i = 0; i < n; i++) {
+        pix = pixaGetPix(page->pixa1, i, L_CLONE);
+        page->pixrowcts[i] = (l_int32 *)LEPT_CALLOC(pixGetHeight(pix),
+                                                    sizeof(l_int32));
+        xsum = 0;
+        ysum = 0;
+        wpl = pixGetWpl(pix);
+        row = pixGetData(pix) + (pixGetHeight(pix) - 1) * wpl;
+        downcount = 0;
+        for (y = pixGetHeight(pix) - 1; y >= 0; y--, row -= wpl) {
+            page->pixrowcts[i][y] = downcount;
+            rowcount = 0;
+            for (x = 0; x < wpl; x++) {
+                word = row[x];
+                byte = word & 0xff;
+                rowcount += sumtab[byte];
+                xsum += centtab[byte] + (x * 32 + 24) * sumtab[byte];
+                byte = (word >> 8) & 0xff;
+                rowcount += sumtab[byte];
+                xsum += centtab[byte] + (x * 32 + 16) * sumtab[byte];
+                byte = (word >> 16) & 0xff;
+                rowcount += sumtab[byte];
+                xsum += centtab[byte] + (x * 32 + 8) * sumtab[byte];
+                byte = (word >> 24) & 0xff;
+                rowcount += sumtab[byte];
+                xsum += centtab[byte] + x * 32 * sumtab[byte];
+            }
+            downcount += rowcount;
+            ysum += rowcount * y;
+        }
+        numaAddNumber(page->nafg, downcount);
+        if (downcount > 0) {
+            ptaAddPt(page->pta,
+                 xsum / (l_float32)downcount, ysum / (l_float32)downcount);
+        } else {  /* no pixels; shouldn't happen */
+            L_ERROR("downcount == 0 !\n", procName);
+            ptaAddPt(page->pta, pixGetWidth(pix) / 2, pixGetHeight(pix) / 2);
+        }
+        pixDestroy(&pix);
+    }
+
+        /* Get the row and column fg counts of the pix in pixa1.  These
+         * are saved with each template, and are used to reject templates
+         * cheaply, without computing the correlation score. */
+    jbGetProjections(page->pixa1, sumtab, &page->naarow1, &page->naacol1);
+    LEPT_FREE(centtab);
+    LEPT_FREE(sumtab);
+    return page;
+}
+
+
+/*!
+ * \brief   jbClassifyPage()
+ *
+ * \param[in]    jbclasser
+ * \param[in]    page      input page, with its components
+ * \return  0 if OK; 1 on error
+ */
+static l_int32
+jbClassifyPage(JBCLASSER  *classer,
+               JBPAGE     *page)
+{
+l_int32  n;
+
+    PROCNAME("jbClassifyPage");
+
         /* Test for no components on the current page.  Always update the
          * number of pages processed, even if nothing is on it. */
-    if (!boxas || !pixas || (boxaGetCount(boxas) == 0)) {
+    if (!page->boxa || !page->pixa || (boxaGetCount(page->boxa) == 0)) {
         classer->npages++;
         return 0;
     }
@@ -556,10 +883,10 @@ l_int32  n;
          * structuring element and specified rank.  For correlation,
          * it uses a specified threshold. */
     if (classer->method == JB_RANKHAUS) {
-        if (jbClassifyRankHaus(classer, boxas, pixas))
+        if (jbClassifyRankHausPage(classer, page))
             return ERROR_INT("rankhaus classification failed", procName, 1);
     } else {  /* classer->method == JB_CORRELATION */
-        if (jbClassifyCorrelation(classer, boxas, pixas))
+        if (jbClassifyCorrelationPage(classer, page))
             return ERROR_INT("correlation classification failed", procName, 1);
     }
 
@@ -567,11 +894,11 @@ l_int32  n;
          * that the class template and instance will have their
          * centroids in the same place.  Then the template can be
          * used to replace the instance. */
-    if (jbGetULCorners(classer, pixs, boxas))
+    if (jbGetULCorners(classer, page->pix, page->boxa))
         return ERROR_INT("UL corners not found", procName, 1);
 
         /* Update total component counts and number of pages processed. */
-    n = boxaGetCount(boxas);
+    n = boxaGetCount(page->boxa);
     classer->baseindex += n;
     numaAddNumber(classer->nacomps, n);
     classer->npages++;
@@ -595,59 +922,87 @@ jbClassifyRankHaus(JBCLASSER  *classer,
                    BOXA       *boxa,
                    PIXA       *pixas)
 {
-l_int32     n, nt, i, wt, ht, iclass, size, found, testval;
-l_int32     npages, area1, area3;
+l_int32  ret;
+JBPAGE  *page;
+
+    PROCNAME("jbClassifyRankHaus");
+
+    if (!classer)
+        return ERROR_INT("classer not defined", procName, 1);
+    if (!boxa)
+        return ERROR_INT("boxa not defined", procName, 1);
+    if (!pixas)
+        return ERROR_INT("pixas not defined", procName, 1);
+    if (pixaGetCount(pixas) == 0)
+        return ERROR_INT("pixas is empty", procName, 1);
+
+    if ((page = jbPageCreateFromComponents(JB_RANKHAUS, classer->sizehaus,
+                                           NULL, boxa, pixas)) == NULL)
+        return ERROR_INT("page not made", procName, 1);
+    ret = jbClassifyRankHausPage(classer, page);
+    jbPageDestroy(&page);
+    return ret;
+}
+
+
+/*!
+ * \brief   jbClassifyRankHausPage()
+ *
+ * \param[in]    jbclasser
+ * \param[in]    page      components, prepared for rank hausdorff
+ * \return  0 if OK; 1 on error
+ */
+static l_int32
+jbClassifyRankHausPage(JBCLASSER  *classer,
+                       JBPAGE     *page)
+{
+l_int32     n, nt, i, wt, ht, iclass, found, testval;
+l_int32     npages, area1, area3, thresh1, thresh3;
 l_int32    *tab8;
 l_float32   rank, x1, y1, x2, y2;
 BOX        *box;
+BOXA       *boxa;
 NUMA       *naclass, *napage;
 NUMA       *nafg;   /* fg area of all instances */
 NUMA       *nafgt;  /* fg area of all templates */
 JBFINDCTX  *findcontext;
 L_DNAHASH  *dahash;
+NUMA       *narow1, *nacol1, *narow2, *nacol2;
+NUMAA      *naarow1, *naacol1;  /* fg counts by row and column; un-dilated */
+NUMAA      *naarow2, *naacol2;  /* fg counts by row and column; dilated */
 PIX        *pix, *pix1, *pix2, *pix3, *pix4;
-PIXA       *pixa, *pixa1, *pixa2, *pixat, *pixatd;
+PIXA       *pixa, *pixas, *pixa1, *pixa2, *pixat, *pixatd;
 PIXAA      *pixaa;
 PTA        *pta, *ptac, *ptact;
-SEL        *sel;
 
-    PROCNAME("jbClassifyRankHaus");
+    PROCNAME("jbClassifyRankHausPage");
 
-    if (!classer)
-        return ERROR_INT("classer not defined", procName, 1);
-    if (!boxa)
-        return ERROR_INT("boxa not defined", procName, 1);
-    if (!pixas)
-        return ERROR_INT("pixas not defined", procName, 1);
-    if ((n = pixaGetCount(pixas)) == 0)
-        return ERROR_INT("pixas is empty", procName, 1);
-    if ((nafg = pixaCountPixels(pixas)) == NULL)  /* areas for this page */
-        return ERROR_INT("fg counting failed", procName, 1);
+    if (!page->pixa1 || !page->pixa2)
+        return ERROR_INT("page not prepared for rankhaus", procName, 1);
 
     npages = classer->npages;
-    size = classer->sizehaus;
-    sel = selCreateBrick(size, size, size / 2, size / 2, SEL_HIT);
-
-        /* Generate the bordered pixa, with and without dilation.
-         * pixa1 and pixa2 contain all the input components. */
-    pixa1 = pixaCreate(n);
-    pixa2 = pixaCreate(n);
-    for (i = 0; i < n; i++) {
-        pix = pixaGetPix(pixas, i, L_CLONE);
-        pix1 = pixAddBorderGeneral(pix, JB_ADDED_PIXELS, JB_ADDED_PIXELS,
-                    JB_ADDED_PIXELS, JB_ADDED_PIXELS, 0);
-        pix2 = pixDilate(NULL, pix1, sel);
-        pixaAddPix(pixa1, pix1, L_INSERT);   /* un-dilated */
-        pixaAddPix(pixa2, pix2, L_INSERT);   /* dilated */
-        pixDestroy(&pix);
-    }
-
-        /* Get the centroids of all the bordered images.
-         * These are relative to the UL corner of each (bordered) pix.  */
-    pta = pixaCentroids(pixa1);  /* centroids for this page; use here */
+    boxa = page->boxa;
+    pixas = page->pixa;
+    n = pixaGetCount(pixas);
+
+        /* The bordered pixa, with and without dilation, contain all
+         * the input components.  They were made with the page, along
+         * with the fg areas, the centroids (relative to the UL corner
+         * of each bordered pix), and the row and column fg counts.
+         * The counts are saved with each template, and are used to
+         * reject templates cheaply, without doing the Hausdorff test. */
+    pixa1 = page->pixa1;
+    pixa2 = page->pixa2;
+    nafg = page->nafg;  /* areas for this page */
+    pta = page->pta;  /* centroids for this page; use here */
+    naarow1 = page->naarow1;
+    naacol1 = page->naacol1;
+    naarow2 = page->naarow2;
+    naacol2 = page->naacol2;
     ptac = classer->ptac;  /* holds centroids of components up to this page */
     ptaJoin(ptac, pta, 0, -1);  /* save centroids of all components */
     ptact = classer->ptact;  /* holds centroids of templates */
+    tab8 = makePixelSumTab8();
 
         /* Use these to save the class and page of each component. */
     naclass = classer->naclass;
@@ -697,14 +1052,22 @@ SEL        *sel;
             pix1 = pixaGetPix(pixa1, i, L_CLONE);
             pix2 = pixaGetPix(pixa2, i, L_CLONE);
             ptaGetPt(pta, i, &x1, &y1);
+            narow1 = numaaGetNuma(naarow1, i, L_CLONE);
+            nacol1 = numaaGetNuma(naacol1, i, L_CLONE);
+            narow2 = numaaGetNuma(naarow2, i, L_CLONE);
+            nacol2 = numaaGetNuma(naacol2, i, L_CLONE);
             nt = pixaGetCount(pixat);  /* number of templates */
             found = FALSE;
             findcontext = findSimilarSizedTemplatesInit(classer, pix1);
             while ((iclass = findSimilarSizedTemplatesNext(findcontext)) > -1) {
+                ptaGetPt(ptact, iclass, &x2, &y2);
+                if (!jbHausMayMatch(classer, iclass, narow1, nacol1, narow2,
+                                    nacol2, x1 - x2, y1 - y2, 0, 0))
+                    continue;
+
                     /* Find score for this template */
                 pix3 = pixaGetPix(pixat, iclass, L_CLONE);
                 pix4 = pixaGetPix(pixatd, iclass, L_CLONE);
-                ptaGetPt(ptact, iclass, &x2, &y2);
                 testval = pixHaustest(pix1, pix2, pix3, pix4, x1 - x2, y1 - y2,
                                       MAX_DIFF_WIDTH, MAX_DIFF_HEIGHT);
                 pixDestroy(&pix3);
@@ -734,34 +1097,51 @@ SEL        *sel;
                 wt = pixGetWidth(pix);
                 ht = pixGetHeight(pix);
                 l_dnaHashAdd(dahash, (l_uint64)ht * wt, nt);
+                ptaAddPt(classer->ptadimt, wt, ht);
                 box = boxaGetBox(boxa, i, L_CLONE);
                 pixaAddBox(pixa, box, L_INSERT);
                 pixaaAddPixa(pixaa, pixa, L_INSERT);  /* unbordered instance */
                 ptaAddPt(ptact, x1, y1);
                 pixaAddPix(pixat, pix1, L_INSERT);  /* bordered template */
                 pixaAddPix(pixatd, pix2, L_INSERT);  /* bordered dil template */
+                jbAddTemplateProjections(classer, narow1, nacol1,
+                                         narow2, nacol2);
             } else {  /* don't save them */
                 pixDestroy(&pix1);
                 pixDestroy(&pix2);
             }
+            numaDestroy(&narow1);
+            numaDestroy(&nacol1);
+            numaDestroy(&narow2);
+            numaDestroy(&nacol2);
         }
     } else {  /* rank < 1.0 */
         nafgt = classer->nafgt;
-        tab8 = makePixelSumTab8();
         for (i = 0; i < n; i++) {   /* all instances on this page */
             pix1 = pixaGetPix(pixa1, i, L_CLONE);
             numaGetIValue(nafg, i, &area1);
             pix2 = pixaGetPix(pixa2, i, L_CLONE);
             ptaGetPt(pta, i, &x1, &y1);   /* use pta for this page */
+            narow1 = numaaGetNuma(naarow1, i, L_CLONE);
+            nacol1 = numaaGetNuma(naacol1, i, L_CLONE);
+            narow2 = numaaGetNuma(naarow2, i, L_CLONE);
+            nacol2 = numaaGetNuma(naacol2, i, L_CLONE);
+            thresh1 = (l_int32)(area1 * (1. - rank) + 0.5);
             nt = pixaGetCount(pixat);  /* number of templates */
             found = FALSE;
             findcontext = findSimilarSizedTemplatesInit(classer, pix1);
             while ((iclass = findSimilarSizedTemplatesNext(findcontext)) > -1) {
+                numaGetIValue(nafgt, iclass, &area3);
+                ptaGetPt(ptact, iclass, &x2, &y2);
+                thresh3 = (l_int32)(area3 * (1. - rank) + 0.5);
+                if (!jbHausMayMatch(classer, iclass, narow1, nacol1, narow2,
+                                    nacol2, x1 - x2, y1 - y2,
+                                    thresh1, thresh3))
+                    continue;
+
                     /* Find score for this template */
                 pix3 = pixaGetPix(pixat, iclass, L_CLONE);
-                numaGetIValue(nafgt, iclass, &area3);
                 pix4 = pixaGetPix(pixatd, iclass, L_CLONE);
-                ptaGetPt(ptact, iclass, &x2, &y2);
                 testval = pixRankHaustest(pix1, pix2, pix3, pix4,
                                           x1 - x2, y1 - y2,
                                           MAX_DIFF_WIDTH, MAX_DIFF_HEIGHT,
@@ -793,6 +1173,7 @@ SEL        *sel;
                 wt = pixGetWidth(pix);
                 ht = pixGetHeight(pix);
                 l_dnaHashAdd(dahash, (l_uint64)ht * wt, nt);
+                ptaAddPt(classer->ptadimt, wt, ht);
                 box = boxaGetBox(boxa, i, L_CLONE);
                 pixaAddBox(pixa, box, L_INSERT);
                 pixaaAddPixa(pixaa, pixa, L_INSERT);  /* unbordered instance */
@@ -800,20 +1181,21 @@ SEL        *sel;
                 pixaAddPix(pixat, pix1, L_INSERT);  /* bordered template */
                 pixaAddPix(pixatd, pix2, L_INSERT);  /* ditto */
                 numaAddNumber(nafgt, area1);
+                jbAddTemplateProjections(classer, narow1, nacol1,
+                                         narow2, nacol2);
             } else {  /* don't save them */
                 pixDestroy(&pix1);
                 pixDestroy(&pix2);
             }
+            numaDestroy(&narow1);
+            numaDestroy(&nacol1);
+            numaDestroy(&narow2);
+            numaDestroy(&nacol2);
         }
-        LEPT_FREE(tab8);
     }
     classer->nclass = pixaGetCount(pixat);
 
-    numaDestroy(&nafg);
-    ptaDestroy(&pta);
-    pixaDestroy(&pixa1);
-    pixaDestroy(&pixa2);
-    selDestroy(&sel);
+    LEPT_FREE(tab8);
     return 0;
 }
 
@@ -1035,114 +1417,90 @@ jbClassifyCorrelation(JBCLASSER  *classer,
                       BOXA       *boxa,
                       PIXA       *pixas)
 {
+l_int32  ret;
+JBPAGE  *page;
+
+    PROCNAME("jbClassifyCorrelation");
+
+    if (!classer)
+        return ERROR_INT("classer not found", procName, 1);
+    if (!boxa)
+        return ERROR_INT("boxa not found", procName, 1);
+    if (!pixas)
+        return ERROR_INT("pixas not found", procName, 1);
+    if (pixaGetCount(pixas) == 0) {
+        L_WARNING("pixas is empty\n", procName);
+        return 0;
+    }
+
+    if ((page = jbPageCreateFromComponents(JB_CORRELATION, 0, NULL,
+                                           boxa, pixas)) == NULL)
+        return ERROR_INT("page not made", procName, 1);
+    ret = jbClassifyCorrelationPage(classer, page);
+    jbPageDestroy(&page);
+    return ret;
+}
+
+
+/*!
+ * \brief   jbClassifyCorrelationPage()
+ *
+ * \param[in]    jbclasser
+ * \param[in]    page      components, prepared for correlation
+ * \return  0 if OK; 1 on error
+ */
+static l_int32
+jbClassifyCorrelationPage(JBCLASSER  *classer,
+                          JBPAGE     *page)
+{
 l_int32     n, nt, i, iclass, wt, ht, found, area, area1, area2, npages,
             overthreshold;
-l_int32    *sumtab, *centtab;
-l_uint32   *row, word;
-l_float32   x1, y1, x2, y2, xsum, ysum;
+l_int32    *sumtab;
+l_float32   x1, y1, x2, y2;
 l_float32   thresh, weight, threshold;
 BOX        *box;
+BOXA       *boxa;
 NUMA       *naclass, *napage;
+NUMA       *nafg;    /* fg area of all instances */
 NUMA       *nafgt;   /* fg area of all templates */
 NUMA       *naarea;   /* w * h area of all templates */
 JBFINDCTX  *findcontext;
 L_DNAHASH  *dahash;
 PIX        *pix, *pix1, *pix2;
-PIXA       *pixa, *pixa1, *pixat;
+PIXA       *pixa, *pixas, *pixa1, *pixat;
 PIXAA      *pixaa;
 PTA        *pta, *ptac, *ptact;
-l_int32    *pixcts;  /* pixel counts of each pixa */
 l_int32   **pixrowcts;  /* row-by-row pixel counts of each pixa */
-l_int32     x, y, rowcount, downcount, wpl;
-l_uint8     byte;
+NUMA       *narow, *nacol;
+NUMAA      *naarow, *naacol;  /* fg counts by row and column of each pix */
 
-    PROCNAME("jbClassifyCorrelation");
+    PROCNAME("jbClassifyCorrelationPage");
 
-    if (!classer)
-        return ERROR_INT("classer not found", procName, 1);
-    if (!boxa)
-        return ERROR_INT("boxa not found", procName, 1);
-    if (!pixas)
-        return ERROR_INT("pixas not found", procName, 1);
+    if (!page->pixa1 || !page->pixrowcts)
+        return ERROR_INT("page not prepared for correlation", procName, 1);
 
     npages = classer->npages;
-
-        /* Generate the bordered pixa, which contains all the the
-         * input components.  This will not be saved.   */
-    if ((n = pixaGetCount(pixas)) == 0) {
-        L_WARNING("pixas is empty\n", procName);
-        return 0;
-    }
-    pixa1 = pixaCreate(n);
-    for (i = 0; i < n; i++) {
-        pix = pixaGetPix(pixas, i, L_CLONE);
-        pix1 = pixAddBorderGeneral(pix, JB_ADDED_PIXELS, JB_ADDED_PIXELS,
-                    JB_ADDED_PIXELS, JB_ADDED_PIXELS, 0);
-        pixaAddPix(pixa1, pix1, L_INSERT);
-        pixDestroy(&pix);
-    }
+    boxa = page->boxa;
+    pixas = page->pixa;
+    n = pixaGetCount(pixas);
+
+        /* The bordered pixa contains all the input components.  It was
+         * made with the page, along with the fg areas, the centroids
+         * (relative to the UL corner of each bordered pix), the fg
+         * counts below each row, and the row and column fg counts.  */
+    pixa1 = page->pixa1;
+    nafg = page->nafg;
+    pta = page->pta;
+    pixrowcts = page->pixrowcts;
+    naarow = page->naarow1;
+    naacol = page->naacol1;
 
         /* Use these to save the class and page of each component. */
     naclass = classer->naclass;
     napage = classer->napage;
-
-        /* Get the number of fg pixels in each component.  */
     nafgt = classer->nafgt;    /* holds fg areas of the templates */
     sumtab = makePixelSumTab8();
 
-    pixcts = (l_int32 *)LEPT_CALLOC(n, sizeof(*pixcts));
-    pixrowcts = (l_int32 **)LEPT_CALLOC(n, sizeof(*pixrowcts));
-    centtab = makePixelCentroidTab8();
-
-        /* Count the "1" pixels in each row of the pix in pixa1; this
-         * allows pixCorrelationScoreThresholded to abort early if a match
-         * is impossible.  This loop merges three calculations: the total
-         * number of "1" pixels, the number of "1" pixels in each row, and
-         * the centroid.  The centroids are relative to the UL corner of
-         * each (bordered) pix.  The pixrowcts[i][y] are the total number
-         * of fg pixels in pixa[i] below row y. */
-    pta = ptaCreate(n);
-    for (i = 0; i < n; i++) {
-        pix = pixaGetPix(pixa1, i, L_CLONE);
-        pixrowcts[i] = (l_int32 *)LEPT_CALLOC(pixGetHeight(pix),
-                                         sizeof(**pixrowcts));
-        xsum = 0;
-        ysum = 0;
-        wpl = pixGetWpl(pix);
-        row = pixGetData(pix) + (pixGetHeight(pix) - 1) * wpl;
-        downcount = 0;
-        for (y = pixGetHeight(pix) - 1; y >= 0; y--, row -= wpl) {
-            pixrowcts[i][y] = downcount;
-            rowcount = 0;
-            for (x = 0; x < wpl; x++) {
-                word = row[x];
-                byte = word & 0xff;
-                rowcount += sumtab[byte];
-                xsum += centtab[byte] + (x * 32 + 24) * sumtab[byte];
-                byte = (word >> 8) & 0xff;
-                rowcount += sumtab[byte];
-                xsum += centtab[byte] + (x * 32 + 16) * sumtab[byte];
-                byte = (word >> 16) & 0xff;
-                rowcount += sumtab[byte];
-                xsum += centtab[byte] + (x * 32 + 8) * sumtab[byte];
-                byte = (word >> 24) & 0xff;
-                rowcount += sumtab[byte];
-                xsum += centtab[byte] + x * 32 * sumtab[byte];
-            }
-            downcount += rowcount;
-            ysum += rowcount * y;
-        }
-        pixcts[i] = downcount;
-        if (downcount > 0) {
-            ptaAddPt(pta,
-                 xsum / (l_float32)downcount, ysum / (l_float32)downcount);
-        } else {  /* no pixels; shouldn't happen */
-            L_ERROR("downcount == 0 !\n", procName);
-            ptaAddPt(pta, pixGetWidth(pix) / 2, pixGetHeight(pix) / 2);
-        }
-        pixDestroy(&pix);
-    }
-
     ptac = classer->ptac;  /* holds centroids of components up to this page */
     ptaJoin(ptac, pta, 0, -1);  /* save centroids of all components */
     ptact = classer->ptact;  /* holds centroids of templates */
@@ -1187,14 +1545,14 @@ l_uint8     byte;
     dahash = classer->dahash;
     for (i = 0; i < n; i++) {
         pix1 = pixaGetPix(pixa1, i, L_CLONE);
-        area1 = pixcts[i];
+        numaGetIValue(nafg, i, &area1);
         ptaGetPt(pta, i, &x1, &y1);  /* centroid for this instance */
+        narow = numaaGetNuma(naarow, i, L_CLONE);
+        nacol = numaaGetNuma(naacol, i, L_CLONE);
         nt = pixaGetCount(pixat);
         found = FALSE;
         findcontext = findSimilarSizedTemplatesInit(classer, pix1);
         while ( (iclass = findSimilarSizedTemplatesNext(findcontext)) > -1) {
-                /* Get the template */
-            pix2 = pixaGetPix(pixat, iclass, L_CLONE);
             numaGetIValue(nafgt, iclass, &area2);
             ptaGetPt(ptact, iclass, &x2, &y2);  /* template centroid */
 
@@ -1206,7 +1564,14 @@ l_uint8     byte;
                 threshold = thresh;
             }
 
-                /* Find score for this template */
+                /* Skip the template if the score can't reach threshold */
+            if (!jbCorrelationMayMatch(classer, iclass, narow, nacol,
+                                       area1, area2, x1 - x2, y1 - y2,
+                                       threshold))
+                continue;
+
+                /* Get the template and find its score */
+            pix2 = pixaGetPix(pixat, iclass, L_CLONE);
             overthreshold = pixCorrelationScoreThresholded(pix1, pix2,
                                          area1, area2, x1 - x2, y1 - y2,
                                          MAX_DIFF_WIDTH, MAX_DIFF_HEIGHT,
@@ -1269,6 +1634,7 @@ l_uint8     byte;
             wt = pixGetWidth(pix);
             ht = pixGetHeight(pix);
             l_dnaHashAdd(dahash, (l_uint64)ht * wt, nt);
+            ptaAddPt(classer->ptadimt, wt, ht);
             box = boxaGetBox(boxa, i, L_CLONE);
             pixaAddBox(pixa, box, L_INSERT);
             pixaaAddPixa(pixaa, pixa, L_INSERT);  /* unbordered instance */
@@ -1278,22 +1644,16 @@ l_uint8     byte;
             area = (pixGetWidth(pix1) - 2 * JB_ADDED_PIXELS) *
                    (pixGetHeight(pix1) - 2 * JB_ADDED_PIXELS);
             numaAddNumber(naarea, area);
+            jbAddTemplateProjections(classer, narow, nacol, NULL, NULL);
         } else {  /* don't save it */
             pixDestroy(&pix1);
         }
+        numaDestroy(&narow);
+        numaDestroy(&nacol);
     }
     classer->nclass = pixaGetCount(pixat);
 
-    LEPT_FREE(pixcts);
-    LEPT_FREE(centtab);
-    for (i = 0; i < n; i++) {
-        LEPT_FREE(pixrowcts[i]);
-    }
-    LEPT_FREE(pixrowcts);
-
     LEPT_FREE(sumtab);
-    ptaDestroy(&pta);
-    pixaDestroy(&pixa1);
     return 0;
 }
 
@@ -1805,12 +2165,17 @@ JBCLASSER  *classer;
     classer->pixat = pixaCreate(0);
     classer->pixatd = pixaCreate(0);
     classer->nafgt = numaCreate(0);
+    classer->ptadimt = ptaCreate(0);
+    classer->naprojt = numaCreate(0);
+    classer->naprojtd = numaCreate(0);
+    classer->daprojt = l_dnaCreate(0);
     classer->naarea = numaCreate(0);
     classer->ptac = ptaCreate(0);
     classer->ptact = ptaCreate(0);
     classer->naclass = numaCreate(0);
     classer->napage = numaCreate(0);
     classer->ptaul = ptaCreate(0);
+    classer->prefilter = 1;
     return classer;
 }
 
@@ -1838,6 +2203,10 @@ JBCLASSER  *classer;
     pixaDestroy(&classer->pixatd);
     l_dnaHashDestroy(&classer->dahash);
     numaDestroy(&classer->nafgt);
+    ptaDestroy(&classer->ptadimt);
+    numaDestroy(&classer->naprojt);
+    numaDestroy(&classer->naprojtd);
+    l_dnaDestroy(&classer->daprojt);
     numaDestroy(&classer->naarea);
     ptaDestroy(&classer->ptac);
     ptaDestroy(&classer->ptact);
@@ -2445,8 +2814,7 @@ JBFINDCTX  *state;
 static l_int32
 findSimilarSizedTemplatesNext(JBFINDCTX  *state)
 {
-l_int32  desiredh, desiredw, size, templ;
-PIX     *pixt;
+l_int32  desiredh, desiredw, size, templ, wt, ht;
 
     while(1) {  /* Continue the walk over step 'i' */
         if (state->i >= 25) {  /* all done; didn't find a good match */
@@ -2476,13 +2844,9 @@ PIX     *pixt;
         size = l_dnaGetCount(state->dna);
         for ( ; state->n < size; ) {
             templ = (l_int32)(state->dna->array[state->n++] + 0.5);
-            pixt = pixaGetPix(state->classer->pixat, templ, L_CLONE);
-            if (pixGetWidth(pixt) - 2 * JB_ADDED_PIXELS == desiredw &&
-                pixGetHeight(pixt) - 2 * JB_ADDED_PIXELS == desiredh) {
-                pixDestroy(&pixt);
+            ptaGetIPt(state->classer->ptadimt, templ, &wt, &ht);
+            if (wt == desiredw && ht == desiredh)
                 return templ;
-            }
-            pixDestroy(&pixt);
         }
 
             /* Exhausted the dna (no match found); take another step and
@@ -2567,3 +2931,298 @@ BOX     *box;
     *pdy = miny;
     return 0;
 }
+
+
+/*!
+ * \brief   jbGetProjections()
+ *
+ * \param[in]    pixa       bordered components, 1 bpp
+ * \param[in]    tab8       table of pixel sums for byte
+ * \param[out]   pnaarow    fg counts in each row of each pix
+ * \param[out]   pnaacol    fg counts in each column of each pix
+ * \return  void
+ */
+static void
+jbGetProjections(PIXA     *pixa,
+                 l_int32  *tab8,
+                 NUMAA   **pnaarow,
+                 NUMAA   **pnaacol)
+{
+l_int32  i, n;
+NUMA    *na;
+NUMAA   *naarow, *naacol;
+PIX     *pix;
+
+    n = pixaGetCount(pixa);
+    naarow = numaaCreate(n);
+    naacol = numaaCreate(n);
+    for (i = 0; i < n; i++) {
+        pix = pixaGetPix(pixa, i, L_CLONE);
+        na = pixCountPixelsByRow(pix, tab8);
+        numaaAddNuma(naarow, na, L_INSERT);
+        na = pixCountPixelsByColumn(pix);
+        numaaAddNuma(naacol, na, L_INSERT);
+        pixDestroy(&pix);
+    }
+    *pnaarow = naarow;
+    *pnaacol = naacol;
+}
+
+
+/*!
+ * \brief   jbAddTemplateProjections()
+ *
+ * \param[in]    classer
+ * \param[in]    narow, nacol     fg counts in rows and columns of the
+ *                                bordered template
+ * \param[in]    narowd, nacold   [optional] fg counts in rows and columns
+ *                                of the bordered and dilated template
+ * \return  void
+ *
+ * <pre>
+ * Notes:
+ *      (1) The counts of all templates are stored contiguously, rows
+ *          followed by columns, at the offset saved in classer->daprojt.
+ *          The dilated counts, used only for rank hausdorff, are stored
+ *          at the same offset in classer->naprojtd.
+ * </pre>
+ */
+static void
+jbAddTemplateProjections(JBCLASSER  *classer,
+                         NUMA       *narow,
+                         NUMA       *nacol,
+                         NUMA       *narowd,
+                         NUMA       *nacold)
+{
+    l_dnaAddNumber(classer->daprojt, numaGetCount(classer->naprojt));
+    numaJoin(classer->naprojt, narow, 0, -1);
+    numaJoin(classer->naprojt, nacol, 0, -1);
+    if (narowd && nacold) {
+        numaJoin(classer->naprojtd, narowd, 0, -1);
+        numaJoin(classer->naprojtd, nacold, 0, -1);
+    }
+}
+
+
+/*!
+ * \brief   jbCorrelationMayMatch()
+ *
+ * \param[in]    classer
+ * \param[in]    iclass            template index
+ * \param[in]    narow, nacol      fg counts in rows and columns of the
+ *                                 bordered instance
+ * \param[in]    area1             number of fg pixels in the instance
+ * \param[in]    area2             number of fg pixels in the template
+ * \param[in]    delx, dely        centroid difference
+ * \param[in]    score_threshold
+ * \return  0 if the correlation score of the instance and template
+ *          cannot reach %score_threshold; 1 otherwise
+ *
+ * <pre>
+ * Notes:
+ *      (1) This is a fast rejection test to be used before
+ *          pixCorrelationScoreThresholded(), with the same input
+ *          parameters.  The AND of the instance and template, aligned
+ *          as in that function, can have no more pixels than the
+ *          smaller of the two, and no more pixels in each row (or
+ *          column) than the smaller of the two counts in that row
+ *          (or column).  If any of these upper bounds is below the
+ *          count needed to reach %score_threshold, the template
+ *          is rejected.
+ *      (2) Because the test only rejects templates that would fail in
+ *          pixCorrelationScoreThresholded(), the classification is
+ *          the same as without it.  Setting classer->prefilter = 0
+ *          turns it off, for verifying this.
+ * </pre>
+ */
+static l_int32
+jbCorrelationMayMatch(JBCLASSER  *classer,
+                      l_int32     iclass,
+                      NUMA       *narow,
+                      NUMA       *nacol,
+                      l_int32     area1,
+                      l_int32     area2,
+                      l_float32   delx,
+                      l_float32   dely,
+                      l_float32   score_threshold)
+{
+l_int32     idelx, idely, countneeded, offset, wt, ht;
+l_float32  *farow, *facol;
+
+    if (!classer->prefilter)
+        return 1;
+
+        /* Same count as needed in pixCorrelationScoreThresholded() */
+    countneeded =
+        (l_int32)ceil(sqrt((l_float64)score_threshold * area1 * area2));
+    if (L_MIN(area1, area2) < countneeded)
+        return 0;
+
+    if (delx >= 0)
+        idelx = (l_int32)(delx + 0.5);
+    else
+        idelx = (l_int32)(delx - 0.5);
+    if (dely >= 0)
+        idely = (l_int32)(dely + 0.5);
+    else
+        idely = (l_int32)(dely - 0.5);
+
+    l_dnaGetIValue(classer->daprojt, iclass, &offset);
+    ptaGetIPt(classer->ptadimt, iclass, &wt, &ht);
+    ht += 2 * JB_ADDED_PIXELS;
+    wt += 2 * JB_ADDED_PIXELS;
+    farow = numaGetFArray(classer->naprojt, L_NOCOPY) + offset;
+    facol = farow + ht;
+    if (projectionOverlap(numaGetFArray(narow, L_NOCOPY),
+                          numaGetCount(narow), farow, ht, idely)
+        < countneeded)
+        return 0;
+    return projectionOverlap(numaGetFArray(nacol, L_NOCOPY),
+                             numaGetCount(nacol), facol, wt, idelx)
+           >= countneeded;
+}
+
+
+/*!
+ * \brief   jbHausMayMatch()
+ *
+ * \param[in]    classer
+ * \param[in]    iclass           template index
+ * \param[in]    narow1, nacol1   fg counts in rows and columns of the
+ *                                bordered instance
+ * \param[in]    narow2, nacol2   fg counts in rows and columns of the
+ *                                bordered and dilated instance
+ * \param[in]    delx, dely       centroid difference
+ * \param[in]    thresh1          max number of instance pixels that are
+ *                                not covered by the dilated template
+ * \param[in]    thresh3          max number of template pixels that are
+ *                                not covered by the dilated instance
+ * \return  0 if the instance and template cannot pass the Hausdorff
+ *          test; 1 otherwise
+ *
+ * <pre>
+ * Notes:
+ *      (1) This is a fast rejection test to be used before pixHaustest()
+ *          (with %thresh1 = %thresh3 = 0) or pixRankHaustest(), with
+ *          the same alignment.  In any row (or column), the number of
+ *          pixels of one image not covered by the other dilated image
+ *          is at least the difference in their counts in that row (or
+ *          column).  If the sum of these differences exceeds the
+ *          allowed number of uncovered pixels, the template is rejected.
+ *      (2) The template is clipped to the instance when it is shifted
+ *          for the second test, so that test is only used when no
+ *          fg pixels of the template can be clipped.
+ *      (3) As with jbCorrelationMayMatch(), the classification is the
+ *          same as without the test, which is off if
+ *          classer->prefilter = 0.
+ * </pre>
+ */
+static l_int32
+jbHausMayMatch(JBCLASSER  *classer,
+               l_int32     iclass,
+               NUMA       *narow1,
+               NUMA       *nacol1,
+               NUMA       *narow2,
+               NUMA       *nacol2,
+               l_float32   delx,
+               l_float32   dely,
+               l_int32     thresh1,
+               l_int32     thresh3)
+{
+l_int32     idelx, idely, wi, hi, wt, ht, offset;
+l_float32  *farow1, *facol1, *farow2, *facol2, *fa;
+
+    if (!classer->prefilter)
+        return 1;
+
+    if (delx >= 0)
+        idelx = (l_int32)(delx + 0.5);
+    else
+        idelx = (l_int32)(delx - 0.5);
+    if (dely >= 0)
+        idely = (l_int32)(dely + 0.5);
+    else
+        idely = (l_int32)(dely - 0.5);
+
+    l_dnaGetIValue(classer->daprojt, iclass, &offset);
+    ptaGetIPt(classer->ptadimt, iclass, &wt, &ht);
+    wt += 2 * JB_ADDED_PIXELS;
+    ht += 2 * JB_ADDED_PIXELS;
+    hi = numaGetCount(narow1);
+    wi = numaGetCount(nacol1);
+    farow1 = numaGetFArray(narow1, L_NOCOPY);
+    facol1 = numaGetFArray(nacol1, L_NOCOPY);
+
+        /* Instance pixels not covered by the dilated template */
+    fa = numaGetFArray(classer->naprojtd, L_NOCOPY) + offset;
+    if (projectionExcess(farow1, hi, fa, ht, idely) > thresh1 ||
+        projectionExcess(facol1, wi, fa + ht, wt, idelx) > thresh1)
+        return 0;
+
+        /* Template pixels not covered by the dilated instance */
+    if (idelx < -JB_ADDED_PIXELS || idelx > wi - wt + JB_ADDED_PIXELS ||
+        idely < -JB_ADDED_PIXELS || idely > hi - ht + JB_ADDED_PIXELS)
+        return 1;
+    fa = numaGetFArray(classer->naprojt, L_NOCOPY) + offset;
+    farow2 = numaGetFArray(narow2, L_NOCOPY);
+    facol2 = numaGetFArray(nacol2, L_NOCOPY);
+    return projectionExcess(fa, ht, farow2, hi, -idely) <= thresh3 &&
+           projectionExcess(fa + ht, wt, facol2, wi, -idelx) <= thresh3;
+}
+
+
+/*!
+ * \brief   projectionOverlap()
+ *
+ * \param[in]    fa1, fa2   fg counts in rows (or columns) of two images
+ * \param[in]    n1, n2     number of counts in each array
+ * \param[in]    shift      of the second image relative to the first
+ * \return  sum over the overlap of the smaller of the two counts
+ */
+static l_int32
+projectionOverlap(l_float32  *fa1,
+                  l_int32     n1,
+                  l_float32  *fa2,
+                  l_int32     n2,
+                  l_int32     shift)
+{
+l_int32  i, first, last, sum;
+
+    first = L_MAX(0, shift);
+    last = L_MIN(n1, n2 + shift);
+    sum = 0;
+    for (i = first; i < last; i++)
+        sum += (l_int32)L_MIN(fa1[i], fa2[i - shift]);
+    return sum;
+}
+
+
+/*!
+ * \brief   projectionExcess()
+ *
+ * \param[in]    fa1, fa2   fg counts in rows (or columns) of two images
+ * \param[in]    n1, n2     number of counts in each array
+ * \param[in]    shift      of the second image relative to the first
+ * \return  sum over the first image of the amount by which its count
+ *          exceeds that of the second image; counts of the second image
+ *          outside the overlap are taken to be 0
+ */
+static l_int32
+projectionExcess(l_float32  *fa1,
+                 l_int32     n1,
+                 l_float32  *fa2,
+                 l_int32     n2,
+                 l_int32     shift)
+{
+l_int32    i, j, sum;
+l_float32  diff;
+
+    sum = 0;
+    for (i = 0; i < n1; i++) {
+        j = i - shift;
+        diff = (j >= 0 && j < n2) ? fa1[i] - fa2[j] : fa1[i];
+        if (diff > 0)
+            sum += (l_int32)diff;
+    }
+    return sum;
+}
@@ -67,6 +67,9 @@ struct JbClasser
     l_int32          h;            /*!< max height of original src images    */
     l_int32          nclass;       /*!< current number of classes            */
     l_int32          keep_pixaa;   /*!< If zero, pixaa isn't filled          */
+    l_int32          prefilter;    /*!< If zero, templates are not rejected  */
+                                   /*!< early using the projections; for     */
+                                   /*!< testing only                         */
     struct Pixaa    *pixaa;        /*!< instances for each class; unbordered */
     struct Pixa     *pixat;        /*!< templates for each class; bordered   */
                                    /*!< and not dilated                      */
@@ -75,6 +78,14 @@ struct JbClasser
     struct L_DnaHash *dahash;      /*!< Hash table to find templates by size */
     struct Numa     *nafgt;        /*!< fg areas of undilated templates;     */
                                    /*!< only used for rank < 1.0             */
+    struct Pta      *ptadimt;      /*!< width and height of each template,   */
+                                   /*!< without extra border pixels          */
+    struct Numa     *naprojt;      /*!< fg counts in each row and then each  */
+                                   /*!< column of all bordered templates     */
+    struct Numa     *naprojtd;     /*!< same, for bordered and dilated       */
+                                   /*!< templates; only used for rankhaus    */
+    struct L_Dna    *daprojt;      /*!< offset of the counts for each        */
+                                   /*!< template in naprojt and naprojtd     */
     struct Pta      *ptac;         /*!< centroids of all bordered cc         */
     struct Pta      *ptact;        /*!< centroids of all bordered template cc */
     struct Numa     *naclass;      /*!< array of class ids for each component */
@@ -87,6 +98,40 @@ struct JbClasser
 typedef struct JbClasser  JBCLASSER;
 
 
+    /*!
+     * <pre>
+     * The JbPage struct holds the components of one page, along with
+     * everything computed from them that is needed for classification
+     * but does not depend on the templates.  Pages can be made
+     * independently with jbPageCreate(), and are then classified in
+     * page order with jbAddPreparedPage().
+     * </pre>
+     */
+struct JbPage
+{
+    struct Pix      *pix;          /*!< input page                           */
+    struct Boxa     *boxa;         /*!< b.b. of components on the page       */
+    struct Pixa     *pixa;         /*!< components on the page; unbordered   */
+    struct Pixa     *pixa1;        /*!< components; bordered                 */
+    struct Pixa     *pixa2;        /*!< components; bordered and dilated;    */
+                                   /*!< only used for rankhaus               */
+    struct Pta      *pta;          /*!< centroids of bordered components     */
+    struct Numa     *nafg;         /*!< fg area of each component            */
+    l_int32        **pixrowcts;    /*!< fg count below each row of each      */
+                                   /*!< bordered component; only used for    */
+                                   /*!< correlation                          */
+    struct Numaa    *naarow1;      /*!< fg counts in each row of each        */
+                                   /*!< bordered component                   */
+    struct Numaa    *naacol1;      /*!< fg counts in each column of each     */
+                                   /*!< bordered component                   */
+    struct Numaa    *naarow2;      /*!< same as naarow1, for bordered and    */
+                                   /*!< dilated components; only rankhaus    */
+    struct Numaa    *naacol2;      /*!< same as naacol1, for bordered and    */
+                                   /*!< dilated components; only rankhaus    */
+};
+typedef struct JbPage  JBPAGE;
+
+
     /*!
      * <pre>
      * The JbData struct holds all the data required for
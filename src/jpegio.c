@@ -31,6 +31,7 @@
  *    Read jpeg from file
  *          PIX             *pixReadJpeg()  [special top level]
  *          PIX             *pixReadStreamJpeg()
+ *          static PIX      *jpegDecompressToPix()
  *
  *    Read jpeg metadata from file
  *          l_int32          readHeaderJpeg()
@@ -41,6 +42,7 @@
  *    Write jpeg to file
  *          l_int32          pixWriteJpeg()  [special top level]
  *          l_int32          pixWriteStreamJpeg()
+ *          static l_int32   jpegCompressPix()
  *
  *    Read/write to memory
  *          PIX             *pixReadMemJpeg()
@@ -48,6 +50,14 @@
  *          l_int32          readResolutionMemJpeg()
  *          l_int32          pixWriteMemJpeg()
  *
+ *    Reusable encoder and decoder contexts
+ *          L_JPEG_ENCODER  *jpegEncoderCreate()
+ *          void             jpegEncoderDestroy()
+ *          l_int32          jpegEncoderEncode()
+ *          L_JPEG_DECODER  *jpegDecoderCreate()
+ *          void             jpegDecoderDestroy()
+ *          PIX             *jpegDecoderDecode()
+ *
  *    Setting special flag for chroma sampling on write
  *          l_int32          pixSetChromaSampling()
  *
@@ -56,6 +66,8 @@
  *          static void      jpeg_error_catch_all_2()
  *          static l_uint8   jpeg_getc()
  *          static l_int32   jpeg_comment_callback()
+ *          static void      jpegSetMemSource()
+ *          static void      jpegSetMemDest()
  *
  *    Documentation: libjpeg.doc can be found, along with all
  *    source code, at ftp://ftp.uu.net/graphics/jpeg
@@ -111,10 +123,13 @@
  *
  *    Compressing to memory and decompressing from memory
  *    ---------------------------------------------------
- *    On systems like windows without fmemopen() and open_memstream(),
- *    we write data to a temp file and read it back for operations
- *    between pix and compressed-data, such as pixReadMemJpeg() and
- *    pixWriteMemJpeg().
+ *    pixReadMemJpeg() and pixWriteMemJpeg() use libjpeg source and
+ *    destination managers that work directly on memory, so no file
+ *    streams are needed.  For encoding or decoding many images, make
+ *    a L_JPEG_ENCODER or L_JPEG_DECODER and reuse it.  These keep the
+ *    libjpeg compressor or decompressor, and the encoder also keeps its
+ *    output buffer, which grows to the size of the largest image.
+ *    Each context must be used by only one thread at a time.
  *
  *    Vestigial code: parsing the jpeg file for header metadata
  *    ---------------------------------------------------------
@@ -147,6 +162,7 @@
      * but we suppress it by undefining the variable. */
 #undef HAVE_STDLIB_H
 #include "jpeglib.h"
+#include "jerror.h"
 
 static void jpeg_error_catch_all_1(j_common_ptr cinfo);
 static void jpeg_error_catch_all_2(j_common_ptr cinfo);
@@ -166,6 +182,55 @@ struct callback_data {
     l_uint8  *comment;
 };
 
+    /* Destination manager for compressing into a growable buffer */
+struct L_JpegMemDest {
+    struct jpeg_destination_mgr  pub;     /* public fields               */
+    l_uint8                     *buffer;  /* output buffer               */
+    size_t                       size;    /* allocated size of buffer    */
+    size_t                       nbytes;  /* bytes written for the image */
+};
+typedef struct L_JpegMemDest  L_JPEG_MEMDEST;
+
+    /* Reusable encoder and decoder.  These are opaque outside this file
+     * because they hold the libjpeg structs. */
+struct L_Jpeg_Encoder {
+    struct jpeg_compress_struct    cinfo;
+    struct jpeg_error_mgr          jerr;
+    jmp_buf                        jmpbuf;
+    L_JPEG_MEMDEST                 dest;
+    JHUFF_TBL                      dchuff[2];  /* standard huffman tables */
+    JHUFF_TBL                      achuff[2];
+    l_int32                        created;  /* 1 if cinfo is initialized */
+};
+
+struct L_Jpeg_Decoder {
+    struct jpeg_decompress_struct  cinfo;
+    struct jpeg_error_mgr          jerr;
+    struct callback_data           cb_data;
+    l_int32                        created;  /* 1 if cinfo is initialized */
+};
+
+    /* Initial size of the output buffer for compressing to memory */
+static const size_t  JpegInitBufferSize = 65536;
+
+static PIX *jpegDecompressToPix(struct jpeg_decompress_struct *cinfo,
+                                l_int32 cmapflag, l_int32 reduction,
+                                l_int32 *pnwarn, l_int32 hint);
+static l_int32 jpegCompressPix(struct jpeg_compress_struct *cinfo,
+                               PIX *pixs, l_int32 quality,
+                               l_int32 progressive);
+static void jpegSetMemSource(struct jpeg_decompress_struct *cinfo,
+                             const l_uint8 *data, size_t size);
+static void jpeg_mem_init_source(j_decompress_ptr cinfo);
+static boolean jpeg_mem_fill_input_buffer(j_decompress_ptr cinfo);
+static void jpeg_mem_skip_input_data(j_decompress_ptr cinfo, long nbytes);
+static void jpeg_mem_term_source(j_decompress_ptr cinfo);
+static void jpegSetMemDest(struct jpeg_compress_struct *cinfo,
+                           L_JPEG_MEMDEST *dest);
+static void jpeg_mem_init_destination(j_compress_ptr cinfo);
+static boolean jpeg_mem_empty_output_buffer(j_compress_ptr cinfo);
+static void jpeg_mem_term_destination(j_compress_ptr cinfo);
+
 #ifndef  NO_CONSOLE_IO
 #define  DEBUG_INFO      0
 #endif  /* ~NO_CONSOLE_IO */
@@ -217,10 +282,8 @@ pixReadJpeg(const char  *filename,
             l_int32     *pnwarn,
             l_int32      hint)
 {
-l_int32   ret;
-l_uint8  *comment;
-FILE     *fp;
-PIX      *pix;
+FILE  *fp;
+PIX   *pix;
 
     PROCNAME("pixReadJpeg");
 
@@ -235,12 +298,6 @@ PIX      *pix;
     if ((fp = fopenReadStream(filename)) == NULL)
         return (PIX *)ERROR_PTR("image file not found", procName, NULL);
     pix = pixReadStreamJpeg(fp, cmapflag, reduction, pnwarn, hint);
-    if (pix) {
-        ret = fgetJpegComment(fp, &comment);
-        if (!ret && comment)
-            pixSetText(pix, (char *)comment);
-        LEPT_FREE(comment);
-    }
     fclose(fp);
 
     if (!pix)
@@ -263,7 +320,7 @@ PIX      *pix;
  *  Usage: see pixReadJpeg
  * <pre>
  * Notes:
- *      (1) The jpeg comment, if it exists, is not stored in the pix.
+ *      (1) The jpeg comment, if it exists, is stored as text in the pix.
  * </pre>
  */
 PIX *
@@ -273,23 +330,77 @@ pixReadStreamJpeg(FILE     *fp,
                   l_int32  *pnwarn,
                   l_int32   hint)
 {
-l_int32                        cyan, yellow, magenta, black, nwarn;
-l_int32                        i, j, k, rval, gval, bval;
-l_int32                        w, h, wpl, spp, ncolors, cindex, ycck, cmyk;
-l_uint32                      *data;
-l_uint32                      *line, *ppixel;
-JSAMPROW                       rowbuffer;
 PIX                           *pix;
-PIXCMAP                       *cmap;
 struct jpeg_decompress_struct  cinfo;
 struct jpeg_error_mgr          jerr;
-jmp_buf                        jmpbuf;  /* must be local to the function */
+struct callback_data           cb_data;  /* contains local jmp_buf */
 
     PROCNAME("pixReadStreamJpeg");
 
     if (pnwarn) *pnwarn = 0;
     if (!fp)
         return (PIX *)ERROR_PTR("fp not defined", procName, NULL);
+
+    rewind(fp);
+
+        /* Modify the jpeg error handling to catch fatal errors  */
+    cinfo.err = jpeg_std_error(&jerr);
+    jerr.error_exit = jpeg_error_catch_all_2;
+    cb_data.comment = NULL;
+    cinfo.client_data = (void *)&cb_data;
+    if (setjmp(cb_data.jmpbuf))
+        return (PIX *)ERROR_PTR("internal jpeg error", procName, NULL);
+
+        /* Initialize jpeg structs for decompression */
+    jpeg_create_decompress(&cinfo);
+    jpeg_stdio_src(&cinfo, fp);
+    pix = jpegDecompressToPix(&cinfo, cmapflag, reduction, pnwarn, hint);
+    jpeg_destroy_decompress(&cinfo);
+    return pix;
+}
+
+
+/*!
+ * \brief   jpegDecompressToPix()
+ *
+ * \param[in]    cinfo      initialized, with the data source set up
+ * \param[in]    cmapflag   0 for no colormap in returned pix;
+ *                          1 to return an 8 bpp cmapped pix if spp = 3 or 4
+ * \param[in]    reduction  scaling factor: 1, 2, 4 or 8
+ * \param[out]   pnwarn     [optional] number of warnings
+ * \param[in]    hint       a bitwise OR of L_JPEG_* values; 0 for default
+ * \return  pix, or NULL on error
+ *
+ * <pre>
+ * Notes:
+ *      (1) This does the decompression for reading from a stream, from
+ *          memory, and with a reusable L_JPEG_DECODER.
+ *      (2) cinfo->client_data must hold a struct callback_data, and the
+ *          error handler must be jpeg_error_catch_all_2().  On a fatal
+ *          jpeg error, the handler destroys %cinfo; otherwise, %cinfo
+ *          is left ready for reuse.
+ * </pre>
+ */
+static PIX *
+jpegDecompressToPix(struct jpeg_decompress_struct  *cinfo,
+                    l_int32                         cmapflag,
+                    l_int32                         reduction,
+                    l_int32                        *pnwarn,
+                    l_int32                         hint)
+{
+l_int32                 cyan, yellow, magenta, black, nwarn;
+l_int32                 i, j, k, rval, gval, bval;
+l_int32                 w, h, wpl, spp, ncolors, cindex, ycck, cmyk;
+l_uint32               *data;
+l_uint32               *line, *ppixel;
+JSAMPROW                rowbuffer;
+PIX                    *pix;
+PIXCMAP                *cmap;
+struct callback_data   *pcb_data;
+
+    PROCNAME("jpegDecompressToPix");
+
+    if (pnwarn) *pnwarn = 0;
     if (cmapflag != 0 && cmapflag != 1)
         cmapflag = 0;  /* default */
     if (reduction != 1 && reduction != 2 && reduction != 4 && reduction != 8)
@@ -298,42 +409,39 @@ jmp_buf                        jmpbuf;  /* must be local to the function */
     if (BITS_IN_JSAMPLE != 8)  /* set in jmorecfg.h */
         return (PIX *)ERROR_PTR("BITS_IN_JSAMPLE != 8", procName, NULL);
 
-    rewind(fp);
     pix = NULL;
     rowbuffer = NULL;
-
-        /* Modify the jpeg error handling to catch fatal errors  */
-    cinfo.err = jpeg_std_error(&jerr);
-    jerr.error_exit = jpeg_error_catch_all_1;
-    cinfo.client_data = (void *)&jmpbuf;
-    if (setjmp(jmpbuf)) {
+    pcb_data = (struct callback_data *)cinfo->client_data;
+    pcb_data->comment = NULL;
+    if (setjmp(pcb_data->jmpbuf)) {
         pixDestroy(&pix);
         LEPT_FREE(rowbuffer);
+        LEPT_FREE(pcb_data->comment);
         return (PIX *)ERROR_PTR("internal jpeg error", procName, NULL);
     }
 
-        /* Initialize jpeg structs for decompression */
-    jpeg_create_decompress(&cinfo);
-    jpeg_stdio_src(&cinfo, fp);
-    jpeg_read_header(&cinfo, TRUE);
-    cinfo.scale_denom = reduction;
-    cinfo.scale_num = 1;
-    jpeg_calc_output_dimensions(&cinfo);
+        /* Read the header, saving the comment */
+    jpeg_set_marker_processor(cinfo, JPEG_COM, jpeg_comment_callback);
+    jpeg_read_header(cinfo, TRUE);
+    cinfo->scale_denom = reduction;
+    cinfo->scale_num = 1;
+    jpeg_calc_output_dimensions(cinfo);
     if (hint & L_JPEG_READ_LUMINANCE) {
-        cinfo.out_color_space = JCS_GRAYSCALE;
+        cinfo->out_color_space = JCS_GRAYSCALE;
         spp = 1;
         L_INFO("reading luminance channel only\n", procName);
     } else {
-        spp = cinfo.out_color_components;
+        spp = cinfo->out_color_components;
     }
 
         /* Allocate the image and a row buffer */
-    w = cinfo.output_width;
-    h = cinfo.output_height;
-    ycck = (cinfo.jpeg_color_space == JCS_YCCK && spp == 4 && cmapflag == 0);
-    cmyk = (cinfo.jpeg_color_space == JCS_CMYK && spp == 4 && cmapflag == 0);
+    w = cinfo->output_width;
+    h = cinfo->output_height;
+    ycck = (cinfo->jpeg_color_space == JCS_YCCK && spp == 4 && cmapflag == 0);
+    cmyk = (cinfo->jpeg_color_space == JCS_CMYK && spp == 4 && cmapflag == 0);
     if (spp != 1 && spp != 3 && !ycck && !cmyk) {
-        jpeg_destroy_decompress(&cinfo);
+        LEPT_FREE(pcb_data->comment);
+        jpeg_abort_decompress(cinfo);
         return (PIX *)ERROR_PTR("spp must be 1 or 3, or YCCK or CMYK",
                                 procName, NULL);
     }
@@ -348,30 +456,31 @@ jmp_buf                        jmpbuf;  /* must be local to the function */
     if (!rowbuffer || !pix) {
         LEPT_FREE(rowbuffer);
         pixDestroy(&pix);
-        jpeg_destroy_decompress(&cinfo);
+        LEPT_FREE(pcb_data->comment);
+        jpeg_abort_decompress(cinfo);
         return (PIX *)ERROR_PTR("rowbuffer or pix not made", procName, NULL);
     }
 
         /* Initialize decompression.  Set up a colormap for color
          * quantization if requested. */
     if (spp == 1) {  /* Grayscale or colormapped */
-        jpeg_start_decompress(&cinfo);
+        jpeg_start_decompress(cinfo);
     } else {        /* Color; spp == 3 or YCCK or CMYK */
         if (cmapflag == 0) {   /* 24 bit color in 32 bit pix or YCCK/CMYK */
-            cinfo.quantize_colors = FALSE;
-            jpeg_start_decompress(&cinfo);
+            cinfo->quantize_colors = FALSE;
+            jpeg_start_decompress(cinfo);
         } else {      /* Color quantize to 8 bits */
-            cinfo.quantize_colors = TRUE;
-            cinfo.desired_number_of_colors = 256;
-            jpeg_start_decompress(&cinfo);
+            cinfo->quantize_colors = TRUE;
+            cinfo->desired_number_of_colors = 256;
+            jpeg_start_decompress(cinfo);
 
                 /* Construct a pix cmap */
             cmap = pixcmapCreate(8);
-            ncolors = cinfo.actual_number_of_colors;
+            ncolors = cinfo->actual_number_of_colors;
             for (cindex = 0; cindex < ncolors; cindex++) {
-                rval = cinfo.colormap[0][cindex];
-                gval = cinfo.colormap[1][cindex];
-                bval = cinfo.colormap[2][cindex];
+                rval = cinfo->colormap[0][cindex];
+                gval = cinfo->colormap[1][cindex];
+                bval = cinfo->colormap[2][cindex];
                 pixcmapAddColor(cmap, rval, gval, bval);
             }
             pixSetColormap(pix, cmap);
@@ -389,11 +498,12 @@ jmp_buf                        jmpbuf;  /* must be local to the function */
          * hint to have the same bit flag as L_JPEG_FAIL_ON_BAD_DATA,
          * no image will be returned if there are any warnings. */
     for (i = 0; i < h; i++) {
-        if (jpeg_read_scanlines(&cinfo, &rowbuffer, (JDIMENSION)1) == 0) {
+        if (jpeg_read_scanlines(cinfo, &rowbuffer, (JDIMENSION)1) == 0) {
             L_ERROR("read error at scanline %d\n", procName, i);
             pixDestroy(&pix);
-            jpeg_destroy_decompress(&cinfo);
+            jpeg_abort_decompress(cinfo);
             LEPT_FREE(rowbuffer);
+            LEPT_FREE(pcb_data->comment);
             return (PIX *)ERROR_PTR("bad data", procName, NULL);
         }
 
@@ -434,7 +544,7 @@ jmp_buf                        jmpbuf;  /* must be local to the function */
                     magenta = rowbuffer[k++];
                     yellow = rowbuffer[k++];
                     black = rowbuffer[k++];
-                    if (cinfo.saw_Adobe_marker) {
+                    if (cinfo->saw_Adobe_marker) {
                         rval = (black * cyan) / 255;
                         gval = (black * magenta) / 255;
                         bval = (black * yellow) / 255;
@@ -457,26 +567,29 @@ jmp_buf                        jmpbuf;  /* must be local to the function */
         }
     }
 
-    nwarn = cinfo.err->num_warnings;
+    nwarn = cinfo->err->num_warnings;
     if (pnwarn) *pnwarn = nwarn;
 
         /* If the pixel density is neither 1 nor 2, it may not be defined.
          * In that case, don't set the resolution.  */
-    if (cinfo.density_unit == 1) {  /* pixels per inch */
-        pixSetXRes(pix, cinfo.X_density);
-        pixSetYRes(pix, cinfo.Y_density);
-    } else if (cinfo.density_unit == 2) {  /* pixels per centimeter */
-        pixSetXRes(pix, (l_int32)((l_float32)cinfo.X_density * 2.54 + 0.5));
-        pixSetYRes(pix, (l_int32)((l_float32)cinfo.Y_density * 2.54 + 0.5));
+    if (cinfo->density_unit == 1) {  /* pixels per inch */
+        pixSetXRes(pix, cinfo->X_density);
+        pixSetYRes(pix, cinfo->Y_density);
+    } else if (cinfo->density_unit == 2) {  /* pixels per centimeter */
+        pixSetXRes(pix, (l_int32)((l_float32)cinfo->X_density * 2.54 + 0.5));
+        pixSetYRes(pix, (l_int32)((l_float32)cinfo->Y_density * 2.54 + 0.5));
     }
 
-    if (cinfo.output_components != spp)
+    if (cinfo->output_components != spp)
         lept_stderr("output spp = %d, spp = %d\n",
-                    cinfo.output_components, spp);
+                    cinfo->output_components, spp);
 
-    jpeg_finish_decompress(&cinfo);
-    jpeg_destroy_decompress(&cinfo);
+    jpeg_finish_decompress(cinfo);
     LEPT_FREE(rowbuffer);
+    if (pcb_data->comment) {
+        pixSetText(pix, (char *)pcb_data->comment);
+        LEPT_FREE(pcb_data->comment);
+    }
 
     if (nwarn > 0) {
         if (hint & L_JPEG_FAIL_ON_BAD_DATA) {
@@ -804,15 +917,9 @@ pixWriteStreamJpeg(FILE    *fp,
                    l_int32  quality,
                    l_int32  progressive)
 {
-l_int32                      xres, yres;
-l_int32                      i, j, k;
-l_int32                      w, h, d, wpl, spp, colorflag, rowsamples;
-l_uint32                    *ppixel, *line, *data;
-JSAMPROW                     rowbuffer;
-PIX                         *pix;
+l_int32                      ret;
 struct jpeg_compress_struct  cinfo;
 struct jpeg_error_mgr        jerr;
-char                        *text;
 jmp_buf                      jmpbuf;  /* must be local to the function */
 
     PROCNAME("pixWriteStreamJpeg");
@@ -821,6 +928,60 @@ jmp_buf                      jmpbuf;  /* must be local to the function */
         return ERROR_INT("stream not open", procName, 1);
     if (!pixs)
         return ERROR_INT("pixs not defined", procName, 1);
+
+    rewind(fp);
+
+        /* Modify the jpeg error handling to catch fatal errors  */
+    cinfo.err = jpeg_std_error(&jerr);
+    cinfo.client_data = (void *)&jmpbuf;
+    jerr.error_exit = jpeg_error_catch_all_1;
+    if (setjmp(jmpbuf))
+        return ERROR_INT("internal jpeg error", procName, 1);
+
+        /* Initialize the jpeg structs for compression */
+    jpeg_create_compress(&cinfo);
+    jpeg_stdio_dest(&cinfo, fp);
+    ret = jpegCompressPix(&cinfo, pixs, quality, progressive);
+    jpeg_destroy_compress(&cinfo);
+    return ret;
+}
+
+
+/*!
+ * \brief   jpegCompressPix()
+ *
+ * \param[in]    cinfo        initialized, with the destination set up
+ * \param[in]    pixs         any depth; cmap is OK
+ * \param[in]    quality      1 - 100; 75 is default value; 0 is also default
+ * \param[in]    progressive  0 for baseline sequential; 1 for progressive
+ * \return  0 if OK, 1 on error
+ *
+ * <pre>
+ * Notes:
+ *      (1) This does the compression for writing to a stream, to memory,
+ *          and with a reusable L_JPEG_ENCODER.
+ *      (2) cinfo->client_data must hold a jmp_buf, and the error handler
+ *          must be jpeg_error_catch_all_1().  On a fatal jpeg error, the
+ *          handler destroys %cinfo; otherwise, %cinfo is left ready
+ *          for reuse.
+ * </pre>
+ */
+static l_int32
+jpegCompressPix(struct jpeg_compress_struct  *cinfo,
+                PIX                          *pixs,
+                l_int32                       quality,
+                l_int32                       progressive)
+{
+l_int32    xres, yres;
+l_int32    i, j, k;
+l_int32    w, h, d, wpl, spp, colorflag, rowsamples;
+l_uint32  *ppixel, *line, *data;
+JSAMPROW   rowbuffer;
+PIX       *pix;
+char      *text;
+
+    PROCNAME("jpegCompressPix");
+
     if (quality <= 0) quality = 75;  /* default */
     if (quality > 100) {
         L_ERROR("invalid jpeg quality; setting to 75\n", procName);
@@ -849,56 +1010,47 @@ jmp_buf                      jmpbuf;  /* must be local to the function */
         return ERROR_INT("pix not made", procName, 1);
     pixSetPadBits(pix, 0);
 
-    rewind(fp);
     rowbuffer = NULL;
-
-        /* Modify the jpeg error handling to catch fatal errors  */
-    cinfo.err = jpeg_std_error(&jerr);
-    cinfo.client_data = (void *)&jmpbuf;
-    jerr.error_exit = jpeg_error_catch_all_1;
-    if (setjmp(jmpbuf)) {
+    if (setjmp(*(jmp_buf *)cinfo->client_data)) {
         LEPT_FREE(rowbuffer);
         pixDestroy(&pix);
         return ERROR_INT("internal jpeg error", procName, 1);
     }
 
-        /* Initialize the jpeg structs for compression */
-    jpeg_create_compress(&cinfo);
-    jpeg_stdio_dest(&cinfo, fp);
-    cinfo.image_width  = w;
-    cinfo.image_height = h;
+    cinfo->image_width  = w;
+    cinfo->image_height = h;
 
         /* Set the color space and number of components */
     d = pixGetDepth(pix);
     if (d == 8) {
         colorflag = 0;    /* 8 bpp grayscale; no cmap */
-        cinfo.input_components = 1;
-        cinfo.in_color_space = JCS_GRAYSCALE;
+        cinfo->input_components = 1;
+        cinfo->in_color_space = JCS_GRAYSCALE;
     } else {  /* d == 32 || d == 24 */
         colorflag = 1;    /* rgb */
-        cinfo.input_components = 3;
-        cinfo.in_color_space = JCS_RGB;
+        cinfo->input_components = 3;
+        cinfo->in_color_space = JCS_RGB;
     }
 
-    jpeg_set_defaults(&cinfo);
+    jpeg_set_defaults(cinfo);
 
         /* Setting optimize_coding to TRUE seems to improve compression
          * by approx 2-4 percent, and increases comp time by approx 20%. */
-    cinfo.optimize_coding = FALSE;
+    cinfo->optimize_coding = FALSE;
 
         /* Set resolution in pixels/in (density_unit: 1 = in, 2 = cm) */
     xres = pixGetXRes(pix);
     yres = pixGetYRes(pix);
     if ((xres != 0) && (yres != 0)) {
-        cinfo.density_unit = 1;  /* designates pixels per inch */
-        cinfo.X_density = xres;
-        cinfo.Y_density = yres;
+        cinfo->density_unit = 1;  /* designates pixels per inch */
+        cinfo->X_density = xres;
+        cinfo->Y_density = yres;
     }
 
         /* Set the quality and progressive parameters */
-    jpeg_set_quality(&cinfo, quality, TRUE);
+    jpeg_set_quality(cinfo, quality, TRUE);
     if (progressive)
-        jpeg_simple_progression(&cinfo);
+        jpeg_simple_progression(cinfo);
 
         /* Set the chroma subsampling parameters.  This is done in
          * YUV color space.  The Y (intensity) channel is never subsampled.
@@ -909,15 +1061,15 @@ jmp_buf                      jmpbuf;  /* must be local to the function */
          * We allow high quality where there is no subsampling on the
          * chroma channels: denoted as 4:4:4.  */
     if (pixs->special == L_NO_CHROMA_SAMPLING_JPEG) {
-        cinfo.comp_info[0].h_samp_factor = 1;
-        cinfo.comp_info[0].v_samp_factor = 1;
-        cinfo.comp_info[1].h_samp_factor = 1;
-        cinfo.comp_info[1].v_samp_factor = 1;
-        cinfo.comp_info[2].h_samp_factor = 1;
-        cinfo.comp_info[2].v_samp_factor = 1;
+        cinfo->comp_info[0].h_samp_factor = 1;
+        cinfo->comp_info[0].v_samp_factor = 1;
+        cinfo->comp_info[1].h_samp_factor = 1;
+        cinfo->comp_info[1].v_samp_factor = 1;
+        cinfo->comp_info[2].h_samp_factor = 1;
+        cinfo->comp_info[2].v_samp_factor = 1;
     }
 
-    jpeg_start_compress(&cinfo, TRUE);
+    jpeg_start_compress(cinfo, TRUE);
 
         /* Cap the text the length limit, 65533, for JPEG_COM payload.
          * Just to be safe, subtract 100 to cover the Adobe name space.  */
@@ -927,15 +1079,16 @@ jmp_buf                      jmpbuf;  /* must be local to the function */
                    procName, strlen(text));
             text[65433] = '\0';
         }
-        jpeg_write_marker(&cinfo, JPEG_COM, (const JOCTET *)text, strlen(text));
+        jpeg_write_marker(cinfo, JPEG_COM, (const JOCTET *)text, strlen(text));
     }
 
         /* Allocate row buffer */
-    spp = cinfo.input_components;
+    spp = cinfo->input_components;
     rowsamples = spp * w;
     if ((rowbuffer = (JSAMPROW)LEPT_CALLOC(sizeof(JSAMPLE), rowsamples))
         == NULL) {
         pixDestroy(&pix);
+        jpeg_abort_compress(cinfo);
         return ERROR_INT("calloc fail for rowbuffer", procName, 1);
     }
 
@@ -948,7 +1101,7 @@ jmp_buf                      jmpbuf;  /* must be local to the function */
                 rowbuffer[j] = GET_DATA_BYTE(line, j);
         } else {  /* colorflag == 1 */
             if (d == 24) {  /* See note 3 above; special case of 24 bpp rgb */
-                jpeg_write_scanlines(&cinfo, (JSAMPROW *)&line, 1);
+                jpeg_write_scanlines(cinfo, (JSAMPROW *)&line, 1);
             } else {  /* standard 32 bpp rgb */
                 ppixel = line;
                 for (j = k = 0; j < w; j++) {
@@ -960,13 +1113,12 @@ jmp_buf                      jmpbuf;  /* must be local to the function */
             }
         }
         if (d != 24)
-            jpeg_write_scanlines(&cinfo, &rowbuffer, 1);
+            jpeg_write_scanlines(cinfo, &rowbuffer, 1);
     }
-    jpeg_finish_compress(&cinfo);
+    jpeg_finish_compress(cinfo);
 
     pixDestroy(&pix);
     LEPT_FREE(rowbuffer);
-    jpeg_destroy_compress(&cinfo);
     return 0;
 }
 
@@ -990,10 +1142,11 @@ jmp_buf                      jmpbuf;  /* must be local to the function */
  *
  * <pre>
  * Notes:
- *      (1) The %size byte of %data must be a null character.
- *      (2) The only hint flag so far is L_JPEG_READ_LUMINANCE,
- *          given in the enum in imageio.h.
- *      (3) See pixReadJpeg() for usage.
+ *      (1) This decodes directly from %data, without a file stream.
+ *          The jpeg comment, if it exists, is stored as text in the pix.
+ *      (2) See pixReadJpeg() for usage and the hint flags.
+ *      (3) To decode many images, use a L_JPEG_DECODER, which keeps
+ *          the decompressor between calls.
  * </pre>
  */
 PIX *
@@ -1004,10 +1157,10 @@ pixReadMemJpeg(const l_uint8  *data,
                l_int32        *pnwarn,
                l_int32         hint)
 {
-l_int32   ret;
-l_uint8  *comment;
-FILE     *fp;
-PIX      *pix;
+PIX                           *pix;
+struct jpeg_decompress_struct  cinfo;
+struct jpeg_error_mgr          jerr;
+struct callback_data           cb_data;  /* contains local jmp_buf */
 
     PROCNAME("pixReadMemJpeg");
 
@@ -1015,17 +1168,17 @@ PIX      *pix;
     if (!data)
         return (PIX *)ERROR_PTR("data not defined", procName, NULL);
 
-    if ((fp = fopenReadFromMemory(data, size)) == NULL)
-        return (PIX *)ERROR_PTR("stream not opened", procName, NULL);
-    pix = pixReadStreamJpeg(fp, cmflag, reduction, pnwarn, hint);
-    if (pix) {
-        ret = fgetJpegComment(fp, &comment);
-        if (!ret && comment) {
-            pixSetText(pix, (char *)comment);
-            LEPT_FREE(comment);
-        }
-    }
-    fclose(fp);
+    cinfo.err = jpeg_std_error(&jerr);
+    jerr.error_exit = jpeg_error_catch_all_2;
+    cb_data.comment = NULL;
+    cinfo.client_data = (void *)&cb_data;
+    if (setjmp(cb_data.jmpbuf))
+        return (PIX *)ERROR_PTR("internal jpeg error", procName, NULL);
+
+    jpeg_create_decompress(&cinfo);
+    jpegSetMemSource(&cinfo, data, size);
+    pix = jpegDecompressToPix(&cinfo, cmflag, reduction, pnwarn, hint);
+    jpeg_destroy_decompress(&cinfo);
     if (!pix) L_ERROR("pix not read\n", procName);
     return pix;
 }
@@ -1133,8 +1286,11 @@ pixWriteMemJpeg(l_uint8  **pdata,
                 l_int32    quality,
                 l_int32    progressive)
 {
-l_int32  ret;
-FILE    *fp;
+l_int32                      ret;
+struct jpeg_compress_struct  cinfo;
+struct jpeg_error_mgr        jerr;
+L_JPEG_MEMDEST               dest;
+jmp_buf                      jmpbuf;  /* must be local to the function */
 
     PROCNAME("pixWriteMemJpeg");
 
@@ -1147,25 +1303,283 @@ FILE    *fp;
     if (!pix)
         return ERROR_INT("&pix not defined", procName, 1 );
 
-#if HAVE_FMEMOPEN
-    if ((fp = open_memstream((char **)pdata, psize)) == NULL)
-        return ERROR_INT("stream not opened", procName, 1);
-    ret = pixWriteStreamJpeg(fp, pix, quality, progressive);
-#else
-    L_INFO("work-around: writing to a temp file\n", procName);
-  #ifdef _WIN32
-    if ((fp = fopenWriteWinTempfile()) == NULL)
-        return ERROR_INT("tmpfile stream not opened", procName, 1);
-  #else
-    if ((fp = tmpfile()) == NULL)
-        return ERROR_INT("tmpfile stream not opened", procName, 1);
-  #endif  /* _WIN32 */
-    ret = pixWriteStreamJpeg(fp, pix, quality, progressive);
-    rewind(fp);
-    *pdata = l_binaryReadStream(fp, psize);
-#endif  /* HAVE_FMEMOPEN */
-    fclose(fp);
-    return ret;
+    memset(&dest, 0, sizeof(L_JPEG_MEMDEST));
+    cinfo.err = jpeg_std_error(&jerr);
+    cinfo.client_data = (void *)&jmpbuf;
+    jerr.error_exit = jpeg_error_catch_all_1;
+    if (setjmp(jmpbuf)) {
+        LEPT_FREE(dest.buffer);
+        return ERROR_INT("internal jpeg error", procName, 1);
+    }
+
+    jpeg_create_compress(&cinfo);
+    jpegSetMemDest(&cinfo, &dest);
+    ret = jpegCompressPix(&cinfo, pix, quality, progressive);
+    jpeg_destroy_compress(&cinfo);
+    if (ret) {
+        LEPT_FREE(dest.buffer);
+        return ERROR_INT("pix not written to memory", procName, 1);
+    }
+    *pdata = dest.buffer;
+    *psize = dest.nbytes;
+    return 0;
+}
+
+
+/*---------------------------------------------------------------------*
+ *                Reusable encoder and decoder contexts                *
+ *---------------------------------------------------------------------*/
+/*!
+ * \brief   jpegEncoderCreate()
+ *
+ * \return  enc, or NULL on error
+ *
+ * <pre>
+ * Notes:
+ *      (1) An encoder holds a jpeg compressor and a growable output
+ *          buffer.  Use it to compress a sequence of images to memory
+ *          without setting up the compressor or reallocating the
+ *          output for each image.
+ *      (2) An encoder may be used by only one thread at a time.  For
+ *          concurrent encoding, make one encoder for each thread.
+ * </pre>
+ */
+L_JPEG_ENCODER *
+jpegEncoderCreate(void)
+{
+L_JPEG_ENCODER  *enc;
+
+    PROCNAME("jpegEncoderCreate");
+
+    if ((enc = (L_JPEG_ENCODER *)LEPT_CALLOC(1, sizeof(L_JPEG_ENCODER)))
+        == NULL)
+        return (L_JPEG_ENCODER *)ERROR_PTR("enc not made", procName, NULL);
+    return enc;
+}
+
+
+/*!
+ * \brief   jpegEncoderDestroy()
+ *
+ * \param[in,out]   penc    will be set to null before returning
+ * \return  void
+ */
+void
+jpegEncoderDestroy(L_JPEG_ENCODER  **penc)
+{
+L_JPEG_ENCODER  *enc;
+
+    PROCNAME("jpegEncoderDestroy");
+
+    if (penc == NULL) {
+        L_WARNING("ptr address is null!\n", procName);
+        return;
+    }
+    if ((enc = *penc) == NULL)
+        return;
+
+    if (enc->created)
+        jpeg_destroy_compress(&enc->cinfo);
+    LEPT_FREE(enc->dest.buffer);
+    LEPT_FREE(enc);
+    *penc = NULL;
+}
+
+
+/*!
+ * \brief   jpegEncoderEncode()
+ *
+ * \param[in]    enc
+ * \param[in]    pix          any depth; cmap is OK
+ * \param[in]    quality      1 - 100; 75 is default value; 0 is also default
+ * \param[in]    progressive  0 for baseline sequential; 1 for progressive
+ * \param[out]   pdata        jpeg compressed data; owned by %enc
+ * \param[out]   psize        size of returned data
+ * \return  0 if OK, 1 on error
+ *
+ * <pre>
+ * Notes:
+ *      (1) This gives the same result as pixWriteMemJpeg().
+ *      (2) The returned data is owned by the encoder, and is valid
+ *          until the next call on %enc.  Do not free it; copy it if
+ *          it must be kept.
+ *      (3) After a jpeg error, the compressor is rebuilt on the next call.
+ * </pre>
+ */
+l_ok
+jpegEncoderEncode(L_JPEG_ENCODER  *enc,
+                  PIX             *pix,
+                  l_int32          quality,
+                  l_int32          progressive,
+                  const l_uint8  **pdata,
+                  size_t          *psize)
+{
+l_int32  i;
+
+    PROCNAME("jpegEncoderEncode");
+
+    if (pdata) *pdata = NULL;
+    if (psize) *psize = 0;
+    if (!pdata || !psize)
+        return ERROR_INT("&data and &size not both defined", procName, 1);
+    if (!enc)
+        return ERROR_INT("enc not defined", procName, 1);
+    if (!pix)
+        return ERROR_INT("pix not defined", procName, 1);
+
+    if (!enc->created) {
+        enc->cinfo.err = jpeg_std_error(&enc->jerr);
+        enc->cinfo.client_data = (void *)&enc->jmpbuf;
+        enc->jerr.error_exit = jpeg_error_catch_all_1;
+        if (setjmp(enc->jmpbuf))
+            return ERROR_INT("internal jpeg error", procName, 1);
+        jpeg_create_compress(&enc->cinfo);
+        jpegSetMemDest(&enc->cinfo, &enc->dest);
+
+            /* Save the standard huffman tables */
+        enc->cinfo.in_color_space = JCS_RGB;
+        enc->cinfo.input_components = 3;
+        jpeg_set_defaults(&enc->cinfo);
+        for (i = 0; i < 2; i++) {
+            enc->dchuff[i] = *enc->cinfo.dc_huff_tbl_ptrs[i];
+            enc->achuff[i] = *enc->cinfo.ac_huff_tbl_ptrs[i];
+        }
+        enc->created = 1;
+    }
+
+        /* The huffman tables in cinfo are replaced by optimized tables
+         * when the coding is optimized, as it is for progressive jpeg,
+         * and jpeg_set_defaults() does not restore them.  Restore the
+         * standard tables so that each image is encoded as if with a
+         * new compressor. */
+    for (i = 0; i < 2; i++) {
+        *enc->cinfo.dc_huff_tbl_ptrs[i] = enc->dchuff[i];
+        *enc->cinfo.ac_huff_tbl_ptrs[i] = enc->achuff[i];
+    }
+
+    if (jpegCompressPix(&enc->cinfo, pix, quality, progressive)) {
+        jpeg_destroy_compress(&enc->cinfo);  /* safe if already destroyed */
+        enc->created = 0;
+        return ERROR_INT("pix not encoded", procName, 1);
+    }
+    *pdata = enc->dest.buffer;
+    *psize = enc->dest.nbytes;
+    return 0;
+}
+
+
+/*!
+ * \brief   jpegDecoderCreate()
+ *
+ * \return  dec, or NULL on error
+ *
+ * <pre>
+ * Notes:
+ *      (1) A decoder holds a jpeg decompressor that is reused to
+ *          decompress a sequence of images from memory.
+ *      (2) A decoder may be used by only one thread at a time.  For
+ *          concurrent decoding, make one decoder for each thread.
+ * </pre>
+ */
+L_JPEG_DECODER *
+jpegDecoderCreate(void)
+{
+L_JPEG_DECODER  *dec;
+
+    PROCNAME("jpegDecoderCreate");
+
+    if ((dec = (L_JPEG_DECODER *)LEPT_CALLOC(1, sizeof(L_JPEG_DECODER)))
+        == NULL)
+        return (L_JPEG_DECODER *)ERROR_PTR("dec not made", procName, NULL);
+    return dec;
+}
+
+
+/*!
+ * \brief   jpegDecoderDestroy()
+ *
+ * \param[in,out]   pdec    will be set to null before returning
+ * \return  void
+ */
+void
+jpegDecoderDestroy(L_JPEG_DECODER  **pdec)
+{
+L_JPEG_DECODER  *dec;
+
+    PROCNAME("jpegDecoderDestroy");
+
+    if (pdec == NULL) {
+        L_WARNING("ptr address is null!\n", procName);
+        return;
+    }
+    if ((dec = *pdec) == NULL)
+        return;
+
+    if (dec->created)
+        jpeg_destroy_decompress(&dec->cinfo);
+    LEPT_FREE(dec);
+    *pdec = NULL;
+}
+
+
+/*!
+ * \brief   jpegDecoderDecode()
+ *
+ * \param[in]    dec
+ * \param[in]    data       const; jpeg-encoded
+ * \param[in]    size       of data
+ * \param[in]    cmflag     colormap flag 0 means return RGB image if color;
+ *                          1 means create a colormap and return
+ *                          an 8 bpp colormapped image if color
+ * \param[in]    reduction  scaling factor: 1, 2, 4 or 8
+ * \param[out]   pnwarn     [optional] number of warnings
+ * \param[in]    hint       a bitwise OR of L_JPEG_* values; 0 for default
+ * \return  pix, or NULL on error
+ *
+ * <pre>
+ * Notes:
+ *      (1) This gives the same result as pixReadMemJpeg().
+ *      (2) After a jpeg error, the decompressor is rebuilt on the next call.
+ * </pre>
+ */
+PIX *
+jpegDecoderDecode(L_JPEG_DECODER  *dec,
+                  const l_uint8   *data,
+                  size_t           size,
+                  l_int32          cmflag,
+                  l_int32          reduction,
+                  l_int32         *pnwarn,
+                  l_int32          hint)
+{
+PIX  *pix;
+
+    PROCNAME("jpegDecoderDecode");
+
+    if (pnwarn) *pnwarn = 0;
+    if (!dec)
+        return (PIX *)ERROR_PTR("dec not defined", procName, NULL);
+    if (!data)
+        return (PIX *)ERROR_PTR("data not defined", procName, NULL);
+
+    if (!dec->created) {
+        dec->cinfo.err = jpeg_std_error(&dec->jerr);
+        dec->jerr.error_exit = jpeg_error_catch_all_2;
+        dec->cb_data.comment = NULL;
+        dec->cinfo.client_data = (void *)&dec->cb_data;
+        if (setjmp(dec->cb_data.jmpbuf))
+            return (PIX *)ERROR_PTR("internal jpeg error", procName, NULL);
+        jpeg_create_decompress(&dec->cinfo);
+        dec->created = 1;
+    }
+
+    jpegSetMemSource(&dec->cinfo, data, size);
+    if ((pix = jpegDecompressToPix(&dec->cinfo, cmflag, reduction,
+                                   pnwarn, hint)) == NULL) {
+        jpeg_destroy_decompress(&dec->cinfo);  /* safe if already destroyed */
+        dec->created = 0;
+        return (PIX *)ERROR_PTR("pix not decoded", procName, NULL);
+    }
+    return pix;
 }
 
 
@@ -1297,6 +1711,153 @@ struct callback_data  *pcb_data;
     return 1;
 }
 
+
+/*!
+ * \brief   jpegSetMemSource()
+ *
+ * \param[in]    cinfo
+ * \param[in]    data     const; jpeg-encoded
+ * \param[in]    size     of data
+ * \return  void
+ *
+ * <pre>
+ * Notes:
+ *      (1) This sets up the decompressor to read directly from %data.
+ *          The source manager is allocated in the permanent pool of
+ *          %cinfo, so it is made only once for a reused decompressor.
+ *      (2) As with jpeg_stdio_src(), premature end of data is reported
+ *          as a warning, and the decoding is finished with a fake EOI.
+ * </pre>
+ */
+static void
+jpegSetMemSource(struct jpeg_decompress_struct  *cinfo,
+                 const l_uint8                  *data,
+                 size_t                          size)
+{
+struct jpeg_source_mgr  *src;
+
+    if (cinfo->src == NULL) {
+        cinfo->src = (struct jpeg_source_mgr *)(*cinfo->mem->alloc_small)
+            ((j_common_ptr)cinfo, JPOOL_PERMANENT,
+             sizeof(struct jpeg_source_mgr));
+    }
+    src = cinfo->src;
+    src->init_source = jpeg_mem_init_source;
+    src->fill_input_buffer = jpeg_mem_fill_input_buffer;
+    src->skip_input_data = jpeg_mem_skip_input_data;
+    src->resync_to_restart = jpeg_resync_to_restart;  /* use default */
+    src->term_source = jpeg_mem_term_source;
+    src->next_input_byte = (const JOCTET *)data;
+    src->bytes_in_buffer = size;
+}
+
+static void
+jpeg_mem_init_source(j_decompress_ptr cinfo)
+{
+    (void)cinfo;
+}
+
+static boolean
+jpeg_mem_fill_input_buffer(j_decompress_ptr cinfo)
+{
+static const JOCTET  eoibuf[2] = {0xff, JPEG_EOI};
+
+        /* All the data has been consumed.  Warn, and insert a fake EOI
+         * marker so that the decompressor finishes with what it has. */
+    WARNMS(cinfo, JWRN_JPEG_EOF);
+    cinfo->src->next_input_byte = eoibuf;
+    cinfo->src->bytes_in_buffer = 2;
+    return TRUE;
+}
+
+static void
+jpeg_mem_skip_input_data(j_decompress_ptr  cinfo,
+                         long              nbytes)
+{
+struct jpeg_source_mgr  *src = cinfo->src;
+
+    if (nbytes <= 0)
+        return;
+    if ((size_t)nbytes > src->bytes_in_buffer) {
+        (*src->fill_input_buffer)(cinfo);
+    } else {
+        src->next_input_byte += nbytes;
+        src->bytes_in_buffer -= nbytes;
+    }
+}
+
+static void
+jpeg_mem_term_source(j_decompress_ptr cinfo)
+{
+    (void)cinfo;
+}
+
+
+/*!
+ * \brief   jpegSetMemDest()
+ *
+ * \param[in]    cinfo
+ * \param[in]    dest     holds the growable output buffer
+ * \return  void
+ *
+ * <pre>
+ * Notes:
+ *      (1) This sets up the compressor to write into the buffer in
+ *          %dest, which is doubled in size whenever it fills.  The
+ *          buffer is kept between images, and is owned by the caller.
+ * </pre>
+ */
+static void
+jpegSetMemDest(struct jpeg_compress_struct  *cinfo,
+               L_JPEG_MEMDEST               *dest)
+{
+    dest->pub.init_destination = jpeg_mem_init_destination;
+    dest->pub.empty_output_buffer = jpeg_mem_empty_output_buffer;
+    dest->pub.term_destination = jpeg_mem_term_destination;
+    cinfo->dest = &dest->pub;
+}
+
+static void
+jpeg_mem_init_destination(j_compress_ptr cinfo)
+{
+L_JPEG_MEMDEST  *dest = (L_JPEG_MEMDEST *)cinfo->dest;
+
+    if (!dest->buffer) {
+        if ((dest->buffer = (l_uint8 *)LEPT_MALLOC(JpegInitBufferSize))
+            == NULL)
+            ERREXIT1(cinfo, JERR_OUT_OF_MEMORY, 0);
+        dest->size = JpegInitBufferSize;
+    }
+    dest->nbytes = 0;
+    dest->pub.next_output_byte = dest->buffer;
+    dest->pub.free_in_buffer = dest->size;
+}
+
+static boolean
+jpeg_mem_empty_output_buffer(j_compress_ptr cinfo)
+{
+l_uint8         *newbuf;
+L_JPEG_MEMDEST  *dest = (L_JPEG_MEMDEST *)cinfo->dest;
+
+        /* The buffer is full; double it */
+    if ((newbuf = (l_uint8 *)LEPT_REALLOC(dest->buffer, 2 * dest->size))
+        == NULL)
+        ERREXIT1(cinfo, JERR_OUT_OF_MEMORY, 1);
+    dest->buffer = newbuf;
+    dest->pub.next_output_byte = newbuf + dest->size;
+    dest->pub.free_in_buffer = dest->size;
+    dest->size *= 2;
+    return TRUE;
+}
+
+static void
+jpeg_mem_term_destination(j_compress_ptr cinfo)
+{
+L_JPEG_MEMDEST  *dest = (L_JPEG_MEMDEST *)cinfo->dest;
+
+    dest->nbytes = dest->size - dest->pub.free_in_buffer;
+}
+
 /* --------------------------------------------*/
 #endif  /* HAVE_LIBJPEG */
 /* --------------------------------------------*/
@@ -139,6 +139,57 @@ l_ok pixWriteMemJpeg(l_uint8 **pdata, size_t *psize, PIX *pix,
 
 /* ----------------------------------------------------------------------*/
 
+L_JPEG_ENCODER * jpegEncoderCreate(void)
+{
+    return (L_JPEG_ENCODER * )ERROR_PTR("function not present",
+                                        "jpegEncoderCreate", NULL);
+}
+
+/* ----------------------------------------------------------------------*/
+
+void jpegEncoderDestroy(L_JPEG_ENCODER **penc)
+{
+    L_ERROR("function not present\n", "jpegEncoderDestroy");
+    return;
+}
+
+/* ----------------------------------------------------------------------*/
+
+l_ok jpegEncoderEncode(L_JPEG_ENCODER *enc, PIX *pix, l_int32 quality,
+                       l_int32 progressive, const l_uint8 **pdata,
+                       size_t *psize)
+{
+    return ERROR_INT("function not present", "jpegEncoderEncode", 1);
+}
+
+/* ----------------------------------------------------------------------*/
+
+L_JPEG_DECODER * jpegDecoderCreate(void)
+{
+    return (L_JPEG_DECODER * )ERROR_PTR("function not present",
+                                        "jpegDecoderCreate", NULL);
+}
+
+/* ----------------------------------------------------------------------*/
+
+void jpegDecoderDestroy(L_JPEG_DECODER **pdec)
+{
+    L_ERROR("function not present\n", "jpegDecoderDestroy");
+    return;
+}
+
+/* ----------------------------------------------------------------------*/
+
+PIX * jpegDecoderDecode(L_JPEG_DECODER *dec, const l_uint8 *data,
+                        size_t size, l_int32 cmflag, l_int32 reduction,
+                        l_int32 *pnwarn, l_int32 hint)
+{
+    return (PIX * )ERROR_PTR("function not present",
+                             "jpegDecoderDecode", NULL);
+}
+
+/* ----------------------------------------------------------------------*/
+
 l_ok pixSetChromaSampling(PIX *pix, l_int32 sampling)
 {
     return ERROR_INT("function not present", "pixSetChromaSampling", 1);
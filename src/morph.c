@@ -62,6 +62,11 @@
  *         static PIX     *processMorphArgs1()
  *         static PIX     *processMorphArgs2()
  *
+ *     Static helpers for Sels that are solid lines
+ *         static l_int32  selIsSolidLine()
+ *         static void     morphSolidLineLow()
+ *         static void     morphLineWindowLow()
+ *
  *  You are provided with many simple ways to do binary morphology.
  *  In particular, if you are using brick Sels, there are six
  *  convenient methods, all specially tailored for separable operations
@@ -178,10 +183,21 @@ LEPT_DLL l_int32  MORPH_BC = ASYMMETRIC_MORPH_BC;
     /* We accept this cost in extra rasterops for decomposing exactly. */
 static const l_int32  ACCEPTABLE_COST = 5;
 
+    /* Solid line Sels of at least this length are done in
+     * pixDilate() and pixErode() by logarithmic decomposition. */
+static const l_int32  MIN_LOG_LINE_SIZE = 8;
+
     /* Static helpers for arg processing */
 static PIX * processMorphArgs1(PIX *pixd, PIX *pixs, SEL *sel, PIX **ppixt);
 static PIX * processMorphArgs2(PIX *pixd, PIX *pixs, SEL *sel);
 
+    /* Static helpers for Sels that are solid lines */
+static l_int32 selIsSolidLine(SEL *sel);
+static void morphSolidLineLow(PIX *pixd, PIX *pixs, SEL *sel, l_int32 type);
+static void morphLineWindowLow(PIX *pixd, PIX *pixs, PIX *pixt,
+                               l_int32 len, l_int32 dx, l_int32 dy,
+                               l_int32 op);
+
 
 /*-----------------------------------------------------------------*
  *    Generic binary morphological ops implemented with rasterop   *
@@ -222,6 +238,12 @@ PIX     *pixt;
     if ((pixd = processMorphArgs1(pixd, pixs, sel, &pixt)) == NULL)
         return (PIX *)ERROR_PTR("processMorphArgs1 failed", procName, pixd);
 
+    if (selIsSolidLine(sel)) {
+        morphSolidLineLow(pixd, pixt, sel, L_MORPH_DILATE);
+        pixDestroy(&pixt);
+        return pixd;
+    }
+
     pixGetDimensions(pixs, &w, &h, NULL);
     selGetParameters(sel, &sy, &sx, &cy, &cx);
     pixClearAll(pixd);
@@ -279,13 +301,17 @@ PIX     *pixt;
 
     pixGetDimensions(pixs, &w, &h, NULL);
     selGetParameters(sel, &sy, &sx, &cy, &cx);
-    pixSetAll(pixd);
-    for (i = 0; i < sy; i++) {
-        for (j = 0; j < sx; j++) {
-            seldata = sel->data[i][j];
-            if (seldata == 1) {   /* src & dst */
+    if (selIsSolidLine(sel)) {
+        morphSolidLineLow(pixd, pixt, sel, L_MORPH_ERODE);
+    } else {
+        pixSetAll(pixd);
+        for (i = 0; i < sy; i++) {
+            for (j = 0; j < sx; j++) {
+                seldata = sel->data[i][j];
+                if (seldata == 1) {   /* src & dst */
                     pixRasterop(pixd, cx - j, cy - i, w, h, PIX_SRC & PIX_DST,
                                 pixt, 0, 0);
+                }
             }
         }
     }
@@ -1913,3 +1939,139 @@ l_int32  sx, sy;
     pixResizeImageData(pixd, pixs);
     return pixd;
 }
+
+
+/*-----------------------------------------------------------------*
+ *            Static helpers for Sels that are solid lines         *
+ *-----------------------------------------------------------------*/
+/*!
+ * \brief   selIsSolidLine()
+ *
+ * \param[in]    sel
+ * \return  1 if %sel is a horizontal or vertical line of hits with
+ *              at least MIN_LOG_LINE_SIZE elements; 0 otherwise
+ */
+static l_int32
+selIsSolidLine(SEL  *sel)
+{
+l_int32  i, j, sx, sy;
+
+    selGetParameters(sel, &sy, &sx, NULL, NULL);
+    if ((sx != 1 && sy != 1) || L_MAX(sx, sy) < MIN_LOG_LINE_SIZE)
+        return 0;
+    for (i = 0; i < sy; i++) {
+        for (j = 0; j < sx; j++) {
+            if (sel->data[i][j] != SEL_HIT)
+                return 0;
+        }
+    }
+    return 1;
+}
+
+
+/*!
+ * \brief   morphSolidLineLow()
+ *
+ * \param[in]    pixd    same size as pixs; not equal to pixs
+ * \param[in]    pixs
+ * \param[in]    sel     horizontal or vertical line of hits
+ * \param[in]    type    L_MORPH_DILATE or L_MORPH_ERODE
+ * \return  void
+ *
+ * <pre>
+ * Notes:
+ *      (1) A line Sel of length n with origin at c covers an interval
+ *          of n pixels that extends back by c pixels from the origin.
+ *          For the dilation, each dst pixel is the OR of the src pixels
+ *          in the reflected interval, and for the erosion, the AND of
+ *          the src pixels in the interval.  The interval is split at
+ *          the dst pixel into a part extending backward and a part
+ *          extending forward, and each part is computed with about
+ *          log2(n) rasterops by doubling the window.
+ *      (2) This gives the same result as the sum over the Sel hits
+ *          in pixDilate() and pixErode(), in about 4 * log2(n / 2)
+ *          rasterops instead of n.  As in those functions, src pixels
+ *          outside the image are ignored.  The boundary condition for
+ *          erosion is applied by the caller.
+ * </pre>
+ */
+static void
+morphSolidLineLow(PIX     *pixd,
+                  PIX     *pixs,
+                  SEL     *sel,
+                  l_int32  type)
+{
+l_int32  sx, sy, cx, cy, n, c, nback, nfwd, vert, op;
+PIX     *pix1, *pixt;
+
+    selGetParameters(sel, &sy, &sx, &cy, &cx);
+    vert = (sx == 1);
+    n = (vert) ? sy : sx;
+    c = (vert) ? cy : cx;
+    if (type == L_MORPH_DILATE) {
+        nback = n - 1 - c;
+        nfwd = c;
+        op = PIX_SRC | PIX_DST;
+    } else {  /* L_MORPH_ERODE */
+        nback = c;
+        nfwd = n - 1 - c;
+        op = PIX_SRC & PIX_DST;
+    }
+
+    pix1 = pixCreateTemplateNoInit(pixs);
+    pixt = pixCreateTemplateNoInit(pixs);
+    morphLineWindowLow(pixd, pixs, pixt, nback + 1, !vert, vert, op);
+    morphLineWindowLow(pix1, pixs, pixt, nfwd + 1, -(!vert), -vert, op);
+    pixRasterop(pixd, 0, 0, pixGetWidth(pixd), pixGetHeight(pixd), op,
+                pix1, 0, 0);
+    pixDestroy(&pix1);
+    pixDestroy(&pixt);
+}
+
+
+/*!
+ * \brief   morphLineWindowLow()
+ *
+ * \param[in]    pixd     result; same size as pixs
+ * \param[in]    pixs
+ * \param[in]    pixt     temp image; same size as pixs
+ * \param[in]    len      length of window
+ * \param[in]    dx, dy   unit step of window from the dst pixel:
+ *                         (1, 0), (-1, 0), (0, 1) or (0, -1)
+ * \param[in]    op       PIX_SRC | PIX_DST or PIX_SRC & PIX_DST
+ * \return  void
+ *
+ * <pre>
+ * Notes:
+ *      (1) Each dst pixel is the OR (or AND) of the %len src pixels
+ *          starting at the same location and going in the direction
+ *          opposite to (dx, dy).
+ *      (2) With the result for a window of length m, the result for
+ *          length 2m is found by combining it with itself shifted by m.
+ *          The final length is reached by combining the result for the
+ *          largest power of 2 not exceeding %len with itself shifted
+ *          by the remainder; the overlap does no harm.
+ * </pre>
+ */
+static void
+morphLineWindowLow(PIX     *pixd,
+                   PIX     *pixs,
+                   PIX     *pixt,
+                   l_int32  len,
+                   l_int32  dx,
+                   l_int32  dy,
+                   l_int32  op)
+{
+l_int32  w, h, m;
+
+    pixGetDimensions(pixs, &w, &h, NULL);
+    pixCopy(pixd, pixs);
+    for (m = 1; 2 * m <= len; m *= 2) {
+        pixCopy(pixt, pixd);
+        pixRasterop(pixd, m * dx, m * dy, w, h, op, pixt, 0, 0);
+    }
+    if (m < len) {
+        pixCopy(pixt, pixd);
+        pixRasterop(pixd, (len - m) * dx, (len - m) * dy, w, h, op, pixt, 0, 0);
+    }
+}
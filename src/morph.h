@@ -35,6 +35,8 @@
  *      struct Sel
  *      struct Sela
  *      struct Kernel
+ *      struct L_MorphStep
+ *      struct L_MorphProg
  *
  *  Contains definitions for:
  *      morphological b.c. flags
@@ -96,6 +98,34 @@ struct L_Kernel
 typedef struct L_Kernel  L_KERNEL;
 
 
+/*-------------------------------------------------------------------------*
+ *              Compiled binary morphological sequence                     *
+ *-------------------------------------------------------------------------*/
+/*! One step of a compiled binary morphological sequence */
+struct L_MorphStep
+{
+    char          op;        /*!< 'd', 'e', 'o', 'c', 'r', 'x' or 'b'       */
+    l_int32       w;         /*!< brick width; expansion factor; border    */
+    l_int32       h;         /*!< brick height                             */
+    l_int32       level[4];  /*!< rank levels for reduction; 0 if unused   */
+    l_int32       usedwa;    /*!< 1 if the brick op is done with dwa       */
+    char          selh[16];  /*!< dwa sel name for width; "" if w == 1     */
+    char          selv[16];  /*!< dwa sel name for height; "" if h == 1    */
+};
+typedef struct L_MorphStep  L_MORPHSTEP;
+
+/*! Compiled binary morphological sequence */
+struct L_MorphProg
+{
+    l_int32              n;       /*!< number of steps                     */
+    struct L_MorphStep  *step;    /*!< array of steps                      */
+    l_int32              border;  /*!< border added by a 'b' step, or 0    */
+    struct Pix          *pix1;    /*!< dwa work buffer, kept between runs  */
+    struct Pix          *pix2;    /*!< dwa work buffer, kept between runs  */
+};
+typedef struct L_MorphProg  L_MORPHPROG;
+
+
 /*-------------------------------------------------------------------------*
  *                 Morphological boundary condition flags                  *
  *                                                                         *
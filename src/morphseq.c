@@ -43,6 +43,15 @@
  *      Parser verifier for binary morphological operations
  *            l_int32  morphSequenceVerify()
  *
+ *      Compiled binary morphological sequence
+ *            L_MORPHPROG  *morphProgCreate()
+ *            void          morphProgDestroy()
+ *            l_int32       morphProgGetCount()
+ *            PIX          *morphProgRun()
+ *            static l_int32  morphProgFindSels()
+ *            static void     morphProgLoadBuffer()
+ *            static void     morphProgRunDwa()
+ *
  *      Run a sequence of grayscale morphological operations
  *            PIX     *pixGrayMorphSequence()
  *
@@ -58,6 +67,13 @@
 #include <string.h>
 #include "allheaders.h"
 
+static l_int32 morphProgFindSels(SELA *sela, l_int32 w, l_int32 h,
+                                 char *selh, char *selv);
+static void morphProgLoadBuffer(L_MORPHPROG *prog, PIX *pixs,
+                                l_int32 bsize);
+static void morphProgRunDwa(L_MORPHPROG *prog, L_MORPHSTEP *step,
+                            l_int32 bsize);
+
 /*-------------------------------------------------------------------------*
  *         Run a sequence of binary rasterop morphological operations      *
  *-------------------------------------------------------------------------*/
@@ -859,6 +875,421 @@ l_int32  intlogbase2[5] = {1, 2, 3, 0, 4};  /* of arg/4 */
 }
 
 
+/*-------------------------------------------------------------------------*
+ *              Compiled binary morphological sequence                     *
+ *-------------------------------------------------------------------------*/
+/*!
+ * \brief   morphProgCreate()
+ *
+ * \param[in]    sequence   string specifying sequence
+ * \return  prog, or NULL on error
+ *
+ * <pre>
+ * Notes:
+ *      (1) This parses and verifies a binary morphological sequence once,
+ *          for running on many images with morphProgRun().  The format
+ *          of %sequence is the same as for pixMorphSequence(), and
+ *          morphProgRun() gives the same result as pixMorphSequence().
+ *      (2) Adjacent dilations (or adjacent erosions) are merged into
+ *          a single step when the composite Sel is a brick with the
+ *          same origin as a brick Sel of that size.  This holds for
+ *          odd sizes, and for combining a 1-sized dimension with any
+ *          size.  For example, "d3.1 + d1.5 + d5.5" is run as "d7.9".
+ *          Merging is exact: a dilation by A followed by dilation by B
+ *          equals the dilation by the Minkowski sum of A and B, even
+ *          with clipping at the image boundary.
+ *      (3) Each brick step is done with dwa if dwa sels are available
+ *          for both dimensions, and with rasterop otherwise.  Two steps
+ *          that can each be done with dwa are not merged if the merged
+ *          step cannot.  The composite dwa functions are not used,
+ *          because they may approximate the requested brick size.
+ *      (4) Consecutive dwa steps are done on a work image with a border,
+ *          without removing and adding the border between steps.
+ *          The work images are kept in the prog and reused on the next
+ *          run, so a prog must not be used by more than one thread
+ *          at a time.
+ *      (5) The boundary condition, set by resetMorphBoundaryCondition(),
+ *          is read when the prog is run.
+ * </pre>
+ */
+L_MORPHPROG *
+morphProgCreate(const char  *sequence)
+{
+char          *rawop, *op;
+char           name[16];
+l_int32        nops, i, j, nred, w, h;
+L_MORPHPROG   *prog;
+L_MORPHSTEP   *step, *last;
+SARRAY        *sa;
+SELA          *sela;
+
+    PROCNAME("morphProgCreate");
+
+    if (!sequence)
+        return (L_MORPHPROG *)ERROR_PTR("sequence not defined",
+                                        procName, NULL);
+
+    sa = sarrayCreate(0);
+    sarraySplitString(sa, sequence, "+");
+    if (!morphSequenceVerify(sa)) {
+        sarrayDestroy(&sa);
+        return (L_MORPHPROG *)ERROR_PTR("sequence not valid", procName, NULL);
+    }
+
+    nops = sarrayGetCount(sa);
+    prog = (L_MORPHPROG *)LEPT_CALLOC(1, sizeof(L_MORPHPROG));
+    prog->step = (L_MORPHSTEP *)LEPT_CALLOC(L_MAX(1, nops),
+                                            sizeof(L_MORPHSTEP));
+    sela = selaAddBasic(NULL);
+    for (i = 0; i < nops; i++) {
+        rawop = sarrayGetString(sa, i, L_NOCOPY);
+        op = stringRemoveChars(rawop, " \n\t");
+        step = &prog->step[prog->n];
+        switch (op[0])
+        {
+        case 'd':
+        case 'D':
+        case 'e':
+        case 'E':
+        case 'o':
+        case 'O':
+        case 'c':
+        case 'C':
+            step->op = op[0] | 0x20;  /* lower case */
+            sscanf(&op[1], "%d.%d", &step->w, &step->h);
+            break;
+        case 'r':
+        case 'R':
+            step->op = 'r';
+            nred = strlen(op) - 1;
+            for (j = 0; j < nred; j++)
+                step->level[j] = op[j + 1] - '0';
+            break;
+        case 'x':
+        case 'X':
+            step->op = 'x';
+            sscanf(&op[1], "%d", &step->w);
+            break;
+        case 'b':
+        case 'B':
+            step->op = 'b';
+            sscanf(&op[1], "%d", &step->w);
+            prog->border = step->w;
+            break;
+        default:
+            /* All invalid ops are caught by the verifier */
+            break;
+        }
+        LEPT_FREE(op);
+        if (step->op == 'r' || step->op == 'x' || step->op == 'b') {
+            prog->n++;
+            continue;
+        }
+
+            /* Find the dwa sels for the brick */
+        step->usedwa = morphProgFindSels(sela, step->w, step->h,
+                                         step->selh, step->selv);
+
+            /* Merge with the previous step if possible */
+        last = (prog->n > 0) ? &prog->step[prog->n - 1] : NULL;
+        if (last && last->op == step->op &&
+            (step->op == 'd' || step->op == 'e') &&
+            last->w / 2 + step->w / 2 == (last->w + step->w - 1) / 2 &&
+            last->h / 2 + step->h / 2 == (last->h + step->h - 1) / 2) {
+            w = last->w + step->w - 1;
+            h = last->h + step->h - 1;
+            if (morphProgFindSels(sela, w, h, name, name) ||
+                !last->usedwa || !step->usedwa) {
+                last->w = w;
+                last->h = h;
+                last->usedwa = morphProgFindSels(sela, w, h, last->selh,
+                                                 last->selv);
+                memset(step, 0, sizeof(L_MORPHSTEP));
+                continue;
+            }
+        }
+        prog->n++;
+    }
+
+    selaDestroy(&sela);
+    sarrayDestroy(&sa);
+    return prog;
+}
+
+
+/*!
+ * \brief   morphProgDestroy()
+ *
+ * \param[in,out]   pprog    will be set to null before returning
+ * \return  void
+ */
+void
+morphProgDestroy(L_MORPHPROG  **pprog)
+{
+L_MORPHPROG  *prog;
+
+    PROCNAME("morphProgDestroy");
+
+    if (pprog == NULL) {
+        L_WARNING("ptr address is null!\n", procName);
+        return;
+    }
+    if ((prog = *pprog) == NULL)
+        return;
+
+    LEPT_FREE(prog->step);
+    pixDestroy(&prog->pix1);
+    pixDestroy(&prog->pix2);
+    LEPT_FREE(prog);
+    *pprog = NULL;
+}
+
+
+/*!
+ * \brief   morphProgGetCount()
+ *
+ * \param[in]    prog
+ * \return  number of steps after merging, or 0 on error
+ */
+l_int32
+morphProgGetCount(L_MORPHPROG  *prog)
+{
+    PROCNAME("morphProgGetCount");
+
+    if (!prog)
+        return ERROR_INT("prog not defined", procName, 0);
+    return prog->n;
+}
+
+
+/*!
+ * \brief   morphProgRun()
+ *
+ * \param[in]    prog
+ * \param[in]    pixs     1 bpp
+ * \return  pixd, or NULL on error
+ *
+ * <pre>
+ * Notes:
+ *      (1) A new image is always produced; the input image is not changed.
+ *      (2) See morphProgCreate() for details.
+ * </pre>
+ */
+PIX *
+morphProgRun(L_MORPHPROG  *prog,
+             PIX          *pixs)
+{
+l_int32       i, bsize, inbuf;
+PIX          *pix1, *pix2, *pixref;
+L_MORPHSTEP  *step;
+
+    PROCNAME("morphProgRun");
+
+    if (!prog)
+        return (PIX *)ERROR_PTR("prog not defined", procName, NULL);
+    if (!pixs || pixGetDepth(pixs) != 1)
+        return (PIX *)ERROR_PTR("pixs undefined or not 1 bpp",
+                                procName, NULL);
+
+        /* With asymmetric b.c., the safe dwa closing needs another 32
+         * OFF pixels around the image, in addition to the 32 pixel
+         * border used by all dwa operations. */
+    bsize = (getMorphBorderPixelColor(L_MORPH_ERODE, 1) == 0) ? 64 : 32;
+
+    pix1 = pixCopy(NULL, pixs);
+    pixref = NULL;
+    inbuf = FALSE;
+    for (i = 0; i < prog->n; i++) {
+        step = &prog->step[i];
+
+            /* Move the image into or out of the dwa work buffer */
+        if (step->usedwa && !inbuf) {
+            morphProgLoadBuffer(prog, pix1, bsize);
+            pixref = pix1;
+            pix1 = NULL;
+            inbuf = TRUE;
+        } else if (!step->usedwa && inbuf) {
+            pix1 = pixRemoveBorder(prog->pix1, bsize);
+            pixCopyResolution(pix1, pixref);
+            pixCopyText(pix1, pixref);
+            pixCopyInputFormat(pix1, pixref);
+            pixDestroy(&pixref);
+            inbuf = FALSE;
+        }
+
+        if (step->usedwa) {
+            morphProgRunDwa(prog, step, bsize);
+            continue;
+        }
+
+        pix2 = NULL;
+        switch (step->op)
+        {
+        case 'd':
+            pix2 = pixDilateBrick(NULL, pix1, step->w, step->h);
+            break;
+        case 'e':
+            pix2 = pixErodeBrick(NULL, pix1, step->w, step->h);
+            break;
+        case 'o':
+            pixOpenBrick(pix1, pix1, step->w, step->h);
+            break;
+        case 'c':
+            pixCloseSafeBrick(pix1, pix1, step->w, step->h);
+            break;
+        case 'r':
+            pix2 = pixReduceRankBinaryCascade(pix1, step->level[0],
+                                              step->level[1], step->level[2],
+                                              step->level[3]);
+            break;
+        case 'x':
+            pix2 = pixExpandReplicate(pix1, step->w);
+            break;
+        case 'b':
+            pix2 = pixAddBorder(pix1, step->w, 0);
+            break;
+        }
+        if (pix2)
+            pixSwapAndDestroy(&pix1, &pix2);
+    }
+    if (inbuf) {
+        pix1 = pixRemoveBorder(prog->pix1, bsize);
+        pixCopyResolution(pix1, pixref);
+        pixCopyText(pix1, pixref);
+        pixCopyInputFormat(pix1, pixref);
+        pixDestroy(&pixref);
+    }
+
+    if (prog->border > 0) {
+        pix2 = pixRemoveBorder(pix1, prog->border);
+        pixSwapAndDestroy(&pix1, &pix2);
+    }
+    return pix1;
+}
+
+
+/*!
+ * \brief   morphProgFindSels()
+ *
+ * \param[in]    sela      basic sels
+ * \param[in]    w, h      brick size
+ * \param[out]   selh      name of horizontal dwa sel; "" if w == 1
+ * \param[out]   selv      name of vertical dwa sel; "" if h == 1
+ * \return  1 if the brick can be done with dwa; 0 otherwise
+ *
+ * <pre>
+ * Notes:
+ *      (1) The names are written into arrays of size 16.
+ * </pre>
+ */
+static l_int32
+morphProgFindSels(SELA    *sela,
+                  l_int32  w,
+                  l_int32  h,
+                  char    *selh,
+                  char    *selv)
+{
+    selh[0] = selv[0] = '\0';
+    if (w > 1) {
+        snprintf(selh, 16, "sel_%dh", w);
+        if (selaFindSelByName(sela, selh, NULL, NULL))
+            return 0;
+    }
+    if (h > 1) {
+        snprintf(selv, 16, "sel_%dv", h);
+        if (selaFindSelByName(sela, selv, NULL, NULL))
+            return 0;
+    }
+    return 1;
+}
+
+
+/*!
+ * \brief   morphProgLoadBuffer()
+ *
+ * \param[in]    prog
+ * \param[in]    pixs
+ * \param[in]    bsize    border size
+ * \return  void
+ *
+ * <pre>
+ * Notes:
+ *      (1) This copies %pixs into prog->pix1, with a border of OFF
+ *          pixels of width %bsize.  The buffer is reused if it has
+ *          the right size.
+ * </pre>
+ */
+static void
+morphProgLoadBuffer(L_MORPHPROG  *prog,
+                    PIX          *pixs,
+                    l_int32       bsize)
+{
+l_int32  w, h;
+
+    pixGetDimensions(pixs, &w, &h, NULL);
+    if (!prog->pix1 || pixGetWidth(prog->pix1) != w + 2 * bsize ||
+        pixGetHeight(prog->pix1) != h + 2 * bsize) {
+        pixDestroy(&prog->pix1);
+        prog->pix1 = pixCreateNoInit(w + 2 * bsize, h + 2 * bsize, 1);
+    }
+    pixSetOrClearBorder(prog->pix1, bsize, bsize, bsize, bsize, PIX_CLR);
+    pixRasterop(prog->pix1, bsize, bsize, w, h, PIX_SRC, pixs, 0, 0);
+}
+
+
+/*!
+ * \brief   morphProgRunDwa()
+ *
+ * \param[in]    prog
+ * \param[in]    step     brick step to be done with dwa
+ * \param[in]    bsize    border size of the work buffer
+ * \return  void
+ *
+ * <pre>
+ * Notes:
+ *      (1) The image is in prog->pix1, and the result is returned there.
+ *          Each 1-D operation alternates between prog->pix1 and
+ *          prog->pix2.
+ *      (2) The dwa functions read from the outer 32 pixels of the
+ *          border and reset them before each operation.  For a border
+ *          of 64, the inner 32 pixels of the border take the results of
+ *          operations outside the image.  These are cleared at the end
+ *          of the step; keeping them between the dilation and erosion
+ *          of a closing makes it a safe closing.
+ * </pre>
+ */
+static void
+morphProgRunDwa(L_MORPHPROG  *prog,
+                L_MORPHSTEP  *step,
+                l_int32       bsize)
+{
+char    *selname;
+l_int32  i, j, nops;
+l_int32  ops[2];
+PIX     *pixt;
+
+    if (step->op == 'd' || step->op == 'e') {
+        nops = 1;
+        ops[0] = (step->op == 'd') ? L_MORPH_DILATE : L_MORPH_ERODE;
+    } else {
+        nops = 2;
+        ops[0] = (step->op == 'o') ? L_MORPH_ERODE : L_MORPH_DILATE;
+        ops[1] = (step->op == 'o') ? L_MORPH_DILATE : L_MORPH_ERODE;
+    }
+
+    for (i = 0; i < nops; i++) {
+        for (j = 0; j < 2; j++) {
+            selname = (j == 0) ? step->selh : step->selv;
+            if (selname[0] == '\0') continue;
+            pixt = pixFMorphopGen_1(prog->pix2, prog->pix1, ops[i], selname);
+            prog->pix2 = prog->pix1;
+            prog->pix1 = pixt;
+        }
+    }
+    pixSetOrClearBorder(prog->pix1, bsize, bsize, bsize, bsize, PIX_CLR);
+}
+
+
 /*-----------------------------------------------------------------*
  *       Run a sequence of grayscale morphological operations      *
  *-----------------------------------------------------------------*/
@@ -297,6 +297,8 @@ SARRAY  *sa;
  * <pre>
  * Notes:
  *      (1) See convertFilesToPdf().
+ *      (2) Each page is written to %fileout as it is made, so only
+ *          one page is held in memory.
  * </pre>
  */
 l_ok
@@ -308,27 +310,52 @@ saConvertFilesToPdf(SARRAY      *sa,
                     const char  *title,
                     const char  *fileout)
 {
-l_uint8  *data;
-l_int32   ret;
-size_t    nbytes;
+char          *fname;
+const char    *pdftitle;
+l_int32        i, n, scaledres;
+L_PDF_WRITER  *lpw;
+PIX           *pixs, *pix;
 
     PROCNAME("saConvertFilesToPdf");
 
     if (!sa)
         return ERROR_INT("sa not defined", procName, 1);
+    if (!fileout)
+        return ERROR_INT("fileout not defined", procName, 1);
+    if ((n = sarrayGetCount(sa)) == 0)
+        return ERROR_INT("no files in sa", procName, 1);
+    if (scalefactor <= 0.0) scalefactor = 1.0;
+    if (type != L_JPEG_ENCODE && type != L_G4_ENCODE &&
+        type != L_FLATE_ENCODE && type != L_JP2K_ENCODE) {
+        type = L_DEFAULT_ENCODE;
+    }
 
-    ret = saConvertFilesToPdfData(sa, res, scalefactor, type, quality,
-                                  title, &data, &nbytes);
-    if (ret) {
-        if (data) LEPT_FREE(data);
-        return ERROR_INT("pdf data not made", procName, 1);
+        /* Write each page to file as it is generated */
+    pdftitle = (title) ? title : sarrayGetString(sa, 0, L_NOCOPY);
+    if ((lpw = pdfWriterOpen(fileout, pdftitle)) == NULL)
+        return ERROR_INT("pdf writer not made", procName, 1);
+    scaledres = (l_int32)(res * scalefactor);
+    for (i = 0; i < n; i++) {
+        if (i && (i % 10 == 0)) lept_stderr(".. %d ", i);
+        fname = sarrayGetString(sa, i, L_NOCOPY);
+        if ((pixs = pixRead(fname)) == NULL) {
+            L_ERROR("image not readable from file %s\n", procName, fname);
+            continue;
+        }
+        if (scalefactor != 1.0)
+            pix = pixScale(pixs, scalefactor, scalefactor);
+        else
+            pix = pixClone(pixs);
+        pixDestroy(&pixs);
+        if (pdfWriterAddPix(lpw, pix, type, quality, scaledres))
+            L_ERROR("pdf encoding failed for %s\n", procName, fname);
+        pixDestroy(&pix);
     }
+    if (n > 10) lept_stderr("\n");
 
-    ret = l_binaryWrite(fileout, "w", data, nbytes);
-    LEPT_FREE(data);
-    if (ret)
-        L_ERROR("pdf data not written to file\n", procName);
-    return ret;
+    if (pdfWriterClose(&lpw))
+        return ERROR_INT("pdf file not written", procName, 1);
+    return 0;
 }
 
 
@@ -572,6 +599,8 @@ SARRAY  *sa;
  * <pre>
  * Notes:
  *      (1) See convertUnscaledFilesToPdf().
+ *      (2) Each page is written to %fileout as it is made, so only
+ *          one page is held in memory.
  * </pre>
  */
 l_ok
@@ -579,26 +608,41 @@ saConvertUnscaledFilesToPdf(SARRAY      *sa,
                             const char  *title,
                             const char  *fileout)
 {
-l_uint8  *data;
-l_int32   ret;
-size_t    nbytes;
+char          *fname, *tail;
+l_int32        i, n;
+L_PDF_WRITER  *lpw;
 
     PROCNAME("saConvertUnscaledFilesToPdf");
 
     if (!sa)
         return ERROR_INT("sa not defined", procName, 1);
+    if (!fileout)
+        return ERROR_INT("fileout not defined", procName, 1);
+    if ((n = sarrayGetCount(sa)) == 0)
+        return ERROR_INT("no files in sa", procName, 1);
+
+        /* If %title == NULL, use the tail of the first file name */
+    tail = NULL;
+    if (!title) {
+        splitPathAtDirectory(sarrayGetString(sa, 0, L_NOCOPY), NULL, &tail);
+        title = tail;
+    }
+    lpw = pdfWriterOpen(fileout, title);
+    LEPT_FREE(tail);
+    if (!lpw)
+        return ERROR_INT("pdf writer not made", procName, 1);
 
-    ret = saConvertUnscaledFilesToPdfData(sa, title, &data, &nbytes);
-    if (ret) {
-        if (data) LEPT_FREE(data);
-        return ERROR_INT("pdf data not made", procName, 1);
+        /* Write each page to file as it is generated */
+    for (i = 0; i < n; i++) {
+        if (i && (i % 10 == 0)) lept_stderr(".. %d ", i);
+        fname = sarrayGetString(sa, i, L_NOCOPY);
+        pdfWriterAddFile(lpw, fname, 0, 0);
     }
+    if (n > 10) lept_stderr("\n");
 
-    ret = l_binaryWrite(fileout, "w", data, nbytes);
-    LEPT_FREE(data);
-    if (ret)
-        L_ERROR("pdf data not written to file\n", procName);
-    return ret;
+    if (pdfWriterClose(&lpw))
+        return ERROR_INT("pdf file not written", procName, 1);
+    return 0;
 }
 
 
@@ -784,6 +828,8 @@ L_COMP_DATA  *cid;
  *          all images to be compressed with that type.  Use 0 to have
  *          the type determined for each image based on depth and whether
  *          or not it has a colormap.
+ *      (4) Each page is written to %fileout as it is made, so only
+ *          one page is held in memory.
  * </pre>
  */
 l_ok
@@ -795,27 +841,48 @@ pixaConvertToPdf(PIXA        *pixa,
                  const char  *title,
                  const char  *fileout)
 {
-l_uint8  *data;
-l_int32   ret;
-size_t    nbytes;
+l_int32        i, n, scaledres;
+L_PDF_WRITER  *lpw;
+PIX           *pixs, *pix;
 
     PROCNAME("pixaConvertToPdf");
 
     if (!pixa)
         return ERROR_INT("pixa not defined", procName, 1);
+    if (!fileout)
+        return ERROR_INT("fileout not defined", procName, 1);
+    if (scalefactor <= 0.0) scalefactor = 1.0;
+    if (type != L_DEFAULT_ENCODE && type != L_JPEG_ENCODE &&
+        type != L_G4_ENCODE && type != L_FLATE_ENCODE &&
+        type != L_JP2K_ENCODE) {
+        L_WARNING("invalid compression type; using per-page default\n",
+                  procName);
+        type = L_DEFAULT_ENCODE;
+    }
 
-    ret = pixaConvertToPdfData(pixa, res, scalefactor, type, quality,
-                               title, &data, &nbytes);
-    if (ret) {
-        LEPT_FREE(data);
-        return ERROR_INT("conversion to pdf failed", procName, 1);
+        /* Write each page to file as it is generated */
+    if ((lpw = pdfWriterOpen(fileout, title)) == NULL)
+        return ERROR_INT("pdf writer not made", procName, 1);
+    n = pixaGetCount(pixa);
+    scaledres = (l_int32)(res * scalefactor);
+    for (i = 0; i < n; i++) {
+        if ((pixs = pixaGetPix(pixa, i, L_CLONE)) == NULL) {
+            L_ERROR("pix[%d] not retrieved\n", procName, i);
+            continue;
+        }
+        if (scalefactor != 1.0)
+            pix = pixScale(pixs, scalefactor, scalefactor);
+        else
+            pix = pixClone(pixs);
+        pixDestroy(&pixs);
+        if (pdfWriterAddPix(lpw, pix, type, quality, scaledres))
+            L_ERROR("pdf encoding failed for pix[%d]\n", procName, i);
+        pixDestroy(&pix);
     }
 
-    ret = l_binaryWrite(fileout, "w", data, nbytes);
-    LEPT_FREE(data);
-    if (ret)
-        L_ERROR("pdf data not written to file\n", procName);
-    return ret;
+    if (pdfWriterClose(&lpw))
+        return ERROR_INT("conversion to pdf failed", procName, 1);
+    return 0;
 }
 
 
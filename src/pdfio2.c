@@ -36,6 +36,14 @@
  *     Intermediate function for generating multipage pdf output
  *          l_int32              ptraConcatenatePdfToData()
  *
+ *     Streaming multipage pdf output
+ *          L_PDF_WRITER        *pdfWriterOpen()
+ *          l_int32              pdfWriterAddPix()
+ *          l_int32              pdfWriterAddFile()
+ *          l_int32              pdfWriterAddCIData()
+ *          l_int32              pdfWriterClose()
+ *          static void          pdfWriterWrite()
+ *
  *     Convert tiff multipage to pdf file
  *          l_int32              convertTiffMultipageToPdf()
  *
@@ -47,6 +55,7 @@
  *          L_COMP_DATA         *l_generateJpegData()
  *          L_COMP_DATA         *l_generateJpegDataMem()
  *          static L_COMP_DATA  *l_generateJp2kData()
+ *          L_COMP_DATA         *l_generateTiffPageData()
  *
  *       With transcoding
  *          l_int32              l_generateCIData()
@@ -132,6 +141,9 @@ static l_int32       parseTrailerPdf(L_BYTEA *bas, L_DNA **pda);
 static char         *generatePagesObjStringPdf(NUMA *napage);
 static L_BYTEA      *substituteObjectNumbers(L_BYTEA *bas, NUMA *na_objs);
 
+static void          pdfWriterWrite(L_PDF_WRITER *lpw, const void *data,
+                                    size_t size);
+
 static L_PDF_DATA   *pdfdataCreate(const char *title);
 static void          pdfdataDestroy(L_PDF_DATA **plpd);
 static L_COMP_DATA  *pdfdataGetCid(L_PDF_DATA *lpd, l_int32 index);
@@ -465,6 +477,338 @@ NUMAA    *naa_objs;  /* object mapping numbers to new values */
 }
 
 
+/*---------------------------------------------------------------------*
+ *                   Streaming multipage pdf output                    *
+ *---------------------------------------------------------------------*/
+/*!
+ * \brief   pdfWriterOpen()
+ *
+ * \param[in]    fileout    output pdf file
+ * \param[in]    title      [optional] pdf title; can be null
+ * \return  lpw, or NULL on error
+ *
+ * <pre>
+ * Notes:
+ *      (1) This starts a multipage pdf that is written to file as each
+ *          page is added, with pdfWriterAddPix(), pdfWriterAddFile() or
+ *          pdfWriterAddCIData().  The file is completed and closed by
+ *          pdfWriterClose().
+ *      (2) Unlike ptraConcatenatePdfToData(), which holds the pdf
+ *          strings for all pages and the output in memory, this holds
+ *          only one page at a time, along with the locations of the
+ *          objects written so far.
+ *      (3) Each page is generated as a single-page pdf, which is then
+ *          renumbered and written without its header objects and
+ *          trailer.  The Pages object, which needs the object numbers
+ *          of all Page objects, is written after the last page.
+ * </pre>
+ */
+L_PDF_WRITER *
+pdfWriterOpen(const char  *fileout,
+              const char  *title)
+{
+FILE          *fp;
+L_PDF_WRITER  *lpw;
+
+    PROCNAME("pdfWriterOpen");
+
+    if (!fileout)
+        return (L_PDF_WRITER *)ERROR_PTR("fileout not defined", procName, NULL);
+
+    if ((fp = fopenWriteStream(fileout, "wb")) == NULL)
+        return (L_PDF_WRITER *)ERROR_PTR("stream not opened", procName, NULL);
+    lpw = (L_PDF_WRITER *)LEPT_CALLOC(1, sizeof(L_PDF_WRITER));
+    lpw->fp = fp;
+    if (title) lpw->title = stringNew(title);
+    lpw->objloc = l_dnaCreate(0);
+    lpw->napage = numaCreate(0);
+    return lpw;
+}
+
+
+/*!
+ * \brief   pdfWriterAddPix()
+ *
+ * \param[in]    lpw
+ * \param[in]    pix        all depths; cmap OK
+ * \param[in]    type       L_G4_ENCODE, L_JPEG_ENCODE, L_FLATE_ENCODE,
+ *                          L_JP2K_ENCODE; use L_DEFAULT_ENCODE to choose
+ *                          the encoding from the image
+ * \param[in]    quality    for jpeg: 1-100; 0 for default (75)
+ *                          for jp2k: 27-45; 0 for default (34)
+ * \param[in]    res        override the resolution of the input image, in
+ *                          ppi; use 0 to respect the resolution of the pix
+ * \return  0 if OK, 1 on error
+ */
+l_ok
+pdfWriterAddPix(L_PDF_WRITER  *lpw,
+                PIX           *pix,
+                l_int32        type,
+                l_int32        quality,
+                l_int32        res)
+{
+L_COMP_DATA  *cid;
+
+    PROCNAME("pdfWriterAddPix");
+
+    if (!lpw)
+        return ERROR_INT("lpw not defined", procName, 1);
+    if (!pix)
+        return ERROR_INT("pix not defined", procName, 1);
+    if (type != L_JPEG_ENCODE && type != L_G4_ENCODE &&
+        type != L_FLATE_ENCODE && type != L_JP2K_ENCODE) {
+        if (selectDefaultPdfEncoding(pix, &type) != 0)
+            return ERROR_INT("encoding type not selected", procName, 1);
+    }
+
+    pixGenerateCIData(pix, type, quality, 0, &cid);
+    if (!cid)
+        return ERROR_INT("cid not made", procName, 1);
+    return pdfWriterAddCIData(lpw, cid, res);
+}
+
+
+/*!
+ * \brief   pdfWriterAddFile()
+ *
+ * \param[in]    lpw
+ * \param[in]    fname      input image file
+ * \param[in]    quality    for jpeg if transcoded: 1-100; 0 for default (75)
+ *                          for jp2k if transcoded: 27-45; 0 for default (34)
+ * \param[in]    res        override the resolution of the input image, in
+ *                          ppi; use 0 to respect the resolution in the file
+ * \return  0 if OK, 1 on error
+ *
+ * <pre>
+ * Notes:
+ *      (1) Where possible, the compressed data in the file is written
+ *          to the pdf without transcoding: jpeg and jp2k data, flate
+ *          data from non-interlaced png, and tiff g4 and jpeg data.
+ *          For tiff, only the first page is used.
+ *      (2) Other formats are decoded and encoded with the default
+ *          encoding for the image.
+ * </pre>
+ */
+l_ok
+pdfWriterAddFile(L_PDF_WRITER  *lpw,
+                 const char    *fname,
+                 l_int32        quality,
+                 l_int32        res)
+{
+l_int32       format;
+L_COMP_DATA  *cid;
+
+    PROCNAME("pdfWriterAddFile");
+
+    if (!lpw)
+        return ERROR_INT("lpw not defined", procName, 1);
+    if (!fname)
+        return ERROR_INT("fname not defined", procName, 1);
+
+    findFileFormat(fname, &format);
+    if (format == IFF_UNKNOWN) {
+        L_WARNING("file %s format is unknown; skip\n", procName, fname);
+        return 1;
+    }
+    if (format == IFF_PS || format == IFF_LPDF) {
+        L_WARNING("file %s format is %d; skip\n", procName, fname, format);
+        return 1;
+    }
+
+    cid = NULL;
+    if (format == IFF_TIFF_G4 || format == IFF_TIFF_JPEG)
+        cid = l_generateTiffPageData(fname, NULL, 0);
+    if (!cid)
+        l_generateCIDataForPdf(fname, NULL, quality, &cid);
+    if (!cid) {
+        L_ERROR("file %s format is %d; unreadable\n", procName, fname, format);
+        return 1;
+    }
+    return pdfWriterAddCIData(lpw, cid, res);
+}
+
+
+/*!
+ * \brief   pdfWriterAddCIData()
+ *
+ * \param[in]    lpw
+ * \param[in]    cid        compressed image data for the page
+ * \param[in]    res        override the resolution of the image, in ppi;
+ *                          use 0 to respect the resolution in %cid
+ * \return  0 if OK, 1 on error
+ *
+ * <pre>
+ * Notes:
+ *      (1) Caller must not destroy the cid.  It is absorbed and
+ *          destroyed by this function.
+ *      (2) For the first page, the header and the Catalog and Info
+ *          objects are written.  For every page, the remaining objects
+ *          (Page, Contents, XObjects and ColorSpace) are renumbered
+ *          and appended to the file.
+ * </pre>
+ */
+l_ok
+pdfWriterAddCIData(L_PDF_WRITER  *lpw,
+                   L_COMP_DATA   *cid,
+                   l_int32        res)
+{
+l_uint8  *pdfdata, *data;
+l_int32   j, nobj;
+l_int32  *sizes, *locs;
+size_t    nbytes, size;
+L_BYTEA  *bas, *bat1, *bat2;
+L_DNA    *da_locs, *da_sizes;
+NUMA     *na_objs;
+
+    PROCNAME("pdfWriterAddCIData");
+
+    if (!lpw)
+        return ERROR_INT("lpw not defined", procName, 1);
+    if (!cid)
+        return ERROR_INT("cid not defined", procName, 1);
+
+        /* Make the single-page pdf and find the object locations */
+    if (res > 0) cid->res = res;
+    if (cidConvertToPdfData(cid, (lpw->npages == 0) ? lpw->title : NULL,
+                            &pdfdata, &nbytes))
+        return ERROR_INT("pdf data not made", procName, 1);
+    bas = l_byteaInitFromMem(pdfdata, nbytes);
+    LEPT_FREE(pdfdata);
+    if (parseTrailerPdf(bas, &da_locs) != 0) {
+        l_byteaDestroy(&bas);
+        return ERROR_INT("pdf data not parsed", procName, 1);
+    }
+    pdfdata = l_byteaGetData(bas, &size);
+    nobj = l_dnaGetCount(da_locs) - 1;
+    da_sizes = l_dnaDiffAdjValues(da_locs);
+    sizes = l_dnaGetIArray(da_sizes);
+    locs = l_dnaGetIArray(da_locs);
+
+        /* The header and objects 1 and 2 are taken from the first page.
+         * The location of the Pages object (3) is set at the end. */
+    if (lpw->npages == 0) {
+        pdfWriterWrite(lpw, pdfdata, locs[3]);
+        for (j = 0; j < 3; j++)
+            l_dnaAddNumber(lpw->objloc, locs[j]);
+        l_dnaAddNumber(lpw->objloc, 0);
+        lpw->nobj = 4;
+    }
+
+        /* Map the object numbers on this page to the output numbers.
+         * All Page objects refer to the same parent (object 3). */
+    numaAddNumber(lpw->napage, lpw->nobj);  /* the Page object is first */
+    na_objs = numaMakeConstant(0.0, nobj);
+    numaReplaceNumber(na_objs, 3, 3);
+    for (j = 4; j < nobj; j++)
+        numaReplaceNumber(na_objs, j, lpw->nobj++);
+
+        /* Write the renumbered objects of this page */
+    for (j = 4; j < nobj; j++) {
+        l_dnaAddNumber(lpw->objloc, lpw->nbytes);
+        bat1 = l_byteaInitFromMem(pdfdata + locs[j], sizes[j]);
+        bat2 = substituteObjectNumbers(bat1, na_objs);
+        data = l_byteaGetData(bat2, &size);
+        pdfWriterWrite(lpw, data, size);
+        l_byteaDestroy(&bat1);
+        l_byteaDestroy(&bat2);
+    }
+    lpw->npages++;
+
+    LEPT_FREE(sizes);
+    LEPT_FREE(locs);
+    l_dnaDestroy(&da_locs);
+    l_dnaDestroy(&da_sizes);
+    numaDestroy(&na_objs);
+    l_byteaDestroy(&bas);
+    if (lpw->error)
+        return ERROR_INT("write to stream failed", procName, 1);
+    return 0;
+}
+
+
+/*!
+ * \brief   pdfWriterClose()
+ *
+ * \param[in,out]   plpw    will be set to null before returning
+ * \return  0 if OK, 1 on error
+ *
+ * <pre>
+ * Notes:
+ *      (1) This writes the Pages object and the trailer, closes the
+ *          file and destroys the writer.
+ *      (2) It is an error if no pages have been added.  The file is
+ *          closed in any case.
+ * </pre>
+ */
+l_ok
+pdfWriterClose(L_PDF_WRITER  **plpw)
+{
+char          *str_pages, *str_trailer;
+l_int32        ret;
+L_PDF_WRITER  *lpw;
+
+    PROCNAME("pdfWriterClose");
+
+    if (!plpw)
+        return ERROR_INT("&lpw not defined", procName, 1);
+    if ((lpw = *plpw) == NULL)
+        return ERROR_INT("lpw not defined", procName, 1);
+
+    ret = 0;
+    if (lpw->npages == 0) {
+        L_ERROR("no pages were written\n", procName);
+        ret = 1;
+    } else {
+        l_dnaSetValue(lpw->objloc, 3, lpw->nbytes);
+        str_pages = generatePagesObjStringPdf(lpw->napage);
+        pdfWriterWrite(lpw, str_pages, strlen(str_pages));
+        pdfWriterWrite(lpw, "endobj\n", 7);
+        l_dnaAddNumber(lpw->objloc, lpw->nbytes);  /* xref location */
+        str_trailer = makeTrailerStringPdf(lpw->objloc);
+        pdfWriterWrite(lpw, str_trailer, strlen(str_trailer));
+        LEPT_FREE(str_pages);
+        LEPT_FREE(str_trailer);
+        if (lpw->error) {
+            L_ERROR("write to stream failed\n", procName);
+            ret = 1;
+        }
+    }
+
+    if (fclose(lpw->fp) != 0) ret = 1;
+    if (lpw->title) LEPT_FREE(lpw->title);
+    l_dnaDestroy(&lpw->objloc);
+    numaDestroy(&lpw->napage);
+    LEPT_FREE(lpw);
+    *plpw = NULL;
+    return ret;
+}
+
+
+/*!
+ * \brief   pdfWriterWrite()
+ *
+ * \param[in]    lpw
+ * \param[in]    data     bytes to be written
+ * \param[in]    size     number of bytes
+ * \return  void
+ *
+ * <pre>
+ * Notes:
+ *      (1) This keeps the count of bytes written, which gives the
+ *          location of the next object without calling ftell().
+ * </pre>
+ */
+static void
+pdfWriterWrite(L_PDF_WRITER  *lpw,
+               const void    *data,
+               size_t         size)
+{
+    if (fwrite(data, 1, size, lpw->fp) != size)
+        lpw->error = TRUE;
+    lpw->nbytes += size;
+}
+
+
 /*---------------------------------------------------------------------*
  *                  Convert tiff multipage to pdf file                 *
  *---------------------------------------------------------------------*/
@@ -479,15 +823,26 @@ NUMAA    *naa_objs;  /* object mapping numbers to new values */
  * Notes:
  *      (1) A multipage tiff file can also be converted to PS, using
  *          convertTiffMultipageToPS()
+ *      (2) Pages that are a single strip of g4 or jpeg data are copied
+ *          into the pdf without decoding; see
+ *          extractTiffPageCompressedData().  Other pages are decoded
+ *          and encoded with the default encoding for the image.
+ *      (3) The pages are located with a tiff index and written to
+ *          %fileout one at a time, so the time is linear in the
+ *          number of pages and only one page is held in memory.
  * </pre>
  */
 l_ok
 convertTiffMultipageToPdf(const char  *filein,
                           const char  *fileout)
 {
-l_int32  istiff;
-PIXA    *pixa;
-FILE    *fp;
+char          *tail;
+l_int32        i, n, istiff;
+FILE          *fp;
+L_COMP_DATA   *cid;
+L_PDF_WRITER  *lpw;
+L_TIFFINDEX   *tindex;
+PIX           *pix;
 
     PROCNAME("convertTiffMultipageToPdf");
 
@@ -498,9 +853,33 @@ FILE    *fp;
     if (!istiff)
         return ERROR_INT("file not tiff format", procName, 1);
 
-    pixa = pixaReadMultipageTiff(filein);
-    pixaConvertToPdf(pixa, 0, 1.0, 0, 0, "weasel2", fileout);
-    pixaDestroy(&pixa);
+    if ((tindex = tiffIndexCreate(filein)) == NULL)
+        return ERROR_INT("tindex not made", procName, 1);
+    splitPathAtDirectory(filein, NULL, &tail);
+    lpw = pdfWriterOpen(fileout, tail);
+    LEPT_FREE(tail);
+    if (!lpw) {
+        tiffIndexDestroy(&tindex);
+        return ERROR_INT("pdf writer not made", procName, 1);
+    }
+
+    n = tiffIndexGetCount(tindex);
+    for (i = 0; i < n; i++) {
+        if ((cid = l_generateTiffPageData(filein, tindex, i)) != NULL) {
+            pdfWriterAddCIData(lpw, cid, 0);
+            continue;
+        }
+        if ((pix = pixReadTiffIndexed(filein, tindex, i)) == NULL) {
+            L_ERROR("page %d not read\n", procName, i);
+            continue;
+        }
+        pdfWriterAddPix(lpw, pix, L_DEFAULT_ENCODE, 0, 0);
+        pixDestroy(&pix);
+    }
+
+    tiffIndexDestroy(&tindex);
+    if (pdfWriterClose(&lpw))
+        return ERROR_INT("pdf file not written", procName, 1);
     return 0;
 }
 
@@ -949,6 +1328,69 @@ FILE         *fp;
 }
 
 
+/*!
+ * \brief   l_generateTiffPageData()
+ *
+ * \param[in]    fname     tiff file
+ * \param[in]    tindex    [optional] index made from %fname; can be null
+ * \param[in]    page      0-based page number
+ * \return  cid containing g4 or jpeg data, or NULL if the page
+ *              can not be used without decoding, or on error
+ *
+ * <pre>
+ * Notes:
+ *      (1) The compressed data of the page is copied without decoding,
+ *          for a CCITTFaxDecode or DCTDecode stream in pdf.  The
+ *          requirements are given in extractTiffPageCompressedData().
+ *      (2) A null return for a page that must be decoded is not an
+ *          error, and no message is given.
+ * </pre>
+ */
+L_COMP_DATA *
+l_generateTiffPageData(const char   *fname,
+                       L_TIFFINDEX  *tindex,
+                       l_int32       page)
+{
+l_uint8      *data;
+l_int32       comptype, w, h, minisblack, res;
+size_t        nbytes;
+L_COMP_DATA  *cid;
+
+    PROCNAME("l_generateTiffPageData");
+
+    if (!fname)
+        return (L_COMP_DATA *)ERROR_PTR("fname not defined", procName, NULL);
+
+    if (extractTiffPageCompressedData(fname, tindex, page, &comptype, &data,
+                                      &nbytes, &w, &h, &minisblack, &res))
+        return (L_COMP_DATA *)ERROR_PTR("page data not read", procName, NULL);
+    if (comptype == IFF_UNKNOWN)
+        return NULL;
+
+    if (comptype == IFF_TIFF_JPEG) {
+            /* The jpeg header must agree with the tiff header */
+        if ((cid = l_generateJpegDataMem(data, nbytes, 0)) == NULL)
+            return NULL;
+        if (cid->w != w || cid->h != h) {
+            l_CIDataDestroy(&cid);
+            return NULL;
+        }
+    } else {  /* IFF_TIFF_G4 */
+        cid = (L_COMP_DATA *)LEPT_CALLOC(1, sizeof(L_COMP_DATA));
+        cid->datacomp = data;
+        cid->type = L_G4_ENCODE;
+        cid->nbytescomp = nbytes;
+        cid->w = w;
+        cid->h = h;
+        cid->bps = 1;
+        cid->spp = 1;
+        cid->minisblack = minisblack;
+    }
+    cid->res = res;
+    return cid;
+}
+
+
 /*!
  * \brief   l_generateCIData()
  *
@@ -2119,10 +2561,11 @@ L_DNA   *daloc, *dasize;
 static char *
 makeTrailerStringPdf(L_DNA  *daloc)
 {
-char    *outstr;
-char     buf[L_BIGBUF];
-l_int32  i, n, linestart, xrefloc;
-SARRAY  *sa;
+char      *outstr;
+char       buf[L_BIGBUF];
+l_int32    i, n;
+l_float64  linestart, xrefloc;
+SARRAY    *sa;
 
     PROCNAME("makeTrailerStringPdf");
 
@@ -2136,12 +2579,12 @@ SARRAY  *sa;
                                "0000000000 65535 f \n", n);
     sarrayAddString(sa, buf, L_COPY);
     for (i = 1; i < n; i++) {
-        l_dnaGetIValue(daloc, i, &linestart);
-        snprintf(buf, sizeof(buf), "%010d 00000 n \n", linestart);
+        l_dnaGetDValue(daloc, i, &linestart);
+        snprintf(buf, sizeof(buf), "%010.0f 00000 n \n", linestart);
         sarrayAddString(sa, buf, L_COPY);
     }
 
-    l_dnaGetIValue(daloc, n, &xrefloc);
+    l_dnaGetDValue(daloc, n, &xrefloc);
     snprintf(buf, sizeof(buf), "trailer\n"
                                "<<\n"
                                "/Size %d\n"
@@ -2149,7 +2592,7 @@ SARRAY  *sa;
                                "/Info 2 0 R\n"
                                ">>\n"
                                "startxref\n"
-                               "%d\n"
+                               "%.0f\n"
                                "%%%%EOF\n", n, xrefloc);
     sarrayAddString(sa, buf, L_COPY);
     outstr = sarrayToString(sa, 0);
@@ -63,6 +63,44 @@ l_ok ptraConcatenatePdfToData(L_PTRA *pa_data, SARRAY *sa,
 
 /* ----------------------------------------------------------------------*/
 
+L_PDF_WRITER * pdfWriterOpen(const char *fileout, const char *title)
+{
+    return (L_PDF_WRITER *)ERROR_PTR("function not present",
+                                     "pdfWriterOpen", NULL);
+}
+
+/* ----------------------------------------------------------------------*/
+
+l_ok pdfWriterAddPix(L_PDF_WRITER *lpw, PIX *pix, l_int32 type,
+                     l_int32 quality, l_int32 res)
+{
+    return ERROR_INT("function not present", "pdfWriterAddPix", 1);
+}
+
+/* ----------------------------------------------------------------------*/
+
+l_ok pdfWriterAddFile(L_PDF_WRITER *lpw, const char *fname,
+                      l_int32 quality, l_int32 res)
+{
+    return ERROR_INT("function not present", "pdfWriterAddFile", 1);
+}
+
+/* ----------------------------------------------------------------------*/
+
+l_ok pdfWriterAddCIData(L_PDF_WRITER *lpw, L_COMP_DATA *cid, l_int32 res)
+{
+    return ERROR_INT("function not present", "pdfWriterAddCIData", 1);
+}
+
+/* ----------------------------------------------------------------------*/
+
+l_ok pdfWriterClose(L_PDF_WRITER **plpw)
+{
+    return ERROR_INT("function not present", "pdfWriterClose", 1);
+}
+
+/* ----------------------------------------------------------------------*/
+
 l_ok convertTiffMultipageToPdf(const char *filein, const char *fileout)
 {
     return ERROR_INT("function not present", "convertTiffMultipageToPdf", 1);
@@ -103,6 +141,15 @@ L_COMP_DATA * l_generateJpegDataMem(l_uint8 *data, size_t nbytes,
 
 /* ----------------------------------------------------------------------*/
 
+L_COMP_DATA * l_generateTiffPageData(const char *fname, L_TIFFINDEX *tindex,
+                                     l_int32 page)
+{
+    return (L_COMP_DATA *)ERROR_PTR("function not present",
+                                    "l_generateTiffPageData", NULL);
+}
+
+/* ----------------------------------------------------------------------*/
+
 l_ok l_generateCIData(const char *fname, l_int32 type, l_int32 quality,
                       l_int32 ascii85, L_COMP_DATA **pcid)
 {
@@ -0,0 +1,894 @@
+/*====================================================================*
+ -  Copyright (C) 2001 Leptonica.  All rights reserved.
+ -
+ -  Redistribution and use in source and binary forms, with or without
+ -  modification, are permitted provided that the following conditions
+ -  are met:
+ -  1. Redistributions of source code must retain the above copyright
+ -     notice, this list of conditions and the following disclaimer.
+ -  2. Redistributions in binary form must reproduce the above
+ -     copyright notice, this list of conditions and the following
+ -     disclaimer in the documentation and/or other materials
+ -     provided with the distribution.
+ -
+ -  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ -  ``AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ -  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ -  A PARTICULAR PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL ANY
+ -  CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ -  EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ -  PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ -  PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ -  OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ -  NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ -  SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *====================================================================*/
+
+/*!
+ * \file  pipeline.c
+ * <pre>
+ *
+ *      Create/destroy
+ *          L_PIPELINE      *pipelineCreate()
+ *          void             pipelineDestroy()
+ *
+ *      Adding stages
+ *          l_int32          pipelineAddReduceRankBinary2()
+ *          l_int32          pipelineAddScaleToGray()
+ *          l_int32          pipelineAddThresholdToBinary()
+ *          l_int32          pipelineAddConvertRGBToGray()
+ *          l_int32          pipelineAddBlockconv()
+ *          l_int32          pipelineAddRankFilter()
+ *          l_int32          pipelineAddBrickMorph()
+ *          static l_int32   pipelineAddStage()
+ *
+ *      Running
+ *          PIX             *pipelineRunPix()
+ *          l_int32          pipelineRunTiff()
+ *          static l_int32   pipelineRun()
+ *          static PIX      *pipeGetRows()
+ *          static PIX      *pipeComputeRows()
+ *          static PIX      *pipeApplyStage()
+ *          static PIX      *pipeClipRows()
+ *          static PIX      *pipeJoinRows()
+ *
+ *   A pipeline is a sequence of operations on an image, such as
+ *
+ *       L_PIPELINE  *pipe = pipelineCreate();
+ *       pipelineAddConvertRGBToGray(pipe, 0.0, 0.0, 0.0);
+ *       pipelineAddBlockconv(pipe, 10, 10);
+ *       pipelineAddThresholdToBinary(pipe, 128);
+ *       pipelineAddBrickMorph(pipe, L_MORPH_CLOSE, 5, 5);
+ *       pipelineRunTiff(pipe, "in.tif", 0, "out.tif", IFF_TIFF_G4, 64);
+ *       pipelineDestroy(&pipe);
+ *
+ *   that is run on the image in bands of rows.  The result is identical
+ *   to applying the operations in sequence on the full image, but
+ *   only a window of rows is held at each stage.  With a tiff reader
+ *   as source and a tiff writer as sink, this allows processing of
+ *   images that are too large to hold in memory.
+ *
+ *   Each stage has a vertical reduction factor r and a vertical
+ *   support m.  Output row i of the stage depends only on input rows
+ *   in [r * i - m, r * (i + 1) + m).  The operations are those for
+ *   which this holds, with the image boundary treated identically for
+ *   a band that touches it:
+ *       pixReduceRankBinary2()          r = 2, m = 0
+ *       pixScaleToGray()                r = factor, m = 0
+ *       pixThresholdToBinary()          r = 1, m = 0
+ *       pixConvertRGBToGray()           r = 1, m = 0
+ *       pixBlockconv()                  r = 1, m = hc + 1
+ *       pixRankFilter()                 r = 1, m = hf
+ *       brick dilation and erosion      r = 1, m = vsize
+ *       brick opening and closing       r = 1, m = 2 * vsize
+ *
+ *   The pipeline is run by pulling rows from the end: a band of output
+ *   rows is requested from the last stage, which requests the rows it
+ *   needs from the stage before it, and so on back to the source.
+ *   Requests at each stage move monotonically down the image, so each
+ *   stage keeps a window of its output rows that starts with the
+ *   first row that can still be needed by the following stage.  Rows
+ *   computed at the bottom of a band are kept in the window and are
+ *   not recomputed; rows in the support region of a band are computed
+ *   twice, in adjacent bands.  Thus the number of rows live at any
+ *   stage is about (band height) + 2 * (support), scaled by the
+ *   reductions of the following stages.
+ *
+ *   Bands are extended so that, except when a band covers the full
+ *   image, each band given to an operation has at least 2 * m + 1 rows.
+ *   This is needed by pixBlockconv(), which reduces the filter size
+ *   for small images.
+ *
+ *   The pipeline is run in a single thread.  A pipeline holds no state
+ *   of a run, so one pipeline may be run on several images.
+ * </pre>
+ */
+
+#ifdef HAVE_CONFIG_H
+#include <config_auto.h>
+#endif  /* HAVE_CONFIG_H */
+
+#include "allheaders.h"
+
+    /* Default number of stages allocated */
+static const l_int32  InitialStages = 8;
+
+    /* State of one level of a pipeline that is being run.
+     * Level 0 is the source image, and level k + 1 is the output of
+     * stage k.  The window holds rows [y0, y0 + (height of pixw)). */
+struct PipeLevel
+{
+    PIX      *pixw;      /* window of rows at this level               */
+    l_int32   y0;        /* first row in the window                    */
+    l_int32   y1;        /* row following the last row in the window   */
+    l_int32   h;         /* height of the full image at this level     */
+};
+
+    /* State of a pipeline that is being run */
+struct PipeRun
+{
+    L_PIPELINE        *pipe;    /* the pipeline                         */
+    PIX               *pixs;    /* source image, if in memory           */
+    L_TIFF_READER     *reader;  /* source image, if read in bands       */
+    struct PipeLevel  *level;   /* array of (pipe->n + 1) levels        */
+};
+
+static l_int32 pipelineAddStage(L_PIPELINE *pipe, l_int32 op,
+                                l_int32 reduction, l_int32 support,
+                                l_int32 i0, l_int32 i1, l_int32 i2,
+                                l_float32 f0, l_float32 f1, l_float32 f2);
+static l_int32 pipelineRun(L_PIPELINE *pipe, PIX *pixs,
+                           L_TIFF_READER *reader, l_int32 bandh,
+                           PIX **ppixd, const char *fileout,
+                           l_int32 comptype);
+static PIX *pipeGetRows(struct PipeRun *run, l_int32 k, l_int32 y0,
+                        l_int32 y1);
+static PIX *pipeComputeRows(struct PipeRun *run, l_int32 k, l_int32 y0,
+                            l_int32 y1);
+static PIX *pipeApplyStage(L_PIPESTAGE *stage, PIX *pixs);
+static PIX *pipeClipRows(PIX *pixs, l_int32 y0, l_int32 nrows);
+static PIX *pipeJoinRows(PIX *pix1, l_int32 y0, PIX *pix2);
+
+
+/*------------------------------------------------------------------------*
+ *                           Create/destroy                               *
+ *------------------------------------------------------------------------*/
+/*!
+ * \brief   pipelineCreate()
+ *
+ * \return  pipe, or NULL on error
+ */
+L_PIPELINE *
+pipelineCreate(void)
+{
+L_PIPELINE  *pipe;
+
+    pipe = (L_PIPELINE *)LEPT_CALLOC(1, sizeof(L_PIPELINE));
+    pipe->nalloc = InitialStages;
+    pipe->stage = (L_PIPESTAGE *)LEPT_CALLOC(InitialStages,
+                                             sizeof(L_PIPESTAGE));
+    return pipe;
+}
+
+
+/*!
+ * \brief   pipelineDestroy()
+ *
+ * \param[in,out]   ppipe    will be set to null before returning
+ * \return  void
+ */
+void
+pipelineDestroy(L_PIPELINE  **ppipe)
+{
+L_PIPELINE  *pipe;
+
+    PROCNAME("pipelineDestroy");
+
+    if (ppipe == NULL) {
+        L_WARNING("ptr address is null!\n", procName);
+        return;
+    }
+    if ((pipe = *ppipe) == NULL)
+        return;
+
+    LEPT_FREE(pipe->stage);
+    LEPT_FREE(pipe);
+    *ppipe = NULL;
+}
+
+
+/*------------------------------------------------------------------------*
+ *                            Adding stages                               *
+ *------------------------------------------------------------------------*/
+/*!
+ * \brief   pipelineAddReduceRankBinary2()
+ *
+ * \param[in]    pipe
+ * \param[in]    level    rank threshold: 1, 2, 3, 4
+ * \return  0 if OK, 1 on error
+ *
+ * <pre>
+ * Notes:
+ *      (1) This adds a 2x rank binary reduction; see
+ *          pixReduceRankBinary2().  The input must be 1 bpp.
+ * </pre>
+ */
+l_ok
+pipelineAddReduceRankBinary2(L_PIPELINE  *pipe,
+                             l_int32      level)
+{
+    PROCNAME("pipelineAddReduceRankBinary2");
+
+    if (!pipe)
+        return ERROR_INT("pipe not defined", procName, 1);
+    if (level < 1 || level > 4)
+        return ERROR_INT("level must be in set {1,2,3,4}", procName, 1);
+    return pipelineAddStage(pipe, L_PIPE_REDUCE_RANK_BINARY2, 2, 0,
+                            level, 0, 0, 0.0, 0.0, 0.0);
+}
+
+
+/*!
+ * \brief   pipelineAddScaleToGray()
+ *
+ * \param[in]    pipe
+ * \param[in]    factor    reduction factor: 2, 3, 4, 6, 8 or 16
+ * \return  0 if OK, 1 on error
+ *
+ * <pre>
+ * Notes:
+ *      (1) This adds a scale-to-gray reduction of a 1 bpp image, using
+ *          pixScaleToGray2() ... pixScaleToGray16().
+ * </pre>
+ */
+l_ok
+pipelineAddScaleToGray(L_PIPELINE  *pipe,
+                       l_int32      factor)
+{
+    PROCNAME("pipelineAddScaleToGray");
+
+    if (!pipe)
+        return ERROR_INT("pipe not defined", procName, 1);
+    if (factor != 2 && factor != 3 && factor != 4 && factor != 6 &&
+        factor != 8 && factor != 16)
+        return ERROR_INT("invalid factor", procName, 1);
+    return pipelineAddStage(pipe, L_PIPE_SCALE_TO_GRAY, factor, 0,
+                            factor, 0, 0, 0.0, 0.0, 0.0);
+}
+
+
+/*!
+ * \brief   pipelineAddThresholdToBinary()
+ *
+ * \param[in]    pipe
+ * \param[in]    thresh    threshold value; see pixThresholdToBinary()
+ * \return  0 if OK, 1 on error
+ */
+l_ok
+pipelineAddThresholdToBinary(L_PIPELINE  *pipe,
+                             l_int32      thresh)
+{
+    PROCNAME("pipelineAddThresholdToBinary");
+
+    if (!pipe)
+        return ERROR_INT("pipe not defined", procName, 1);
+    if (thresh < 0)
+        return ERROR_INT("thresh must be non-negative", procName, 1);
+    return pipelineAddStage(pipe, L_PIPE_THRESHOLD_TO_BINARY, 1, 0,
+                            thresh, 0, 0, 0.0, 0.0, 0.0);
+}
+
+
+/*!
+ * \brief   pipelineAddConvertRGBToGray()
+ *
+ * \param[in]    pipe
+ * \param[in]    rwt, gwt, bwt    non-negative; these should add to 1.0,
+ *                                or use 0.0 for default
+ * \return  0 if OK, 1 on error
+ */
+l_ok
+pipelineAddConvertRGBToGray(L_PIPELINE  *pipe,
+                            l_float32    rwt,
+                            l_float32    gwt,
+                            l_float32    bwt)
+{
+    PROCNAME("pipelineAddConvertRGBToGray");
+
+    if (!pipe)
+        return ERROR_INT("pipe not defined", procName, 1);
+    if (rwt < 0.0 || gwt < 0.0 || bwt < 0.0)
+        return ERROR_INT("weights not all >= 0.0", procName, 1);
+    return pipelineAddStage(pipe, L_PIPE_CONVERT_RGB_TO_GRAY, 1, 0,
+                            0, 0, 0, rwt, gwt, bwt);
+}
+
+
+/*!
+ * \brief   pipelineAddBlockconv()
+ *
+ * \param[in]    pipe
+ * \param[in]    wc, hc   half width/height of convolution kernel
+ * \return  0 if OK, 1 on error
+ *
+ * <pre>
+ * Notes:
+ *      (1) This adds a block convolution of an 8 or 32 bpp image;
+ *          see pixBlockconv().
+ * </pre>
+ */
+l_ok
+pipelineAddBlockconv(L_PIPELINE  *pipe,
+                     l_int32      wc,
+                     l_int32      hc)
+{
+    PROCNAME("pipelineAddBlockconv");
+
+    if (!pipe)
+        return ERROR_INT("pipe not defined", procName, 1);
+    if (wc < 0 || hc < 0)
+        return ERROR_INT("wc and hc must be >= 0", procName, 1);
+        /* blockconvLow() treats the first hc + 1 rows as boundary rows */
+    return pipelineAddStage(pipe, L_PIPE_BLOCKCONV, 1, hc + 1,
+                            wc, hc, 0, 0.0, 0.0, 0.0);
+}
+
+
+/*!
+ * \brief   pipelineAddRankFilter()
+ *
+ * \param[in]    pipe
+ * \param[in]    wf, hf   width and height of filter; each is >= 1
+ * \param[in]    rank     in [0.0 ... 1.0]
+ * \return  0 if OK, 1 on error
+ *
+ * <pre>
+ * Notes:
+ *      (1) This adds a rank filter on an 8 or 32 bpp image;
+ *          see pixRankFilter().
+ * </pre>
+ */
+l_ok
+pipelineAddRankFilter(L_PIPELINE  *pipe,
+                      l_int32      wf,
+                      l_int32      hf,
+                      l_float32    rank)
+{
+    PROCNAME("pipelineAddRankFilter");
+
+    if (!pipe)
+        return ERROR_INT("pipe not defined", procName, 1);
+    if (wf < 1 || hf < 1)
+        return ERROR_INT("wf < 1 || hf < 1", procName, 1);
+    if (rank < 0.0 || rank > 1.0)
+        return ERROR_INT("rank must be in [0.0, 1.0]", procName, 1);
+    return pipelineAddStage(pipe, L_PIPE_RANK_FILTER, 1, hf,
+                            wf, hf, 0, rank, 0.0, 0.0);
+}
+
+
+/*!
+ * \brief   pipelineAddBrickMorph()
+ *
+ * \param[in]    pipe
+ * \param[in]    type     L_MORPH_DILATE, L_MORPH_ERODE,
+ *                        L_MORPH_OPEN, L_MORPH_CLOSE
+ * \param[in]    hsize    width of brick Sel
+ * \param[in]    vsize    height of brick Sel
+ * \return  0 if OK, 1 on error
+ *
+ * <pre>
+ * Notes:
+ *      (1) This adds a brick morphological operation.  A 1 bpp image
+ *          is processed with the binary brick functions, such as
+ *          pixDilateBrick(), and an 8 bpp image with the grayscale
+ *          functions, such as pixDilateGray().
+ * </pre>
+ */
+l_ok
+pipelineAddBrickMorph(L_PIPELINE  *pipe,
+                      l_int32      type,
+                      l_int32      hsize,
+                      l_int32      vsize)
+{
+l_int32  support;
+
+    PROCNAME("pipelineAddBrickMorph");
+
+    if (!pipe)
+        return ERROR_INT("pipe not defined", procName, 1);
+    if (type != L_MORPH_DILATE && type != L_MORPH_ERODE &&
+        type != L_MORPH_OPEN && type != L_MORPH_CLOSE)
+        return ERROR_INT("invalid morph type", procName, 1);
+    if (hsize < 1 || vsize < 1)
+        return ERROR_INT("hsize and vsize not >= 1", procName, 1);
+    support = (type == L_MORPH_DILATE || type == L_MORPH_ERODE) ?
+              vsize : 2 * vsize;
+    return pipelineAddStage(pipe, L_PIPE_BRICK_MORPH, 1, support,
+                            type, hsize, vsize, 0.0, 0.0, 0.0);
+}
+
+
+/*!
+ * \brief   pipelineAddStage()
+ *
+ * \param[in]    pipe
+ * \param[in]    op           L_PIPE_*
+ * \param[in]    reduction    input rows for each output row
+ * \param[in]    support      extra input rows needed on each side
+ * \param[in]    i0, i1, i2   integer parameters
+ * \param[in]    f0, f1, f2   float parameters
+ * \return  0 if OK, 1 on error
+ *
+ * <pre>
+ * Notes:
+ *      (1) The support is rounded up to a multiple of the reduction,
+ *          so that each band starts on the first row of a reduced row.
+ * </pre>
+ */
+static l_int32
+pipelineAddStage(L_PIPELINE  *pipe,
+                 l_int32      op,
+                 l_int32      reduction,
+                 l_int32      support,
+                 l_int32      i0,
+                 l_int32      i1,
+                 l_int32      i2,
+                 l_float32    f0,
+                 l_float32    f1,
+                 l_float32    f2)
+{
+L_PIPESTAGE  *stage;
+
+    PROCNAME("pipelineAddStage");
+
+    if (pipe->n >= pipe->nalloc) {
+        if ((pipe->stage = (L_PIPESTAGE *)reallocNew((void **)&pipe->stage,
+                             sizeof(L_PIPESTAGE) * pipe->nalloc,
+                             2 * sizeof(L_PIPESTAGE) * pipe->nalloc)) == NULL)
+            return ERROR_INT("new stage array not made", procName, 1);
+        pipe->nalloc *= 2;
+    }
+
+    stage = &pipe->stage[pipe->n++];
+    stage->op = op;
+    stage->reduction = reduction;
+    stage->support = reduction * ((support + reduction - 1) / reduction);
+    stage->iparam[0] = i0;
+    stage->iparam[1] = i1;
+    stage->iparam[2] = i2;
+    stage->fparam[0] = f0;
+    stage->fparam[1] = f1;
+    stage->fparam[2] = f2;
+    return 0;
+}
+
+
+/*------------------------------------------------------------------------*
+ *                               Running                                  *
+ *------------------------------------------------------------------------*/
+/*!
+ * \brief   pipelineRunPix()
+ *
+ * \param[in]    pipe
+ * \param[in]    pixs
+ * \param[in]    bandh    height of output bands; use 0 for default
+ * \return  pixd, or NULL on error
+ *
+ * <pre>
+ * Notes:
+ *      (1) This runs the pipeline on %pixs in bands of %bandh output rows.
+ *          The result is the same as applying the stages in sequence on
+ *          %pixs, but the intermediate images are held only in windows
+ *          of rows.
+ *      (2) The default band height is 64.
+ * </pre>
+ */
+PIX *
+pipelineRunPix(L_PIPELINE  *pipe,
+               PIX         *pixs,
+               l_int32      bandh)
+{
+PIX  *pixd;
+
+    PROCNAME("pipelineRunPix");
+
+    if (!pipe)
+        return (PIX *)ERROR_PTR("pipe not defined", procName, NULL);
+    if (!pixs)
+        return (PIX *)ERROR_PTR("pixs not defined", procName, NULL);
+
+    if (pipelineRun(pipe, pixs, NULL, bandh, &pixd, NULL, 0))
+        return (PIX *)ERROR_PTR("pipeline failed", procName, NULL);
+    return pixd;
+}
+
+
+/*!
+ * \brief   pipelineRunTiff()
+ *
+ * \param[in]    pipe
+ * \param[in]    filein     input tiff file
+ * \param[in]    page       page of input tiff file: 0 based
+ * \param[in]    fileout    output tiff file
+ * \param[in]    comptype   IFF_TIFF, IFF_TIFF_RLE, IFF_TIFF_PACKBITS,
+ *                          IFF_TIFF_G3, IFF_TIFF_G4,
+ *                          IFF_TIFF_LZW, IFF_TIFF_ZIP, IFF_TIFF_JPEG
+ * \param[in]    bandh      height of output bands; use 0 for default
+ * \return  0 if OK, 1 on error
+ *
+ * <pre>
+ * Notes:
+ *      (1) This reads the input image in bands with tiffReaderReadRows()
+ *          and writes the output in bands with tiffWriterWriteRows(),
+ *          so neither the input nor the output image is held in memory.
+ *          See tiffReaderOpen() for the input images that are supported.
+ *      (2) The default band height is 64.
+ * </pre>
+ */
+l_ok
+pipelineRunTiff(L_PIPELINE  *pipe,
+                const char  *filein,
+                l_int32      page,
+                const char  *fileout,
+                l_int32      comptype,
+                l_int32      bandh)
+{
+l_int32         ret;
+L_TIFF_READER  *reader;
+
+    PROCNAME("pipelineRunTiff");
+
+    if (!pipe)
+        return ERROR_INT("pipe not defined", procName, 1);
+    if (!filein)
+        return ERROR_INT("filein not defined", procName, 1);
+    if (!fileout)
+        return ERROR_INT("fileout not defined", procName, 1);
+
+    if ((reader = tiffReaderOpen(filein, page)) == NULL)
+        return ERROR_INT("reader not made", procName, 1);
+    ret = pipelineRun(pipe, NULL, reader, bandh, NULL, fileout, comptype);
+    tiffReaderClose(&reader);
+    if (ret)
+        return ERROR_INT("pipeline failed", procName, 1);
+    return 0;
+}
+
+
+/*!
+ * \brief   pipelineRun()
+ *
+ * \param[in]    pipe
+ * \param[in]    pixs       [optional] source image
+ * \param[in]    reader     [optional] source tiff reader; use if !pixs
+ * \param[in]    bandh      height of output bands; use 0 for default
+ * \param[out]   ppixd      [optional] output image
+ * \param[in]    fileout    [optional] output tiff file; use if !ppixd
+ * \param[in]    comptype   tiff compression for %fileout
+ * \return  0 if OK, 1 on error
+ */
+static l_int32
+pipelineRun(L_PIPELINE     *pipe,
+            PIX            *pixs,
+            L_TIFF_READER  *reader,
+            l_int32         bandh,
+            PIX           **ppixd,
+            const char     *fileout,
+            l_int32         comptype)
+{
+l_int32           i, n, y, w, h, d, hout, ret;
+PIX              *pixb, *pixd;
+L_TIFF_WRITER    *writer;
+struct PipeRun    run;
+
+    PROCNAME("pipelineRun");
+
+    if (ppixd) *ppixd = NULL;
+    if (bandh <= 0) bandh = 64;
+
+        /* Set up the levels, with the full image height at each */
+    n = pipe->n;
+    run.pipe = pipe;
+    run.pixs = pixs;
+    run.reader = reader;
+    run.level = (struct PipeLevel *)LEPT_CALLOC(n + 1,
+                                                sizeof(struct PipeLevel));
+    if (pixs)
+        run.level[0].h = pixGetHeight(pixs);
+    else
+        tiffReaderGetDimensions(reader, NULL, &run.level[0].h, NULL);
+    for (i = 0; i < n; i++)
+        run.level[i + 1].h = run.level[i].h / pipe->stage[i].reduction;
+    hout = run.level[n].h;
+    if (hout == 0) {
+        LEPT_FREE(run.level);
+        return ERROR_INT("output image is empty", procName, 1);
+    }
+
+        /* Pull bands from the last level and paint or write them */
+    ret = 0;
+    pixd = NULL;
+    writer = NULL;
+    for (y = 0; y < hout; y += bandh) {
+        if ((pixb = pipeGetRows(&run, n, y, L_MIN(y + bandh, hout)))
+            == NULL) {
+            ret = ERROR_INT("band not made", procName, 1);
+            break;
+        }
+        pixGetDimensions(pixb, &w, &h, &d);
+        if (y == 0 && ppixd) {
+            pixd = pixCreate(w, hout, d);
+            pixCopyColormap(pixd, pixb);
+            pixCopySpp(pixd, pixb);
+            pixCopyResolution(pixd, pixb);
+            pixCopyInputFormat(pixd, pixb);
+            pixCopyText(pixd, pixb);
+        } else if (y == 0) {
+            writer = tiffWriterOpen(fileout, pixb, hout, comptype);
+        }
+        if (pixd)
+            ret = pixRasterop(pixd, 0, y, w, h, PIX_SRC, pixb, 0, 0);
+        else if (writer)
+            ret = tiffWriterWriteRows(writer, pixb);
+        else
+            ret = ERROR_INT("no output for band", procName, 1);
+        pixDestroy(&pixb);
+        if (ret) break;
+    }
+
+    for (i = 0; i <= n; i++)
+        pixDestroy(&run.level[i].pixw);
+    LEPT_FREE(run.level);
+    if (writer && tiffWriterClose(&writer))
+        ret = 1;
+    if (ret) {
+        pixDestroy(&pixd);
+        return ERROR_INT("pipeline run failed", procName, 1);
+    }
+    if (ppixd) *ppixd = pixd;
+    return 0;
+}
+
+
+/*!
+ * \brief   pipeGetRows()
+ *
+ * \param[in]    run
+ * \param[in]    k       level
+ * \param[in]    y0      first row
+ * \param[in]    y1      row following the last row
+ * \return  pix with rows [y0, y1) at level %k, or NULL on error
+ *
+ * <pre>
+ * Notes:
+ *      (1) Requests at each level must be monotonic: %y0 is not less
+ *          than %y0 of the previous request, and not greater than %y1
+ *          of the previous request.  Rows above %y0 are then dropped
+ *          from the window of the level.
+ * </pre>
+ */
+static PIX *
+pipeGetRows(struct PipeRun  *run,
+            l_int32          k,
+            l_int32          y0,
+            l_int32          y1)
+{
+PIX               *pixn, *pixw;
+struct PipeLevel  *lev;
+
+    PROCNAME("pipeGetRows");
+
+    if (k == 0 && run->pixs)
+        return pipeClipRows(run->pixs, y0, y1 - y0);
+
+    lev = &run->level[k];
+    if (y0 < lev->y0 || y0 > lev->y1)
+        return (PIX *)ERROR_PTR("non-monotonic request", procName, NULL);
+    if (y1 > lev->y1) {
+        if (k == 0)
+            pixn = tiffReaderReadRows(run->reader, y1 - lev->y1);
+        else
+            pixn = pipeComputeRows(run, k, lev->y1, y1);
+        if (!pixn)
+            return (PIX *)ERROR_PTR("new rows not made", procName, NULL);
+        pixw = pipeJoinRows(lev->pixw, y0 - lev->y0, pixn);
+        lev->y1 += pixGetHeight(pixn);
+        pixDestroy(&pixn);
+    } else {
+        pixw = pipeClipRows(lev->pixw, y0 - lev->y0, lev->y1 - y0);
+    }
+    pixDestroy(&lev->pixw);
+    lev->pixw = pixw;
+    lev->y0 = y0;
+    if (!pixw || lev->y1 < y1)
+        return (PIX *)ERROR_PTR("window not made", procName, NULL);
+    return pipeClipRows(pixw, 0, y1 - y0);
+}
+
+
+/*!
+ * \brief   pipeComputeRows()
+ *
+ * \param[in]    run
+ * \param[in]    k       level, >= 1
+ * \param[in]    y0      first row
+ * \param[in]    y1      row following the last row
+ * \return  pix with rows [y0, y1') at level %k, where y1' >= y1,
+ *              or NULL on error
+ *
+ * <pre>
+ * Notes:
+ *      (1) This applies stage k - 1 to the rows it needs at level k - 1.
+ *      (2) The band is extended below %y1 so that every band given to
+ *          the operation has at least 2 * m + 1 rows, unless it is the
+ *          full image.
+ * </pre>
+ */
+static PIX *
+pipeComputeRows(struct PipeRun  *run,
+                l_int32          k,
+                l_int32          y0,
+                l_int32          y1)
+{
+l_int32       r, m, hin, hout, s, e;
+PIX          *pix1, *pix2, *pixd;
+L_PIPESTAGE  *stage;
+
+    PROCNAME("pipeComputeRows");
+
+    stage = &run->pipe->stage[k - 1];
+    r = stage->reduction;
+    m = stage->support;
+    hin = run->level[k - 1].h;
+    hout = run->level[k].h;
+
+        /* Extend the band for the support at the top and bottom */
+    y1 = L_MAX(y1, (m + r) / r);
+    if (hin - r * y1 < m + 1)
+        y1 = hout;
+    y1 = L_MIN(y1, hout);
+    s = L_MAX(0, r * y0 - m);
+    e = L_MIN(hin, r * y1 + m);
+
+    if ((pix1 = pipeGetRows(run, k - 1, s, e)) == NULL)
+        return (PIX *)ERROR_PTR("input rows not made", procName, NULL);
+    pix2 = pipeApplyStage(stage, pix1);
+    pixDestroy(&pix1);
+    if (!pix2)
+        return (PIX *)ERROR_PTR("stage failed", procName, NULL);
+    pixd = pipeClipRows(pix2, (r * y0 - s) / r, y1 - y0);
+    pixDestroy(&pix2);
+    return pixd;
+}
+
+
+/*!
+ * \brief   pipeApplyStage()
+ *
+ * \param[in]    stage
+ * \param[in]    pixs
+ * \return  pixd, or NULL on error
+ */
+static PIX *
+pipeApplyStage(L_PIPESTAGE  *stage,
+               PIX          *pixs)
+{
+l_int32  type, hsize, vsize;
+
+    PROCNAME("pipeApplyStage");
+
+    switch (stage->op) {
+    case L_PIPE_REDUCE_RANK_BINARY2:
+        return pixReduceRankBinary2(pixs, stage->iparam[0], NULL);
+    case L_PIPE_SCALE_TO_GRAY:
+        if (pixGetDepth(pixs) != 1)
+            return (PIX *)ERROR_PTR("pixs not 1 bpp", procName, NULL);
+        switch (stage->iparam[0]) {
+        case 2: return pixScaleToGray2(pixs);
+        case 3: return pixScaleToGray3(pixs);
+        case 4: return pixScaleToGray4(pixs);
+        case 6: return pixScaleToGray6(pixs);
+        case 8: return pixScaleToGray8(pixs);
+        default: return pixScaleToGray16(pixs);
+        }
+    case L_PIPE_THRESHOLD_TO_BINARY:
+        return pixThresholdToBinary(pixs, stage->iparam[0]);
+    case L_PIPE_CONVERT_RGB_TO_GRAY:
+        return pixConvertRGBToGray(pixs, stage->fparam[0],
+                                   stage->fparam[1], stage->fparam[2]);
+    case L_PIPE_BLOCKCONV:
+        return pixBlockconv(pixs, stage->iparam[0], stage->iparam[1]);
+    case L_PIPE_RANK_FILTER:
+        return pixRankFilter(pixs, stage->iparam[0], stage->iparam[1],
+                             stage->fparam[0]);
+    case L_PIPE_BRICK_MORPH:
+        type = stage->iparam[0];
+        hsize = stage->iparam[1];
+        vsize = stage->iparam[2];
+        if (pixGetDepth(pixs) == 1) {
+            if (type == L_MORPH_DILATE)
+                return pixDilateBrick(NULL, pixs, hsize, vsize);
+            else if (type == L_MORPH_ERODE)
+                return pixErodeBrick(NULL, pixs, hsize, vsize);
+            else if (type == L_MORPH_OPEN)
+                return pixOpenBrick(NULL, pixs, hsize, vsize);
+            else
+                return pixCloseBrick(NULL, pixs, hsize, vsize);
+        } else if (pixGetDepth(pixs) == 8) {
+            if (type == L_MORPH_DILATE)
+                return pixDilateGray(pixs, hsize, vsize);
+            else if (type == L_MORPH_ERODE)
+                return pixErodeGray(pixs, hsize, vsize);
+            else if (type == L_MORPH_OPEN)
+                return pixOpenGray(pixs, hsize, vsize);
+            else
+                return pixCloseGray(pixs, hsize, vsize);
+        }
+        return (PIX *)ERROR_PTR("pixs not 1 or 8 bpp", procName, NULL);
+    default:
+        return (PIX *)ERROR_PTR("invalid op", procName, NULL);
+    }
+}
+
+
+/*!
+ * \brief   pipeClipRows()
+ *
+ * \param[in]    pixs
+ * \param[in]    y0       first row
+ * \param[in]    nrows    number of rows
+ * \return  pixd with rows [y0, y0 + nrows) of pixs, or NULL on error
+ */
+static PIX *
+pipeClipRows(PIX     *pixs,
+             l_int32  y0,
+             l_int32  nrows)
+{
+BOX  *box;
+PIX  *pixd;
+
+    box = boxCreate(0, y0, pixGetWidth(pixs), nrows);
+    pixd = pixClipRectangle(pixs, box, NULL);
+    boxDestroy(&box);
+    return pixd;
+}
+
+
+/*!
+ * \brief   pipeJoinRows()
+ *
+ * \param[in]    pix1    [optional] upper rows
+ * \param[in]    y0      first row of pix1 to use
+ * \param[in]    pix2    lower rows
+ * \return  pixd, with rows of pix1 starting at %y0 followed by pix2,
+ *              or NULL on error
+ */
+static PIX *
+pipeJoinRows(PIX     *pix1,
+             l_int32  y0,
+             PIX     *pix2)
+{
+l_int32  w, h1, h2, d;
+PIX     *pixd;
+
+    PROCNAME("pipeJoinRows");
+
+    h1 = (pix1) ? pixGetHeight(pix1) - y0 : 0;
+    if (h1 == 0)
+        return pixCopy(NULL, pix2);
+
+    pixGetDimensions(pix2, &w, &h2, &d);
+    if (pixGetWidth(pix1) != w || pixGetDepth(pix1) != d)
+        return (PIX *)ERROR_PTR("pix1 and pix2 sizes differ", procName, NULL);
+    if ((pixd = pixCreate(w, h1 + h2, d)) == NULL)
+        return (PIX *)ERROR_PTR("pixd not made", procName, NULL);
+    pixCopyColormap(pixd, pix2);
+    pixCopySpp(pixd, pix2);
+    pixCopyResolution(pixd, pix2);
+    pixCopyInputFormat(pixd, pix2);
+    pixCopyText(pixd, pix2);
+    pixRasterop(pixd, 0, 0, w, h1, PIX_SRC, pix1, 0, y0);
+    pixRasterop(pixd, 0, h1, w, h2, PIX_SRC, pix2, 0, 0);
+    return pixd;
+}
@@ -0,0 +1,84 @@
+/*====================================================================*
+ -  Copyright (C) 2001 Leptonica.  All rights reserved.
+ -
+ -  Redistribution and use in source and binary forms, with or without
+ -  modification, are permitted provided that the following conditions
+ -  are met:
+ -  1. Redistributions of source code must retain the above copyright
+ -     notice, this list of conditions and the following disclaimer.
+ -  2. Redistributions in binary form must reproduce the above
+ -     copyright notice, this list of conditions and the following
+ -     disclaimer in the documentation and/or other materials
+ -     provided with the distribution.
+ -
+ -  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ -  ``AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ -  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ -  A PARTICULAR PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL ANY
+ -  CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ -  EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ -  PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ -  PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ -  OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ -  NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ -  SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *====================================================================*/
+
+#ifndef  LEPTONICA_PIPELINE_H
+#define  LEPTONICA_PIPELINE_H
+
+/*!
+ * \file pipeline.h
+ *
+ * <pre>
+ *  Contains the following structs
+ *      struct L_PipeStage
+ *      struct L_Pipeline
+ *  and the enum for the stage operations.
+ *
+ *  A pipeline is a sequence of image operations that is run on an
+ *  image in bands of rows, so that only a window of rows is held in
+ *  memory at each stage.  Each stage has a vertical reduction factor
+ *  and a vertical support: to compute a band of output rows, the
+ *  stage needs the corresponding input rows plus %support rows on
+ *  each side.  See pipeline.c for details.
+ * </pre>
+ */
+
+
+/*------------------------------------------------------------------------*
+ *                             Pipeline data                              *
+ *------------------------------------------------------------------------*/
+/*! Pipeline stage */
+struct L_PipeStage
+{
+    l_int32         op;          /*!< operation: L_PIPE_*                    */
+    l_int32         reduction;   /*!< input rows for each output row         */
+    l_int32         support;     /*!< extra input rows needed on each side   */
+    l_int32         iparam[3];   /*!< integer parameters of the operation    */
+    l_float32       fparam[3];   /*!< float parameters of the operation      */
+};
+typedef struct L_PipeStage  L_PIPESTAGE;
+
+/*! Pipeline of operations applied in bands */
+struct L_Pipeline
+{
+    l_int32         n;           /*!< number of stages                       */
+    l_int32         nalloc;      /*!< size of allocated stage array          */
+    L_PIPESTAGE    *stage;       /*!< array of stages                        */
+};
+typedef struct L_Pipeline  L_PIPELINE;
+
+
+/*! Pipeline stage operation */
+enum {
+    L_PIPE_REDUCE_RANK_BINARY2 = 1,  /*!< pixReduceRankBinary2()           */
+    L_PIPE_SCALE_TO_GRAY = 2,        /*!< pixScaleToGray2() ... 16()       */
+    L_PIPE_THRESHOLD_TO_BINARY = 3,  /*!< pixThresholdToBinary()           */
+    L_PIPE_CONVERT_RGB_TO_GRAY = 4,  /*!< pixConvertRGBToGray()            */
+    L_PIPE_BLOCKCONV = 5,            /*!< pixBlockconv()                   */
+    L_PIPE_RANK_FILTER = 6,          /*!< pixRankFilter()                  */
+    L_PIPE_BRICK_MORPH = 7           /*!< binary or grayscale brick morph  */
+};
+
+#endif  /* LEPTONICA_PIPELINE_H */
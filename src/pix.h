@@ -67,6 +67,7 @@
  *         struct DPix
  *         struct PixComp
  *         struct PixaComp
+ *         struct L_Pixac_Archive
  *
  *   (2) This file has definitions for:
  *         Colors for RGBA
@@ -152,6 +153,9 @@ struct Pix
     char                *text;      /*!< text string associated with pix   */
     struct PixColormap  *colormap;  /*!< colormap (may be null)            */
     l_uint32            *data;      /*!< the image data                    */
+    l_uint8             *mapdata;   /*!< file mapping holding the image    */
+                                    /*!<   data; NULL if data is on heap   */
+    size_t               mapsize;   /*!< size of the file mapping          */
 };
 typedef struct Pix PIX;
 
@@ -662,6 +666,24 @@ struct PixaComp
 typedef struct PixaComp PIXAC;
 
 
+/*-------------------------------------------------------------------------*
+ *             L_Pixac_Archive: indexed pixacomp in a file                 *
+ *-------------------------------------------------------------------------*/
+#define  PIXACOMP_ARCHIVE_VERSION_NUMBER 1  /*!< Version for pixacomp     */
+                                            /*!< archive file             */
+
+/*! Indexed file of compressed pix, with random access to each pixcomp */
+struct L_Pixac_Archive
+{
+    FILE                *fp;        /*!< stream for the archive file       */
+    l_int32              n;         /*!< number of pixcomp in the archive  */
+    size_t               indexloc;  /*!< byte location of the index        */
+    struct L_Bytea      *index;     /*!< index entries, when open for      */
+                                    /*!<   writing; NULL if read-only      */
+};
+typedef struct L_Pixac_Archive L_PIXAC_ARCHIVE;
+
+
 /*-------------------------------------------------------------------------*
  *                         Access and storage flags                        *
  *-------------------------------------------------------------------------*/
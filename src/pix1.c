@@ -106,6 +106,7 @@
  *          l_int32       pixSetData()
  *          l_uint32     *pixExtractData()
  *          l_int32       pixFreeData()
+ *          l_int32       pixSetMappedData()
  *
  *    Pix line ptrs
  *          void        **pixGetLinePtrs()
@@ -179,6 +180,12 @@
  *      a copy, and the data ptr in the pix must be nulled before
  *      destroying it because the pix will no longer 'own' the data.
  *
+ *  (5) Use pixSetMappedData() to have the pix use image data that is
+ *      in a file mapping, such as that made by pixReadSpixMapped().
+ *      The pix then owns the mapping, and it is released by
+ *      pixFreeData() and pixDestroy() instead of freeing the data.
+ *      pixExtractData() always returns a copy of mapped data.
+ *
  *  We have provided accessors and functions here that should be
  *  sufficient so that you can do anything you want without
  *  explicitly referencing any of the pix member fields.
@@ -616,15 +623,13 @@ PIX  *pix;
 static void
 pixFree(PIX  *pix)
 {
-l_uint32  *data;
-char      *text;
+char  *text;
 
     if (!pix) return;
 
     pixChangeRefcount(pix, -1);
     if (pixGetRefcount(pix) <= 0) {
-        if ((data = pixGetData(pix)) != NULL)
-            pix_free(data);
+        pixFreeData(pix);
         if ((text = pixGetText(pix)) != NULL)
             LEPT_FREE(text);
         pixDestroyColormap(pix);
@@ -912,7 +917,11 @@ PIX     *pixs;
     if (pixGetRefcount(pixs) == 1) {  /* transfer the data, cmap, text */
         pixFreeData(pixd);  /* dealloc any existing data */
         pixSetData(pixd, pixGetData(pixs));  /* transfer new data from pixs */
+        pixd->mapdata = pixs->mapdata;  /* and the file mapping, if any */
+        pixd->mapsize = pixs->mapsize;
         pixs->data = NULL;  /* pixs no longer owns data */
+        pixs->mapdata = NULL;
+        pixs->mapsize = 0;
         pixSetColormap(pixd, pixGetColormap(pixs));  /* frees old; sets new */
         pixs->colormap = NULL;  /* pixs no longer owns colormap */
         if (copytext) {
@@ -1715,6 +1724,7 @@ pixSetData(PIX       *pix,
  *          pix->data ptr is set to NULL.
  *      (3) If refcount > 1, this simply returns a copy of the data,
  *          using the pix allocator, and leaving the input pix unchanged.
+ *          A copy is also returned if the data is in a file mapping.
  * </pre>
  */
 l_uint32 *
@@ -1729,10 +1739,10 @@ l_uint32  *data, *datas;
         return (l_uint32 *)ERROR_PTR("pixs not defined", procName, NULL);
 
     count = pixGetRefcount(pixs);
-    if (count == 1) {  /* extract */
+    if (count == 1 && !pixs->mapdata) {  /* extract */
         data = pixGetData(pixs);
         pixSetData(pixs, NULL);
-    } else {  /* refcount > 1; copy */
+    } else {  /* refcount > 1 or mapped; copy */
         bytes = 4 * pixGetWpl(pixs) * pixGetHeight(pixs);
         datas = pixGetData(pixs);
         if ((data = (l_uint32 *)pix_malloc(bytes)) == NULL)
@@ -1756,6 +1766,7 @@ l_uint32  *data, *datas;
  *          It should be used before pixSetData() in the situation where
  *          you want to free any existing data before doing
  *          a subsequent assignment with pixSetData().
+ *      (2) If the data is in a file mapping, the mapping is released.
  * </pre>
  */
 l_int32
@@ -1768,7 +1779,12 @@ l_uint32  *data;
     if (!pix)
         return ERROR_INT("pix not defined", procName, 1);
 
-    if ((data = pixGetData(pix)) != NULL) {
+    if (pix->mapdata) {
+        l_binaryUnmapFile(pix->mapdata, pix->mapsize);
+        pix->mapdata = NULL;
+        pix->mapsize = 0;
+        pix->data = NULL;
+    } else if ((data = pixGetData(pix)) != NULL) {
         pix_free(data);
         pix->data = NULL;
     }
@@ -1776,6 +1792,55 @@ l_uint32  *data;
 }
 
 
+/*!
+ * \brief   pixSetMappedData()
+ *
+ * \param[in]   pix
+ * \param[in]   data      image data, within the file mapping
+ * \param[in]   mapdata   start of the file mapping
+ * \param[in]   mapsize   size of the file mapping
+ * \return  0 if OK, 1 on error
+ *
+ * <pre>
+ * Notes:
+ *      (1) This frees any existing data and sets the image data to
+ *          a location within a file mapping made by l_binaryMapFile().
+ *          No image data is copied.
+ *      (2) The pix takes ownership of the mapping.  It is released
+ *          by pixFreeData(), or by pixDestroy() when the last clone
+ *          is destroyed.  The caller must not unmap it.
+ *      (3) The data must be 4-byte aligned and the mapping must hold
+ *          4 * wpl * h bytes of image data starting at %data.
+ * </pre>
+ */
+l_int32
+pixSetMappedData(PIX       *pix,
+                 l_uint32  *data,
+                 l_uint8   *mapdata,
+                 size_t     mapsize)
+{
+size_t  offset;
+
+    PROCNAME("pixSetMappedData");
+
+    if (!pix)
+        return ERROR_INT("pix not defined", procName, 1);
+    if (!data || !mapdata)
+        return ERROR_INT("data and mapdata not both defined", procName, 1);
+    if ((l_uint8 *)data < mapdata || (size_t)data % 4 != 0)
+        return ERROR_INT("data not aligned in mapping", procName, 1);
+    offset = (l_uint8 *)data - mapdata;
+    if (offset + 4LL * pixGetWpl(pix) * pixGetHeight(pix) > mapsize)
+        return ERROR_INT("mapping too small for data", procName, 1);
+
+    pixFreeData(pix);
+    pix->data = data;
+    pix->mapdata = mapdata;
+    pix->mapsize = mapsize;
+    return 0;
+}
+
+
 /*--------------------------------------------------------------------*
  *                          Pix line ptrs                             *
  *--------------------------------------------------------------------*/
@@ -87,6 +87,24 @@
  *           l_int32   pixacompWrite()
  *           l_int32   pixacompWriteStream()
  *           l_int32   pixacompWriteMem()
+ *           static PIXC     *pixcompReadStream()
+ *           static l_int32   pixcompWriteStream()
+ *
+ *      Indexed pixacomp archive
+ *           L_PIXAC_ARCHIVE  *pixacompArchiveCreate()
+ *           L_PIXAC_ARCHIVE  *pixacompArchiveOpen()
+ *           l_int32   pixacompArchiveClose()
+ *           l_int32   pixacompArchiveGetCount()
+ *           l_int32   pixacompArchiveAddPix()
+ *           l_int32   pixacompArchiveAddPixcomp()
+ *           PIXC     *pixacompArchiveGetPixcomp()
+ *           PIX      *pixacompArchiveGetPix()
+ *           l_int32   pixacompArchiveGetPixDimensions()
+ *           BOX      *pixacompArchiveGetBox()
+ *           static l_int32   pixacompArchiveFindTrailer()
+ *           static l_int32   pixacompArchiveGetEntry()
+ *           l_int32   pixacompWriteArchive()
+ *           PIXAC    *pixacompReadArchive()
  *
  *      Conversion to pdf
  *           l_int32   pixacompConvertToPdf()
@@ -162,12 +180,26 @@ static const l_int32  InitialPtrArraySize = 20;      /*!< n'importe quoi */
     /* Bound on size for a compressed data string */
 static const size_t  MaxDataSize = 1000000000;   /* 1 GB */
 
+    /* Fixed sizes of an index entry and the trailer in an archive */
+#define  ARCHIVE_ENTRY_SIZE      90
+#define  ARCHIVE_TRAILER_SIZE    68
+
+    /* Size of blocks read when searching back for an archive trailer */
+static const size_t  ArchiveSearchSize = 65536;
+
     /* These two globals are defined in writefile.c */
 extern l_int32  NumImageFileFormatExtensions;
 extern const char  *ImageFileFormatExtensions[];
 
     /* Static functions */
 static l_int32 pixacompExtendArray(PIXAC *pixac);
+static PIXC *pixcompReadStream(FILE *fp);
+static l_int32 pixcompWriteStream(FILE *fp, PIXC *pixc, l_int32 index);
+static l_int32 pixacompArchiveFindTrailer(FILE *fp, size_t filesize,
+                                          l_int32 *pn, size_t *pindexloc);
+static l_int32 pixacompArchiveGetEntry(L_PIXAC_ARCHIVE *parch, l_int32 index,
+                                       size_t *ploc, l_int32 *pw,
+                                       l_int32 *ph, l_int32 *pd, BOX **pbox);
 static l_int32 pixcompFastConvertToPdfData(PIXC *pixc, const char *title,
                                            l_uint8 **pdata, size_t *pnbytes);
 
@@ -1696,14 +1728,10 @@ PIXAC  *pixac;
 PIXAC *
 pixacompReadStream(FILE  *fp)
 {
-char      buf[256];
-l_uint8  *data;
-l_int32   n, offset, i, w, h, d, ignore;
-l_int32   comptype, cmapflag, version, xres, yres;
-size_t    size;
-BOXA     *boxa;
-PIXC     *pixc;
-PIXAC    *pixac;
+l_int32  n, offset, i, version;
+BOXA    *boxa;
+PIXC    *pixc;
+PIXAC   *pixac;
 
     PROCNAME("pixacompReadStream");
 
@@ -1735,55 +1763,10 @@ PIXAC    *pixac;
     pixacompSetOffset(pixac, offset);
 
     for (i = 0; i < n; i++) {
-        if (fscanf(fp, "\nPixcomp[%d]: w = %d, h = %d, d = %d\n",
-                   &ignore, &w, &h, &d) != 4) {
-            pixacompDestroy(&pixac);
-            return (PIXAC *)ERROR_PTR("dimension reading", procName, NULL);
-        }
-        if (fscanf(fp, "  comptype = %d, size = %zu, cmapflag = %d\n",
-                   &comptype, &size, &cmapflag) != 3) {
-            pixacompDestroy(&pixac);
-            return (PIXAC *)ERROR_PTR("comptype/size reading", procName, NULL);
-        }
-        if (size > MaxDataSize) {
-            pixacompDestroy(&pixac);
-            L_ERROR("data size = %zu is too big", procName, size);
-            return NULL;
-        }
-
-           /* Use fgets() and sscanf(); not fscanf(), for the last
-             * bit of header data before the binary data.  The reason is
-             * that fscanf throws away white space, and if the binary data
-             * happens to begin with ascii character(s) that are white
-             * space, it will swallow them and all will be lost!  */
-        if (fgets(buf, sizeof(buf), fp) == NULL) {
-            pixacompDestroy(&pixac);
-            return (PIXAC *)ERROR_PTR("fgets read fail", procName, NULL);
-        }
-        if (sscanf(buf, "  xres = %d, yres = %d\n", &xres, &yres) != 2) {
-            pixacompDestroy(&pixac);
-            return (PIXAC *)ERROR_PTR("read fail for res", procName, NULL);
-        }
-        if ((data = (l_uint8 *)LEPT_CALLOC(1, size)) == NULL) {
-            pixacompDestroy(&pixac);
-            return (PIXAC *)ERROR_PTR("calloc fail for data", procName, NULL);
-        }
-        if (fread(data, 1, size, fp) != size) {
+        if ((pixc = pixcompReadStream(fp)) == NULL) {
             pixacompDestroy(&pixac);
-            LEPT_FREE(data);
-            return (PIXAC *)ERROR_PTR("error reading data", procName, NULL);
+            return (PIXAC *)ERROR_PTR("pixc not read", procName, NULL);
         }
-        fgetc(fp);  /* swallow the ending nl */
-        pixc = (PIXC *)LEPT_CALLOC(1, sizeof(PIXC));
-        pixc->w = w;
-        pixc->h = h;
-        pixc->d = d;
-        pixc->xres = xres;
-        pixc->yres = yres;
-        pixc->comptype = comptype;
-        pixc->cmapflag = cmapflag;
-        pixc->data = data;
-        pixc->size = size;
         pixacompAddPixcomp(pixac, pixc, L_INSERT);
     }
     return pixac;
@@ -1891,13 +1874,8 @@ PIXC    *pixc;
         if ((pixc = pixacompGetPixcomp(pixac, pixac->offset + i, L_NOCOPY))
                 == NULL)
             return ERROR_INT("pixc not found", procName, 1);
-        fprintf(fp, "\nPixcomp[%d]: w = %d, h = %d, d = %d\n",
-                i, pixc->w, pixc->h, pixc->d);
-        fprintf(fp, "  comptype = %d, size = %zu, cmapflag = %d\n",
-                pixc->comptype, pixc->size, pixc->cmapflag);
-        fprintf(fp, "  xres = %d, yres = %d\n", pixc->xres, pixc->yres);
-        fwrite(pixc->data, 1, pixc->size, fp);
-        fprintf(fp, "\n");
+        if (pixcompWriteStream(fp, pixc, i))
+            return ERROR_INT("pixc not written", procName, 1);
     }
     return 0;
 }
@@ -1957,6 +1935,810 @@ FILE    *fp;
 }
 
 
+/*!
+ * \brief   pixcompReadStream()
+ *
+ * \param[in]    fp     file stream
+ * \return  pixc, or NULL on error
+ *
+ * <pre>
+ * Notes:
+ *      (1) Reads one pixcomp record, as written by pixcompWriteStream().
+ * </pre>
+ */
+static PIXC *
+pixcompReadStream(FILE  *fp)
+{
+char      buf[256];
+l_uint8  *data;
+l_int32   w, h, d, ignore, comptype, cmapflag, xres, yres;
+size_t    size;
+PIXC     *pixc;
+
+    PROCNAME("pixcompReadStream");
+
+    if (fscanf(fp, "\nPixcomp[%d]: w = %d, h = %d, d = %d\n",
+               &ignore, &w, &h, &d) != 4)
+        return (PIXC *)ERROR_PTR("dimension reading", procName, NULL);
+    if (fscanf(fp, "  comptype = %d, size = %zu, cmapflag = %d\n",
+               &comptype, &size, &cmapflag) != 3)
+        return (PIXC *)ERROR_PTR("comptype/size reading", procName, NULL);
+    if (size > MaxDataSize) {
+        L_ERROR("data size = %zu is too big", procName, size);
+        return NULL;
+    }
+
+       /* Use fgets() and sscanf(); not fscanf(), for the last
+         * bit of header data before the binary data.  The reason is
+         * that fscanf throws away white space, and if the binary data
+         * happens to begin with ascii character(s) that are white
+         * space, it will swallow them and all will be lost!  */
+    if (fgets(buf, sizeof(buf), fp) == NULL)
+        return (PIXC *)ERROR_PTR("fgets read fail", procName, NULL);
+    if (sscanf(buf, "  xres = %d, yres = %d\n", &xres, &yres) != 2)
+        return (PIXC *)ERROR_PTR("read fail for res", procName, NULL);
+    if ((data = (l_uint8 *)LEPT_CALLOC(1, size)) == NULL)
+        return (PIXC *)ERROR_PTR("calloc fail for data", procName, NULL);
+    if (fread(data, 1, size, fp) != size) {
+        LEPT_FREE(data);
+        return (PIXC *)ERROR_PTR("error reading data", procName, NULL);
+    }
+    fgetc(fp);  /* swallow the ending nl */
+    pixc = (PIXC *)LEPT_CALLOC(1, sizeof(PIXC));
+    pixc->w = w;
+    pixc->h = h;
+    pixc->d = d;
+    pixc->xres = xres;
+    pixc->yres = yres;
+    pixc->comptype = comptype;
+    pixc->cmapflag = cmapflag;
+    pixc->data = data;
+    pixc->size = size;
+    return pixc;
+}
+
+
+/*!
+ * \brief   pixcompWriteStream()
+ *
+ * \param[in]    fp      file stream
+ * \param[in]    pixc
+ * \param[in]    index   of the pixcomp, written in the record header
+ * \return  0 if OK, 1 on error
+ */
+static l_int32
+pixcompWriteStream(FILE    *fp,
+                   PIXC    *pixc,
+                   l_int32  index)
+{
+    PROCNAME("pixcompWriteStream");
+
+    fprintf(fp, "\nPixcomp[%d]: w = %d, h = %d, d = %d\n",
+            index, pixc->w, pixc->h, pixc->d);
+    fprintf(fp, "  comptype = %d, size = %zu, cmapflag = %d\n",
+            pixc->comptype, pixc->size, pixc->cmapflag);
+    fprintf(fp, "  xres = %d, yres = %d\n", pixc->xres, pixc->yres);
+    if (fwrite(pixc->data, 1, pixc->size, fp) != pixc->size)
+        return ERROR_INT("data not written", procName, 1);
+    fprintf(fp, "\n");
+    return 0;
+}
+
+
+/*---------------------------------------------------------------------*
+ *                       Indexed pixacomp archive                      *
+ *---------------------------------------------------------------------*/
+/*!
+ * \brief   pixacompArchiveCreate()
+ *
+ * \param[in]    filename
+ * \return  parch   archive open for adding pixcomps, or NULL on error
+ *
+ * <pre>
+ * Notes:
+ *      (1) The archive is a file of pixcomps that, unlike the serialized
+ *          pixacomp, can be read back one pixcomp at a time, and to
+ *          which pixcomps can be added without rewriting the file.
+ *          It has three parts:
+ *            * a short header identifying the file
+ *            * the pixcomp records, each written as in
+ *              pixacompWriteStream()
+ *            * an index, with one fixed-size entry for each pixcomp
+ *              giving the location of its record, its dimensions and
+ *              its box, followed by a fixed-size trailer giving the
+ *              number of entries and the location of the index.
+ *      (2) Any existing file is overwritten.  To add to an existing
+ *          archive, use pixacompArchiveOpen() with %append = 1.
+ *      (3) The index is written by pixacompArchiveClose(); the file
+ *          is not a valid archive until it has been closed.
+ *      (4) The boxes are optional.  An entry without a box is stored
+ *          with a box of (0,0,0,0), and pixacompArchiveGetBox()
+ *          returns NULL for it.
+ * </pre>
+ */
+L_PIXAC_ARCHIVE *
+pixacompArchiveCreate(const char  *filename)
+{
+FILE             *fp;
+L_PIXAC_ARCHIVE  *parch;
+
+    PROCNAME("pixacompArchiveCreate");
+
+    if (!filename)
+        return (L_PIXAC_ARCHIVE *)ERROR_PTR("filename not defined",
+                                            procName, NULL);
+
+    if ((fp = fopenWriteStream(filename, "w+b")) == NULL)
+        return (L_PIXAC_ARCHIVE *)ERROR_PTR("stream not opened",
+                                            procName, NULL);
+    fprintf(fp, "\nPixacomp Archive Version %d\n",
+            PIXACOMP_ARCHIVE_VERSION_NUMBER);
+
+    parch = (L_PIXAC_ARCHIVE *)LEPT_CALLOC(1, sizeof(L_PIXAC_ARCHIVE));
+    parch->fp = fp;
+    parch->n = 0;
+    parch->indexloc = ftell(fp);
+    parch->index = l_byteaCreate(0);
+    return parch;
+}
+
+
+/*!
+ * \brief   pixacompArchiveOpen()
+ *
+ * \param[in]    filename
+ * \param[in]    append    1 to open for adding pixcomps; 0 for read-only
+ * \return  parch, or NULL on error
+ *
+ * <pre>
+ * Notes:
+ *      (1) For read-only access, only the header and the trailer are
+ *          read, so the time to open does not depend on the size of
+ *          the archive.  Each index entry is read when it is needed.
+ *      (2) With %append = 1, the index is also read into memory.
+ *          New records are written at the end of the file, after the
+ *          old index and trailer, and the new index and trailer are
+ *          written after them by pixacompArchiveClose().  Nothing
+ *          already in the file is overwritten, so if appending is
+ *          interrupted before the archive is closed, the file still
+ *          holds the archive as it was before it was opened.
+ *      (3) The trailer is normally at the end of the file.  If it
+ *          is not, as after an interrupted append, the file is
+ *          searched back from the end for the last trailer that is
+ *          consistent with its index, and that archive is used.
+ *          Each append leaves the previous index and trailer, and
+ *          any partial records, as unused bytes in the file.
+ *      (4) The archive holds its file stream open until it is closed.
+ *          It must not be shared between threads; each thread can
+ *          open the file as its own read-only archive.
+ *      (5) Records are read from the stream with fseek() and fread(),
+ *          not through l_binaryMapFile().  A mapping is only available
+ *          where HAVE_MMAP is set, and it is a private snapshot of the
+ *          file, so records added with %append = 1 would not be seen
+ *          through it.  Reading a record from the stream costs a copy
+ *          of that record, which is small compared with decompressing.
+ * </pre>
+ */
+L_PIXAC_ARCHIVE *
+pixacompArchiveOpen(const char  *filename,
+                    l_int32      append)
+{
+l_uint8          *data;
+l_int32           n, version;
+size_t            indexloc, filesize, nbytes;
+FILE             *fp;
+L_PIXAC_ARCHIVE  *parch;
+
+    PROCNAME("pixacompArchiveOpen");
+
+    if (!filename)
+        return (L_PIXAC_ARCHIVE *)ERROR_PTR("filename not defined",
+                                            procName, NULL);
+
+    if (append)
+        fp = fopenWriteStream(filename, "r+b");
+    else
+        fp = fopenReadStream(filename);
+    if (!fp)
+        return (L_PIXAC_ARCHIVE *)ERROR_PTR("stream not opened",
+                                            procName, NULL);
+
+        /* Check the header, and read the trailer */
+    if (fscanf(fp, "\nPixacomp Archive Version %d\n", &version) != 1) {
+        fclose(fp);
+        return (L_PIXAC_ARCHIVE *)ERROR_PTR("not a pixacomp archive",
+                                            procName, NULL);
+    }
+    if (version != PIXACOMP_ARCHIVE_VERSION_NUMBER) {
+        fclose(fp);
+        return (L_PIXAC_ARCHIVE *)ERROR_PTR("invalid archive version",
+                                            procName, NULL);
+    }
+    fseek(fp, 0, SEEK_END);
+    filesize = ftell(fp);
+    if (pixacompArchiveFindTrailer(fp, filesize, &n, &indexloc)) {
+        fclose(fp);
+        return (L_PIXAC_ARCHIVE *)ERROR_PTR("valid trailer not found",
+                                            procName, NULL);
+    }
+    nbytes = (size_t)n * ARCHIVE_ENTRY_SIZE;
+
+    parch = (L_PIXAC_ARCHIVE *)LEPT_CALLOC(1, sizeof(L_PIXAC_ARCHIVE));
+    parch->fp = fp;
+    parch->n = n;
+    parch->indexloc = indexloc;
+    if (!append)
+        return parch;
+
+        /* Read the index into memory for appending */
+    parch->index = l_byteaCreate(nbytes);
+    if (n > 0) {
+        data = (l_uint8 *)LEPT_CALLOC(nbytes, sizeof(l_uint8));
+        fseek(fp, indexloc, SEEK_SET);
+        if (fread(data, 1, nbytes, fp) != nbytes) {
+            LEPT_FREE(data);
+            l_byteaDestroy(&parch->index);
+            pixacompArchiveClose(&parch);
+            return (L_PIXAC_ARCHIVE *)ERROR_PTR("index not read",
+                                                procName, NULL);
+        }
+        l_byteaAppendData(parch->index, data, nbytes);
+        LEPT_FREE(data);
+    }
+
+        /* New records go after everything now in the file */
+    parch->indexloc = filesize;
+    return parch;
+}
+
+
+/*!
+ * \brief   pixacompArchiveFindTrailer()
+ *
+ * \param[in]    fp          archive file stream
+ * \param[in]    filesize
+ * \param[out]   pn          number of entries in the index
+ * \param[out]   pindexloc   location of the index
+ * \return  0 if OK, 1 if no valid trailer is found
+ *
+ * <pre>
+ * Notes:
+ *      (1) This finds the last trailer in the file that immediately
+ *          follows an index of the size it gives.  For an archive that
+ *          has been closed, it is the last ARCHIVE_TRAILER_SIZE bytes,
+ *          and is found with a single read.
+ * </pre>
+ */
+static l_int32
+pixacompArchiveFindTrailer(FILE     *fp,
+                           size_t    filesize,
+                           l_int32  *pn,
+                           size_t   *pindexloc)
+{
+char      tbuf[ARCHIVE_TRAILER_SIZE + 1];
+char     *buf;
+l_int32   n, found;
+size_t    pos, start, end, t, indexloc;
+static const char  prefix[] = "\nPixacomp archive index: n = ";
+
+    PROCNAME("pixacompArchiveFindTrailer");
+
+    *pn = 0;
+    *pindexloc = 0;
+    if (filesize < ARCHIVE_TRAILER_SIZE)
+        return ERROR_INT("file too small for trailer", procName, 1);
+
+        /* Examine each candidate position t, going back from the end.
+         * Block [start, end) holds all trailers starting in [start, pos). */
+    buf = (char *)LEPT_CALLOC(ArchiveSearchSize + ARCHIVE_TRAILER_SIZE,
+                              sizeof(char));
+    found = FALSE;
+    pos = filesize - ARCHIVE_TRAILER_SIZE + 1;
+    while (pos > 0 && !found) {
+        start = (pos > ArchiveSearchSize) ? pos - ArchiveSearchSize : 0;
+        end = pos - 1 + ARCHIVE_TRAILER_SIZE;
+        if (fseek(fp, start, SEEK_SET) ||
+            fread(buf, 1, end - start, fp) != end - start)
+            break;
+        for (t = pos; t > start && !found; t--) {
+            if (memcmp(buf + t - 1 - start, prefix, sizeof(prefix) - 1))
+                continue;
+            memcpy(tbuf, buf + t - 1 - start, ARCHIVE_TRAILER_SIZE);
+            tbuf[ARCHIVE_TRAILER_SIZE] = '\0';
+            if (sscanf(tbuf, "\nPixacomp archive index: n = %d, loc = %zu\n",
+                       &n, &indexloc) != 2)
+                continue;
+            if (n < 0 || n > MaxPtrArraySize ||
+                indexloc + (size_t)n * ARCHIVE_ENTRY_SIZE != t - 1)
+                continue;
+            found = TRUE;
+            if (t - 1 + ARCHIVE_TRAILER_SIZE != filesize)
+                L_WARNING("archive was not closed; using earlier index\n",
+                          procName);
+        }
+        pos = start;
+    }
+    LEPT_FREE(buf);
+
+    if (!found)
+        return 1;
+    *pn = n;
+    *pindexloc = indexloc;
+    return 0;
+}
+
+
+/*!
+ * \brief   pixacompArchiveClose()
+ *
+ * \param[in,out]   pparch   will be set to null before returning
+ * \return  0 if OK, 1 on error
+ *
+ * <pre>
+ * Notes:
+ *      (1) If the archive was opened for adding pixcomps, this writes
+ *          the index and trailer after the last record, at the end of
+ *          the file.  Until the trailer is written, readers find the
+ *          archive as it was before it was opened for adding.
+ * </pre>
+ */
+l_ok
+pixacompArchiveClose(L_PIXAC_ARCHIVE  **pparch)
+{
+char              buf[ARCHIVE_TRAILER_SIZE + 1];
+l_uint8          *data;
+l_int32           ret;
+size_t            nbytes;
+L_PIXAC_ARCHIVE  *parch;
+
+    PROCNAME("pixacompArchiveClose");
+
+    if (pparch == NULL)
+        return ERROR_INT("ptr address is null!", procName, 1);
+    if ((parch = *pparch) == NULL)
+        return 0;
+
+    ret = 0;
+    if (parch->index) {
+        data = l_byteaGetData(parch->index, &nbytes);
+        snprintf(buf, sizeof(buf),
+                 "\nPixacomp archive index: n = %010d, loc = %020zu\n",
+                 parch->n, parch->indexloc);
+        fseek(parch->fp, parch->indexloc, SEEK_SET);
+        if ((nbytes > 0 && fwrite(data, 1, nbytes, parch->fp) != nbytes) ||
+            fwrite(buf, 1, ARCHIVE_TRAILER_SIZE, parch->fp) !=
+                ARCHIVE_TRAILER_SIZE) {
+            L_ERROR("index not written\n", procName);
+            ret = 1;
+        }
+        l_byteaDestroy(&parch->index);
+    }
+    if (fclose(parch->fp)) {
+        L_ERROR("stream not closed\n", procName);
+        ret = 1;
+    }
+    LEPT_FREE(parch);
+    *pparch = NULL;
+    return ret;
+}
+
+
+/*!
+ * \brief   pixacompArchiveGetCount()
+ *
+ * \param[in]    parch
+ * \return  count, or 0 if no archive
+ */
+l_int32
+pixacompArchiveGetCount(L_PIXAC_ARCHIVE  *parch)
+{
+    PROCNAME("pixacompArchiveGetCount");
+
+    if (!parch)
+        return ERROR_INT("parch not defined", procName, 0);
+
+    return parch->n;
+}
+
+
+/*!
+ * \brief   pixacompArchiveAddPix()
+ *
+ * \param[in]    parch      open for adding pixcomps
+ * \param[in]    pix        to be compressed and added
+ * \param[in]    comptype   IFF_DEFAULT, IFF_TIFF_G4, IFF_PNG, IFF_JFIF_JPEG
+ * \param[in]    box        [optional] associated with the pix
+ * \return  0 if OK; 1 on error
+ *
+ * <pre>
+ * Notes:
+ *      (1) The compression type is chosen as in pixcompCreateFromPix().
+ * </pre>
+ */
+l_ok
+pixacompArchiveAddPix(L_PIXAC_ARCHIVE  *parch,
+                      PIX              *pix,
+                      l_int32           comptype,
+                      BOX              *box)
+{
+l_int32  ret;
+PIXC    *pixc;
+
+    PROCNAME("pixacompArchiveAddPix");
+
+    if (!parch)
+        return ERROR_INT("parch not defined", procName, 1);
+    if (!pix)
+        return ERROR_INT("pix not defined", procName, 1);
+
+    if ((pixc = pixcompCreateFromPix(pix, comptype)) == NULL)
+        return ERROR_INT("pixc not made", procName, 1);
+    ret = pixacompArchiveAddPixcomp(parch, pixc, box);
+    pixcompDestroy(&pixc);
+    return ret;
+}
+
+
+/*!
+ * \brief   pixacompArchiveAddPixcomp()
+ *
+ * \param[in]    parch    open for adding pixcomps
+ * \param[in]    pixc     to be added; not consumed
+ * \param[in]    box      [optional] associated with the pixc
+ * \return  0 if OK; 1 on error
+ *
+ * <pre>
+ * Notes:
+ *      (1) The record is written immediately, at the end of the
+ *          existing records; the index entry is held in memory
+ *          until the archive is closed.
+ * </pre>
+ */
+l_ok
+pixacompArchiveAddPixcomp(L_PIXAC_ARCHIVE  *parch,
+                          PIXC             *pixc,
+                          BOX              *box)
+{
+char     buf[ARCHIVE_ENTRY_SIZE + 1];
+l_int32  bx, by, bw, bh;
+long     loc;
+
+    PROCNAME("pixacompArchiveAddPixcomp");
+
+    if (!parch)
+        return ERROR_INT("parch not defined", procName, 1);
+    if (!parch->index)
+        return ERROR_INT("parch is read-only", procName, 1);
+    if (!pixc)
+        return ERROR_INT("pixc not defined", procName, 1);
+    if (parch->n >= MaxPtrArraySize)
+        return ERROR_INT("archive is full", procName, 1);
+
+    if (fseek(parch->fp, parch->indexloc, SEEK_SET))
+        return ERROR_INT("end of records not found", procName, 1);
+    if (pixcompWriteStream(parch->fp, pixc, parch->n))
+        return ERROR_INT("pixc not written", procName, 1);
+    if ((loc = ftell(parch->fp)) < 0)
+        return ERROR_INT("end of record not found", procName, 1);
+
+    bx = by = bw = bh = 0;
+    if (box) boxGetGeometry(box, &bx, &by, &bw, &bh);
+    if (snprintf(buf, sizeof(buf),
+                 "%020zu %010d %010d %02d %010d %010d %010d %010d\n",
+                 parch->indexloc, pixc->w, pixc->h, pixc->d,
+                 bx, by, bw, bh) != ARCHIVE_ENTRY_SIZE)
+        return ERROR_INT("invalid index entry", procName, 1);
+    l_byteaAppendData(parch->index, (l_uint8 *)buf, ARCHIVE_ENTRY_SIZE);
+    parch->indexloc = loc;
+    parch->n++;
+    return 0;
+}
+
+
+/*!
+ * \brief   pixacompArchiveGetPixcomp()
+ *
+ * \param[in]    parch
+ * \param[in]    index    into the archive; 0-based
+ * \return  pixc, or NULL on error
+ *
+ * <pre>
+ * Notes:
+ *      (1) Only the index entry and the record for %index are read.
+ * </pre>
+ */
+PIXC *
+pixacompArchiveGetPixcomp(L_PIXAC_ARCHIVE  *parch,
+                          l_int32           index)
+{
+size_t  loc;
+
+    PROCNAME("pixacompArchiveGetPixcomp");
+
+    if (!parch)
+        return (PIXC *)ERROR_PTR("parch not defined", procName, NULL);
+
+    if (pixacompArchiveGetEntry(parch, index, &loc, NULL, NULL, NULL, NULL))
+        return (PIXC *)ERROR_PTR("index entry not read", procName, NULL);
+    if (fseek(parch->fp, loc, SEEK_SET))
+        return (PIXC *)ERROR_PTR("record not found", procName, NULL);
+    return pixcompReadStream(parch->fp);
+}
+
+
+/*!
+ * \brief   pixacompArchiveGetPix()
+ *
+ * \param[in]    parch
+ * \param[in]    index    into the archive; 0-based
+ * \return  pix, or NULL on error
+ *
+ * <pre>
+ * Notes:
+ *      (1) Only the pixcomp at %index is read and decompressed.
+ * </pre>
+ */
+PIX *
+pixacompArchiveGetPix(L_PIXAC_ARCHIVE  *parch,
+                      l_int32           index)
+{
+PIX   *pix;
+PIXC  *pixc;
+
+    PROCNAME("pixacompArchiveGetPix");
+
+    if (!parch)
+        return (PIX *)ERROR_PTR("parch not defined", procName, NULL);
+
+    if ((pixc = pixacompArchiveGetPixcomp(parch, index)) == NULL)
+        return (PIX *)ERROR_PTR("pixc not read", procName, NULL);
+    pix = pixCreateFromPixcomp(pixc);
+    pixcompDestroy(&pixc);
+    return pix;
+}
+
+
+/*!
+ * \brief   pixacompArchiveGetPixDimensions()
+ *
+ * \param[in]    parch
+ * \param[in]    index   into the archive; 0-based
+ * \param[out]   pw, ph, pd   [optional] each can be null
+ * \return  0 if OK, 1 on error
+ *
+ * <pre>
+ * Notes:
+ *      (1) The dimensions are taken from the index; no image data is read.
+ * </pre>
+ */
+l_ok
+pixacompArchiveGetPixDimensions(L_PIXAC_ARCHIVE  *parch,
+                                l_int32           index,
+                                l_int32          *pw,
+                                l_int32          *ph,
+                                l_int32          *pd)
+{
+    PROCNAME("pixacompArchiveGetPixDimensions");
+
+    if (pw) *pw = 0;
+    if (ph) *ph = 0;
+    if (pd) *pd = 0;
+    if (!parch)
+        return ERROR_INT("parch not defined", procName, 1);
+
+    if (pixacompArchiveGetEntry(parch, index, NULL, pw, ph, pd, NULL))
+        return ERROR_INT("index entry not read", procName, 1);
+    return 0;
+}
+
+
+/*!
+ * \brief   pixacompArchiveGetBox()
+ *
+ * \param[in]    parch
+ * \param[in]    index   into the archive; 0-based
+ * \return  box, or NULL if there is no box for %index or on error
+ *
+ * <pre>
+ * Notes:
+ *      (1) It is not an error for an entry to have no box.
+ * </pre>
+ */
+BOX *
+pixacompArchiveGetBox(L_PIXAC_ARCHIVE  *parch,
+                      l_int32           index)
+{
+BOX  *box;
+
+    PROCNAME("pixacompArchiveGetBox");
+
+    if (!parch)
+        return (BOX *)ERROR_PTR("parch not defined", procName, NULL);
+
+    if (pixacompArchiveGetEntry(parch, index, NULL, NULL, NULL, NULL, &box))
+        return (BOX *)ERROR_PTR("index entry not read", procName, NULL);
+    return box;
+}
+
+
+/*!
+ * \brief   pixacompArchiveGetEntry()
+ *
+ * \param[in]    parch
+ * \param[in]    index    into the archive; 0-based
+ * \param[out]   ploc     [optional] location of the pixcomp record
+ * \param[out]   pw, ph, pd   [optional] dimensions of the pix
+ * \param[out]   pbox     [optional] box; null if there is none
+ * \return  0 if OK, 1 on error
+ *
+ * <pre>
+ * Notes:
+ *      (1) If the archive is open for adding, the index entry is in
+ *          memory; otherwise it is read from the file.
+ * </pre>
+ */
+static l_int32
+pixacompArchiveGetEntry(L_PIXAC_ARCHIVE  *parch,
+                        l_int32           index,
+                        size_t           *ploc,
+                        l_int32          *pw,
+                        l_int32          *ph,
+                        l_int32          *pd,
+                        BOX             **pbox)
+{
+char      buf[ARCHIVE_ENTRY_SIZE + 1];
+l_uint8  *data;
+l_int32   w, h, d, bx, by, bw, bh;
+size_t    loc, offset;
+
+    PROCNAME("pixacompArchiveGetEntry");
+
+    if (pbox) *pbox = NULL;
+    if (index < 0 || index >= parch->n) {
+        L_ERROR("index %d not in [0 ... %d]\n", procName, index,
+                parch->n - 1);
+        return 1;
+    }
+
+    offset = (size_t)index * ARCHIVE_ENTRY_SIZE;
+    if (parch->index) {
+        data = l_byteaGetData(parch->index, NULL);
+        memcpy(buf, data + offset, ARCHIVE_ENTRY_SIZE);
+    } else {
+        if (fseek(parch->fp, parch->indexloc + offset, SEEK_SET) ||
+            fread(buf, 1, ARCHIVE_ENTRY_SIZE, parch->fp) != ARCHIVE_ENTRY_SIZE)
+            return ERROR_INT("index entry not read", procName, 1);
+    }
+    buf[ARCHIVE_ENTRY_SIZE] = '\0';
+    if (sscanf(buf, "%zu %d %d %d %d %d %d %d",
+               &loc, &w, &h, &d, &bx, &by, &bw, &bh) != 8)
+        return ERROR_INT("invalid index entry", procName, 1);
+    if (loc >= parch->indexloc)
+        return ERROR_INT("invalid record location", procName, 1);
+
+    if (ploc) *ploc = loc;
+    if (pw) *pw = w;
+    if (ph) *ph = h;
+    if (pd) *pd = d;
+    if (pbox && bw > 0 && bh > 0)
+        *pbox = boxCreate(bx, by, bw, bh);
+    return 0;
+}
+
+
+/*!
+ * \brief   pixacompWriteArchive()
+ *
+ * \param[in]    filename
+ * \param[in]    pixac
+ * \return  0 if OK, 1 on error
+ *
+ * <pre>
+ * Notes:
+ *      (1) Writes all the pixcomps in %pixac to a new archive.  The box
+ *          for each pixcomp, if it exists, is stored in the index.
+ *          Boxes are matched to pixcomps by index.  A pixcomp with no
+ *          box in the boxa, or with a box of (0,0,0,0), is stored
+ *          without a box.
+ * </pre>
+ */
+l_ok
+pixacompWriteArchive(const char  *filename,
+                     PIXAC       *pixac)
+{
+l_int32           i, n, nbox, ret;
+BOX              *box;
+PIXC             *pixc;
+L_PIXAC_ARCHIVE  *parch;
+
+    PROCNAME("pixacompWriteArchive");
+
+    if (!filename)
+        return ERROR_INT("filename not defined", procName, 1);
+    if (!pixac)
+        return ERROR_INT("pixac not defined", procName, 1);
+
+    if ((parch = pixacompArchiveCreate(filename)) == NULL)
+        return ERROR_INT("parch not made", procName, 1);
+    n = pixacompGetCount(pixac);
+    nbox = boxaGetCount(pixac->boxa);
+    for (i = 0, ret = 0; i < n && !ret; i++) {
+        pixc = pixacompGetPixcomp(pixac, pixac->offset + i, L_NOCOPY);
+        box = (i < nbox) ? boxaGetBox(pixac->boxa, i, L_CLONE) : NULL;
+        ret = pixacompArchiveAddPixcomp(parch, pixc, box);
+        boxDestroy(&box);
+    }
+    if (pixacompArchiveClose(&parch))
+        ret = 1;
+    if (ret)
+        return ERROR_INT("archive not written", procName, 1);
+    return 0;
+}
+
+
+/*!
+ * \brief   pixacompReadArchive()
+ *
+ * \param[in]    filename
+ * \return  pixac, or NULL on error
+ *
+ * <pre>
+ * Notes:
+ *      (1) Reads every pixcomp in the archive into a pixac.
+ *      (2) If any entry has a box, the pixac boxa gets one box for each
+ *          pixcomp, so that they stay aligned; entries without a box
+ *          get a placeholder box of (0,0,0,0).  If no entry has a box,
+ *          the boxa is empty.
+ *      (3) Use pixacompArchiveOpen() to read pixcomps individually.
+ * </pre>
+ */
+PIXAC *
+pixacompReadArchive(const char  *filename)
+{
+l_int32           i, n, hasbox;
+BOX              *box;
+BOXA             *boxa;
+PIXC             *pixc;
+PIXAC            *pixac;
+L_PIXAC_ARCHIVE  *parch;
+
+    PROCNAME("pixacompReadArchive");
+
+    if (!filename)
+        return (PIXAC *)ERROR_PTR("filename not defined", procName, NULL);
+
+    if ((parch = pixacompArchiveOpen(filename, 0)) == NULL)
+        return (PIXAC *)ERROR_PTR("parch not opened", procName, NULL);
+    n = pixacompArchiveGetCount(parch);
+    pixac = pixacompCreate(n);
+    boxa = boxaCreate(n);
+    hasbox = FALSE;
+    for (i = 0; i < n; i++) {
+        if ((pixc = pixacompArchiveGetPixcomp(parch, i)) == NULL) {
+            boxaDestroy(&boxa);
+            pixacompDestroy(&pixac);
+            pixacompArchiveClose(&parch);
+            return (PIXAC *)ERROR_PTR("pixc not read", procName, NULL);
+        }
+        pixacompAddPixcomp(pixac, pixc, L_INSERT);
+        if ((box = pixacompArchiveGetBox(parch, i)) != NULL)
+            hasbox = TRUE;
+        else
+            box = boxCreate(0, 0, 0, 0);
+        boxaAddBox(boxa, box, L_INSERT);
+    }
+    pixacompArchiveClose(&parch);
+
+    if (hasbox) {
+        boxaDestroy(&pixac->boxa);
+        pixac->boxa = boxa;
+    } else {
+        boxaDestroy(&boxa);
+    }
+    return pixac;
+}
+
+
 /*--------------------------------------------------------------------*
  *                         Conversion to pdf                          *
  *--------------------------------------------------------------------*/
@@ -31,6 +31,7 @@
  *
  *    Reading png through stream
  *          PIX        *pixReadStreamPng()
+ *          PIX        *pixReadStreamPngRegion()
  *
  *    Reading png header
  *          l_int32     readHeaderPng()
@@ -50,11 +51,12 @@
  *    Set flag for special read mode
  *          void        l_pngSetReadStrip16To8()
  *
+ *    Set row filter for writing
+ *          void        l_pngSetWriteFilter()
+ *          static l_int32  pngGetFilterMask()
+ *
  *    Low-level memio utility (thanks to T. D. Hintz)
- *          static void memio_png_write_data()
- *          static void memio_png_flush()
  *          static void memio_png_read_data()
- *          static void memio_free()
  *
  *    Reading png from memory
  *          PIX        *pixReadMemPng()
@@ -62,6 +64,13 @@
  *    Writing png to memory
  *          l_int32     pixWriteMemPng()
  *
+ *    Reusable encoder context
+ *          L_PNG_ENCODER  *pngEncoderCreate()
+ *          void        pngEncoderDestroy()
+ *          l_int32     pngEncoderEncode()
+ *          static l_int32  pngEncodeToBuffer()
+ *          static void png_encoder_write_data()
+ *
  *    Documentation: libpng.txt and example.c
  *
  *    On input (decompression from file), palette color images
@@ -96,6 +105,14 @@
  *    Note that if you are using the defined constants in zlib instead
  *    of the compression integers given above, you must include zlib.h.
  *
+ *    Most of the time for writing png is spent in zlib, and for 8 bps
+ *    images, libpng by default tries all five row filters on each row
+ *    to choose the best one.  To write faster, use l_pngSetWriteFilter()
+ *    to pick a single filter.  For example, L_PNG_FILTER_SUB with
+ *    compression 1 can be 6 times faster than the default, with files
+ *    that are typically 20-50% larger.  The output is always a
+ *    standard png file.
+ *
  *    There is global for determining the size of retained samples:
  *             var_PNG_STRIP_16_to_8
  *    and a function l_pngSetReadStrip16To8() for setting it.
@@ -141,6 +158,18 @@
      * If you don't strip, you can't read the gray-alpha spp = 2 images. */
 static l_int32   var_PNG_STRIP_16_TO_8 = 1;
 
+    /* Row filter for writing; the default lets libpng choose */
+static l_int32   var_PNG_WRITE_FILTER = L_PNG_FILTER_DEFAULT;
+
+static l_int32 pngGetFilterMask(l_int32 filter);
+static l_int32 pngEncodeToBuffer(L_PNG_ENCODER *enc, PIX *pix,
+                                 l_float32 gamma);
+static void png_encoder_write_data(png_structp png_ptr, png_bytep data,
+                                   png_size_t len);
+
+    /* Initial size of the output buffer of a L_PNG_ENCODER */
+static const size_t  PngInitBufferSize = 16384;
+
 #ifndef  NO_CONSOLE_IO
 #define  DEBUG_READ     0
 #define  DEBUG_WRITE    0
@@ -495,6 +524,218 @@ PIXCMAP     *cmap;
 }
 
 
+/*!
+ * \brief   pixReadStreamPngRegion()
+ *
+ * \param[in]    fp     file stream, positioned at the beginning of the file
+ * \param[in]    box    region to be read
+ * \return  pix, or NULL on error or if %box does not intersect the image
+ *
+ * <pre>
+ * Notes:
+ *      (1) This decodes the image one row at a time, discarding rows
+ *          above %box, and stops decoding after the last row of %box.
+ *          Only a single row of the full image is held in memory.
+ *          %box is clipped to the image.
+ *      (2) The pixels are identical to those in the clipped region of the
+ *          image returned by pixReadStreamPng().  The text chunk is only
+ *          read if it precedes the image data.
+ *      (3) Interlaced images must be fully decoded to get any row, so
+ *          for these we fall back to reading the full image and clipping.
+ * </pre>
+ */
+PIX *
+pixReadStreamPngRegion(FILE  *fp,
+                       BOX   *box)
+{
+l_int32      i, j, k, bx, by, bw, bh, d, spp, wpld, tRNS;
+l_int32      rval, gval, bval, cindex;
+l_uint32    *line, *ppixel;
+int          num_palette, num_text;
+long         fpos;
+png_byte     bit_depth, color_type;
+png_uint_32  w, h, rowbytes, xres, yres;
+png_bytep volatile rowbuf;
+png_structp  png_ptr;
+png_infop    info_ptr;
+png_colorp   palette;
+png_textp    text_ptr;
+BOX         *boxc;
+PIX         *pix, *pixd, *pixrow, *pix1;
+PIXCMAP     *cmap;
+
+    PROCNAME("pixReadStreamPngRegion");
+
+    if (!fp)
+        return (PIX *)ERROR_PTR("fp not defined", procName, NULL);
+    if (!box)
+        return (PIX *)ERROR_PTR("box not defined", procName, NULL);
+    fpos = ftell(fp);
+
+    if ((png_ptr = png_create_read_struct(PNG_LIBPNG_VER_STRING,
+                   (png_voidp)NULL, NULL, NULL)) == NULL)
+        return (PIX *)ERROR_PTR("png_ptr not made", procName, NULL);
+    if ((info_ptr = png_create_info_struct(png_ptr)) == NULL) {
+        png_destroy_read_struct(&png_ptr, (png_infopp)NULL, (png_infopp)NULL);
+        return (PIX *)ERROR_PTR("info_ptr not made", procName, NULL);
+    }
+    if (setjmp(png_jmpbuf(png_ptr))) {
+        png_destroy_read_struct(&png_ptr, &info_ptr, (png_infopp)NULL);
+        return (PIX *)ERROR_PTR("internal png error", procName, NULL);
+    }
+
+    png_init_io(png_ptr, fp);
+    png_read_info(png_ptr, info_ptr);
+    w = png_get_image_width(png_ptr, info_ptr);
+    h = png_get_image_height(png_ptr, info_ptr);
+    color_type = png_get_color_type(png_ptr, info_ptr);
+    tRNS = png_get_valid(png_ptr, info_ptr, PNG_INFO_tRNS) ? 1 : 0;
+    if ((boxc = boxClipToRectangle(box, w, h)) == NULL) {
+        png_destroy_read_struct(&png_ptr, &info_ptr, (png_infopp)NULL);
+        return (PIX *)ERROR_PTR("box outside image", procName, NULL);
+    }
+    boxGetGeometry(boxc, &bx, &by, &bw, &bh);
+    boxDestroy(&boxc);
+
+        /* Interlaced: read the full image and clip */
+    if (png_get_interlace_type(png_ptr, info_ptr) != PNG_INTERLACE_NONE) {
+        L_INFO("interlaced; reading full image\n", procName);
+        png_destroy_read_struct(&png_ptr, &info_ptr, (png_infopp)NULL);
+        if (fseek(fp, fpos, SEEK_SET) != 0)
+            return (PIX *)ERROR_PTR("stream not seekable", procName, NULL);
+        if ((pix = pixReadStreamPng(fp)) == NULL)
+            return (PIX *)ERROR_PTR("pix not read", procName, NULL);
+        pixd = pixClipRectangle(pix, box, NULL);
+        pixDestroy(&pix);
+        return pixd;
+    }
+
+        /* Gray with a tRNS chunk and no colormap: pixReadStreamPng()
+         * makes a fully transparent image, so there is nothing to decode */
+    if (tRNS && !(color_type & PNG_COLOR_MASK_PALETTE) &&
+        !(color_type & PNG_COLOR_MASK_COLOR)) {
+        png_destroy_read_struct(&png_ptr, &info_ptr, (png_infopp)NULL);
+        pixd = pixCreate(bw, bh, 32);
+        pixSetSpp(pixd, 4);
+        pixSetInputFormat(pixd, IFF_PNG);
+        return pixd;
+    }
+
+        /* Set the same transforms as pixReadStreamPng().  A colormap
+         * with transparency is expanded to RGBA, as is done there. */
+    if (var_PNG_STRIP_16_TO_8 == 1)
+        png_set_strip_16(png_ptr);
+    if ((color_type & PNG_COLOR_MASK_PALETTE) && tRNS) {
+        png_set_palette_to_rgb(png_ptr);
+        png_set_tRNS_to_alpha(png_ptr);
+    }
+    png_read_update_info(png_ptr, info_ptr);
+    bit_depth = png_get_bit_depth(png_ptr, info_ptr);
+    rowbytes = png_get_rowbytes(png_ptr, info_ptr);
+    spp = png_get_channels(png_ptr, info_ptr);
+    d = (spp == 1) ? bit_depth : 4 * bit_depth;
+    if (spp != 1 && bit_depth != 8) {
+        L_ERROR("spp = %d and bps = %d != 8\n"
+                "turn on 16 --> 8 stripping\n", procName, spp, bit_depth);
+        png_destroy_read_struct(&png_ptr, &info_ptr, (png_infopp)NULL);
+        return (PIX *)ERROR_PTR("not implemented for this image",
+            procName, NULL);
+    }
+
+    cmap = NULL;
+    if (spp == 1 && (color_type & PNG_COLOR_MASK_PALETTE)) {
+        png_get_PLTE(png_ptr, info_ptr, &palette, &num_palette);
+        cmap = pixcmapCreate(d);
+        for (cindex = 0; cindex < num_palette; cindex++) {
+            rval = palette[cindex].red;
+            gval = palette[cindex].green;
+            bval = palette[cindex].blue;
+            pixcmapAddColor(cmap, rval, gval, bval);
+        }
+    }
+
+    rowbuf = (png_bytep)LEPT_CALLOC(rowbytes + 1, sizeof(l_uint8));
+    pixrow = (spp == 1) ? pixCreate(w, 1, d) : NULL;
+    pixd = pixCreate(bw, bh, d);
+    if (!rowbuf || !pixd || (spp == 1 && !pixrow)) {
+        LEPT_FREE(rowbuf);
+        pixDestroy(&pixrow);
+        pixDestroy(&pixd);
+        pixcmapDestroy(&cmap);
+        png_destroy_read_struct(&png_ptr, &info_ptr, (png_infopp)NULL);
+        return (PIX *)ERROR_PTR("buffers not made", procName, NULL);
+    }
+    pixSetColormap(pixd, cmap);
+    pixSetSpp(pixd, (spp == 2) ? 4 : spp);
+    pixSetInputFormat(pixd, IFF_PNG);
+    wpld = pixGetWpl(pixd);
+
+        /* Reset error handling so that the buffers are freed */
+    if (setjmp(png_jmpbuf(png_ptr))) {
+        LEPT_FREE(rowbuf);
+        pixDestroy(&pixrow);
+        pixDestroy(&pixd);
+        png_destroy_read_struct(&png_ptr, &info_ptr, (png_infopp)NULL);
+        return (PIX *)ERROR_PTR("internal png error", procName, NULL);
+    }
+
+        /* Decode up to the last row of the box */
+    for (i = 0; i < by + bh; i++) {
+        png_read_row(png_ptr, rowbuf, NULL);
+        if (i < by) continue;
+        line = pixGetData(pixd) + (i - by) * wpld;
+        if (spp == 1) {
+            ppixel = pixGetData(pixrow);
+            for (j = 0; j < rowbytes; j++)
+                SET_DATA_BYTE(ppixel, j, rowbuf[j]);
+            pixRasterop(pixd, 0, i - by, bw, 1, PIX_SRC, pixrow, bx, 0);
+        } else if (spp == 2) {  /* grayscale + alpha; convert to RGBA */
+            for (j = 0, k = 2 * bx, ppixel = line; j < bw; j++) {
+                SET_DATA_BYTE(ppixel, COLOR_RED, rowbuf[k]);
+                SET_DATA_BYTE(ppixel, COLOR_GREEN, rowbuf[k]);
+                SET_DATA_BYTE(ppixel, COLOR_BLUE, rowbuf[k++]);
+                SET_DATA_BYTE(ppixel, L_ALPHA_CHANNEL, rowbuf[k++]);
+                ppixel++;
+            }
+        } else {  /* spp == 3 or spp == 4 */
+            for (j = 0, k = spp * bx, ppixel = line; j < bw; j++) {
+                SET_DATA_BYTE(ppixel, COLOR_RED, rowbuf[k++]);
+                SET_DATA_BYTE(ppixel, COLOR_GREEN, rowbuf[k++]);
+                SET_DATA_BYTE(ppixel, COLOR_BLUE, rowbuf[k++]);
+                if (spp == 3)
+                    SET_DATA_BYTE(ppixel, L_ALPHA_CHANNEL, 255);
+                else
+                    SET_DATA_BYTE(ppixel, L_ALPHA_CHANNEL, rowbuf[k++]);
+                ppixel++;
+            }
+        }
+    }
+    LEPT_FREE(rowbuf);
+    pixDestroy(&pixrow);
+
+    xres = png_get_x_pixels_per_meter(png_ptr, info_ptr);
+    yres = png_get_y_pixels_per_meter(png_ptr, info_ptr);
+    pixSetXRes(pixd, (l_int32)((l_float32)xres / 39.37 + 0.5));  /* to ppi */
+    pixSetYRes(pixd, (l_int32)((l_float32)yres / 39.37 + 0.5));  /* to ppi */
+    png_get_text(png_ptr, info_ptr, &text_ptr, &num_text);
+    if (num_text && text_ptr)
+        pixSetText(pixd, text_ptr->text);
+    png_destroy_read_struct(&png_ptr, &info_ptr, (png_infopp)NULL);
+
+        /* Final adjustments for 1 bpp, as in pixReadStreamPng() */
+    if (pixGetDepth(pixd) == 1) {
+        if (!pixGetColormap(pixd)) {
+            pixInvert(pixd, pixd);
+        } else {
+            pix1 = pixRemoveColormap(pixd, REMOVE_CMAP_BASED_ON_SRC);
+            pixDestroy(&pixd);
+            pixd = pix1;
+        }
+    }
+    return pixd;
+}
+
+
 /*---------------------------------------------------------------------*
  *                          Reading png header                         *
  *---------------------------------------------------------------------*/
@@ -1072,6 +1313,9 @@ char        *text;
     if (pix->special >= 10 && pix->special < 20)
         compval = pix->special - 10;
     png_set_compression_level(png_ptr, compval);
+    if (var_PNG_WRITE_FILTER != L_PNG_FILTER_DEFAULT)
+        png_set_filter(png_ptr, PNG_FILTER_TYPE_BASE,
+                       pngGetFilterMask(var_PNG_WRITE_FILTER));
 
     w = pixGetWidth(pix);
     h = pixGetHeight(pix);
@@ -1292,6 +1536,66 @@ l_pngSetReadStrip16To8(l_int32  flag)
 }
 
 
+/*---------------------------------------------------------------------*
+ *                     Set row filter for writing                      *
+ *---------------------------------------------------------------------*/
+/*!
+ * \brief   l_pngSetWriteFilter()
+ *
+ * \param[in]    filter   L_PNG_FILTER_DEFAULT, L_PNG_FILTER_NONE, ...
+ * \return  void
+ *
+ * <pre>
+ * Notes:
+ *      (1) This sets the row filter used for all subsequent png writes,
+ *          both to file and to memory.  Use L_PNG_FILTER_DEFAULT to
+ *          return to the libpng default.
+ *      (2) A single filter, such as L_PNG_FILTER_SUB or
+ *          L_PNG_FILTER_UP, is much faster than the adaptive choice
+ *          made by libpng for 8 bps images.
+ *      (3) As with l_pngSetReadStrip16To8(), results can be
+ *          non-deterministic if used with multi-threaded applications.
+ * </pre>
+ */
+void
+l_pngSetWriteFilter(l_int32  filter)
+{
+    PROCNAME("l_pngSetWriteFilter");
+
+    if (filter < L_PNG_FILTER_DEFAULT || filter > L_PNG_FILTER_ALL) {
+        L_ERROR("invalid filter %d; using default\n", procName, filter);
+        filter = L_PNG_FILTER_DEFAULT;
+    }
+    var_PNG_WRITE_FILTER = filter;
+}
+
+
+/*!
+ * \brief   pngGetFilterMask()
+ *
+ * \param[in]    filter   L_PNG_FILTER_NONE, ...
+ * \return  libpng filter mask
+ */
+static l_int32
+pngGetFilterMask(l_int32  filter)
+{
+    switch (filter) {
+    case L_PNG_FILTER_NONE:
+        return PNG_FILTER_NONE;
+    case L_PNG_FILTER_SUB:
+        return PNG_FILTER_SUB;
+    case L_PNG_FILTER_UP:
+        return PNG_FILTER_UP;
+    case L_PNG_FILTER_AVG:
+        return PNG_FILTER_AVG;
+    case L_PNG_FILTER_PAETH:
+        return PNG_FILTER_PAETH;
+    default:
+        return PNG_ALL_FILTERS;
+    }
+}
+
+
 /*-------------------------------------------------------------------------*
  *                               Memio utility                             *
  *    libpng read/write callback replacements for performing memory I/O    *
@@ -1315,142 +1619,8 @@ struct MemIOData
 };
 typedef struct MemIOData MEMIODATA;
 
-static void memio_png_write_data(png_structp png_ptr, png_bytep data,
-                                 png_size_t length);
-static void memio_png_flush(MEMIODATA* pthing);
 static void memio_png_read_data(png_structp png_ptr, png_bytep outBytes,
                                 png_size_t byteCountToRead);
-static void memio_free(MEMIODATA* pthing);
-
-static const l_int32  MEMIO_BUFFER_SIZE = 8192;  /*! buffer alloc size */
-
-/*
- * \brief   memio_png_write_data()
- *
- * \param[in]     png_ptr
- * \param[in]     data
- * \param[in]     len     size of array data in bytes
- *
- * <pre>
- * Notes:
- *      (1) This is a libpng callback for writing an image into a
- *          linked list of memory buffers.
- * </pre>
- */
-static void
-memio_png_write_data(png_structp  png_ptr,
-                     png_bytep    data,
-                     png_size_t   len)
-{
-MEMIODATA  *thing, *last;
-l_int32     written = 0;
-l_int32     remainingSpace, remainingToWrite;
-
-    thing = (struct MemIOData*)png_get_io_ptr(png_ptr);
-    last = (struct MemIOData*)thing->m_Last;
-    if (last->m_Buffer == NULL) {
-        if (len > MEMIO_BUFFER_SIZE) {
-            last->m_Buffer = (char *)LEPT_MALLOC(len);
-            memcpy(last->m_Buffer, data, len);
-            last->m_Size = last->m_Count = len;
-            return;
-        }
-
-        last->m_Buffer = (char *)LEPT_MALLOC(MEMIO_BUFFER_SIZE);
-        last->m_Size = MEMIO_BUFFER_SIZE;
-    }
-
-    while (written < len) {
-        if (last->m_Count == last->m_Size) {
-            MEMIODATA* next = (MEMIODATA *)LEPT_MALLOC(sizeof(MEMIODATA));
-            next->m_Next = NULL;
-            next->m_Count = 0;
-            next->m_Last = next;
-
-            last->m_Next = next;
-            last = thing->m_Last = next;
-
-            last->m_Buffer = (char *)LEPT_MALLOC(MEMIO_BUFFER_SIZE);
-            last->m_Size = MEMIO_BUFFER_SIZE;
-        }
-
-        remainingSpace = last->m_Size - last->m_Count;
-        remainingToWrite = len - written;
-        if (remainingSpace < remainingToWrite) {
-            memcpy(last->m_Buffer + last->m_Count, data + written,
-                   remainingSpace);
-            written += remainingSpace;
-            last->m_Count += remainingSpace;
-        } else {
-            memcpy(last->m_Buffer + last->m_Count, data + written,
-                   remainingToWrite);
-            written += remainingToWrite;
-            last->m_Count += remainingToWrite;
-        }
-    }
-}
-
-
-/*
- * \brief   memio_png_flush()
- *
- * \param[in]     pthing
- *
- * <pre>
- * Notes:
- *      (1) This consolidates write buffers into a single buffer at the
- *          haed of the link list of buffers.
- * </pre>
- */
-static void
-memio_png_flush(MEMIODATA  *pthing)
-{
-l_int32     amount = 0;
-l_int32     copied = 0;
-MEMIODATA  *buffer = 0;
-char       *data = 0;
-
-        /* If the data is in one buffer, give the buffer to the user. */
-    if (pthing->m_Next == NULL) return;
-
-        /* Consolidate multiple buffers into one new one; add the buffer
-         * sizes together. */
-    amount = pthing->m_Count;
-    buffer = pthing->m_Next;
-    while (buffer != NULL) {
-        amount += buffer->m_Count;
-        buffer = buffer->m_Next;
-    }
-
-        /* Copy data to a new buffer. */
-    data = (char *)LEPT_MALLOC(amount);
-    memcpy(data, pthing->m_Buffer, pthing->m_Count);
-    copied = pthing->m_Count;
-
-    LEPT_FREE(pthing->m_Buffer);
-    pthing->m_Buffer = NULL;
-
-        /* Don't delete original "thing" because we don't control it. */
-    buffer = pthing->m_Next;
-    pthing->m_Next = NULL;
-    while (buffer != NULL && copied < amount) {
-        MEMIODATA* old;
-        memcpy(data + copied, buffer->m_Buffer, buffer->m_Count);
-        copied += buffer->m_Count;
-
-        old = buffer;
-        buffer = buffer->m_Next;
-
-        LEPT_FREE(old->m_Buffer);
-        LEPT_FREE(old);
-    }
-
-    pthing->m_Buffer = data;
-    pthing->m_Count = copied;
-    pthing->m_Size = amount;
-    return;
-}
-
 
 /*
  * \brief   memio_png_read_data()
@@ -1481,38 +1651,6 @@ MEMIODATA  *thing;
 }
 
 
-/*
- * \brief   memio_free()
- *
- * \param[in]     pthing
- *
- * <pre>
- * Notes:
- *      (1) This frees all the write buffers in the linked list.  It must
- *          be done before exiting the pixWriteMemPng().
- * </pre>
- */
-static void
-memio_free(MEMIODATA*  pthing)
-{
-MEMIODATA  *buffer, *old;
-
-    if (pthing->m_Buffer != NULL)
-        LEPT_FREE(pthing->m_Buffer);
-
-    pthing->m_Buffer = NULL;
-    buffer = pthing->m_Next;
-    while (buffer != NULL) {
-        old = buffer;
-        buffer = buffer->m_Next;
-
-        if (old->m_Buffer != NULL)
-            LEPT_FREE(old->m_Buffer);
-        LEPT_FREE(old);
-    }
-}
-
-
 /*---------------------------------------------------------------------*
  *                       Reading png from memory                       *
  *---------------------------------------------------------------------*/
@@ -1863,6 +2001,8 @@ MEMIODATA    state;
  * <pre>
  * Notes:
  *      (1) See pixWriteStreamPng()
+ *      (2) To encode many images, use a L_PNG_ENCODER, which keeps
+ *          its output buffer between calls.
  * </pre>
  */
 l_ok
@@ -1871,6 +2011,158 @@ pixWriteMemPng(l_uint8  **pfiledata,
                PIX       *pix,
                l_float32  gamma)
 {
+l_uint8        *data;
+L_PNG_ENCODER   enc;
+
+    PROCNAME("pixWriteMemPng");
+
+    if (pfiledata) *pfiledata = NULL;
+    if (pfilesize) *pfilesize = 0;
+    if (!pfiledata)
+        return ERROR_INT("&filedata not defined", procName, 1);
+    if (!pfilesize)
+        return ERROR_INT("&filesize not defined", procName, 1);
+    if (!pix)
+        return ERROR_INT("pix not defined", procName, 1);
+
+    memset(&enc, 0, sizeof(L_PNG_ENCODER));
+    if (pngEncodeToBuffer(&enc, pix, gamma)) {
+        LEPT_FREE(enc.data);
+        return ERROR_INT("pix not written to memory", procName, 1);
+    }
+
+        /* Give the caller a buffer of the exact size */
+    if ((data = (l_uint8 *)LEPT_REALLOC(enc.data, enc.nbytes)) != NULL)
+        enc.data = data;
+    *pfiledata = enc.data;
+    *pfilesize = enc.nbytes;
+    return 0;
+}
+
+
+/*---------------------------------------------------------------------*
+ *                      Reusable encoder context                       *
+ *---------------------------------------------------------------------*/
+/*!
+ * \brief   pngEncoderCreate()
+ *
+ * \return  enc, or NULL on error
+ *
+ * <pre>
+ * Notes:
+ *      (1) An encoder holds an output buffer that grows to the size
+ *          of the largest image encoded, so that a sequence of images
+ *          can be compressed to memory without reallocating the output
+ *          for each image.
+ *      (2) An encoder may be used by only one thread at a time.  For
+ *          concurrent encoding, make one encoder for each thread.
+ *      (3) There is no decoder context: libpng read structs cannot be
+ *          reused, and pixReadMemPng() already reads directly from memory.
+ * </pre>
+ */
+L_PNG_ENCODER *
+pngEncoderCreate(void)
+{
+L_PNG_ENCODER  *enc;
+
+    PROCNAME("pngEncoderCreate");
+
+    if ((enc = (L_PNG_ENCODER *)LEPT_CALLOC(1, sizeof(L_PNG_ENCODER)))
+        == NULL)
+        return (L_PNG_ENCODER *)ERROR_PTR("enc not made", procName, NULL);
+    return enc;
+}
+
+
+/*!
+ * \brief   pngEncoderDestroy()
+ *
+ * \param[in,out]   penc    will be set to null before returning
+ * \return  void
+ */
+void
+pngEncoderDestroy(L_PNG_ENCODER  **penc)
+{
+L_PNG_ENCODER  *enc;
+
+    PROCNAME("pngEncoderDestroy");
+
+    if (penc == NULL) {
+        L_WARNING("ptr address is null!\n", procName);
+        return;
+    }
+    if ((enc = *penc) == NULL)
+        return;
+
+    LEPT_FREE(enc->data);
+    LEPT_FREE(enc);
+    *penc = NULL;
+}
+
+
+/*!
+ * \brief   pngEncoderEncode()
+ *
+ * \param[in]    enc
+ * \param[in]    pix
+ * \param[in]    gamma     use 0.0 if gamma is not defined
+ * \param[out]   pdata     png encoded data; owned by %enc
+ * \param[out]   psize     size of returned data
+ * \return  0 if OK, 1 on error
+ *
+ * <pre>
+ * Notes:
+ *      (1) This gives the same result as pixWriteMemPng().
+ *      (2) The returned data is owned by the encoder, and is valid
+ *          until the next call on %enc.  Do not free it; copy it if
+ *          it must be kept.
+ * </pre>
+ */
+l_ok
+pngEncoderEncode(L_PNG_ENCODER   *enc,
+                 PIX             *pix,
+                 l_float32        gamma,
+                 const l_uint8  **pdata,
+                 size_t          *psize)
+{
+    PROCNAME("pngEncoderEncode");
+
+    if (pdata) *pdata = NULL;
+    if (psize) *psize = 0;
+    if (!pdata || !psize)
+        return ERROR_INT("&data and &size not both defined", procName, 1);
+    if (!enc)
+        return ERROR_INT("enc not defined", procName, 1);
+    if (!pix)
+        return ERROR_INT("pix not defined", procName, 1);
+
+    if (pngEncodeToBuffer(enc, pix, gamma))
+        return ERROR_INT("pix not encoded", procName, 1);
+    *pdata = enc->data;
+    *psize = enc->nbytes;
+    return 0;
+}
+
+
+/*!
+ * \brief   pngEncodeToBuffer()
+ *
+ * \param[in]    enc       holds the growable output buffer
+ * \param[in]    pix
+ * \param[in]    gamma     use 0.0 if gamma is not defined
+ * \return  0 if OK; 1 on error
+ *
+ * <pre>
+ * Notes:
+ *      (1) This writes the png data to the start of the buffer in %enc,
+ *          which is enlarged as needed, and sets enc->nbytes.
+ * </pre>
+ */
+static l_int32
+pngEncodeToBuffer(L_PNG_ENCODER  *enc,
+                  PIX            *pix,
+                  l_float32       gamma)
+{
 char         commentstring[] = "Comment";
 l_int32      i, j, k;
 l_int32      wpl, d, spp, cmflag, opaque;
@@ -1889,24 +2181,10 @@ png_colorp   palette;
 PIX         *pix1;
 PIXCMAP     *cmap;
 char        *text;
-MEMIODATA    state;
 
-    PROCNAME("pixWriteMemPng");
-
-    if (pfiledata) *pfiledata = NULL;
-    if (pfilesize) *pfilesize = 0;
-    if (!pfiledata)
-        return ERROR_INT("&filedata not defined", procName, 1);
-    if (!pfilesize)
-        return ERROR_INT("&filesize not defined", procName, 1);
-    if (!pix)
-        return ERROR_INT("pix not defined", procName, 1);
+    PROCNAME("pngEncodeToBuffer");
 
-    state.m_Buffer = 0;
-    state.m_Size = 0;
-    state.m_Next = 0;
-    state.m_Count = 0;
-    state.m_Last = &state;
+    enc->nbytes = 0;
 
         /* Allocate the 2 data structures */
     if ((png_ptr = png_create_write_struct(PNG_LIBPNG_VER_STRING,
@@ -1921,10 +2199,11 @@ MEMIODATA    state;
         /* Set up png setjmp error handling */
     if (setjmp(png_jmpbuf(png_ptr))) {
         png_destroy_write_struct(&png_ptr, &info_ptr);
+        enc->nbytes = 0;
         return ERROR_INT("internal png error", procName, 1);
     }
 
-    png_set_write_fn(png_ptr, &state, memio_png_write_data,
+    png_set_write_fn(png_ptr, enc, png_encoder_write_data,
                      (png_flush_ptr)NULL);
 
         /* With best zlib compression (9), get between 1 and 10% improvement
@@ -1936,6 +2215,9 @@ MEMIODATA    state;
     if (pix->special >= 10 && pix->special < 20)
         compval = pix->special - 10;
     png_set_compression_level(png_ptr, compval);
+    if (var_PNG_WRITE_FILTER != L_PNG_FILTER_DEFAULT)
+        png_set_filter(png_ptr, PNG_FILTER_TYPE_BASE,
+                       pngGetFilterMask(var_PNG_WRITE_FILTER));
 
     w = pixGetWidth(pix);
     h = pixGetHeight(pix);
@@ -2042,7 +2324,6 @@ MEMIODATA    state;
         if (!pix1) {
             png_destroy_write_struct(&png_ptr, &info_ptr);
             if (cmflag) LEPT_FREE(palette);
-            memio_free(&state);
             return ERROR_INT("pix1 not made", procName, 1);
         }
 
@@ -2062,12 +2343,6 @@ MEMIODATA    state;
         LEPT_FREE(row_pointers);
         pixDestroy(&pix1);
         png_destroy_write_struct(&png_ptr, &info_ptr);
-
-        memio_png_flush(&state);
-        *pfiledata = (l_uint8 *)state.m_Buffer;
-        state.m_Buffer = 0;
-        *pfilesize = state.m_Count;
-        memio_free(&state);
         return 0;
     }
 
@@ -2103,15 +2378,47 @@ MEMIODATA    state;
     if (cmflag)
         LEPT_FREE(palette);
     png_destroy_write_struct(&png_ptr, &info_ptr);
-
-    memio_png_flush(&state);
-    *pfiledata = (l_uint8 *)state.m_Buffer;
-    state.m_Buffer = 0;
-    *pfilesize = state.m_Count;
-    memio_free(&state);
     return 0;
 }
 
+
+
+/*!
+ * \brief   png_encoder_write_data()
+ *
+ * \param[in]     png_ptr
+ * \param[in]     data
+ * \param[in]     len     size of array data in bytes
+ *
+ * <pre>
+ * Notes:
+ *      (1) This is a libpng callback for appending png data to the
+ *          buffer of a L_PNG_ENCODER.  The buffer is at least doubled
+ *          when it must be enlarged.
+ * </pre>
+ */
+static void
+png_encoder_write_data(png_structp  png_ptr,
+                       png_bytep    data,
+                       png_size_t   len)
+{
+size_t          newsize;
+l_uint8        *newbuf;
+L_PNG_ENCODER  *enc;
+
+    enc = (L_PNG_ENCODER *)png_get_io_ptr(png_ptr);
+    if (enc->nbytes + len > enc->size) {
+        newsize = L_MAX(2 * enc->size, enc->nbytes + len);
+        newsize = L_MAX(newsize, PngInitBufferSize);
+        if ((newbuf = (l_uint8 *)LEPT_REALLOC(enc->data, newsize)) == NULL)
+            png_error(png_ptr, "realloc fail in png_encoder_write_data");
+        enc->data = newbuf;
+        enc->size = newsize;
+    }
+    memcpy(enc->data + enc->nbytes, data, len);
+    enc->nbytes += len;
+}
+
 /* --------------------------------------------*/
 #endif  /* HAVE_LIBPNG */
 /* --------------------------------------------*/
@@ -49,6 +49,14 @@ PIX * pixReadStreamPng(FILE *fp)
 
 /* ----------------------------------------------------------------------*/
 
+PIX * pixReadStreamPngRegion(FILE *fp, BOX *box)
+{
+    return (PIX * )ERROR_PTR("function not present",
+                             "pixReadStreamPngRegion", NULL);
+}
+
+/* ----------------------------------------------------------------------*/
+
 l_ok readHeaderPng(const char *filename, l_int32 *pwidth, l_int32 *pheight,
                    l_int32 *pbps, l_int32 *pspp, l_int32 *piscmap)
 {
@@ -125,6 +133,14 @@ void l_pngSetReadStrip16To8(l_int32 flag)
 
 /* ----------------------------------------------------------------------*/
 
+void l_pngSetWriteFilter(l_int32 filter)
+{
+    L_ERROR("function not present\n", "l_pngSetWriteFilter");
+    return;
+}
+
+/* ----------------------------------------------------------------------*/
+
 PIX * pixReadMemPng(const l_uint8 *filedata, size_t filesize)
 {
     return (PIX * )ERROR_PTR("function not present", "pixReadMemPng", NULL);
@@ -138,6 +154,30 @@ l_ok pixWriteMemPng(l_uint8 **pfiledata, size_t *pfilesize, PIX *pix,
     return ERROR_INT("function not present", "pixWriteMemPng", 1);
 }
 
+/* ----------------------------------------------------------------------*/
+
+L_PNG_ENCODER * pngEncoderCreate(void)
+{
+    return (L_PNG_ENCODER * )ERROR_PTR("function not present",
+                                       "pngEncoderCreate", NULL);
+}
+
+/* ----------------------------------------------------------------------*/
+
+void pngEncoderDestroy(L_PNG_ENCODER **penc)
+{
+    L_ERROR("function not present\n", "pngEncoderDestroy");
+    return;
+}
+
+/* ----------------------------------------------------------------------*/
+
+l_ok pngEncoderEncode(L_PNG_ENCODER *enc, PIX *pix, l_float32 gamma,
+                      const l_uint8 **pdata, size_t *psize)
+{
+    return ERROR_INT("function not present", "pngEncoderEncode", 1);
+}
+
 /* --------------------------------------------*/
 #endif  /* !HAVE_LIBPNG */
 /* --------------------------------------------*/
@@ -43,7 +43,14 @@
  *          l_int32          pixWriteMemPam()
  *
  *      Local helpers
- *          static l_int32   pnmReadNextAsciiValue();
+ *          static PIX      *pnmReadRaster();
+ *          static void      pnmUnpackBytes();
+ *          static void      pnmReaderInit();
+ *          static l_int32   pnmReaderFill();
+ *          static l_uint8  *pnmReaderGetBytes();
+ *          static l_int32   pnmReaderSkipWhitespace();
+ *          static l_int32   pnmReaderNextAsciiValue();
+ *          static l_int32   pnmReaderNextAsciiBit();
  *          static l_int32   pnmReadNextNumber();
  *          static l_int32   pnmReadNextString();
  *          static l_int32   pnmSkipCommentLines();
@@ -60,8 +67,11 @@
  *      They are extremely wasteful of memory; for example, the P1 binary
  *      ASCII format is 16 times as big as the packed uncompressed
  *      format, because 2 characters are used to represent every bit
- *      (pixel) in the image.  Reading is slow because we check for extra
- *      white space and EOL at every sample value.
+ *      (pixel) in the image.  They are parsed from a buffer that is
+ *      filled in large blocks, so reading them is not unreasonably slow.
+ *
+ *      The raster of the packed formats is read one line at a time,
+ *      and pixReadMemPnm() decodes it directly from the input data.
  *
  *      The packed pnm formats ("raw") give file sizes similar to
  *      bmp files, which are uncompressed packed.  However, bmp
@@ -122,7 +132,29 @@
 #if  USE_PNMIO   /* defined in environ.h */
 /* --------------------------------------------*/
 
-static l_int32 pnmReadNextAsciiValue(FILE  *fp, l_int32 *pval);
+    /* Cursor for reading the raster, either from a stream through
+     * a buffer, or directly from memory */
+struct L_PnmReader
+{
+    FILE           *fp;       /* stream; NULL when reading from memory  */
+    const l_uint8  *data;     /* data in memory, or the buffer          */
+    size_t          size;     /* number of bytes available in data      */
+    size_t          pos;      /* location of the next byte to be read   */
+    l_uint8        *buf;      /* buffer for reading from the stream     */
+    size_t          bufsize;  /* size of the buffer                     */
+};
+typedef struct L_PnmReader  L_PNMREADER;
+
+static PIX *pnmReadRaster(L_PNMREADER *pr, l_int32 w, l_int32 h, l_int32 d,
+                          l_int32 type, l_int32 bps, l_int32 spp);
+static void pnmUnpackBytes(const l_uint8 *p, l_int32 nbytes, l_uint32 *line);
+static void pnmReaderInit(L_PNMREADER *pr, FILE *fp, const l_uint8 *data,
+                          size_t size);
+static l_int32 pnmReaderFill(L_PNMREADER *pr);
+static const l_uint8 *pnmReaderGetBytes(L_PNMREADER *pr, size_t nbytes);
+static l_int32 pnmReaderSkipWhitespace(L_PNMREADER *pr);
+static l_int32 pnmReaderNextAsciiValue(L_PNMREADER *pr, l_int32 *pval);
+static l_int32 pnmReaderNextAsciiBit(L_PNMREADER *pr, l_int32 *pval);
 static l_int32 pnmReadNextNumber(FILE *fp, l_int32 *pval);
 static l_int32 pnmReadNextString(FILE *fp, char *buff, l_int32 size);
 static l_int32 pnmSkipCommentLines(FILE  *fp);
@@ -131,6 +163,9 @@ static l_int32 pnmSkipCommentLines(FILE  *fp);
 static const l_int32  MAX_PNM_WIDTH = 100000;
 static const l_int32  MAX_PNM_HEIGHT = 100000;
 
+    /* size of the buffer for reading ASCII data from a stream */
+static const size_t  PnmBufferSize = 65536;
+
 
 /*--------------------------------------------------------------------*
  *                          Stream interface                          *
@@ -144,13 +179,9 @@ static const l_int32  MAX_PNM_HEIGHT = 100000;
 PIX *
 pixReadStreamPnm(FILE  *fp)
 {
-l_uint8    val8, rval8, gval8, bval8, aval8, mask8;
-l_uint16   val16, rval16, gval16, bval16, aval16;
-l_int32    w, h, d, bps, spp, bpl, wpl, i, j, type;
-l_int32    val, rval, gval, bval;
-l_uint32   rgbval;
-l_uint32  *line, *data;
-PIX       *pix;
+l_int32       w, h, d, bps, spp, type;
+PIX          *pix;
+L_PNMREADER   pr;
 
     PROCNAME("pixReadStreamPnm");
 
@@ -159,342 +190,11 @@ PIX       *pix;
 
     if (freadHeaderPnm(fp, &w, &h, &d, &type, &bps, &spp))
         return (PIX *)ERROR_PTR("header read failed", procName, NULL);
-    if (bps < 1 || bps > 16)
-        return (PIX *)ERROR_PTR("invalid bps", procName, NULL);
-    if (spp < 1 || spp > 4)
-        return (PIX *)ERROR_PTR("invalid spp", procName, NULL);
-    if ((pix = pixCreate(w, h, d)) == NULL)
-        return (PIX *)ERROR_PTR("pix not made", procName, NULL);
-    pixSetInputFormat(pix, IFF_PNM);
-    data = pixGetData(pix);
-    wpl = pixGetWpl(pix);
-
-        /* If type == 6 and bps == 16, we use the code in type 7
-         * to read 6 bytes/pixel from the input file. */
-    if (type == 6 && bps == 16)
-        type = 7;
-
-    switch (type) {
-    case 1:
-    case 2:
-        /* Old "ASCII" binary or gray format */
-        for (i = 0; i < h; i++) {
-            for (j = 0; j < w; j++) {
-                if (pnmReadNextAsciiValue(fp, &val)) {
-                    pixDestroy(&pix);
-                    return (PIX *)ERROR_PTR("read abend", procName, NULL);
-                }
-                pixSetPixel(pix, j, i, val);
-            }
-        }
-        break;
-
-    case 3:
-        /* Old "ASCII" rgb format */
-        for (i = 0; i < h; i++) {
-            for (j = 0; j < w; j++) {
-                if (pnmReadNextAsciiValue(fp, &rval)) {
-                    pixDestroy(&pix);
-                    return (PIX *)ERROR_PTR("read abend", procName, NULL);
-                }
-                if (pnmReadNextAsciiValue(fp, &gval)) {
-                    pixDestroy(&pix);
-                    return (PIX *)ERROR_PTR("read abend", procName, NULL);
-                }
-                if (pnmReadNextAsciiValue(fp, &bval)) {
-                    pixDestroy(&pix);
-                    return (PIX *)ERROR_PTR("read abend", procName, NULL);
-                }
-                composeRGBPixel(rval, gval, bval, &rgbval);
-                pixSetPixel(pix, j, i, rgbval);
-            }
-        }
-        break;
-
-    case 4:
-        /* "raw" format for 1 bpp */
-        bpl = (d * w + 7) / 8;
-        for (i = 0; i < h; i++) {
-            line = data + i * wpl;
-            for (j = 0; j < bpl; j++) {
-                if (fread(&val8, 1, 1, fp) != 1) {
-                    pixDestroy(&pix);
-                    return (PIX *)ERROR_PTR("read error in 4", procName, NULL);
-                }
-                SET_DATA_BYTE(line, j, val8);
-            }
-        }
-        break;
-
-    case 5:
-        /* "raw" format for grayscale */
-        for (i = 0; i < h; i++) {
-            line = data + i * wpl;
-            if (d != 16) {
-                for (j = 0; j < w; j++) {
-                    if (fread(&val8, 1, 1, fp) != 1) {
-                        pixDestroy(&pix);
-                        return (PIX *)ERROR_PTR("error in 5", procName, NULL);
-                    }
-                    if (d == 2)
-                        SET_DATA_DIBIT(line, j, val8);
-                    else if (d == 4)
-                        SET_DATA_QBIT(line, j, val8);
-                    else  /* d == 8 */
-                        SET_DATA_BYTE(line, j, val8);
-                }
-            } else {  /* d == 16 */
-                for (j = 0; j < w; j++) {
-                    if (fread(&val16, 2, 1, fp) != 1) {
-                        pixDestroy(&pix);
-                        return (PIX *)ERROR_PTR("16 bpp error", procName, NULL);
-                    }
-                    SET_DATA_TWO_BYTES(line, j, val16);
-                }
-            }
-        }
-        break;
-
-    case 6:
-        /* "raw" format, type == 6; 8 bps, rgb */
-        for (i = 0; i < h; i++) {
-            line = data + i * wpl;
-            for (j = 0; j < wpl; j++) {
-                if (fread(&rval8, 1, 1, fp) != 1) {
-                    pixDestroy(&pix);
-                    return (PIX *)ERROR_PTR("read error type 6",
-                                            procName, NULL);
-                }
-                if (fread(&gval8, 1, 1, fp) != 1) {
-                    pixDestroy(&pix);
-                    return (PIX *)ERROR_PTR("read error type 6",
-                                            procName, NULL);
-                }
-                if (fread(&bval8, 1, 1, fp) != 1) {
-                    pixDestroy(&pix);
-                    return (PIX *)ERROR_PTR("read error type 6",
-                                            procName, NULL);
-                }
-                composeRGBPixel(rval8, gval8, bval8, &rgbval);
-                line[j] = rgbval;
-            }
-        }
-        break;
-
-    case 7:
-        /* "arbitrary" format; type == 7; */
-        if (bps != 16) {
-            mask8 = (1 << bps) - 1;
-            switch (spp) {
-            case 1: /* 1, 2, 4, 8 bpp grayscale */
-                for (i = 0; i < h; i++) {
-                    for (j = 0; j < w; j++) {
-                        if (fread(&val8, 1, 1, fp) != 1) {
-                            pixDestroy(&pix);
-                            return (PIX *)ERROR_PTR("read error type 7",
-                                                    procName, NULL);
-                        }
-                        val8 = val8 & mask8;
-                        if (bps == 1) val8 ^= 1;  /* white-is-1 photometry */
-                        pixSetPixel(pix, j, i, val8);
-                    }
-                }
-                break;
-
-            case 2: /* 1, 2, 4, 8 bpp grayscale + alpha */
-                for (i = 0; i < h; i++) {
-                    for (j = 0; j < w; j++) {
-                        if (fread(&val8, 1, 1, fp) != 1) {
-                            pixDestroy(&pix);
-                            return (PIX *)ERROR_PTR("read error type 7",
-                                                    procName, NULL);
-                        }
-                        if (fread(&aval8, 1, 1, fp) != 1) {
-                            pixDestroy(&pix);
-                            return (PIX *)ERROR_PTR("read error type 7",
-                                                    procName, NULL);
-                        }
-                        val8 = val8 & mask8;
-                        aval8 = aval8 & mask8;
-                        composeRGBAPixel(val8, val8, val8, aval8, &rgbval);
-                        pixSetPixel(pix, j, i, rgbval);
-                    }
-                }
-                pixSetSpp(pix, 4);
-                break;
-
-            case 3: /* rgb */
-                for (i = 0; i < h; i++) {
-                    line = data + i * wpl;
-                    for (j = 0; j < wpl; j++) {
-                        if (fread(&rval8, 1, 1, fp) != 1) {
-                            pixDestroy(&pix);
-                            return (PIX *)ERROR_PTR("read error type 7",
-                                                    procName, NULL);
-                        }
-                        if (fread(&gval8, 1, 1, fp) != 1) {
-                            pixDestroy(&pix);
-                            return (PIX *)ERROR_PTR("read error type 7",
-                                                    procName, NULL);
-                        }
-                        if (fread(&bval8, 1, 1, fp) != 1) {
-                            pixDestroy(&pix);
-                            return (PIX *)ERROR_PTR("read error type 7",
-                                                    procName, NULL);
-                        }
-                        rval8 = rval8 & mask8;
-                        gval8 = gval8 & mask8;
-                        bval8 = bval8 & mask8;
-                        composeRGBPixel(rval8, gval8, bval8, &rgbval);
-                        line[j] = rgbval;
-                    }
-                }
-                break;
-
-            case 4: /* rgba */
-                for (i = 0; i < h; i++) {
-                    line = data + i * wpl;
-                    for (j = 0; j < wpl; j++) {
-                        if (fread(&rval8, 1, 1, fp) != 1) {
-                            pixDestroy(&pix);
-                            return (PIX *)ERROR_PTR("read error type 7",
-                                                    procName, NULL);
-                        }
-                        if (fread(&gval8, 1, 1, fp) != 1) {
-                            pixDestroy(&pix);
-                            return (PIX *)ERROR_PTR("read error type 7",
-                                                    procName, NULL);
-                        }
-                        if (fread(&bval8, 1, 1, fp) != 1) {
-                            pixDestroy(&pix);
-                            return (PIX *)ERROR_PTR("read error type 7",
-                                                    procName, NULL);
-                        }
-                        if (fread(&aval8, 1, 1, fp) != 1) {
-                            pixDestroy(&pix);
-                            return (PIX *)ERROR_PTR("read error type 7",
-                                                    procName, NULL);
-                        }
-                        rval8 = rval8 & mask8;
-                        gval8 = gval8 & mask8;
-                        bval8 = bval8 & mask8;
-                        aval8 = aval8 & mask8;
-                        composeRGBAPixel(rval8, gval8, bval8, aval8, &rgbval);
-                        line[j] = rgbval;
-                    }
-                }
-                pixSetSpp(pix, 4);
-                break;
-            }
-        } else {  /* bps == 16 */
-                /* I have only seen one example that is type 6, 16 bps.
-                 * It was 3 spp (rgb), and the 8 bps of real data was stored
-                 * in the second byte.  In the following, I make the wild
-                 * assumption that for all 16 bpp pnm/pam files, we can
-                 * take the second byte. */
-            switch (spp) {
-            case 1: /* 16 bps grayscale */
-                for (i = 0; i < h; i++) {
-                    for (j = 0; j < w; j++) {
-                        if (fread(&val16, 2, 1, fp) != 1) {
-                            pixDestroy(&pix);
-                            return (PIX *)ERROR_PTR("read error type 7",
-                                                    procName, NULL);
-                        }
-                        val8 = val16 & 0xff;
-                        pixSetPixel(pix, j, i, val8);
-                    }
-                }
-                break;
-
-            case 2: /* 16 bps grayscale + alpha */
-                for (i = 0; i < h; i++) {
-                    for (j = 0; j < w; j++) {
-                        if (fread(&val16, 2, 1, fp) != 1) {
-                            pixDestroy(&pix);
-                            return (PIX *)ERROR_PTR("read error type 7",
-                                                    procName, NULL);
-                        }
-                        if (fread(&aval16, 2, 1, fp) != 1) {
-                            pixDestroy(&pix);
-                            return (PIX *)ERROR_PTR("read error type 7",
-                                                    procName, NULL);
-                        }
-                        val8 = val16 & 0xff;
-                        aval8 = aval16 & 0xff;
-                        composeRGBAPixel(val8, val8, val8, aval8, &rgbval);
-                        pixSetPixel(pix, j, i, rgbval);
-                    }
-                }
-                pixSetSpp(pix, 4);
-                break;
-
-            case 3: /* 16bps rgb */
-                for (i = 0; i < h; i++) {
-                    line = data + i * wpl;
-                    for (j = 0; j < wpl; j++) {
-                        if (fread(&rval16, 2, 1, fp) != 1) {
-                            pixDestroy(&pix);
-                            return (PIX *)ERROR_PTR("read error type 7",
-                                                    procName, NULL);
-                        }
-                        if (fread(&gval16, 2, 1, fp) != 1) {
-                            pixDestroy(&pix);
-                            return (PIX *)ERROR_PTR("read error type 7",
-                                                    procName, NULL);
-                        }
-                        if (fread(&bval16, 2, 1, fp) != 1) {
-                            pixDestroy(&pix);
-                            return (PIX *)ERROR_PTR("read error type 7",
-                                                    procName, NULL);
-                        }
-                        rval8 = rval16 & 0xff;
-                        gval8 = gval16 & 0xff;
-                        bval8 = bval16 & 0xff;
-                        composeRGBPixel(rval8, gval8, bval8, &rgbval);
-                        line[j] = rgbval;
-                    }
-                }
-                break;
-
-            case 4: /* 16bps rgba */
-                for (i = 0; i < h; i++) {
-                    line = data + i * wpl;
-                    for (j = 0; j < wpl; j++) {
-                        if (fread(&rval16, 2, 1, fp) != 1) {
-                            pixDestroy(&pix);
-                            return (PIX *)ERROR_PTR("read error type 7",
-                                                    procName, NULL);
-                        }
-                        if (fread(&gval16, 2, 1, fp) != 1) {
-                            pixDestroy(&pix);
-                            return (PIX *)ERROR_PTR("read error type 7",
-                                                    procName, NULL);
-                        }
-                        if (fread(&bval16, 2, 1, fp) != 1) {
-                            pixDestroy(&pix);
-                            return (PIX *)ERROR_PTR("read error type 7",
-                                                    procName, NULL);
-                        }
-                        if (fread(&aval16, 2, 1, fp) != 1) {
-                            pixDestroy(&pix);
-                            return (PIX *)ERROR_PTR("read error type 7",
-                                                    procName, NULL);
-                        }
-                        rval8 = rval16 & 0xff;
-                        gval8 = gval16 & 0xff;
-                        bval8 = bval16 & 0xff;
-                        aval8 = aval16 & 0xff;
-                        composeRGBAPixel(rval8, gval8, bval8, aval8, &rgbval);
-                        line[j] = rgbval;
-                    }
-                }
-                pixSetSpp(pix, 4);
-                break;
-            }
-        }
-        break;
-    }
+    pnmReaderInit(&pr, fp, NULL, 0);
+    pix = pnmReadRaster(&pr, w, h, d, type, bps, spp);
+    LEPT_FREE(pr.buf);
+    if (!pix)
+        return (PIX *)ERROR_PTR("pix not read", procName, NULL);
     return pix;
 }
 
@@ -1148,14 +848,19 @@ PIX       *pixs;
  * <pre>
  * Notes:
  *      (1) The %size byte of %data must be a null character.
+ *      (2) Only the header is parsed through a memory stream.  The
+ *          raster is then decoded directly from %data.
  * </pre>
  */
 PIX *
 pixReadMemPnm(const l_uint8  *data,
               size_t          size)
 {
-FILE  *fp;
-PIX   *pix;
+l_int32       w, h, d, bps, spp, type;
+long          offset;
+FILE         *fp;
+PIX          *pix;
+L_PNMREADER   pr;
 
     PROCNAME("pixReadMemPnm");
 
@@ -1163,8 +868,17 @@ PIX   *pix;
         return (PIX *)ERROR_PTR("data not defined", procName, NULL);
     if ((fp = fopenReadFromMemory(data, size)) == NULL)
         return (PIX *)ERROR_PTR("stream not opened", procName, NULL);
-    pix = pixReadStreamPnm(fp);
+    if (freadHeaderPnm(fp, &w, &h, &d, &type, &bps, &spp)) {
+        fclose(fp);
+        return (PIX *)ERROR_PTR("header read failed", procName, NULL);
+    }
+    offset = ftell(fp);
     fclose(fp);
+    if (offset < 0 || (size_t)offset > size)
+        return (PIX *)ERROR_PTR("invalid header size", procName, NULL);
+
+    pnmReaderInit(&pr, NULL, data + offset, size - offset);
+    pix = pnmReadRaster(&pr, w, h, d, type, bps, spp);
     if (!pix) L_ERROR("pix not read\n", procName);
     return pix;
 }
@@ -1326,33 +1040,435 @@ FILE    *fp;
  *                          Static helpers                            *
  *--------------------------------------------------------------------*/
 /*!
- * \brief   pnmReadNextAsciiValue()
+ * \brief   pnmReadRaster()
  *
- *      Return: 0 if OK, 1 on error or EOF.
+ * \param[in]    pr     reader, positioned at the start of the raster
+ * \param[in]    w, h, d, type, bps, spp    from the header
+ * \return  pix, or NULL on error
  *
- *  Notes:
- *      (1) This reads the next sample value in ASCII from the file.
+ * <pre>
+ * Notes:
+ *      (1) This is used for reading from both a stream and memory.
+ *      (2) For the "raw" types, each raster line is read with a single
+ *          call, and the bytes are then unpacked into the pix.
+ *          For the "ASCII" types, the samples are parsed from a
+ *          buffer that is filled in large blocks.
+ * </pre>
+ */
+static PIX *
+pnmReadRaster(L_PNMREADER  *pr,
+              l_int32       w,
+              l_int32       h,
+              l_int32       d,
+              l_int32       type,
+              l_int32       bps,
+              l_int32       spp)
+{
+l_uint8         mask8;
+l_uint8        *row8;
+l_uint16        val16;
+l_int32         i, j, k, bpl, wpl, ret;
+l_int32         val, rval, gval, bval;
+l_uint32       *line, *data;
+const l_uint8  *p, *src;
+PIX            *pix;
+
+    PROCNAME("pnmReadRaster");
+
+    if (bps < 1 || bps > 16)
+        return (PIX *)ERROR_PTR("invalid bps", procName, NULL);
+    if (spp < 1 || spp > 4)
+        return (PIX *)ERROR_PTR("invalid spp", procName, NULL);
+    if ((pix = pixCreate(w, h, d)) == NULL)
+        return (PIX *)ERROR_PTR("pix not made", procName, NULL);
+    pixSetInputFormat(pix, IFF_PNM);
+    data = pixGetData(pix);
+    wpl = pixGetWpl(pix);
+
+        /* If type == 6 and bps == 16, we use the code in type 7
+         * to read 6 bytes/pixel from the input file. */
+    if (type == 6 && bps == 16)
+        type = 7;
+
+        /* Old "ASCII" binary, gray and rgb formats */
+    if (type <= 3) {
+        ret = 0;
+        for (i = 0; i < h && !ret; i++) {
+            line = data + i * wpl;
+            for (j = 0; j < w; j++) {
+                if (type == 1) {
+                    if ((ret = pnmReaderNextAsciiBit(pr, &val)) != 0)
+                        break;
+                    if (val) SET_DATA_BIT(line, j);
+                } else if (type == 2) {
+                    if ((ret = pnmReaderNextAsciiValue(pr, &val)) != 0)
+                        break;
+                    if (d == 2)
+                        SET_DATA_DIBIT(line, j, val);
+                    else if (d == 4)
+                        SET_DATA_QBIT(line, j, val);
+                    else if (d == 8)
+                        SET_DATA_BYTE(line, j, val);
+                    else  /* d == 16 */
+                        SET_DATA_TWO_BYTES(line, j, val);
+                } else {  /* type == 3 */
+                    if ((ret = pnmReaderNextAsciiValue(pr, &rval)) != 0 ||
+                        (ret = pnmReaderNextAsciiValue(pr, &gval)) != 0 ||
+                        (ret = pnmReaderNextAsciiValue(pr, &bval)) != 0)
+                        break;
+                    composeRGBPixel(rval, gval, bval, line + j);
+                }
+            }
+        }
+        if (ret) {
+            pixDestroy(&pix);
+            return (PIX *)ERROR_PTR("read abend", procName, NULL);
+        }
+        return pix;
+    }
+
+        /* "Raw" formats: get the number of bytes in each raster line */
+    if (type == 4)
+        bpl = (w + 7) / 8;
+    else if (type == 5)
+        bpl = (d == 16) ? 2 * w : w;
+    else if (type == 6)
+        bpl = 3 * w;
+    else  /* type == 7 */
+        bpl = ((bps == 16) ? 2 : 1) * spp * w;
+
+    row8 = NULL;
+    mask8 = (bps < 8) ? (1 << bps) - 1 : 0xff;
+    if (type == 7 && (bps == 16 || mask8 != 0xff))
+        row8 = (l_uint8 *)LEPT_CALLOC(spp * w, sizeof(l_uint8));
+
+    for (i = 0; i < h; i++) {
+        line = data + i * wpl;
+        if ((p = pnmReaderGetBytes(pr, bpl)) == NULL) {
+            L_ERROR("read error in type %d\n", procName, type);
+            LEPT_FREE(row8);
+            pixDestroy(&pix);
+            return NULL;
+        }
+
+        switch (type) {
+        case 4:  /* 1 bpp */
+            pnmUnpackBytes(p, bpl, line);
+            break;
+
+        case 5:  /* grayscale */
+            if (d == 2) {
+                for (j = 0; j < w; j++)
+                    SET_DATA_DIBIT(line, j, p[j]);
+            } else if (d == 4) {
+                for (j = 0; j < w; j++)
+                    SET_DATA_QBIT(line, j, p[j]);
+            } else if (d == 8) {
+                pnmUnpackBytes(p, bpl, line);
+            } else {  /* d == 16 */
+                for (j = 0; j < w; j++) {
+                    memcpy(&val16, p + 2 * j, 2);
+                    SET_DATA_TWO_BYTES(line, j, val16);
+                }
+            }
+            break;
+
+        case 6:  /* 8 bps rgb */
+            for (j = 0; j < w; j++, p += 3) {
+                line[j] = ((l_uint32)p[0] << L_RED_SHIFT) |
+                          ((l_uint32)p[1] << L_GREEN_SHIFT) |
+                          ((l_uint32)p[2] << L_BLUE_SHIFT);
+            }
+            break;
+
+        case 7:  /* "arbitrary" format */
+                /* I have only seen one example that is type 6, 16 bps.
+                 * It was 3 spp (rgb), and the 8 bps of real data was stored
+                 * in the second byte.  In the following, I make the wild
+                 * assumption that for all 16 bpp pnm/pam files, we can
+                 * take the second byte. */
+            src = p;
+            if (bps == 16) {
+                for (k = 0; k < spp * w; k++) {
+                    memcpy(&val16, p + 2 * k, 2);
+                    row8[k] = val16 & 0xff;
+                }
+                src = row8;
+            } else if (mask8 != 0xff) {
+                for (k = 0; k < spp * w; k++)
+                    row8[k] = p[k] & mask8;
+                src = row8;
+            }
+            switch (spp) {
+            case 1:  /* 1, 2, 4, 8 bpp grayscale; 16 bps into 16 bpp */
+                for (j = 0; j < w; j++) {
+                    if (d == 1) {
+                        if (src[j] == 0)  /* white-is-1 photometry */
+                            SET_DATA_BIT(line, j);
+                    } else if (d == 2) {
+                        SET_DATA_DIBIT(line, j, src[j]);
+                    } else if (d == 4) {
+                        SET_DATA_QBIT(line, j, src[j]);
+                    } else if (d == 8) {
+                        SET_DATA_BYTE(line, j, src[j]);
+                    } else {  /* d == 16 */
+                        SET_DATA_TWO_BYTES(line, j, src[j]);
+                    }
+                }
+                break;
+            case 2:  /* grayscale + alpha */
+                for (j = 0; j < w; j++, src += 2)
+                    composeRGBAPixel(src[0], src[0], src[0], src[1],
+                                     line + j);
+                break;
+            case 3:  /* rgb */
+                for (j = 0; j < w; j++, src += 3)
+                    composeRGBPixel(src[0], src[1], src[2], line + j);
+                break;
+            case 4:  /* rgba */
+                for (j = 0; j < w; j++, src += 4)
+                    composeRGBAPixel(src[0], src[1], src[2], src[3],
+                                     line + j);
+                break;
+            }
+            break;
+        }
+    }
+
+    if (type == 7 && (spp == 2 || spp == 4))
+        pixSetSpp(pix, 4);
+    LEPT_FREE(row8);
+    return pix;
+}
+
+
+/*!
+ * \brief   pnmUnpackBytes()
+ *
+ * \param[in]    p        bytes in raster order
+ * \param[in]    nbytes   number of bytes
+ * \param[in]    line     raster line of the pix
+ *
+ * <pre>
+ * Notes:
+ *      (1) This copies a raster line of 1 or 8 bpp data into the pix,
+ *          composing 4 bytes at a time into each 32-bit word.
+ * </pre>
+ */
+static void
+pnmUnpackBytes(const l_uint8  *p,
+               l_int32         nbytes,
+               l_uint32       *line)
+{
+l_int32  k, nwords;
+
+    nwords = nbytes / 4;
+    for (k = 0; k < nwords; k++, p += 4) {
+        line[k] = ((l_uint32)p[0] << 24) | ((l_uint32)p[1] << 16) |
+                  ((l_uint32)p[2] << 8) | (l_uint32)p[3];
+    }
+    for (k = 4 * nwords; k < nbytes; k++, p++)
+        SET_DATA_BYTE(line, k, *p);
+}
+
+
+/*!
+ * \brief   pnmReaderInit()
+ *
+ * \param[in]    pr     reader to be initialized
+ * \param[in]    fp     [optional] stream to read from
+ * \param[in]    data   [optional] data to read from, if %fp is NULL
+ * \param[in]    size   of data
+ *
+ * <pre>
+ * Notes:
+ *      (1) When reading from a stream, the caller must free pr->buf.
+ * </pre>
+ */
+static void
+pnmReaderInit(L_PNMREADER    *pr,
+              FILE           *fp,
+              const l_uint8  *data,
+              size_t          size)
+{
+    memset(pr, 0, sizeof(L_PNMREADER));
+    pr->fp = fp;
+    if (!fp) {
+        pr->data = data;
+        pr->size = size;
+    }
+}
+
+
+/*!
+ * \brief   pnmReaderFill()
+ *
+ * \param[in]    pr
+ * \return  0 if OK, 1 if there is no more data
+ *
+ * <pre>
+ * Notes:
+ *      (1) This refills the buffer from the stream, after all the
+ *          buffered bytes have been read.
+ * </pre>
  */
 static l_int32
-pnmReadNextAsciiValue(FILE     *fp,
-                      l_int32  *pval)
+pnmReaderFill(L_PNMREADER  *pr)
 {
-l_int32   c, ignore;
+    if (!pr->fp)
+        return 1;
+    if (pr->bufsize < PnmBufferSize) {
+        LEPT_FREE(pr->buf);
+        pr->buf = (l_uint8 *)LEPT_CALLOC(PnmBufferSize, sizeof(l_uint8));
+        pr->bufsize = (pr->buf) ? PnmBufferSize : 0;
+    }
+    pr->data = pr->buf;
+    pr->pos = 0;
+    pr->size = (pr->buf) ? fread(pr->buf, 1, pr->bufsize, pr->fp) : 0;
+    return (pr->size == 0) ? 1 : 0;
+}
 
-    PROCNAME("pnmReadNextAsciiValue");
 
-    if (!pval)
-        return ERROR_INT("&val not defined", procName, 1);
+/*!
+ * \brief   pnmReaderGetBytes()
+ *
+ * \param[in]    pr
+ * \param[in]    nbytes   number of bytes requested
+ * \return  pointer to %nbytes of data, or NULL on error or EOF
+ *
+ * <pre>
+ * Notes:
+ *      (1) When reading from memory, this returns a pointer into the
+ *          data without copying.  When reading from a stream, the bytes
+ *          are read into the buffer with a single call to fread().
+ *      (2) The returned data is valid until the next read.
+ * </pre>
+ */
+static const l_uint8 *
+pnmReaderGetBytes(L_PNMREADER  *pr,
+                  size_t        nbytes)
+{
+l_uint8        *buf;
+size_t          navail;
+const l_uint8  *p;
+
+    navail = pr->size - pr->pos;
+    if (navail >= nbytes) {
+        p = pr->data + pr->pos;
+        pr->pos += nbytes;
+        return p;
+    }
+    if (!pr->fp)
+        return NULL;
+
+        /* Move any buffered bytes to the start of a large enough buffer */
+    if (pr->bufsize < nbytes) {
+        if ((buf = (l_uint8 *)LEPT_CALLOC(nbytes, sizeof(l_uint8))) == NULL)
+            return NULL;
+        if (navail > 0) memcpy(buf, pr->data + pr->pos, navail);
+        LEPT_FREE(pr->buf);
+        pr->buf = buf;
+        pr->bufsize = nbytes;
+    } else if (navail > 0) {
+        memmove(pr->buf, pr->data + pr->pos, navail);
+    }
+    pr->data = pr->buf;
+    pr->size = pr->pos = 0;
+    if (fread(pr->buf + navail, 1, nbytes - navail, pr->fp) !=
+        nbytes - navail)
+        return NULL;
+    return pr->buf;
+}
+
+
+/*!
+ * \brief   pnmReaderSkipWhitespace()
+ *
+ * \param[in]    pr
+ * \return  the next char that is not whitespace or in a comment,
+ *          or EOF if there is none
+ */
+static l_int32
+pnmReaderSkipWhitespace(L_PNMREADER  *pr)
+{
+l_int32  c;
+
+    for (;;) {
+        if (pr->pos == pr->size && pnmReaderFill(pr))
+            return EOF;
+        c = pr->data[pr->pos++];
+        if (c == '#') {  /* skip the rest of the line */
+            do {
+                if (pr->pos == pr->size && pnmReaderFill(pr))
+                    return EOF;
+            } while (pr->data[pr->pos++] != '\n');
+        } else if (c != ' ' && c != '\t' && c != '\n' && c != '\r') {
+            return c;
+        }
+    }
+}
+
+
+/*!
+ * \brief   pnmReaderNextAsciiValue()
+ *
+ * \param[in]    pr
+ * \param[out]   pval
+ * \return  0 if OK, 1 on error or EOF
+ *
+ * <pre>
+ * Notes:
+ *      (1) This reads the next sample value in ASCII, and swallows
+ *          the character that follows it.
+ * </pre>
+ */
+static l_int32
+pnmReaderNextAsciiValue(L_PNMREADER  *pr,
+                        l_int32      *pval)
+{
+l_int32  c, val;
+
     *pval = 0;
-    if (!fp)
-        return ERROR_INT("stream not open", procName, 1);
-    do {  /* skip whitespace */
-        if ((c = fgetc(fp)) == EOF)
-            return 1;
-    } while (c == ' ' || c == '\t' || c == '\n' || c == '\r');
+    if ((c = pnmReaderSkipWhitespace(pr)) == EOF || !isdigit(c))
+        return 1;
+    val = c - '0';
+    for (;;) {
+        if (pr->pos == pr->size && pnmReaderFill(pr))
+            break;
+        c = pr->data[pr->pos++];
+        if (!isdigit(c))
+            break;
+        if (val < 1000000)
+            val = 10 * val + c - '0';
+    }
+    *pval = val;
+    return 0;
+}
+
+
+/*!
+ * \brief   pnmReaderNextAsciiBit()
+ *
+ * \param[in]    pr
+ * \param[out]   pval
+ * \return  0 if OK, 1 on error or EOF
+ *
+ * <pre>
+ * Notes:
+ *      (1) This reads the next bit in P1 format.  Each bit is a single
+ *          '0' or '1', and the whitespace between them is optional.
+ * </pre>
+ */
+static l_int32
+pnmReaderNextAsciiBit(L_PNMREADER  *pr,
+                      l_int32      *pval)
+{
+l_int32  c;
 
-    fseek(fp, -1L, SEEK_CUR);        /* back up one byte */
-    ignore = fscanf(fp, "%d", pval);
+    *pval = 0;
+    if ((c = pnmReaderSkipWhitespace(pr)) != '0' && c != '1')
+        return 1;
+    *pval = c - '0';
     return 0;
 }
 
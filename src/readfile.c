@@ -36,6 +36,13 @@
  *           PIX       *pixReadIndexed()
  *           PIX       *pixReadStream()
  *
+ *      Read a region, decoding only what is needed
+ *           PIX       *pixReadRegion()
+ *           PIX       *pixReduceForRead()
+ *
+ *      Read a thumbnail, reducing while decoding
+ *           PIX       *pixReadThumbnail()
+ *
  *      Read header information from file
  *           l_int32    pixReadHeader()
  *
@@ -418,6 +425,281 @@ PIXCMAP  *cmap;
 
 
 
+/*---------------------------------------------------------------------*
+ *               Read a region, decoding only what is needed           *
+ *---------------------------------------------------------------------*/
+/*!
+ * \brief   pixReadRegion()
+ *
+ * \param[in]    filename    with full pathname or in local directory
+ * \param[in]    box         region to be read, at full resolution
+ * \param[in]    reduction   1, 2, 4, 8 or 16
+ * \return  pix if OK; NULL on error
+ *
+ * <pre>
+ * Notes:
+ *      (1) This returns the region of the image (page 0 for tiff) in
+ *          %box, reduced in size by %reduction.  %box is clipped to the
+ *          image; it is an error if it does not intersect the image.
+ *      (2) For tiff and png, only the part of the image that is needed
+ *          is decoded, and the full resolution image is usually not
+ *          held in memory:
+ *          ~ tiff: only the strips or tiles intersecting the box are
+ *            decoded.  Tiled tiff, which pixRead() does not support,
+ *            can be read this way.  Images that are not read as raw
+ *            samples (e.g., rgba) are decoded a strip at a time, so a
+ *            single-strip image is decoded in full; see
+ *            pixReadStreamTiffRegion().
+ *          ~ png: rows above the box are discarded as they are decoded,
+ *            and decoding stops after the last row of the box.
+ *            Interlaced png must be fully decoded.
+ *      (3) For jp2k, the box and reduction are handled by the decoder.
+ *          For jpeg, the reduction is done by the decoder (with DCT
+ *          scaling) and the region is clipped from the result.
+ *          For all other formats, the full image is read and clipped.
+ *      (4) Where the decoder does not perform the reduction, the clipped
+ *          region is reduced with pixReduceForRead().
+ * </pre>
+ */
+PIX *
+pixReadRegion(const char  *filename,
+              BOX         *box,
+              l_int32      reduction)
+{
+l_int32  format, jpegred;
+FILE    *fp;
+BOX     *box1;
+PIX     *pix1, *pix2, *pixd;
+
+    PROCNAME("pixReadRegion");
+
+    if (!filename)
+        return (PIX *)ERROR_PTR("filename not defined", procName, NULL);
+    if (!box)
+        return (PIX *)ERROR_PTR("box not defined", procName, NULL);
+    if (reduction != 1 && reduction != 2 && reduction != 4 &&
+        reduction != 8 && reduction != 16)
+        return (PIX *)ERROR_PTR("invalid reduction", procName, NULL);
+
+    if ((fp = fopenReadStream(filename)) == NULL)
+        return (PIX *)ERROR_PTR("image file not found", procName, NULL);
+    findFileFormatStream(fp, &format);
+
+    pix1 = NULL;
+    switch (format)
+    {
+    case IFF_PNG:
+        pix1 = pixReadStreamPngRegion(fp, box);
+        break;
+
+    case IFF_TIFF:
+    case IFF_TIFF_PACKBITS:
+    case IFF_TIFF_RLE:
+    case IFF_TIFF_G3:
+    case IFF_TIFF_G4:
+    case IFF_TIFF_LZW:
+    case IFF_TIFF_ZIP:
+    case IFF_TIFF_JPEG:
+        pix1 = pixReadStreamTiffRegion(fp, 0, box);
+        break;
+
+    case IFF_JP2:
+        fclose(fp);
+        if ((pixd = pixReadJp2k(filename, reduction, box, 0, 0)) == NULL)
+            return (PIX *)ERROR_PTR("jp2: no pix returned", procName, NULL);
+        return pixd;
+
+    case IFF_JFIF_JPEG:
+        jpegred = L_MIN(8, reduction);
+        pix2 = pixReadStreamJpeg(fp, 0, jpegred, NULL, 0);
+        fclose(fp);
+        if (!pix2)
+            return (PIX *)ERROR_PTR("jpeg: no pix returned", procName, NULL);
+        box1 = boxTransform(box, 0, 0, 1.0 / jpegred, 1.0 / jpegred);
+        pix1 = pixClipRectangle(pix2, box1, NULL);
+        pixDestroy(&pix2);
+        boxDestroy(&box1);
+        if (!pix1)
+            return (PIX *)ERROR_PTR("box outside image", procName, NULL);
+        pixd = pixReduceForRead(pix1, reduction / jpegred);
+        pixDestroy(&pix1);
+        return pixd;
+
+    default:
+        if ((pix2 = pixReadStream(fp, 0)) != NULL) {
+            pix1 = pixClipRectangle(pix2, box, NULL);
+            pixDestroy(&pix2);
+        }
+        break;
+    }
+    fclose(fp);
+
+    if (!pix1)
+        return (PIX *)ERROR_PTR("region not read", procName, NULL);
+    pixd = pixReduceForRead(pix1, reduction);
+    pixDestroy(&pix1);
+    return pixd;
+}
+
+
+/*!
+ * \brief   pixReduceForRead()
+ *
+ * \param[in]    pixs
+ * \param[in]    factor    integer reduction factor >= 1
+ * \return  pixd, reduced by %factor, or NULL on error
+ *
+ * <pre>
+ * Notes:
+ *      (1) This finishes off a reduced read, when the decoder does
+ *          not perform all of the reduction.  A copy is returned
+ *          if %factor == 1.
+ *      (2) Area mapping is used where possible.  1 and 16 bpp, and
+ *          images with colormaps, are subsampled.
+ * </pre>
+ */
+PIX *
+pixReduceForRead(PIX     *pixs,
+                 l_int32  factor)
+{
+l_int32  d;
+
+    PROCNAME("pixReduceForRead");
+
+    if (!pixs)
+        return (PIX *)ERROR_PTR("pixs not defined", procName, NULL);
+    if (factor <= 1)
+        return pixCopy(NULL, pixs);
+    d = pixGetDepth(pixs);
+    if (d == 1 || d == 16 || pixGetColormap(pixs))
+        return pixScaleByIntSampling(pixs, factor);
+    return pixScaleAreaMap(pixs, 1.0 / factor, 1.0 / factor);
+}
+
+
+/*---------------------------------------------------------------------*
+ *               Read a thumbnail, reducing while decoding             *
+ *---------------------------------------------------------------------*/
+/*!
+ * \brief   pixReadThumbnail()
+ *
+ * \param[in]    filename    with full pathname or in local directory
+ * \param[in]    maxw        max width of thumbnail; use 0 for no constraint
+ * \param[in]    maxh        max height of thumbnail; use 0 for no constraint
+ * \return  pix if OK; NULL on error
+ *
+ * <pre>
+ * Notes:
+ *      (1) This returns the image (page 0 for tiff) scaled down, preserving
+ *          the aspect ratio, to fit within %maxw x %maxh.  At least one
+ *          of %maxw and %maxh must be > 0.  Images that already fit
+ *          are returned at full resolution.
+ *      (2) The cheapest available decode-time reduction is used, which
+ *          gives an image no smaller than the thumbnail:
+ *            jpeg:  DCT scaling by 2, 4 or 8
+ *            jp2k:  a reduced resolution level (power of 2, up to 16)
+ *            webp:  decoded directly at the thumbnail size
+ *            tiff:  a stored reduced resolution image (SubIFD or
+ *                   FILETYPE_REDUCEDIMAGE IFD), if available
+ *          All other formats are decoded at full resolution.
+ *      (3) The result is resampled to the thumbnail size with
+ *          pixScaleToGray() for 1 bpp, giving 8 bpp, and with
+ *          pixScale() otherwise.
+ * </pre>
+ */
+PIX *
+pixReadThumbnail(const char  *filename,
+                 l_int32      maxw,
+                 l_int32      maxh)
+{
+l_uint8   *data;
+l_int32    format, w, h, wd, hd, ws, hs, reduction;
+size_t     nbytes;
+l_float32  scale, scalex, scaley;
+FILE      *fp;
+PIX       *pixs, *pixd;
+
+    PROCNAME("pixReadThumbnail");
+
+    if (!filename)
+        return (PIX *)ERROR_PTR("filename not defined", procName, NULL);
+    if (maxw <= 0 && maxh <= 0)
+        return (PIX *)ERROR_PTR("neither maxw nor maxh > 0", procName, NULL);
+
+    if (pixReadHeader(filename, &format, &w, &h, NULL, NULL, NULL))
+        return (PIX *)ERROR_PTR("header not read", procName, NULL);
+    scalex = (maxw > 0) ? (l_float32)maxw / (l_float32)w : 1.0;
+    scaley = (maxh > 0) ? (l_float32)maxh / (l_float32)h : 1.0;
+    scale = L_MIN(scalex, scaley);
+    if (scale >= 1.0)
+        return pixRead(filename);
+    wd = L_MAX(1, (l_int32)(scale * w + 0.5));
+    hd = L_MAX(1, (l_int32)(scale * h + 0.5));
+
+        /* Largest power of 2 reduction that is not smaller than
+         * the thumbnail */
+    for (reduction = 1; reduction < 16; reduction *= 2) {
+        if ((w + 2 * reduction - 1) / (2 * reduction) < wd ||
+            (h + 2 * reduction - 1) / (2 * reduction) < hd)
+            break;
+    }
+
+    pixs = NULL;
+    switch (format)
+    {
+    case IFF_JFIF_JPEG:
+        pixs = pixReadJpeg(filename, 0, L_MIN(8, reduction), NULL, 0);
+        break;
+
+    case IFF_JP2:
+            /* The reduction must be one of the stored resolution levels */
+        for (; reduction >= 1 && !pixs; reduction /= 2)
+            pixs = pixReadJp2k(filename, reduction, NULL, 0, 0);
+        break;
+
+    case IFF_WEBP:
+        if ((data = l_binaryRead(filename, &nbytes)) != NULL) {
+            pixd = pixReadMemWebPScaled(data, nbytes, wd, hd);
+            LEPT_FREE(data);
+            if (pixd) return pixd;
+        }
+        break;
+
+    case IFF_TIFF:
+    case IFF_TIFF_PACKBITS:
+    case IFF_TIFF_RLE:
+    case IFF_TIFF_G3:
+    case IFF_TIFF_G4:
+    case IFF_TIFF_LZW:
+    case IFF_TIFF_ZIP:
+    case IFF_TIFF_JPEG:
+        if ((fp = fopenReadStream(filename)) != NULL) {
+            pixs = pixReadStreamTiffReduced(fp, wd, hd);
+            fclose(fp);
+        }
+        break;
+
+    default:
+        break;
+    }
+    if (!pixs && (pixs = pixRead(filename)) == NULL)
+        return (PIX *)ERROR_PTR("pixs not read", procName, NULL);
+
+        /* Finish with a small resampling */
+    pixGetDimensions(pixs, &ws, &hs, NULL);
+    scale = L_MIN((l_float32)wd / (l_float32)ws,
+                  (l_float32)hd / (l_float32)hs);
+    if (scale >= 1.0)
+        pixd = pixClone(pixs);
+    else if (pixGetDepth(pixs) == 1)
+        pixd = pixScaleToGray(pixs, scale);
+    else
+        pixd = pixScale(pixs, scale, scale);
+    pixDestroy(&pixs);
+    return pixd;
+}
+
+
 /*---------------------------------------------------------------------*
  *                     Read header information from file               *
  *---------------------------------------------------------------------*/
@@ -775,8 +1057,9 @@ l_uint16  twobytepw;
         return 0;
     }
 
-        /* Check for "spix" serialized pix */
-    if (buf[0] == 's' && buf[1] == 'p' && buf[2] == 'i' && buf[3] == 'x') {
+        /* Check for "spix" or "spx2" serialized pix */
+    if ((buf[0] == 's' && buf[1] == 'p' && buf[2] == 'i' && buf[3] == 'x') ||
+        (buf[0] == 's' && buf[1] == 'p' && buf[2] == 'x' && buf[3] == '2')) {
         *pformat = IFF_SPIX;
         return 0;
     }
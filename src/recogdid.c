@@ -412,21 +412,21 @@ L_RDID   *did;
          * locations where the left side of pix2 goes from 0 to nx - 1
          * in pix1.  Do this around the vertical alignment of the pix2
          * centroid and the windowed pix1 centroid.
-         *  (1) Start with pix3 cleared and approximately equal in size to pix1.
-         *  (2) Blit the y-shifted pix2 onto pix3.  Then all ON pixels
-         *      are within the intersection of pix1 and the shifted pix2.
-         *  (3) AND pix1 with pix3. */
+         *  (1) For each location, blit the window of pix1 that pix2 can
+         *      overlap into pix3, with its left edge on a word boundary.
+         *      pix3 has the same width as pix2, and its pad bits are 0.
+         *  (2) For each vertical shift of pix2, count the ON pixels in
+         *      the AND of pix3 and the shifted pix2, using
+         *      pixCorrelationCountShiftedRows(). */
     pix3 = pixCreate(w2, h1, 1);
     for (i = 0; i < nx; i++) {
+        pixRasterop(pix3, 0, 0, w2, h1, PIX_SRC, pix1, i, 0);
         shifty = (l_int32)(ycent1[i] - ycent2 + 0.5);
         maxcount = 0;
         maxdely = 0;
         for (j = -MaxYShift; j <= MaxYShift; j++) {
-            pixClearAll(pix3);
             dely = shifty + j;  /* amount pix2 is shifted relative to pix1 */
-            pixRasterop(pix3, 0, dely, w2, h2, PIX_SRC, pix2, 0, 0);
-            pixRasterop(pix3, 0, 0, w2, h1, PIX_SRC & PIX_DST, pix1, i, 0);
-            pixCountPixels(pix3, &count, sumtab);
+            pixCorrelationCountShiftedRows(pix3, pix2, dely, sumtab, &count);
             if (count > maxcount) {
                 maxcount = count;
                 maxdely = dely;
@@ -43,6 +43,7 @@
  *         l_int32             recogIdentifyPixa()
  *         l_int32             recogIdentifyPix()
  *         l_int32             recogSkipIdentify()
+ *         static l_int32      recogFindBestTemplates()
  *
  *      Operations for handling identification results
  *         static L_RCHA      *rchaCreate()
@@ -117,6 +118,10 @@ static l_int32 pixCorrelationBestShift(PIX *pix1, PIX *pix2, NUMA *nasum1,
                                        l_int32 *tab8, l_int32 *pdelx,
                                        l_int32 *pdely, l_float32 *pscore,
                                        l_int32 debugflag );
+static l_int32 recogFindBestTemplates(L_RECOG *recog, PIXA *pixa,
+                                      l_int32 *bestindex, l_int32 *bestsample,
+                                      l_int32 *bestdelx, l_int32 *bestdely,
+                                      l_int32 *bestwidth, l_float32 *maxscore);
 static L_RCH *rchCreate(l_int32 index, l_float32 score, char *text,
                         l_int32 sample, l_int32 xloc, l_int32 yloc,
                         l_int32 width);
@@ -641,7 +646,7 @@ PIX       *pix1, *pix2;
             ptaGetIPt(recog->pta_u, i, NULL, &ycent2);
             pixCorrelationBestShift(pix1, pix2, nasum, namoment, area2, ycent2,
                                     recog->maxyshift, recog->sumtab, &delx,
-                                    &dely, &score, 1);
+                                    &dely, &score, (ppixdb) ? 1 : 0);
             if (ppixdb) {
                 lept_stderr(
                     "Best match template %d: (x,y) = (%d,%d), score = %5.3f\n",
@@ -722,7 +727,11 @@ PIX       *pix1, *pix2;
  *          and where the centroid of pix2 is aligned, within +-maxyshift,
  *          with the centroid of a window of pix1 of the same width.
  *          The correlation is taken over the full height of pix1.
- *          This can be made more efficient.
+ *      (4) Each window of pix1 is extracted once and compared with all
+ *          vertical shifts of pix2 by word-wise ANDing of rows, so no
+ *          images are made or cleared within the search.  Without debug
+ *          output, windows that can't improve on the best score are
+ *          skipped.  The result is the same as for an exhaustive search.
  * </pre>
  */
 static l_int32
@@ -739,13 +748,13 @@ pixCorrelationBestShift(PIX        *pix1,
                         l_float32  *pscore,
                         l_int32     debugflag)
 {
-l_int32     w1, w2, h1, h2, i, j, nx, shifty, delx, dely;
-l_int32     sum, moment, count;
+l_int32     w1, w2, h1, h2, i, j, nx, shifty, shift, delx, dely;
+l_int32     sum, moment, count, amin;
 l_int32    *tab, *area1, *arraysum, *arraymoment;
-l_float32   maxscore, score;
+l_float32   maxscore, score, bound;
 l_float32  *ycent1;
 FPIX       *fpix;
-PIX        *pixt, *pixt1, *pixt2;
+PIX        *pixw, *pixt1, *pixt2;
 
     PROCNAME("pixCorrelationBestShift");
 
@@ -801,30 +810,40 @@ PIX        *pixt, *pixt1, *pixt2;
     area1[nx - 1] = sum;
     ycent1[nx - 1] = (sum == 0) ? ycent2 : (l_float32)moment / (l_float32)sum;
 
-        /* Find the best match location for pix2.  At each location,
-         * to insure that pixels are ON only within the intersection of
-         * pix and the shifted pix2:
-         *  (1) Start with pixt cleared and equal in size to pix1.
-         *  (2) Blit the shifted pix2 onto pixt.  Then all ON pixels
-         *      are within the intersection of pix1 and the shifted pix2.
-         *  (3) AND pix1 with pixt. */
-    pixt = pixCreate(w2, h1, 1);
+        /* Find the best match location for pix2.  At each x location,
+         * the window of pix1 that pix2 can overlap is blitted once into
+         * pixw, with its left edge on a word boundary.  Each vertical
+         * shift of pix2 is then scored by ANDing the rows of pix2 with
+         * the overlapping rows of pixw, a word at a time, using
+         * pixCorrelationCountShiftedRows().  The pad bits of pixw
+         * are 0, so those of pix2 are ignored.
+         * Because count <= min(area1, area2), the score at each
+         * location is bounded by min(area1, area2)^2 / (area1 * area2),
+         * and without debug output, locations where that bound can't
+         * beat the best score found so far are skipped. */
+    pixw = pixCreate(w2, h1, 1);
     maxscore = 0;
     delx = 0;
     dely = 0;  /* amount to shift pix2 relative to pix1 to get alignment */
     for (i = 0; i < nx; i++) {
+        if (debugflag <= 0) {
+            if (area1[i] == 0) continue;
+            amin = L_MIN(area1[i], area2);
+            bound = (l_float32)amin * (l_float32)amin /
+                    ((l_float32)area1[i] * (l_float32)area2);
+            if (bound <= maxscore) continue;
+        }
+        pixRasterop(pixw, 0, 0, w2, h1, PIX_SRC, pix1, i, 0);
         shifty = (l_int32)(ycent1[i] - ycent2 + 0.5);
         for (j = -maxyshift; j <= maxyshift; j++) {
-            pixClearAll(pixt);
-            pixRasterop(pixt, 0, shifty + j, w2, h2, PIX_SRC, pix2, 0, 0);
-            pixRasterop(pixt, 0, 0, w2, h1, PIX_SRC & PIX_DST, pix1, i, 0);
-            pixCountPixels(pixt, &count, tab);
+            shift = shifty + j;
+            pixCorrelationCountShiftedRows(pixw, pix2, shift, tab, &count);
             score = (l_float32)count * (l_float32)count /
                     ((l_float32)area1[i] * (l_float32)area2);
             if (score > maxscore) {
                 maxscore = score;
                 delx = i;
-                dely = shifty + j;
+                dely = shift;
             }
 
             if (debugflag > 0)
@@ -852,7 +871,7 @@ PIX        *pixt, *pixt1, *pixt2;
     LEPT_FREE(ycent1);
     LEPT_FREE(arraysum);
     LEPT_FREE(arraymoment);
-    pixDestroy(&pixt);
+    pixDestroy(&pixw);
     return 0;
 }
 
@@ -872,10 +891,14 @@ PIX        *pixt, *pixt1, *pixt2;
  * Notes:
  *      (1) This should be called by recogIdentifyMuliple(), which
  *          binarizes and splits characters before sending %pixa here.
- *      (2) This calls recogIdentifyPix(), which does the same operation
- *          on each pix in %pixa, and optionally returns the arrays
- *          of results (scores, class index and character string)
- *          for the best correlation match.
+ *      (2) This does the same operation as recogIdentifyPix() on each
+ *          pix in %pixa, and optionally returns the arrays of results
+ *          (scores, class index and character string) for the best
+ *          correlation match.
+ *      (3) Without debug output, all the characters are matched together:
+ *          each template is compared with only those characters that are
+ *          close enough in size.  The results are the same as when
+ *          each character is identified separately.
  * </pre>
  */
 l_ok
@@ -884,9 +907,11 @@ recogIdentifyPixa(L_RECOG  *recog,
                   PIX     **ppixdb)
 {
 char      *text;
-l_int32    i, n, fail, index, depth;
+l_int32    i, j, n, m, fail, index, depth;
+l_int32   *bestindex, *bestsample, *bestdelx, *bestdely, *bestwidth, *map;
 l_float32  score;
-PIX       *pix1, *pix2, *pix3;
+l_float32 *maxscore;
+PIX       *pix0, *pix1, *pix2, *pix3;
 PIXA      *pixa1;
 L_RCH     *rch;
 
@@ -903,16 +928,81 @@ L_RCH     *rch;
     n = pixaGetCount(pixa);
     rchaDestroy(&recog->rcha);
     recog->rcha = rchaCreate();
-    pixa1 = (ppixdb) ? pixaCreate(n) : NULL;
+    if (!ppixdb) {
+            /* Do the averaging if required and not yet done. */
+        if (recog->templ_use == L_USE_AVERAGE_TEMPLATES && !recog->ave_done) {
+            recogAverageSamples(&recog, 0);
+            if (!recog)
+                return ERROR_INT("averaging failed", procName, 1);
+        }
+
+            /* Make the images to be matched, and find the best
+             * template for each of them */
+        pixa1 = pixaCreate(n);
+        map = (l_int32 *)LEPT_CALLOC(n, sizeof(l_int32));
+        for (i = 0; i < n; i++) {
+            map[i] = -1;
+            pix0 = pixaGetPix(pixa, i, L_CLONE);
+            pix1 = NULL;
+            if (pixGetDepth(pix0) != 1)
+                L_ERROR("char %d not 1 bpp\n", procName, i);
+            else if ((pix2 = recogProcessToIdentify(recog, pix0, 0)) == NULL)
+                L_ERROR("no fg pixels in char %d\n", procName, i);
+            else if ((pix1 = recogModifyTemplate(recog, pix2)) == NULL)
+                L_ERROR("no fg pixels in modified char %d\n", procName, i);
+            if (pix1) {
+                map[i] = pixaGetCount(pixa1);
+                pixaAddPix(pixa1, pix1, L_INSERT);
+            }
+            pixDestroy(&pix0);
+            pixDestroy(&pix2);
+        }
+        m = L_MAX(1, pixaGetCount(pixa1));
+        bestindex = (l_int32 *)LEPT_CALLOC(m, sizeof(l_int32));
+        bestsample = (l_int32 *)LEPT_CALLOC(m, sizeof(l_int32));
+        bestdelx = (l_int32 *)LEPT_CALLOC(m, sizeof(l_int32));
+        bestdely = (l_int32 *)LEPT_CALLOC(m, sizeof(l_int32));
+        bestwidth = (l_int32 *)LEPT_CALLOC(m, sizeof(l_int32));
+        maxscore = (l_float32 *)LEPT_CALLOC(m, sizeof(l_float32));
+        recogFindBestTemplates(recog, pixa1, bestindex, bestsample,
+                               bestdelx, bestdely, bestwidth, maxscore);
+
+            /* Package up the results */
+        for (i = 0; i < n; i++) {
+            if ((j = map[i]) < 0) {
+                recogSkipIdentify(recog);
+            } else {
+                recogGetClassString(recog, bestindex[j], &text);
+                rchDestroy(&recog->rch);
+                recog->rch = rchCreate(bestindex[j], maxscore[j], text,
+                                       bestsample[j], bestdelx[j],
+                                       bestdely[j], bestwidth[j]);
+            }
+            rch = recog->rch;
+            rchExtract(rch, NULL, NULL, &text, NULL, NULL, NULL, NULL);
+            pix1 = pixaGetPix(pixa, i, L_CLONE);
+            pixSetText(pix1, text);
+            LEPT_FREE(text);
+            pixDestroy(&pix1);
+            transferRchToRcha(rch, recog->rcha);
+        }
+        LEPT_FREE(map);
+        LEPT_FREE(bestindex);
+        LEPT_FREE(bestsample);
+        LEPT_FREE(bestdelx);
+        LEPT_FREE(bestdely);
+        LEPT_FREE(bestwidth);
+        LEPT_FREE(maxscore);
+        pixaDestroy(&pixa1);
+        return 0;
+    }
+
+    pixa1 = pixaCreate(n);
     depth = 1;
     for (i = 0; i < n; i++) {
         pix1 = pixaGetPix(pixa, i, L_CLONE);
         pix2 = NULL;
-        fail = FALSE;
-        if (!ppixdb)
-            fail = recogIdentifyPix(recog, pix1, NULL);
-        else
-            fail = recogIdentifyPix(recog, pix1, &pix2);
+        fail = recogIdentifyPix(recog, pix1, &pix2);
         if (fail)
             recogSkipIdentify(recog);
         if ((rch = recog->rch) == NULL) {
@@ -924,23 +1014,18 @@ L_RCH     *rch;
         rchExtract(rch, NULL, NULL, &text, NULL, NULL, NULL, NULL);
         pixSetText(pix1, text);
         LEPT_FREE(text);
-        if (ppixdb) {
-            rchExtract(rch, &index, &score, NULL, NULL, NULL, NULL, NULL);
-            pix3 = recogShowMatch(recog, pix2, NULL, NULL, index, score);
-            if (i == 0) depth = pixGetDepth(pix3);
-            pixaAddPix(pixa1, pix3, L_INSERT);
-            pixDestroy(&pix2);
-        }
+        rchExtract(rch, &index, &score, NULL, NULL, NULL, NULL, NULL);
+        pix3 = recogShowMatch(recog, pix2, NULL, NULL, index, score);
+        if (i == 0) depth = pixGetDepth(pix3);
+        pixaAddPix(pixa1, pix3, L_INSERT);
+        pixDestroy(&pix2);
         transferRchToRcha(rch, recog->rcha);
         pixDestroy(&pix1);
     }
 
         /* Package the images for debug */
-    if (ppixdb) {
-        *ppixdb = pixaDisplayTiledInRows(pixa1, depth, 2500, 1.0, 0, 20, 1);
-        pixaDestroy(&pixa1);
-    }
-
+    *ppixdb = pixaDisplayTiledInRows(pixa1, depth, 2500, 1.0, 0, 20, 1);
+    pixaDestroy(&pixa1);
     return 0;
 }
 
@@ -977,13 +1062,10 @@ recogIdentifyPix(L_RECOG  *recog,
                  PIX     **ppixdb)
 {
 char      *text;
-l_int32    i, j, n, bestindex, bestsample, area1, area2;
-l_int32    shiftx, shifty, bestdelx, bestdely, bestwidth, maxyshift;
-l_float32  x1, y1, x2, y2, delx, dely, score, maxscore;
-NUMA      *numa;
+l_int32    bestindex, bestsample, bestdelx, bestdely, bestwidth, maxyshift;
+l_float32  maxscore;
 PIX       *pix0, *pix1, *pix2;
 PIXA      *pixa;
-PTA       *pta;
 
     PROCNAME("recogIdentifyPix");
 
@@ -1012,72 +1094,12 @@ PTA       *pta;
 
         /* Do correlation at all positions within +-maxyshift of
          * the nominal centroid alignment. */
-    pixCountPixels(pix1, &area1, recog->sumtab);
-    pixCentroid(pix1, recog->centtab, recog->sumtab, &x1, &y1);
-    bestindex = bestsample = bestdelx = bestdely = bestwidth = 0;
-    maxscore = 0.0;
+    pixa = pixaCreate(1);
+    pixaAddPix(pixa, pix1, L_CLONE);
+    recogFindBestTemplates(recog, pixa, &bestindex, &bestsample,
+                           &bestdelx, &bestdely, &bestwidth, &maxscore);
+    pixaDestroy(&pixa);
     maxyshift = recog->maxyshift;
-    if (recog->templ_use == L_USE_AVERAGE_TEMPLATES) {
-        for (i = 0; i < recog->setsize; i++) {
-            numaGetIValue(recog->nasum, i, &area2);
-            if (area2 == 0) continue;  /* no template available */
-            pix2 = pixaGetPix(recog->pixa, i, L_CLONE);
-            ptaGetPt(recog->pta, i, &x2, &y2);
-            delx = x1 - x2;
-            dely = y1 - y2;
-            for (shifty = -maxyshift; shifty <= maxyshift; shifty++) {
-                for (shiftx = -maxyshift; shiftx <= maxyshift; shiftx++) {
-                    pixCorrelationScoreSimple(pix1, pix2, area1, area2,
-                                              delx + shiftx, dely + shifty,
-                                              5, 5, recog->sumtab, &score);
-                    if (score > maxscore) {
-                        bestindex = i;
-                        bestdelx = delx + shiftx;
-                        bestdely = dely + shifty;
-                        maxscore = score;
-                    }
-                }
-            }
-            pixDestroy(&pix2);
-        }
-    } else {  /* use all the samples */
-        for (i = 0; i < recog->setsize; i++) {
-            pixa = pixaaGetPixa(recog->pixaa, i, L_CLONE);
-            n = pixaGetCount(pixa);
-            if (n == 0) {
-                pixaDestroy(&pixa);
-                continue;
-            }
-            numa = numaaGetNuma(recog->naasum, i, L_CLONE);
-            pta = ptaaGetPta(recog->ptaa, i, L_CLONE);
-            for (j = 0; j < n; j++) {
-                pix2 = pixaGetPix(pixa, j, L_CLONE);
-                numaGetIValue(numa, j, &area2);
-                ptaGetPt(pta, j, &x2, &y2);
-                delx = x1 - x2;
-                dely = y1 - y2;
-                for (shifty = -maxyshift; shifty <= maxyshift; shifty++) {
-                    for (shiftx = -maxyshift; shiftx <= maxyshift; shiftx++) {
-                        pixCorrelationScoreSimple(pix1, pix2, area1, area2,
-                                                  delx + shiftx, dely + shifty,
-                                                  5, 5, recog->sumtab, &score);
-                        if (score > maxscore) {
-                            bestindex = i;
-                            bestsample = j;
-                            bestdelx = delx + shiftx;
-                            bestdely = dely + shifty;
-                            maxscore = score;
-                            bestwidth = pixGetWidth(pix2);
-                        }
-                    }
-                }
-                pixDestroy(&pix2);
-            }
-            pixaDestroy(&pixa);
-            numaDestroy(&numa);
-            ptaDestroy(&pta);
-        }
-    }
 
         /* Package up the results */
     recogGetClassString(recog, bestindex, &text);
@@ -1135,6 +1157,180 @@ recogSkipIdentify(L_RECOG  *recog)
 }
 
 
+/*!
+ * \brief   recogFindBestTemplates()
+ *
+ * \param[in]    recog        with training finished
+ * \param[in]    pixa         characters, processed and modified as
+ *                            the templates were
+ * \param[out]   bestindex    class of the best match of each character
+ * \param[out]   bestsample   sample in that class; for L_USE_ALL_TEMPLATES
+ * \param[out]   bestdelx     x shift of the best match
+ * \param[out]   bestdely     y shift of the best match
+ * \param[out]   bestwidth    width of the best template; for
+ *                            L_USE_ALL_TEMPLATES
+ * \param[out]   maxscore     correlation score of the best match
+ * \return  0 if OK, 1 on error
+ *
+ * <pre>
+ * Notes:
+ *      (1) The output arrays are allocated by the caller, with one
+ *          entry for each pix in %pixa.
+ *      (2) For each character, this finds the template with the highest
+ *          correlation score at any position within +-maxyshift of
+ *          the nominal centroid alignment.  Ties go to the first template,
+ *          so the result is the same as matching each character to all
+ *          the templates, in order.
+ *      (3) Each template is only compared with the characters that
+ *          differ from it in width and height by at most 5 pixels,
+ *          which are found from the characters sorted by width.
+ *          Larger differences would give a score of 0.
+ *      (4) The score can be no larger than the ratio of the smaller to
+ *          the larger fg area, so a template is skipped for a character
+ *          if that bound does not exceed the best score so far.
+ *      (5) The scores are found with pixCorrelationScore(), which
+ *          requires the pad bits to be 0.  They are cleared here in the
+ *          characters, and in recogTrainingFinished() and
+ *          recogAverageSamples() for the templates.
+ * </pre>
+ */
+static l_int32
+recogFindBestTemplates(L_RECOG    *recog,
+                       PIXA       *pixa,
+                       l_int32    *bestindex,
+                       l_int32    *bestsample,
+                       l_int32    *bestdelx,
+                       l_int32    *bestdely,
+                       l_int32    *bestwidth,
+                       l_float32  *maxscore)
+{
+l_int32     i, j, k, m, n, ns, useave, first, last, mid, area2, wt, ht;
+l_int32     maxyshift, shiftx, shifty, amin;
+l_int32    *area1, *w1, *h1, *sorted;
+l_float32   x2, y2, delx, dely, score, bound;
+l_float32  *x1, *y1;
+NUMA       *naw, *naindex, *numa;
+PIX        *pix2;
+PIX       **pix1;
+PIXA       *pixat;
+PTA        *pta;
+
+    if ((n = pixaGetCount(pixa)) == 0)
+        return 0;
+
+        /* Get the size, area and centroid of each character */
+    pix1 = (PIX **)LEPT_CALLOC(n, sizeof(PIX *));
+    area1 = (l_int32 *)LEPT_CALLOC(n, sizeof(l_int32));
+    w1 = (l_int32 *)LEPT_CALLOC(n, sizeof(l_int32));
+    h1 = (l_int32 *)LEPT_CALLOC(n, sizeof(l_int32));
+    x1 = (l_float32 *)LEPT_CALLOC(n, sizeof(l_float32));
+    y1 = (l_float32 *)LEPT_CALLOC(n, sizeof(l_float32));
+    naw = numaCreate(n);
+    for (k = 0; k < n; k++) {
+        pix1[k] = pixaGetPix(pixa, k, L_CLONE);
+        pixSetPadBits(pix1[k], 0);
+        pixGetDimensions(pix1[k], &w1[k], &h1[k], NULL);
+        pixCountPixels(pix1[k], &area1[k], recog->sumtab);
+        pixCentroid(pix1[k], recog->centtab, recog->sumtab, &x1[k], &y1[k]);
+        numaAddNumber(naw, w1[k]);
+        bestindex[k] = bestsample[k] = bestdelx[k] = bestdely[k] = 0;
+        bestwidth[k] = 0;
+        maxscore[k] = 0.0;
+    }
+    naindex = numaGetSortIndex(naw, L_SORT_INCREASING);
+    sorted = numaGetIArray(naindex);
+    maxyshift = recog->maxyshift;
+
+        /* Go through the templates in order, and compare each with
+         * the characters of similar width */
+    useave = (recog->templ_use == L_USE_AVERAGE_TEMPLATES) ? 1 : 0;
+    for (i = 0; i < recog->setsize; i++) {
+        if (useave) {
+            pixat = NULL;
+            numa = NULL;
+            pta = NULL;
+            ns = 1;
+        } else {
+            pixat = pixaaGetPixa(recog->pixaa, i, L_CLONE);
+            numa = numaaGetNuma(recog->naasum, i, L_CLONE);
+            pta = ptaaGetPta(recog->ptaa, i, L_CLONE);
+            ns = pixaGetCount(pixat);
+        }
+        for (j = 0; j < ns; j++) {
+            if (useave) {
+                numaGetIValue(recog->nasum, i, &area2);
+                if (area2 == 0) continue;  /* no template available */
+                pix2 = pixaGetPix(recog->pixa, i, L_CLONE);
+                ptaGetPt(recog->pta, i, &x2, &y2);
+            } else {
+                numaGetIValue(numa, j, &area2);
+                if (area2 == 0) continue;
+                pix2 = pixaGetPix(pixat, j, L_CLONE);
+                ptaGetPt(pta, j, &x2, &y2);
+            }
+            pixGetDimensions(pix2, &wt, &ht, NULL);
+
+                /* Find the first character with width >= wt - 5 */
+            first = 0;
+            last = n;
+            while (first < last) {
+                mid = (first + last) / 2;
+                if (w1[sorted[mid]] < wt - 5)
+                    first = mid + 1;
+                else
+                    last = mid;
+            }
+
+            for (m = first; m < n; m++) {
+                k = sorted[m];
+                if (w1[k] > wt + 5) break;
+                if (L_ABS(h1[k] - ht) > 5) continue;
+                amin = L_MIN(area1[k], area2);
+                bound = (l_float32)amin * (l_float32)amin /
+                        ((l_float32)area1[k] * (l_float32)area2);
+                if (bound <= maxscore[k]) continue;
+                delx = x1[k] - x2;
+                dely = y1[k] - y2;
+                for (shifty = -maxyshift; shifty <= maxyshift; shifty++) {
+                    for (shiftx = -maxyshift; shiftx <= maxyshift; shiftx++) {
+                        pixCorrelationScore(pix1[k], pix2, area1[k], area2,
+                                            delx + shiftx, dely + shifty,
+                                            5, 5, recog->sumtab, &score);
+                        if (score > maxscore[k]) {
+                            bestindex[k] = i;
+                            bestdelx[k] = delx + shiftx;
+                            bestdely[k] = dely + shifty;
+                            maxscore[k] = score;
+                            if (!useave) {
+                                bestsample[k] = j;
+                                bestwidth[k] = wt;
+                            }
+                        }
+                    }
+                }
+            }
+            pixDestroy(&pix2);
+        }
+        pixaDestroy(&pixat);
+        numaDestroy(&numa);
+        ptaDestroy(&pta);
+    }
+
+    for (k = 0; k < n; k++)
+        pixDestroy(&pix1[k]);
+    LEPT_FREE(pix1);
+    LEPT_FREE(area1);
+    LEPT_FREE(w1);
+    LEPT_FREE(h1);
+    LEPT_FREE(x1);
+    LEPT_FREE(y1);
+    LEPT_FREE(sorted);
+    numaDestroy(&naw);
+    numaDestroy(&naindex);
+    return 0;
+}
+
+
 /*------------------------------------------------------------------------*
  *             Operations for handling identification results             *
  *------------------------------------------------------------------------*/
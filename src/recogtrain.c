@@ -613,6 +613,7 @@ L_RECOG   *recog;
             break;
         } else {
             boxGetGeometry(box, &bx, &by, NULL, NULL);
+            pixSetPadBits(pix3, 0);  /* for word-wise correlation */
             pixaAddPix(recog->pixa, pix3, L_INSERT);
             ptaAddPt(recog->pta, x - bx, y - by);  /* correct centroid */
             pixCountPixels(pix3, &area, recog->sumtab);
@@ -772,7 +773,9 @@ PTA       *ptac;
  *      (5) The following things are done here:
  *          (a) Allocate (or reallocate) storage for (possibly) modified
  *              bitmaps, centroids, and fg areas.
- *          (b) Generate the (possibly) modified bitmaps.
+ *          (b) Generate the (possibly) modified bitmaps, with their
+ *              pad bits cleared so that they can be correlated a
+ *              word at a time.
  *          (c) Compute centroid and fg area data for both unscaled and
  *              modified bitmaps.
  *          (d) Truncate the pixaa, ptaa and numaa arrays down from
@@ -862,6 +865,7 @@ L_RECOG   *recog;
             else
                 pixd = pixClone(pix);
             if (pixd) {
+                pixSetPadBits(pixd, 0);
                 pixaaAddPix(recog->pixaa, i, pixd, NULL, L_INSERT);
                 pixCentroid(pixd, recog->centtab, recog->sumtab, &xave, &yave);
                 ptaaAddPt(recog->ptaa, i, xave, yave);
@@ -48,6 +48,9 @@
  *
  *      Differential square sum function for scoring
  *          l_int32    pixFindDifferentialSquareSum()
+ *          static l_int32   *pixMakeCumWordSums()
+ *          static l_int32    pixFindShearDiffSquareSum()
+ *          static l_int32    pixelSumToColumn()
  *
  *      Measures of variance of row sums
  *          l_int32    pixFindNormalizedSquareSum()
@@ -84,6 +87,13 @@
  *      with the raster lines.  It also works well in multicolumn
  *      pages where the textlines do not line up across columns.
  *
+ *      The sheared images are never actually made.  A vertical shear
+ *      moves bands of columns up or down by integer amounts, so the
+ *      line sums of a sheared image are found from the pixel sums of
+ *      each band in each row of the unsheared image.  These are read
+ *      from a table of cumulative pixel counts on word boundaries,
+ *      made once for each image; see pixFindShearDiffSquareSum().
+ *
  *      The method is fast, accurate to within an angle (in radians)
  *      of approximately the inverse width in pixels of the image,
  *      and will work on a surprisingly small amount of text data
@@ -100,6 +110,7 @@
 #endif  /* HAVE_CONFIG_H */
 
 #include <math.h>
+#include <string.h>
 #include "allheaders.h"
 
     /* Default sweep angle parameters for pixFindSkew() */
@@ -142,6 +153,17 @@ static const l_int32  DefaultBinaryThreshold = 130;
 #define  DEBUG_PLOT_SCORES      0  /* requires the gnuplot executable */
 #endif  /* ~NO_CONSOLE_IO */
 
+    /* Closest allowed shear angle to pi/2, as in shear.c */
+static const l_float32  MinDiffFromHalfPi = 0.04;
+
+static l_int32 *pixMakeCumWordSums(PIX *pixs, l_int32 *tab8);
+static l_int32 pixFindShearDiffSquareSum(PIX *pixs, PIX *pixt,
+                                         l_int32 *cumsums, l_int32 *tab8,
+                                         l_int32 *rowsums, l_float32 radang,
+                                         l_int32 pivot, l_float32 *psum);
+static l_int32 pixelSumToColumn(l_uint32 *line, l_int32 *cum, l_int32 x,
+                                l_int32 *tab8);
+
 
 
 /*-----------------------------------------------------------------------*
@@ -423,6 +445,7 @@ pixFindSkewSweep(PIX        *pixs,
                  l_float32   sweepdelta)
 {
 l_int32    ret, bzero, i, nangles;
+l_int32   *tab8, *cumsums, *rowsums;
 l_float32  deg2rad, theta;
 l_float32  sum, maxscore, maxangle;
 NUMA      *natheta, *nascore;
@@ -463,9 +486,12 @@ PIX       *pix, *pixt;
     natheta = numaCreate(nangles);
     nascore = numaCreate(nangles);
     pixt = pixCreateTemplate(pix);
+    tab8 = makePixelSumTab8();
+    cumsums = pixMakeCumWordSums(pix, tab8);
+    rowsums = (l_int32 *)LEPT_CALLOC(pixGetHeight(pix), sizeof(l_int32));
 
-    if (!pix || !pixt) {
-        ret = ERROR_INT("pix and pixt not both made", procName, 1);
+    if (!pixt || !cumsums || !rowsums) {
+        ret = ERROR_INT("pixt, cumsums, rowsums not all made", procName, 1);
         goto cleanup;
     }
     if (!natheta || !nascore) {
@@ -476,11 +502,9 @@ PIX       *pix, *pixt;
     for (i = 0; i < nangles; i++) {
         theta = -sweeprange + i * sweepdelta;   /* degrees */
 
-            /* Shear pix about the UL corner and put the result in pixt */
-        pixVShearCorner(pixt, pix, deg2rad * theta, L_BRING_IN_WHITE);
-
-            /* Get score */
-        pixFindDifferentialSquareSum(pixt, &sum);
+            /* Get score for pix sheared about the UL corner */
+        pixFindShearDiffSquareSum(pix, pixt, cumsums, tab8, rowsums,
+                                  deg2rad * theta, L_SHEAR_ABOUT_CORNER, &sum);
 
 #if  DEBUG_PRINT_SCORES
         L_INFO("sum(%7.2f) = %7.0f\n", procName, theta, sum);
@@ -525,6 +549,9 @@ PIX       *pix, *pixt;
 cleanup:
     pixDestroy(&pix);
     pixDestroy(&pixt);
+    LEPT_FREE(tab8);
+    LEPT_FREE(cumsums);
+    LEPT_FREE(rowsums);
     numaDestroy(&nascore);
     numaDestroy(&natheta);
     return ret;
@@ -684,6 +711,7 @@ l_float32  lefttemp, righttemp;
 l_float32  bsearchscore[5];
 l_float32  minscore, minthresh;
 l_float32  rangeleft;
+l_int32   *tab8, *cumsw, *cumsch, *rowsums;
 NUMA      *natheta, *nascore;
 PIX       *pixsw, *pixsch, *pixt1, *pixt2;
 
@@ -743,6 +771,13 @@ PIX       *pixsw, *pixsch, *pixt1, *pixt2;
     else
         pixt2 = pixCreateTemplate(pixsch);
 
+        /* Make the tables of cumulative pixel sums, from which the
+         * row sums of the sheared images are computed */
+    tab8 = makePixelSumTab8();
+    cumsch = pixMakeCumWordSums(pixsch, tab8);
+    cumsw = (ratio == 1) ? cumsch : pixMakeCumWordSums(pixsw, tab8);
+    rowsums = (l_int32 *)LEPT_CALLOC(pixGetHeight(pixsch), sizeof(l_int32));
+
     nangles = (l_int32)((2. * sweeprange) / sweepdelta + 1);
     natheta = numaCreate(nangles);
     nascore = numaCreate(nangles);
@@ -755,6 +790,10 @@ PIX       *pixsw, *pixsch, *pixt1, *pixt2;
         ret = ERROR_INT("pixt1 and pixt2 not both made", procName, 1);
         goto cleanup;
     }
+    if (!cumsch || !cumsw || !rowsums) {
+        ret = ERROR_INT("cumulative and row sums not all made", procName, 1);
+        goto cleanup;
+    }
     if (!natheta || !nascore) {
         ret = ERROR_INT("natheta and nascore not both made", procName, 1);
         goto cleanup;
@@ -765,14 +804,9 @@ PIX       *pixsw, *pixsch, *pixt1, *pixt2;
     for (i = 0; i < nangles; i++) {
         theta = rangeleft + i * sweepdelta;   /* degrees */
 
-            /* Shear pix and put the result in pixt1 */
-        if (pivot == L_SHEAR_ABOUT_CORNER)
-            pixVShearCorner(pixt1, pixsw, deg2rad * theta, L_BRING_IN_WHITE);
-        else
-            pixVShearCenter(pixt1, pixsw, deg2rad * theta, L_BRING_IN_WHITE);
-
-            /* Get score */
-        pixFindDifferentialSquareSum(pixt1, &sum);
+            /* Get score for pixsw sheared about the pivot */
+        pixFindShearDiffSquareSum(pixsw, pixt1, cumsw, tab8, rowsums,
+                                  deg2rad * theta, pivot, &sum);
 
 #if  DEBUG_PRINT_SCORES
         L_INFO("sum(%7.2f) = %7.0f\n", procName, theta, sum);
@@ -820,25 +854,14 @@ PIX       *pixsw, *pixsch, *pixt1, *pixt2;
         /* Do binary search to find skew angle.
          * First, set up initial three points. */
     centerangle = maxangle;
-    if (pivot == L_SHEAR_ABOUT_CORNER) {
-        pixVShearCorner(pixt2, pixsch, deg2rad * centerangle, L_BRING_IN_WHITE);
-        pixFindDifferentialSquareSum(pixt2, &bsearchscore[2]);
-        pixVShearCorner(pixt2, pixsch, deg2rad * (centerangle - sweepdelta),
-                        L_BRING_IN_WHITE);
-        pixFindDifferentialSquareSum(pixt2, &bsearchscore[0]);
-        pixVShearCorner(pixt2, pixsch, deg2rad * (centerangle + sweepdelta),
-                        L_BRING_IN_WHITE);
-        pixFindDifferentialSquareSum(pixt2, &bsearchscore[4]);
-    } else {
-        pixVShearCenter(pixt2, pixsch, deg2rad * centerangle, L_BRING_IN_WHITE);
-        pixFindDifferentialSquareSum(pixt2, &bsearchscore[2]);
-        pixVShearCenter(pixt2, pixsch, deg2rad * (centerangle - sweepdelta),
-                        L_BRING_IN_WHITE);
-        pixFindDifferentialSquareSum(pixt2, &bsearchscore[0]);
-        pixVShearCenter(pixt2, pixsch, deg2rad * (centerangle + sweepdelta),
-                        L_BRING_IN_WHITE);
-        pixFindDifferentialSquareSum(pixt2, &bsearchscore[4]);
-    }
+    pixFindShearDiffSquareSum(pixsch, pixt2, cumsch, tab8, rowsums,
+                              deg2rad * centerangle, pivot, &bsearchscore[2]);
+    pixFindShearDiffSquareSum(pixsch, pixt2, cumsch, tab8, rowsums,
+                              deg2rad * (centerangle - sweepdelta), pivot,
+                              &bsearchscore[0]);
+    pixFindShearDiffSquareSum(pixsch, pixt2, cumsch, tab8, rowsums,
+                              deg2rad * (centerangle + sweepdelta), pivot,
+                              &bsearchscore[4]);
 
     numaAddNumber(nascore, bsearchscore[2]);
     numaAddNumber(natheta, centerangle);
@@ -853,25 +876,17 @@ PIX       *pixsw, *pixsch, *pixt1, *pixt2;
     {
             /* Get the left intermediate score */
         leftcenterangle = centerangle - delta;
-        if (pivot == L_SHEAR_ABOUT_CORNER)
-            pixVShearCorner(pixt2, pixsch, deg2rad * leftcenterangle,
-                            L_BRING_IN_WHITE);
-        else
-            pixVShearCenter(pixt2, pixsch, deg2rad * leftcenterangle,
-                            L_BRING_IN_WHITE);
-        pixFindDifferentialSquareSum(pixt2, &bsearchscore[1]);
+        pixFindShearDiffSquareSum(pixsch, pixt2, cumsch, tab8, rowsums,
+                                  deg2rad * leftcenterangle, pivot,
+                                  &bsearchscore[1]);
         numaAddNumber(nascore, bsearchscore[1]);
         numaAddNumber(natheta, leftcenterangle);
 
             /* Get the right intermediate score */
         rightcenterangle = centerangle + delta;
-        if (pivot == L_SHEAR_ABOUT_CORNER)
-            pixVShearCorner(pixt2, pixsch, deg2rad * rightcenterangle,
-                            L_BRING_IN_WHITE);
-        else
-            pixVShearCenter(pixt2, pixsch, deg2rad * rightcenterangle,
-                            L_BRING_IN_WHITE);
-        pixFindDifferentialSquareSum(pixt2, &bsearchscore[3]);
+        pixFindShearDiffSquareSum(pixsch, pixt2, cumsch, tab8, rowsums,
+                                  deg2rad * rightcenterangle, pivot,
+                                  &bsearchscore[3]);
         numaAddNumber(nascore, bsearchscore[3]);
         numaAddNumber(natheta, rightcenterangle);
 
@@ -967,6 +982,10 @@ cleanup:
     pixDestroy(&pixsch);
     pixDestroy(&pixt1);
     pixDestroy(&pixt2);
+    if (cumsw != cumsch) LEPT_FREE(cumsw);
+    LEPT_FREE(cumsch);
+    LEPT_FREE(tab8);
+    LEPT_FREE(rowsums);
     numaDestroy(&nascore);
     numaDestroy(&natheta);
     return ret;
@@ -1155,6 +1174,277 @@ NUMA      *na;
 }
 
 
+/*!
+ * \brief   pixMakeCumWordSums()
+ *
+ * \param[in]    pixs     1 bpp
+ * \param[in]    tab8     sum tab for ON pixels in byte
+ * \return  array of cumulative pixel sums, or NULL on error
+ *
+ * <pre>
+ * Notes:
+ *      (1) For each row i, the (wpl + 1) values starting at
+ *          i * (wpl + 1) are the number of ON pixels in the first
+ *          0, 1, ..., wpl words of the row.
+ *      (2) Only the sums of whole words within the image width are
+ *          used, so the pad bits need not be cleared.
+ * </pre>
+ */
+static l_int32 *
+pixMakeCumWordSums(PIX      *pixs,
+                   l_int32  *tab8)
+{
+l_int32    i, j, h, wpl, sum;
+l_int32   *cumsums, *cum;
+l_uint32   word;
+l_uint32  *data, *line;
+
+    PROCNAME("pixMakeCumWordSums");
+
+    if (!pixs || pixGetDepth(pixs) != 1)
+        return (l_int32 *)ERROR_PTR("pixs undefined or not 1 bpp",
+                                    procName, NULL);
+    if (!tab8)
+        return (l_int32 *)ERROR_PTR("tab8 not defined", procName, NULL);
+
+    h = pixGetHeight(pixs);
+    wpl = pixGetWpl(pixs);
+    data = pixGetData(pixs);
+    if ((cumsums = (l_int32 *)LEPT_CALLOC((size_t)h * (wpl + 1),
+                                          sizeof(l_int32))) == NULL)
+        return (l_int32 *)ERROR_PTR("cumsums not made", procName, NULL);
+    for (i = 0; i < h; i++) {
+        line = data + i * wpl;
+        cum = cumsums + i * (wpl + 1);
+        sum = 0;
+        for (j = 0; j < wpl; j++) {
+            cum[j] = sum;
+            if ((word = line[j]) != 0) {
+                sum += tab8[word & 0xff] +
+                       tab8[(word >> 8) & 0xff] +
+                       tab8[(word >> 16) & 0xff] +
+                       tab8[word >> 24];
+            }
+        }
+        cum[wpl] = sum;
+    }
+    return cumsums;
+}
+
+
+/*!
+ * \brief   pixFindShearDiffSquareSum()
+ *
+ * \param[in]    pixs      1 bpp
+ * \param[in]    pixt      work image of the same size as pixs
+ * \param[in]    cumsums   cumulative pixel sums of pixs, from
+ *                         pixMakeCumWordSums()
+ * \param[in]    tab8      sum tab for ON pixels in byte
+ * \param[in]    rowsums   work array of size at least the height of pixs
+ * \param[in]    radang    vertical shear angle in radians
+ * \param[in]    pivot     L_SHEAR_ABOUT_CORNER, L_SHEAR_ABOUT_CENTER
+ * \param[out]   psum      result
+ * \return  0 if OK, 1 on error
+ *
+ * <pre>
+ * Notes:
+ *      (1) This gives the same result as pixFindDifferentialSquareSum()
+ *          applied to pixs after shearing with pixVShearCorner()
+ *          or pixVShearCenter(), bringing in white pixels.
+ *      (2) The column bands and their vertical shifts are found exactly
+ *          as in pixVShear().  When there are fewer bands than words
+ *          in a row, which is typical near the skew angle, the sheared
+ *          image is not made.  Instead, the number of ON pixels of each
+ *          band in each row is found from %cumsums, and added to the
+ *          row sum of the sheared image at the shifted row.  Pixels
+ *          shifted out of the image are dropped.
+ *      (3) With more bands, it is faster to shear into %pixt and count
+ *          the pixels in each row.
+ * </pre>
+ */
+static l_int32
+pixFindShearDiffSquareSum(PIX        *pixs,
+                          PIX        *pixt,
+                          l_int32    *cumsums,
+                          l_int32    *tab8,
+                          l_int32    *rowsums,
+                          l_float32   radang,
+                          l_int32     pivot,
+                          l_float32  *psum)
+{
+l_int32    i, j, k, w, h, y, wpl, xloc, sign, x, xincr, initxincr, vshift;
+l_int32    nbands, nleft, sumleft, sumright, skiph, skip, nskip;
+l_int32   *bandx1, *bandshift, *cum;
+l_uint32   word, endmask;
+l_uint32  *data, *line;
+l_float32  pi2, angle, tanangle, invangle, val1, val2, diff, sum;
+
+    PROCNAME("pixFindShearDiffSquareSum");
+
+    if (!psum)
+        return ERROR_INT("&sum not defined", procName, 1);
+    *psum = 0.0;
+    if (!pixs || !pixt || !cumsums || !tab8 || !rowsums)
+        return ERROR_INT("pixs, pixt, cumsums, tab8, rowsums not all defined",
+                         procName, 1);
+
+    pixGetDimensions(pixs, &w, &h, NULL);
+    wpl = pixGetWpl(pixs);
+    data = pixGetData(pixs);
+    xloc = (pivot == L_SHEAR_ABOUT_CORNER) ? 0 : w / 2;
+    bandx1 = (l_int32 *)LEPT_CALLOC(w + 1, sizeof(l_int32));
+    bandshift = (l_int32 *)LEPT_CALLOC(w + 1, sizeof(l_int32));
+
+        /* Normalize the angle, as in shear.c */
+    pi2 = 3.14159265 / 2.0;
+    angle = radang;
+    if (angle < -pi2 || angle > pi2)
+        angle = angle - (l_int32)(angle / pi2) * pi2;
+    if (angle > pi2 - MinDiffFromHalfPi)
+        angle = pi2 - MinDiffFromHalfPi;
+    else if (angle < -pi2 + MinDiffFromHalfPi)
+        angle = -pi2 + MinDiffFromHalfPi;
+
+        /* Find the bands of columns that are shifted together, as in
+         * pixVShear(), and save them in order of increasing x.
+         * Bands to the left of the pivot are found from right to left,
+         * so they are saved from the end of the arrays and then moved
+         * to the front.  Empty bands are skipped. */
+    nbands = 0;
+    if (angle == 0.0 || tan(angle) == 0.0) {
+        bandx1[0] = w;
+        bandshift[0] = 0;
+        nbands = 1;
+    } else {
+        sign = L_SIGN(angle);
+        tanangle = tan(angle);
+        invangle = L_ABS(1. / tanangle);
+        initxincr = (l_int32)(invangle / 2.);
+        nleft = 0;
+        for (vshift = -1, x = xloc - initxincr; x > 0; vshift--) {
+            xincr = (x - xloc) - (l_int32)(invangle * (vshift - 0.5) + 0.5);
+            if (x < xincr)  /* reduce for last one if req'd */
+                xincr = x;
+            if (xincr > 0) {
+                nleft++;
+                bandx1[w + 1 - nleft] = x;
+                bandshift[w + 1 - nleft] = sign * vshift;
+            }
+            x -= xincr;
+        }
+        for (k = 0; k < nleft; k++) {
+            bandx1[k] = bandx1[w + 1 - nleft + k];
+            bandshift[k] = bandshift[w + 1 - nleft + k];
+        }
+        nbands = nleft;
+
+        if (xloc + initxincr > L_MAX(0, xloc - initxincr) &&
+            xloc - initxincr < w) {  /* non-empty center band */
+            bandx1[nbands] = L_MIN(w, xloc + initxincr);
+            bandshift[nbands++] = 0;
+        }
+
+        for (vshift = 1, x = xloc + initxincr; x < w; vshift++) {
+            xincr = (l_int32)(invangle * (vshift + 0.5) + 0.5) - (x - xloc);
+            if (w - x < xincr)  /* reduce for last one if req'd */
+                xincr = w - x;
+            if (xincr > 0) {
+                bandx1[nbands] = x + xincr;
+                bandshift[nbands++] = sign * vshift;
+            }
+            x += xincr;
+        }
+    }
+
+        /* Get the row sums of the sheared image.  With few bands,
+         * accumulate them directly from pixs.  The bands cover the width
+         * of pixs, so each band sum in a row is the difference of the
+         * pixel sums to the left of its two ends. */
+    memset(rowsums, 0, h * sizeof(l_int32));
+    if (nbands < wpl) {
+        for (i = 0; i < h; i++) {
+            line = data + i * wpl;
+            cum = cumsums + i * (wpl + 1);
+            if (cum[wpl] == 0) continue;  /* no fg pixels in this row */
+            sumleft = 0;
+            for (k = 0; k < nbands; k++) {
+                sumright = pixelSumToColumn(line, cum, bandx1[k], tab8);
+                if (sumright > sumleft) {
+                    y = i + bandshift[k];
+                    if (y >= 0 && y < h)
+                        rowsums[y] += sumright - sumleft;
+                    sumleft = sumright;
+                }
+            }
+        }
+    } else {
+        pixVShear(pixt, pixs, xloc, radang, L_BRING_IN_WHITE);
+        data = pixGetData(pixt);
+        endmask = (w & 31) ? ~(0xffffffff >> (w & 31)) : 0xffffffff;
+        for (i = 0; i < h; i++) {
+            line = data + i * wpl;
+            for (j = 0; j < wpl; j++) {
+                word = (j < wpl - 1) ? line[j] : line[j] & endmask;
+                if (word) {
+                    rowsums[i] += tab8[word & 0xff] +
+                                  tab8[(word >> 8) & 0xff] +
+                                  tab8[(word >> 16) & 0xff] +
+                                  tab8[word >> 24];
+                }
+            }
+        }
+    }
+
+        /* Sum the squares of differential row sums, skipping
+         * rows at top and bottom as in pixFindDifferentialSquareSum() */
+    skiph = (l_int32)(0.05 * w);
+    skip = L_MIN(h / 10, skiph);
+    nskip = L_MAX(skip / 2, 1);
+    sum = 0.0;
+    for (i = nskip; i < h - nskip; i++) {
+        val1 = (l_float32)rowsums[i - 1];
+        val2 = (l_float32)rowsums[i];
+        diff = val2 - val1;
+        sum += diff * diff;
+    }
+    *psum = sum;
+
+    LEPT_FREE(bandx1);
+    LEPT_FREE(bandshift);
+    return 0;
+}
+
+
+/*!
+ * \brief   pixelSumToColumn()
+ *
+ * \param[in]    line     row of a 1 bpp image
+ * \param[in]    cum      cumulative word sums for the row
+ * \param[in]    x        column; the pixels in [0, x) are counted
+ * \param[in]    tab8     sum tab for ON pixels in byte
+ * \return  number of ON pixels in the row to the left of column x
+ */
+static l_int32
+pixelSumToColumn(l_uint32  *line,
+                 l_int32   *cum,
+                 l_int32    x,
+                 l_int32   *tab8)
+{
+l_int32   n, nbits, sum;
+l_uint32  word;
+
+    n = x >> 5;
+    nbits = x & 31;
+    sum = cum[n];
+    if (nbits) {
+        word = line[n] & ~(0xffffffff >> nbits);
+        sum += tab8[word & 0xff] + tab8[(word >> 8) & 0xff] +
+               tab8[(word >> 16) & 0xff] + tab8[word >> 24];
+    }
+    return sum;
+}
+
+
 /*----------------------------------------------------------------*
  *                        Normalized square sum                   *
  *----------------------------------------------------------------*/
@@ -35,18 +35,30 @@
  *
  *      Reading spix from file
  *           PIX        *pixReadStreamSpix()
+ *           PIX        *pixReadSpixMapped()
  *           l_int32     readHeaderSpix()
  *           l_int32     freadHeaderSpix()
  *           l_int32     sreadHeaderSpix()
  *
  *      Writing spix to file
  *           l_int32     pixWriteStreamSpix()
+ *           l_int32     pixWriteStreamSpixPaged()
  *
  *      Low-level serialization of pix to/from memory (uncompressed)
  *           PIX        *pixReadMemSpix()
  *           l_int32     pixWriteMemSpix()
  *           l_int32     pixSerializeToMemory()
+ *           l_int32     pixSerializeToMemoryPaged()
+ *           static l_int32  pixSerializeGeneral()
  *           PIX        *pixDeserializeFromMemory()
+ *           static l_int32  spixParseHeader()
+ *
+ *    There are two versions of the spix format.  In version 1 (id "spix")
+ *    the raster data immediately follows the header.  In version 2
+ *    (id "spx2"), the header is padded with zeros so that the raster
+ *    data starts on a page boundary.  Both are read by all the functions
+ *    here, but version 2 is intended for pixReadSpixMapped(), which
+ *    maps the file into memory and uses the raster data in place.
  *
  *    Note: these functions have not been extensively tested for fuzzing
  *    (bad input data that can result in, e.g., memory faults).
@@ -68,6 +80,16 @@ static const l_int32  MaxAllowedWidth = 1000000;
 static const l_int32  MaxAllowedHeight = 1000000;
 static const l_int64  MaxAllowedArea = 400000000LL;
 
+    /* Alignment of the raster data in version 2 spix */
+static const size_t  SpixPageSize = 4096;
+
+    /* Static functions */
+static l_int32 pixSerializeGeneral(PIX *pixs, l_int32 paged,
+                                   l_uint32 **pdata, size_t *pnbytes);
+static l_int32 spixParseHeader(const l_uint32 *data, size_t nbytes,
+                               l_int32 *pw, l_int32 *ph, l_int32 *pd,
+                               l_int32 *pncolors, size_t *poffset);
+
 #ifndef  NO_CONSOLE_IO
 #define  DEBUG_SERIALIZE      0
 #endif  /* ~NO_CONSOLE_IO */
@@ -110,6 +132,85 @@ PIX      *pix;
 }
 
 
+/*!
+ * \brief   pixReadSpixMapped()
+ *
+ * \param[in]    filename   spix file, preferably version 2
+ * \return  pix, or NULL on error.
+ *
+ * <pre>
+ * Notes:
+ *      (1) This maps the file into memory and makes a pix whose image
+ *          data is the raster in the mapping; the raster is not copied.
+ *          Pages of the file are read only when they are accessed.
+ *      (2) The mapping is private, so changes to the pix data are
+ *          never written to the file.  It is owned by the pix and is
+ *          released when the last clone of the pix is destroyed.
+ *      (3) Both spix versions can be read this way.  Use version 2,
+ *          written by pixWriteStreamSpixPaged(), to have the raster
+ *          data start on a page boundary.
+ *      (4) If mmap() is not available, the file is read into memory
+ *          and the raster is copied.
+ * </pre>
+ */
+PIX *
+pixReadSpixMapped(const char  *filename)
+{
+l_uint8  *data;
+size_t    nbytes;
+PIX      *pix;
+#if HAVE_MMAP
+l_int32   w, h, d, ncolors;
+size_t    offset;
+PIXCMAP  *cmap;
+#endif  /* HAVE_MMAP */
+
+    PROCNAME("pixReadSpixMapped");
+
+    if (!filename)
+        return (PIX *)ERROR_PTR("filename not defined", procName, NULL);
+
+#if HAVE_MMAP
+    if ((data = l_binaryMapFile(filename, &nbytes)) == NULL)
+        return (PIX *)ERROR_PTR("file not mapped", procName, NULL);
+    if (spixParseHeader((l_uint32 *)data, nbytes, &w, &h, &d, &ncolors,
+                        &offset)) {
+        l_binaryUnmapFile(data, nbytes);
+        return (PIX *)ERROR_PTR("invalid spix file", procName, NULL);
+    }
+    if ((pix = pixCreateHeader(w, h, d)) == NULL) {
+        l_binaryUnmapFile(data, nbytes);
+        return (PIX *)ERROR_PTR("pix not made", procName, NULL);
+    }
+    if (pixSetMappedData(pix, (l_uint32 *)(data + offset), data, nbytes)) {
+        l_binaryUnmapFile(data, nbytes);
+        pixDestroy(&pix);
+        return (PIX *)ERROR_PTR("mapped data not set", procName, NULL);
+    }
+    if (ncolors > 0) {
+        cmap = pixcmapDeserializeFromMemory(data + 24, 4, ncolors);
+        if (!cmap) {
+            pixDestroy(&pix);  /* releases the mapping */
+            return (PIX *)ERROR_PTR("cmap not made", procName, NULL);
+        }
+        pixSetColormap(pix, cmap);
+    }
+    pixSetInputFormat(pix, IFF_SPIX);
+    return pix;
+#else
+    L_INFO("mmap not available; reading the file\n", procName);
+    if ((data = l_binaryRead(filename, &nbytes)) == NULL)
+        return (PIX *)ERROR_PTR("data not read", procName, NULL);
+    pix = pixReadMemSpix(data, nbytes);
+    LEPT_FREE(data);
+    if (!pix)
+        return (PIX *)ERROR_PTR("pix not made", procName, NULL);
+    pixSetInputFormat(pix, IFF_SPIX);
+    return pix;
+#endif  /* HAVE_MMAP */
+}
+
+
 /*!
  * \brief   readHeaderSpix()
  *
@@ -232,9 +333,10 @@ l_int32  d, ncolors;
     if (piscmap)
       *piscmap = 0;
 
-        /* Check file id */
+        /* Check file id; either version */
     id = (char *)data;
-    if (id[0] != 's' || id[1] != 'p' || id[2] != 'i' || id[3] != 'x')
+    if (id[0] != 's' || id[1] != 'p' ||
+        !((id[2] == 'i' && id[3] == 'x') || (id[2] == 'x' && id[3] == '2')))
         return ERROR_INT("not a valid spix file", procName, 1);
 
     *pwidth = data[1];
@@ -287,6 +389,44 @@ size_t    size;
 }
 
 
+/*!
+ * \brief   pixWriteStreamSpixPaged()
+ *
+ * \param[in]    fp     file stream
+ * \param[in]    pix
+ * \return  0 if OK; 1 on error
+ *
+ * <pre>
+ * Notes:
+ *      (1) Writes version 2 spix, where the raster data starts on a page
+ *          boundary.  See pixSerializeToMemoryPaged().
+ * </pre>
+ */
+l_ok
+pixWriteStreamSpixPaged(FILE  *fp,
+                        PIX   *pix)
+{
+l_uint32  *data;
+size_t     size;
+
+    PROCNAME("pixWriteStreamSpixPaged");
+
+    if (!fp)
+        return ERROR_INT("stream not defined", procName, 1);
+    if (!pix)
+        return ERROR_INT("pix not defined", procName, 1);
+
+    if (pixSerializeToMemoryPaged(pix, &data, &size))
+        return ERROR_INT("failure to write pix to memory", procName, 1);
+    if (fwrite(data, 1, size, fp) != size) {
+        LEPT_FREE(data);
+        return ERROR_INT("data not written", procName, 1);
+    }
+    LEPT_FREE(data);
+    return 0;
+}
+
+
 /*-----------------------------------------------------------------------*
  *       Low-level serialization of pix to/from memory (uncompressed)    *
  *-----------------------------------------------------------------------*/
@@ -350,15 +490,61 @@ l_ok
 pixSerializeToMemory(PIX        *pixs,
                      l_uint32  **pdata,
                      size_t     *pnbytes)
+{
+    return pixSerializeGeneral(pixs, 0, pdata, pnbytes);
+}
+
+
+/*!
+ * \brief   pixSerializeToMemoryPaged()
+ *
+ * \param[in]    pixs     all depths, colormap OK
+ * \param[out]   pdata    serialized data in memory
+ * \param[out]   pnbytes  number of bytes in data string
+ * \return  0 if OK, 1 on error
+ *
+ * <pre>
+ * Notes:
+ *      (1) This makes version 2 spix.  It is the same as the format
+ *          in pixSerializeToMemory(), except that the ID is "spx2"
+ *          and there are zero bytes between rdatasize and rdata, so
+ *          that rdata starts at a multiple of 4096 bytes.
+ *      (2) A file with this data can be read with pixReadSpixMapped()
+ *          so that the raster data is in whole pages of the mapping.
+ * </pre>
+ */
+l_ok
+pixSerializeToMemoryPaged(PIX        *pixs,
+                          l_uint32  **pdata,
+                          size_t     *pnbytes)
+{
+    return pixSerializeGeneral(pixs, 1, pdata, pnbytes);
+}
+
+
+/*!
+ * \brief   pixSerializeGeneral()
+ *
+ * \param[in]    pixs     all depths, colormap OK
+ * \param[in]    paged    1 for version 2; 0 for version 1
+ * \param[out]   pdata    serialized data in memory
+ * \param[out]   pnbytes  number of bytes in data string
+ * \return  0 if OK, 1 on error
+ */
+static l_int32
+pixSerializeGeneral(PIX        *pixs,
+                    l_int32     paged,
+                    l_uint32  **pdata,
+                    size_t     *pnbytes)
 {
 char      *id;
-l_int32    w, h, d, wpl, rdatasize, ncolors, nbytes, index;
+l_int32    w, h, d, wpl, rdatasize, ncolors, nbytes, index, offset;
 l_uint8   *cdata;  /* data in colormap array (4 bytes/color table entry) */
 l_uint32  *data;
 l_uint32  *rdata;  /* data in pix raster */
 PIXCMAP   *cmap;
 
-    PROCNAME("pixSerializeToMemory");
+    PROCNAME("pixSerializeGeneral");
 
     if (!pdata || !pnbytes)
         return ERROR_INT("&data and &nbytes not both defined", procName, 1);
@@ -376,7 +562,10 @@ PIXCMAP   *cmap;
     if ((cmap = pixGetColormap(pixs)) != NULL)
         pixcmapSerializeToMemory(cmap, 4, &ncolors, &cdata);
 
-    nbytes = 24 + 4 * ncolors + 4 + rdatasize;
+    offset = 24 + 4 * ncolors + 4;  /* start of rdata */
+    if (paged)
+        offset = SpixPageSize * ((offset + SpixPageSize - 1) / SpixPageSize);
+    nbytes = offset + rdatasize;
     if ((data = (l_uint32 *)LEPT_CALLOC(nbytes / 4, sizeof(l_uint32)))
          == NULL) {
         LEPT_FREE(cdata);
@@ -387,8 +576,8 @@ PIXCMAP   *cmap;
     id = (char *)data;
     id[0] = 's';
     id[1] = 'p';
-    id[2] = 'i';
-    id[3] = 'x';
+    id[2] = (paged) ? 'x' : 'i';
+    id[3] = (paged) ? '2' : 'x';
     data[1] = w;
     data[2] = h;
     data[3] = d;
@@ -398,7 +587,7 @@ PIXCMAP   *cmap;
         memcpy(data + 6, cdata, 4 * ncolors);
     index = 6 + ncolors;
     data[index] = rdatasize;
-    memcpy(data + index + 1, rdata, rdatasize);
+    memcpy(data + offset / 4, rdata, rdatasize);
 
 #if  DEBUG_SERIALIZE
     lept_stderr("Serialize:   "
@@ -420,7 +609,8 @@ PIXCMAP   *cmap;
  *
  * <pre>
  * Notes:
- *      (1) See pixSerializeToMemory() for the binary format.
+ *      (1) See pixSerializeToMemory() and pixSerializeToMemoryPaged()
+ *          for the binary formats.
  *      (2) Note the image size limits.
  * </pre>
  */
@@ -428,24 +618,90 @@ PIX *
 pixDeserializeFromMemory(const l_uint32  *data,
                          size_t           nbytes)
 {
-char      *id;
-l_int32    w, h, d, pixdata_size, memdata_size, imdata_size, ncolors;
+l_int32    w, h, d, ncolors;
+size_t     offset;
 l_uint32  *imdata;  /* data in pix raster */
-PIX       *pix1, *pixd;
+PIX       *pixd;
 PIXCMAP   *cmap;
 
     PROCNAME("pixDeserializeFromMemory");
 
     if (!data)
         return (PIX *)ERROR_PTR("data not defined", procName, NULL);
+    if (spixParseHeader(data, nbytes, &w, &h, &d, &ncolors, &offset))
+        return (PIX *)ERROR_PTR("invalid spix data", procName, NULL);
+
+    if ((pixd = pixCreate(w, h, d)) == NULL)
+        return (PIX *)ERROR_PTR("pix not made", procName, NULL);
+    if (ncolors > 0) {
+        cmap = pixcmapDeserializeFromMemory((l_uint8 *)(&data[6]), 4, ncolors);
+        if (!cmap) {
+            pixDestroy(&pixd);
+            return (PIX *)ERROR_PTR("cmap not made", procName, NULL);
+        }
+        pixSetColormap(pixd, cmap);
+    }
+
+    imdata = pixGetData(pixd);
+    memcpy(imdata, (l_uint8 *)data + offset, nbytes - offset);
+
+#if  DEBUG_SERIALIZE
+    lept_stderr("Deserialize: "
+                "raster size = %zu, ncolors in cmap = %d, total bytes = %zu\n",
+                nbytes - offset, ncolors, nbytes);
+#endif  /* DEBUG_SERIALIZE */
+
+    return pixd;
+}
+
+
+/*!
+ * \brief   spixParseHeader()
+ *
+ * \param[in]    data       serialized data in memory
+ * \param[in]    nbytes     number of bytes in data string
+ * \param[out]   pw, ph, pd     image dimensions
+ * \param[out]   pncolors   number of colors in the colormap; 0 if none
+ * \param[out]   poffset    location of the raster data, in bytes
+ * \return  0 if OK, 1 on error
+ *
+ * <pre>
+ * Notes:
+ *      (1) This checks the header of either version of spix, and the
+ *          consistency of the raster data size, the size computed
+ *          from the image dimensions, and the number of bytes.
+ * </pre>
+ */
+static l_int32
+spixParseHeader(const l_uint32  *data,
+                size_t           nbytes,
+                l_int32         *pw,
+                l_int32         *ph,
+                l_int32         *pd,
+                l_int32         *pncolors,
+                size_t          *poffset)
+{
+char     *id;
+l_int32   w, h, d, paged, pixdata_size, memdata_size, imdata_size, ncolors;
+size_t    offset;
+PIX      *pix1;
+
+    PROCNAME("spixParseHeader");
+
     if (nbytes < 28 || nbytes > ((1LL << 31) - 1)) {
         L_ERROR("invalid nbytes = %zu\n", procName, nbytes);
-        return NULL;
+        return 1;
     }
 
     id = (char *)data;
-    if (id[0] != 's' || id[1] != 'p' || id[2] != 'i' || id[3] != 'x')
-        return (PIX *)ERROR_PTR("invalid id string", procName, NULL);
+    if (id[0] != 's' || id[1] != 'p')
+        return ERROR_INT("invalid id string", procName, 1);
+    if (id[2] == 'i' && id[3] == 'x')
+        paged = 0;
+    else if (id[2] == 'x' && id[3] == '2')
+        paged = 1;
+    else
+        return ERROR_INT("invalid id string", procName, 1);
     w = data[1];
     h = data[2];
     d = data[3];
@@ -453,45 +709,35 @@ PIXCMAP   *cmap;
 
         /* Sanity checks on the amount of image data */
     if (w < 1 || w > MaxAllowedWidth)
-        return (PIX *)ERROR_PTR("invalid width", procName, NULL);
+        return ERROR_INT("invalid width", procName, 1);
     if (h < 1 || h > MaxAllowedHeight)
-        return (PIX *)ERROR_PTR("invalid height", procName, NULL);
+        return ERROR_INT("invalid height", procName, 1);
     if (1LL * w * h > MaxAllowedArea)
-        return (PIX *)ERROR_PTR("area too large", procName, NULL);
+        return ERROR_INT("area too large", procName, 1);
     if (ncolors < 0 || ncolors > 256 || ncolors + 6 >= nbytes/sizeof(l_int32))
-        return (PIX *)ERROR_PTR("invalid ncolors", procName, NULL);
+        return ERROR_INT("invalid ncolors", procName, 1);
+    offset = 24 + 4 * ncolors + 4;
+    if (paged)
+        offset = SpixPageSize * ((offset + SpixPageSize - 1) / SpixPageSize);
+    if (offset > nbytes)
+        return ERROR_INT("no raster data", procName, 1);
     if ((pix1 = pixCreateHeader(w, h, d)) == NULL)  /* just make the header */
-        return (PIX *)ERROR_PTR("failed to make header", procName, NULL);
+        return ERROR_INT("failed to make header", procName, 1);
     pixdata_size = 4 * h * pixGetWpl(pix1);
-    memdata_size = nbytes - 24 - 4 * ncolors - 4;
+    memdata_size = nbytes - offset;
     imdata_size = data[6 + ncolors];
     pixDestroy(&pix1);
     if (pixdata_size != memdata_size || pixdata_size != imdata_size) {
         L_ERROR("pixdata_size = %d, memdata_size = %d, imdata_size = %d "
                 "not all equal!\n", procName, pixdata_size, memdata_size,
                 imdata_size);
-        return NULL;
-    }
-
-    if ((pixd = pixCreate(w, h, d)) == NULL)
-        return (PIX *)ERROR_PTR("pix not made", procName, NULL);
-    if (ncolors > 0) {
-        cmap = pixcmapDeserializeFromMemory((l_uint8 *)(&data[6]), 4, ncolors);
-        if (!cmap) {
-            pixDestroy(&pixd);
-            return (PIX *)ERROR_PTR("cmap not made", procName, NULL);
-        }
-        pixSetColormap(pixd, cmap);
+        return 1;
     }
 
-    imdata = pixGetData(pixd);
-    memcpy(imdata, data + 7 + ncolors, imdata_size);
-
-#if  DEBUG_SERIALIZE
-    lept_stderr("Deserialize: "
-                "raster size = %d, ncolors in cmap = %d, total bytes = %zu\n",
-                imdata_size, ncolors, nbytes);
-#endif  /* DEBUG_SERIALIZE */
-
-    return pixd;
+    *pw = w;
+    *ph = h;
+    *pd = d;
+    *pncolors = ncolors;
+    *poffset = offset;
+    return 0;
 }
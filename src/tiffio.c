@@ -40,14 +40,34 @@
  *             PIX       *pixReadStreamTiff()
  *      static PIX       *pixReadFromTiffStream()
  *
+ *     Reading a region of tiff:
+ *             PIX       *pixReadStreamTiffRegion()
+ *      static PIX       *pixReadRegionFromTiffStream()
+ *      static void       tiffUnpackRawRow()
+ *      static PIX       *tiffFinishPix()
+ *
+ *     Reading a reduced resolution tiff image:
+ *             PIX       *pixReadStreamTiffReduced()
+ *
  *     Writing tiff:
  *             l_int32    pixWriteTiff()            [ special top level ]
  *             l_int32    pixWriteTiffCustom()      [ special top level ]
  *             l_int32    pixWriteStreamTiff()
  *             l_int32    pixWriteStreamTiffWA()
  *      static l_int32    pixWriteToTiffStream()
+ *      static void       tiffSetWriteTags()
+ *      static l_int32    tiffWriteRows()
  *      static l_int32    writeCustomTiffTags()
  *
+ *     Reading and writing in bands
+ *             L_TIFF_READER  *tiffReaderOpen()
+ *             void            tiffReaderClose()
+ *             l_int32         tiffReaderGetDimensions()
+ *             PIX            *tiffReaderReadRows()
+ *             L_TIFF_WRITER  *tiffWriterOpen()
+ *             l_int32         tiffWriterWriteRows()
+ *             l_int32         tiffWriterClose()
+ *
  *     Reading and writing multipage tiff
  *             PIX       *pixReadFromMultipageTiff()
  *             PIXA      *pixaReadMultipageTiff()   [ special top level ]
@@ -55,6 +75,17 @@
  *             l_int32    writeMultipageTiff()      [ special top level ]
  *             l_int32    writeMultipageTiffSA()
  *
+ *     Indexed random access to multipage tiff
+ *             L_TIFFINDEX  *tiffIndexCreate()
+ *             void          tiffIndexDestroy()
+ *             l_int32       tiffIndexGetCount()
+ *             L_TIFFINDEX  *tiffIndexRead()
+ *             L_TIFFINDEX  *tiffIndexReadStream()
+ *             l_int32       tiffIndexWrite()
+ *             l_int32       tiffIndexWriteStream()
+ *             PIX          *pixReadTiffIndexed()
+ *             PIXA         *pixaReadMultipageTiffRange()
+ *
  *     Information about tiff file
  *             l_int32    fprintTiffInfo()
  *             l_int32    tiffGetCount()
@@ -67,8 +98,9 @@
  *             l_int32    findTiffCompression()
  *      static l_int32    getTiffCompressedFormat()
  *
- *     Extraction of tiff g4 data:
+ *     Extraction of tiff g4 and jpeg data:
  *             l_int32    extractG4DataFromFile()
+ *             l_int32    extractTiffPageCompressedData()
  *
  *     Open tiff stream from file stream
  *      static TIFF      *fopenTiff()
@@ -125,6 +157,11 @@ static const l_uint32  MaxTiffBufferSize = 1 << 24;  /* 16MiB */
 
     /* All functions with TIFF interfaces are static. */
 static PIX      *pixReadFromTiffStream(TIFF *tif);
+static PIX      *pixReadRegionFromTiffStream(TIFF *tif, BOX *box);
+static void      tiffUnpackRawRow(const l_uint8 *rowptr, size_t rowbytes,
+                                  l_uint32 *line, l_int32 w, l_int32 spp);
+static PIX      *tiffFinishPix(TIFF *tif, PIX *pixd, l_int32 bps,
+                               l_uint16 photometry);
 static l_int32   getTiffStreamResolution(TIFF *tif, l_int32 *pxres,
                                          l_int32 *pyres);
 static l_int32   tiffReadHeaderTiff(TIFF *tif, l_int32 *pwidth,
@@ -137,6 +174,10 @@ static l_int32   writeCustomTiffTags(TIFF *tif, NUMA *natags,
 static l_int32   pixWriteToTiffStream(TIFF *tif, PIX *pix, l_int32 comptype,
                                       NUMA *natags, SARRAY *savals,
                                       SARRAY *satypes, NUMA *nasizes);
+static void      tiffSetWriteTags(TIFF *tif, PIX *pix, l_int32 h,
+                                  l_int32 comptype);
+static l_int32   tiffWriteRows(TIFF *tif, PIX *pix, l_int32 row0,
+                               l_uint8 *linebuf);
 static TIFF     *fopenTiff(FILE *fp, const char *modestring);
 static TIFF     *openTiff(const char *filename, const char *modestring);
 
@@ -716,6 +757,490 @@ PIXCMAP   *cmap;
 }
 
 
+/*--------------------------------------------------------------*
+ *                Reading a region from stream                  *
+ *--------------------------------------------------------------*/
+/*!
+ * \brief   pixReadStreamTiffRegion()
+ *
+ * \param[in]    fp     file stream
+ * \param[in]    n      page number: 0 based
+ * \param[in]    box    region to be read, in full resolution coordinates
+ * \return  pix, or NULL on error or if %box does not intersect the image
+ *
+ * <pre>
+ * Notes:
+ *      (1) Only the strips or tiles that intersect %box are decoded,
+ *          and decoding stops after the last row of the box.
+ *          %box is clipped to the image.  The memory needed is that
+ *          of the region plus one block; see note (3) for the block.
+ *      (2) Unlike pixReadStreamTiff(), this can read tiled images.
+ *      (3) Images with 1 spp, 8 bps gray+alpha and 8 bps contiguous rgb
+ *          are read as raw samples, giving the same result as
+ *          pixReadStreamTiff().  All other images (rgba, old jpeg, etc)
+ *          are decoded strip by strip or tile by tile using the
+ *          libtiff RGBA interface.  A block is then a whole strip,
+ *          decoded at 32 bpp, because libtiff can't decode part of a
+ *          strip.  For a stripped image with a single strip, that is
+ *          the full image width and height, so reading a region of
+ *          such an image takes as much memory as reading all of it.
+ *      (4) If the image has an orientation tag other than top-left,
+ *          %box refers to the oriented image, which requires decoding
+ *          the full image.  This case falls back to reading the full
+ *          image and clipping.
+ * </pre>
+ */
+PIX *
+pixReadStreamTiffRegion(FILE    *fp,
+                        l_int32  n,
+                        BOX     *box)
+{
+l_uint16  orientation;
+PIX      *pix, *pixd;
+TIFF     *tif;
+
+    PROCNAME("pixReadStreamTiffRegion");
+
+    if (!fp)
+        return (PIX *)ERROR_PTR("stream not defined", procName, NULL);
+    if (!box)
+        return (PIX *)ERROR_PTR("box not defined", procName, NULL);
+
+    if ((tif = fopenTiff(fp, "r")) == NULL)
+        return (PIX *)ERROR_PTR("tif not opened", procName, NULL);
+
+    if (TIFFSetDirectory(tif, n) == 0) {
+        TIFFCleanup(tif);
+        return NULL;
+    }
+    if (TIFFGetField(tif, TIFFTAG_ORIENTATION, &orientation) &&
+        orientation != ORIENTATION_TOPLEFT) {
+        L_INFO("orientation = %d; reading full image\n", procName,
+               orientation);
+        if ((pix = pixReadFromTiffStream(tif)) == NULL) {
+            TIFFCleanup(tif);
+            return (PIX *)ERROR_PTR("pix not read", procName, NULL);
+        }
+        pixd = pixClipRectangle(pix, box, NULL);
+        pixDestroy(&pix);
+    } else {
+        pixd = pixReadRegionFromTiffStream(tif, box);
+    }
+    TIFFCleanup(tif);
+    return pixd;
+}
+
+
+/*!
+ * \brief   pixReadRegionFromTiffStream()
+ *
+ * \param[in]    tif    TIFF handle
+ * \param[in]    box    region to be read, in full resolution coordinates
+ * \return  pix, or NULL on error
+ *
+ * <pre>
+ * Notes:
+ *      (1) The image is traversed in blocks, which are tiles for a tiled
+ *          image.  For a stripped image, a block is a single scanline
+ *          for raw sample reading, and a strip for RGBA reading.
+ *          Each block that intersects %box is decoded into a small pix
+ *          and rasterop'd into the destination.
+ *      (2) For strips, libtiff decodes only the strip holding the
+ *          requested scanline, so strips above the box are skipped.
+ *          Because most codecs (e.g., ccitt) can't seek within a strip,
+ *          scanlines are read from the top of the first strip that
+ *          intersects the box; rows above the box are clipped by the
+ *          rasterop.  For RGBA reading, the buffer holds an entire
+ *          decoded strip (tw * rowsperstrip * 4 bytes); this is the
+ *          full image if it has only one strip.
+ *      (3) The postprocessing (colormap, photometry and metadata) is
+ *          identical to pixReadFromTiffStream().
+ * </pre>
+ */
+static PIX *
+pixReadRegionFromTiffStream(TIFF  *tif,
+                            BOX   *box)
+{
+l_uint8   *buf;
+l_uint16   spp, bps, photometry, tiffcomp, sample_fmt, planar;
+l_int32    d, i, j, x, y, bx, by, bw, bh, ystart, nrows, wplt, ret;
+l_int32    rawread, tiled;
+l_uint32   w, h, tw, th, rps, tiffword;
+l_uint32  *raster, *src, *line;
+size_t     bufsize, rowbytes;
+BOX       *boxc;
+PIX       *pixd, *pixt;
+
+    PROCNAME("pixReadRegionFromTiffStream");
+
+    TIFFGetFieldDefaulted(tif, TIFFTAG_SAMPLEFORMAT, &sample_fmt);
+    if (sample_fmt != SAMPLEFORMAT_UINT) {
+        L_ERROR("sample format = %d is not uint\n", procName, sample_fmt);
+        return NULL;
+    }
+    TIFFGetFieldDefaulted(tif, TIFFTAG_BITSPERSAMPLE, &bps);
+    TIFFGetFieldDefaulted(tif, TIFFTAG_SAMPLESPERPIXEL, &spp);
+    TIFFGetFieldDefaulted(tif, TIFFTAG_PLANARCONFIG, &planar);
+    TIFFGetFieldDefaulted(tif, TIFFTAG_COMPRESSION, &tiffcomp);
+    if (bps != 1 && bps != 2 && bps != 4 && bps != 8 && bps != 16) {
+        L_ERROR("invalid bps = %d\n", procName, bps);
+        return NULL;
+    }
+    if (spp == 2 && bps != 8) {
+        L_WARNING("for 2 spp, only handle 8 bps\n", procName);
+        return NULL;
+    }
+    if (spp < 1 || spp > 4)
+        return (PIX *)ERROR_PTR("spp not in set {1,2,3,4}", procName, NULL);
+    d = (spp == 1) ? bps : 32;
+    if (!TIFFGetField(tif, TIFFTAG_PHOTOMETRIC, &photometry))
+        photometry = (tiffcomp == COMPRESSION_CCITTFAX3 ||
+                      tiffcomp == COMPRESSION_CCITTFAX4 ||
+                      tiffcomp == COMPRESSION_CCITTRLE ||
+                      tiffcomp == COMPRESSION_CCITTRLEW) ?
+                      PHOTOMETRIC_MINISWHITE : PHOTOMETRIC_MINISBLACK;
+    rawread = (spp == 1 && tiffcomp != COMPRESSION_OJPEG) || spp == 2 ||
+              (spp == 3 && bps == 8 && planar == PLANARCONFIG_CONTIG &&
+               photometry == PHOTOMETRIC_RGB &&
+               tiffcomp != COMPRESSION_OJPEG && tiffcomp != COMPRESSION_JPEG);
+
+    TIFFGetField(tif, TIFFTAG_IMAGEWIDTH, &w);
+    TIFFGetField(tif, TIFFTAG_IMAGELENGTH, &h);
+    if ((boxc = boxClipToRectangle(box, w, h)) == NULL)
+        return (PIX *)ERROR_PTR("box outside image", procName, NULL);
+    boxGetGeometry(boxc, &bx, &by, &bw, &bh);
+    boxDestroy(&boxc);
+
+        /* Set up the block size and the decoding buffer */
+    tiled = TIFFIsTiled(tif);
+    if (tiled) {
+        TIFFGetField(tif, TIFFTAG_TILEWIDTH, &tw);
+        TIFFGetField(tif, TIFFTAG_TILELENGTH, &th);
+        rowbytes = TIFFTileRowSize(tif);
+        bufsize = (rawread) ? TIFFTileSize(tif) : (size_t)tw * th * 4;
+    } else {
+        tw = w;
+        rowbytes = TIFFScanlineSize(tif);
+        if (rowbytes < (bps * spp * w + 7) / 8)
+            return (PIX *)ERROR_PTR("bad tiff file: tiffbpl is too small",
+                                    procName, NULL);
+        if (rowbytes > MaxTiffBufferSize)
+            return (PIX *)ERROR_PTR("bad tiff file: tiffbpl is too large",
+                                    procName, NULL);
+        TIFFGetFieldDefaulted(tif, TIFFTAG_ROWSPERSTRIP, &rps);
+        rps = L_MAX(1, L_MIN(rps, h));
+        if (rawread) {  /* scanlines */
+            th = 1;
+            bufsize = rowbytes + 1;
+        } else {
+            th = rps;
+            bufsize = (size_t)tw * th * 4;
+        }
+    }
+    if (tw == 0 || th == 0)
+        return (PIX *)ERROR_PTR("invalid block size", procName, NULL);
+
+        /* Start at the top of the first block; for scanlines, that is
+         * the top of the strip holding the first row of the box */
+    if (!tiled && rawread)
+        ystart = (by / rps) * rps;
+    else
+        ystart = (by / th) * th;
+    if ((buf = (l_uint8 *)LEPT_CALLOC(bufsize, 1)) == NULL)
+        return (PIX *)ERROR_PTR("buf not made", procName, NULL);
+    raster = (l_uint32 *)buf;
+
+    pixt = pixCreate(tw, th, d);
+    pixd = pixCreate(bw, bh, d);
+    if (!pixt || !pixd) {
+        LEPT_FREE(buf);
+        pixDestroy(&pixt);
+        pixDestroy(&pixd);
+        return (PIX *)ERROR_PTR("pix not made", procName, NULL);
+    }
+    wplt = pixGetWpl(pixt);
+    if (spp == 2 || spp == 4) pixSetSpp(pixd, 4);
+
+        /* Decode each intersecting block into pixt, and paste it in */
+    ret = 0;
+    for (y = ystart; y < by + bh && !ret; y += th) {
+        nrows = L_MIN(th, h - y);
+        for (x = (bx / tw) * tw; x < bx + bw && !ret; x += tw) {
+            if (rawread) {
+                if (tiled)
+                    ret = (TIFFReadTile(tif, buf, x, y, 0, 0) < 0);
+                else
+                    ret = (TIFFReadScanline(tif, buf, y, 0) < 0);
+                if (ret) break;
+                for (i = 0; i < nrows; i++) {
+                    tiffUnpackRawRow(buf + i * rowbytes, rowbytes,
+                                     pixGetData(pixt) + i * wplt, tw, spp);
+                }
+                if (spp == 1 && bps <= 8)
+                    pixEndianByteSwap(pixt);
+                else if (spp == 1)  /* bps == 16 */
+                    pixEndianTwoByteSwap(pixt);
+            } else {
+                    /* The RGBA raster has its origin at the lower left */
+                if (tiled)
+                    ret = !TIFFReadRGBATile(tif, x, y, raster);
+                else
+                    ret = !TIFFReadRGBAStrip(tif, y, raster);
+                if (ret) break;
+                for (i = 0; i < nrows; i++) {
+                    src = (tiled) ? raster + (th - 1 - i) * tw
+                                  : raster + (nrows - 1 - i) * tw;
+                    line = pixGetData(pixt) + i * wplt;
+                    for (j = 0; j < tw; j++) {
+                        tiffword = src[j];
+                        if (d == 8) {  /* old jpeg */
+                            SET_DATA_BYTE(line, j, TIFFGetR(tiffword));
+                        } else if (spp == 3) {
+                            composeRGBPixel(TIFFGetR(tiffword),
+                                TIFFGetG(tiffword), TIFFGetB(tiffword),
+                                line + j);
+                        } else {
+                            composeRGBAPixel(TIFFGetR(tiffword),
+                                TIFFGetG(tiffword), TIFFGetB(tiffword),
+                                TIFFGetA(tiffword), line + j);
+                        }
+                    }
+                }
+            }
+            pixRasterop(pixd, x - bx, y - by, tw, nrows, PIX_SRC,
+                        pixt, 0, 0);
+        }
+    }
+    LEPT_FREE(buf);
+    pixDestroy(&pixt);
+    if (ret) {
+        pixDestroy(&pixd);
+        return (PIX *)ERROR_PTR("block read fail", procName, NULL);
+    }
+
+    return tiffFinishPix(tif, pixd, bps, photometry);
+}
+
+
+/*!
+ * \brief   tiffUnpackRawRow()
+ *
+ * \param[in]    rowptr     one row of raw tiff samples
+ * \param[in]    rowbytes   number of bytes in the row
+ * \param[in]    line       row of the pix to be filled
+ * \param[in]    w          number of pixels in the row
+ * \param[in]    spp        1, 2 (gray + alpha, 8 bps) or 3 (rgb, 8 bps)
+ * \return  void
+ *
+ * <pre>
+ * Notes:
+ *      (1) For spp == 1, the bytes are copied; the caller must do
+ *          the endian byte swap on the pix.
+ * </pre>
+ */
+static void
+tiffUnpackRawRow(const l_uint8  *rowptr,
+                 size_t          rowbytes,
+                 l_uint32       *line,
+                 l_int32         w,
+                 l_int32         spp)
+{
+l_int32    j, k;
+l_uint32  *ppixel;
+
+    if (spp == 1) {
+        memcpy(line, rowptr, rowbytes);
+        return;
+    }
+    for (j = k = 0, ppixel = line; j < w; j++, ppixel++) {
+        if (spp == 2) {  /* gray plus alpha */
+            SET_DATA_BYTE(ppixel, COLOR_RED, rowptr[k]);
+            SET_DATA_BYTE(ppixel, COLOR_GREEN, rowptr[k]);
+            SET_DATA_BYTE(ppixel, COLOR_BLUE, rowptr[k++]);
+            SET_DATA_BYTE(ppixel, L_ALPHA_CHANNEL, rowptr[k++]);
+        } else {  /* rgb */
+            composeRGBPixel(rowptr[k], rowptr[k + 1], rowptr[k + 2], ppixel);
+            k += 3;
+        }
+    }
+}
+
+
+/*!
+ * \brief   tiffFinishPix()
+ *
+ * \param[in]    tif          TIFF handle
+ * \param[in]    pixd         raster as read from the tiff samples
+ * \param[in]    bps          bits/sample
+ * \param[in]    photometry   tiff photometric interpretation
+ * \return  pixd, which may be a new pix; NULL on error
+ *
+ * <pre>
+ * Notes:
+ *      (1) This sets the resolution, input format, colormap and text,
+ *          and inverts the raster if required by the photometry.  It is
+ *          used for region and band reading, and does the same
+ *          postprocessing as pixReadFromTiffStream().
+ *      (2) On error, %pixd is destroyed.
+ * </pre>
+ */
+static PIX *
+tiffFinishPix(TIFF     *tif,
+              PIX      *pixd,
+              l_int32   bps,
+              l_uint16  photometry)
+{
+char      *text;
+l_uint16   tiffcomp;
+l_uint16  *redmap, *greenmap, *bluemap;
+l_int32    i, d, ncolors, xres, yres;
+PIX       *pix1;
+PIXCMAP   *cmap;
+
+    PROCNAME("tiffFinishPix");
+
+    d = pixGetDepth(pixd);
+    if (getTiffStreamResolution(tif, &xres, &yres) == 0) {
+        pixSetXRes(pixd, xres);
+        pixSetYRes(pixd, yres);
+    }
+    TIFFGetFieldDefaulted(tif, TIFFTAG_COMPRESSION, &tiffcomp);
+    pixSetInputFormat(pixd, getTiffCompressedFormat(tiffcomp));
+
+    if (TIFFGetField(tif, TIFFTAG_COLORMAP, &redmap, &greenmap, &bluemap)) {
+        if (bps > 8) {
+            pixDestroy(&pixd);
+            return (PIX *)ERROR_PTR("colormap size > 256", procName, NULL);
+        }
+        cmap = pixcmapCreate(bps);
+        ncolors = 1 << bps;
+        for (i = 0; i < ncolors; i++)
+            pixcmapAddColor(cmap, redmap[i] >> 8, greenmap[i] >> 8,
+                            bluemap[i] >> 8);
+        pixSetColormap(pixd, cmap);
+        if (bps == 1) {
+            pix1 = pixRemoveColormap(pixd, REMOVE_CMAP_BASED_ON_SRC);
+            pixDestroy(&pixd);
+            pixd = pix1;
+        }
+    } else if ((d == 1 && photometry == PHOTOMETRIC_MINISBLACK) ||
+               (d == 8 && photometry == PHOTOMETRIC_MINISWHITE)) {
+        pixInvert(pixd, pixd);
+    }
+
+    text = NULL;
+    TIFFGetField(tif, TIFFTAG_IMAGEDESCRIPTION, &text);
+    if (text) pixSetText(pixd, text);
+    return pixd;
+}
+
+
+/*--------------------------------------------------------------*
+ *            Reading a reduced resolution image                *
+ *--------------------------------------------------------------*/
+/*!
+ * \brief   pixReadStreamTiffReduced()
+ *
+ * \param[in]    fp       file stream
+ * \param[in]    minw     minimum width of returned image
+ * \param[in]    minh     minimum height of returned image
+ * \return  pix, or NULL on error
+ *
+ * <pre>
+ * Notes:
+ *      (1) Pyramidal tiff files store reduced resolution versions of
+ *          an image, either in SubIFDs of the full resolution image or
+ *          in IFDs immediately following it that have the
+ *          FILETYPE_REDUCEDIMAGE bit set in the subfile type.
+ *          This returns the smallest stored version of the first image
+ *          that is at least %minw x %minh.  If there is none, the full
+ *          resolution image is returned.
+ *      (2) Only the IFDs are read to make the selection; just the
+ *          selected image is decoded.
+ * </pre>
+ */
+PIX *
+pixReadStreamTiffReduced(FILE     *fp,
+                         l_int32   minw,
+                         l_int32   minh)
+{
+l_uint16   nsub;
+l_uint32   w, h, subtype;
+l_int32    i, index, bestindex;
+l_uint64   area, bestarea;
+toff_t    *subifds, *offsets;
+toff_t     bestoffset;
+PIX       *pix;
+TIFF      *tif;
+
+    PROCNAME("pixReadStreamTiffReduced");
+
+    if (!fp)
+        return (PIX *)ERROR_PTR("stream not defined", procName, NULL);
+
+    if ((tif = fopenTiff(fp, "r")) == NULL)
+        return (PIX *)ERROR_PTR("tif not opened", procName, NULL);
+    if (TIFFSetDirectory(tif, 0) == 0) {
+        TIFFCleanup(tif);
+        return (PIX *)ERROR_PTR("no image in file", procName, NULL);
+    }
+
+        /* Start with the full resolution image */
+    TIFFGetField(tif, TIFFTAG_IMAGEWIDTH, &w);
+    TIFFGetField(tif, TIFFTAG_IMAGELENGTH, &h);
+    bestarea = (l_uint64)w * h;
+    bestindex = 0;
+    bestoffset = 0;
+
+        /* Look at the SubIFDs.  The offset array belongs to the
+         * current directory, so it must be copied before moving. */
+    if (TIFFGetField(tif, TIFFTAG_SUBIFD, &nsub, &subifds) && nsub > 0) {
+        offsets = (toff_t *)LEPT_CALLOC(nsub, sizeof(toff_t));
+        memcpy(offsets, subifds, nsub * sizeof(toff_t));
+        for (i = 0; i < nsub; i++) {
+            if (!TIFFSetSubDirectory(tif, offsets[i]))
+                continue;
+            TIFFGetField(tif, TIFFTAG_IMAGEWIDTH, &w);
+            TIFFGetField(tif, TIFFTAG_IMAGELENGTH, &h);
+            area = (l_uint64)w * h;
+            if (w >= minw && h >= minh && area < bestarea) {
+                bestarea = area;
+                bestoffset = offsets[i];
+            }
+        }
+        LEPT_FREE(offsets);
+        TIFFSetDirectory(tif, 0);
+    }
+
+        /* Look at the reduced images that follow in the main chain */
+    index = 0;
+    while (TIFFReadDirectory(tif)) {
+        index++;
+        if (!TIFFGetField(tif, TIFFTAG_SUBFILETYPE, &subtype) ||
+            !(subtype & FILETYPE_REDUCEDIMAGE))
+            break;
+        TIFFGetField(tif, TIFFTAG_IMAGEWIDTH, &w);
+        TIFFGetField(tif, TIFFTAG_IMAGELENGTH, &h);
+        area = (l_uint64)w * h;
+        if (w >= minw && h >= minh && area < bestarea) {
+            bestarea = area;
+            bestindex = index;
+            bestoffset = 0;
+        }
+    }
+
+    if ((bestoffset && !TIFFSetSubDirectory(tif, bestoffset)) ||
+        (!bestoffset && !TIFFSetDirectory(tif, bestindex))) {
+        TIFFCleanup(tif);
+        return (PIX *)ERROR_PTR("selected image not found", procName, NULL);
+    }
+    pix = pixReadFromTiffStream(tif);
+    TIFFCleanup(tif);
+    if (!pix)
+        return (PIX *)ERROR_PTR("pix not read", procName, NULL);
+    return pix;
+}
+
 
 /*--------------------------------------------------------------*
  *                       Writing to file                        *
@@ -963,15 +1488,8 @@ pixWriteToTiffStream(TIFF    *tif,
                      SARRAY  *satypes,
                      NUMA    *nasizes)
 {
-l_uint8   *linebuf, *data;
-l_uint16   redmap[256], greenmap[256], bluemap[256];
-l_int32    w, h, d, spp, i, j, k, wpl, bpl, tiffbpl, ncolors, cmapsize;
-l_int32   *rmap, *gmap, *bmap;
-l_int32    xres, yres;
-l_uint32  *line, *ppixel;
-PIX       *pixt;
-PIXCMAP   *cmap;
-char      *text;
+l_uint8  *linebuf;
+l_int32   h, ret;
 
     PROCNAME("pixWriteToTiffStream");
 
@@ -981,7 +1499,61 @@ char      *text;
         return ERROR_INT( "pix not defined", procName, 1 );
 
     pixSetPadBits(pix, 0);
-    pixGetDimensions(pix, &w, &h, &d);
+    h = pixGetHeight(pix);
+    tiffSetWriteTags(tif, pix, h, comptype);
+
+        /* This is a no-op if arrays are NULL */
+    writeCustomTiffTags(tif, natags, savals, satypes, nasizes);
+
+        /* Use single strip for image */
+    TIFFSetField(tif, TIFFTAG_ROWSPERSTRIP, h);
+
+    if ((linebuf = (l_uint8 *)LEPT_CALLOC(1, 4 * pixGetWpl(pix))) == NULL)
+        return ERROR_INT("calloc fail for linebuf", procName, 1);
+    ret = tiffWriteRows(tif, pix, 0, linebuf);
+    LEPT_FREE(linebuf);
+    if (ret)
+        L_ERROR("scanline write failed\n", procName);
+
+/*    TIFFWriteDirectory(tif); */
+    return 0;
+}
+
+
+/*!
+ * \brief   tiffSetWriteTags()
+ *
+ * \param[in]    tif
+ * \param[in]    pix        template for width, depth, colormap, resolution
+ *                          and text
+ * \param[in]    h          height of the image to be written
+ * \param[in]    comptype   IFF_TIFF, IFF_TIFF_G4, etc.
+ * \return  void
+ *
+ * <pre>
+ * Notes:
+ *      (1) This sets the header tags for writing an image of height %h,
+ *          which need not be the height of %pix.  It is used both for
+ *          writing a full image and for writing an image in bands.
+ * </pre>
+ */
+static void
+tiffSetWriteTags(TIFF    *tif,
+                 PIX     *pix,
+                 l_int32  h,
+                 l_int32  comptype)
+{
+l_uint16   redmap[256], greenmap[256], bluemap[256];
+l_int32    w, d, spp, i, ncolors, cmapsize;
+l_int32   *rmap, *gmap, *bmap;
+l_int32    xres, yres;
+PIXCMAP   *cmap;
+char      *text;
+
+    PROCNAME("tiffSetWriteTags");
+
+    w = pixGetWidth(pix);
+    d = pixGetDepth(pix);
     spp = pixGetSpp(pix);
     xres = pixGetXRes(pix);
     yres = pixGetYRes(pix);
@@ -1081,22 +1653,37 @@ char      *text;
         L_WARNING("unknown tiff compression; using none\n", procName);
         TIFFSetField(tif, TIFFTAG_COMPRESSION, COMPRESSION_NONE);
     }
+}
 
-        /* This is a no-op if arrays are NULL */
-    writeCustomTiffTags(tif, natags, savals, satypes, nasizes);
 
-        /* ------------- Write out the image data -------------  */
+/*!
+ * \brief   tiffWriteRows()
+ *
+ * \param[in]    tif
+ * \param[in]    pix       rows to be written; the pad bits must be 0
+ * \param[in]    row0      tiff row of the first row of %pix
+ * \param[in]    linebuf   buffer of at least 4 * wpl bytes
+ * \return  0 if OK, 1 on error
+ */
+static l_int32
+tiffWriteRows(TIFF     *tif,
+              PIX      *pix,
+              l_int32   row0,
+              l_uint8  *linebuf)
+{
+l_uint8   *data;
+l_int32    w, h, d, spp, i, j, k, wpl, bpl, tiffbpl, ret;
+l_uint32  *line, *ppixel;
+PIX       *pixt;
+
+    pixGetDimensions(pix, &w, &h, &d);
+    spp = pixGetSpp(pix);
     tiffbpl = TIFFScanlineSize(tif);
     wpl = pixGetWpl(pix);
     bpl = 4 * wpl;
     if (tiffbpl > bpl)
         lept_stderr("Big trouble: tiffbpl = %d, bpl = %d\n", tiffbpl, bpl);
-    if ((linebuf = (l_uint8 *)LEPT_CALLOC(1, bpl)) == NULL)
-        return ERROR_INT("calloc fail for linebuf", procName, 1);
-
-        /* Use single strip for image */
-    TIFFSetField(tif, TIFFTAG_ROWSPERSTRIP, h);
-
+    ret = 0;
     if (d != 24 && d != 32) {
         if (d == 16)
             pixt = pixEndianTwoByteSwapNew(pix);
@@ -1105,14 +1692,16 @@ char      *text;
         data = (l_uint8 *)pixGetData(pixt);
         for (i = 0; i < h; i++, data += bpl) {
             memcpy(linebuf, data, tiffbpl);
-            if (TIFFWriteScanline(tif, linebuf, i, 0) < 0)
+            if ((ret = (TIFFWriteScanline(tif, linebuf, row0 + i, 0) < 0)))
                 break;
         }
         pixDestroy(&pixt);
-    } else if (d == 24) {  /* See note 4 above: special case of 24 bpp rgb */
+    } else if (d == 24) {  /* special case of 24 bpp rgb; see
+                            * note 4 in pixWriteToTiffStream() */
         for (i = 0; i < h; i++) {
             line = pixGetData(pix) + i * wpl;
-            if (TIFFWriteScanline(tif, (l_uint8 *)line, i, 0) < 0)
+            if ((ret = (TIFFWriteScanline(tif, (l_uint8 *)line,
+                                          row0 + i, 0) < 0)))
                 break;
         }
     } else {  /* 32 bpp rgb or rgba */
@@ -1126,15 +1715,12 @@ char      *text;
                     linebuf[k++] = GET_DATA_BYTE(ppixel, L_ALPHA_CHANNEL);
                 ppixel++;
             }
-            if (TIFFWriteScanline(tif, linebuf, i, 0) < 0)
+            if ((ret = (TIFFWriteScanline(tif, linebuf, row0 + i, 0) < 0)))
                 break;
         }
     }
 
-/*    TIFFWriteDirectory(tif); */
-    LEPT_FREE(linebuf);
-
-    return 0;
+    return ret;
 }
 
 
@@ -1262,12 +1848,375 @@ l_uint32   uval, uval2;
 
 
 /*--------------------------------------------------------------*
- *               Reading and writing multipage tiff             *
+ *                Reading and writing in bands                  *
  *--------------------------------------------------------------*/
+    /*! Sequential reader of rows from a stripped tiff image */
+struct L_Tiff_Reader
+{
+    TIFF       *tif;          /*!< tiff handle                            */
+    l_uint8    *buf;          /*!< buffer for one scanline                */
+    size_t      rowbytes;     /*!< bytes in a scanline                    */
+    l_int32     w;            /*!< image width                            */
+    l_int32     h;            /*!< image height                           */
+    l_int32     d;            /*!< depth of the raster that is read       */
+    l_int32     bps;          /*!< bits/sample                            */
+    l_int32     spp;          /*!< samples/pixel                          */
+    l_uint16    photometry;   /*!< photometric interpretation             */
+    l_int32     row;          /*!< next row to be read                    */
+};
+
+    /*! Sequential writer of rows to a single-strip tiff image */
+struct L_Tiff_Writer
+{
+    TIFF       *tif;          /*!< tiff handle                            */
+    l_uint8    *linebuf;      /*!< buffer for one scanline                */
+    l_int32     w;            /*!< image width                            */
+    l_int32     h;            /*!< image height                           */
+    l_int32     d;            /*!< image depth                            */
+    l_int32     spp;          /*!< samples/pixel                          */
+    l_int32     row;          /*!< next row to be written                 */
+    l_int32     error;        /*!< set if a scanline write fails          */
+};
+
+
 /*!
- * \brief   pixReadFromMultipageTiff()
+ * \brief   tiffReaderOpen()
  *
- * \param[in]      fname     filename
+ * \param[in]    filename
+ * \param[in]    n          page number: 0 based
+ * \return  reader, or NULL on error
+ *
+ * <pre>
+ * Notes:
+ *      (1) This opens page %n for reading rows in sequence from the
+ *          top, with tiffReaderReadRows().  Only one scanline of the
+ *          image is buffered, so an image that is too large to hold
+ *          in memory can be processed in bands of rows.
+ *      (2) The image must be stored in strips, and have samples that
+ *          can be read without the libtiff RGBA interface: 1 spp with
+ *          any depth (except old jpeg), 8 bps gray + alpha, or 8 bps
+ *          contiguous rgb that is not jpeg compressed.  These give the
+ *          same rows as pixReadTiff().  For other images, use pixReadTiff()
+ *          or pixReadStreamTiffRegion().
+ *      (3) Orientation tags are ignored; the rows are in file order.
+ * </pre>
+ */
+L_TIFF_READER *
+tiffReaderOpen(const char  *filename,
+               l_int32      n)
+{
+l_uint16        spp, bps, tiffcomp, sample_fmt, planar, photometry;
+l_uint32        w, h;
+size_t          rowbytes;
+L_TIFF_READER  *reader;
+TIFF           *tif;
+
+    PROCNAME("tiffReaderOpen");
+
+    if (!filename)
+        return (L_TIFF_READER *)ERROR_PTR("filename not defined",
+                                          procName, NULL);
+    if ((tif = openTiff(filename, "r")) == NULL)
+        return (L_TIFF_READER *)ERROR_PTR("tif not opened", procName, NULL);
+    if (TIFFSetDirectory(tif, n) == 0) {
+        TIFFClose(tif);
+        return (L_TIFF_READER *)ERROR_PTR("page not found", procName, NULL);
+    }
+
+    TIFFGetFieldDefaulted(tif, TIFFTAG_SAMPLEFORMAT, &sample_fmt);
+    TIFFGetFieldDefaulted(tif, TIFFTAG_BITSPERSAMPLE, &bps);
+    TIFFGetFieldDefaulted(tif, TIFFTAG_SAMPLESPERPIXEL, &spp);
+    TIFFGetFieldDefaulted(tif, TIFFTAG_PLANARCONFIG, &planar);
+    TIFFGetFieldDefaulted(tif, TIFFTAG_COMPRESSION, &tiffcomp);
+    if (!TIFFGetField(tif, TIFFTAG_PHOTOMETRIC, &photometry))
+        photometry = (tiffcomp == COMPRESSION_CCITTFAX3 ||
+                      tiffcomp == COMPRESSION_CCITTFAX4 ||
+                      tiffcomp == COMPRESSION_CCITTRLE ||
+                      tiffcomp == COMPRESSION_CCITTRLEW) ?
+                      PHOTOMETRIC_MINISWHITE : PHOTOMETRIC_MINISBLACK;
+    TIFFGetField(tif, TIFFTAG_IMAGEWIDTH, &w);
+    TIFFGetField(tif, TIFFTAG_IMAGELENGTH, &h);
+    rowbytes = TIFFScanlineSize(tif);
+    if (TIFFIsTiled(tif) || sample_fmt != SAMPLEFORMAT_UINT ||
+        (bps != 1 && bps != 2 && bps != 4 && bps != 8 && bps != 16) ||
+        (spp == 1 && tiffcomp == COMPRESSION_OJPEG) ||
+        (spp == 2 && bps != 8) ||
+        (spp == 3 && (bps != 8 || planar != PLANARCONFIG_CONTIG ||
+                      photometry != PHOTOMETRIC_RGB ||
+                      tiffcomp == COMPRESSION_OJPEG ||
+                      tiffcomp == COMPRESSION_JPEG)) ||
+        spp < 1 || spp > 3) {
+        TIFFClose(tif);
+        return (L_TIFF_READER *)ERROR_PTR("image can't be read in bands",
+                                          procName, NULL);
+    }
+    if (w == 0 || h == 0 || rowbytes < ((size_t)bps * spp * w + 7) / 8 ||
+        rowbytes > MaxTiffBufferSize) {
+        TIFFClose(tif);
+        return (L_TIFF_READER *)ERROR_PTR("invalid image size",
+                                          procName, NULL);
+    }
+
+    reader = (L_TIFF_READER *)LEPT_CALLOC(1, sizeof(L_TIFF_READER));
+    reader->tif = tif;
+    reader->buf = (l_uint8 *)LEPT_CALLOC(rowbytes + 1, 1);
+    reader->rowbytes = rowbytes;
+    reader->w = w;
+    reader->h = h;
+    reader->d = (spp == 1) ? bps : 32;
+    reader->bps = bps;
+    reader->spp = spp;
+    reader->photometry = photometry;
+    return reader;
+}
+
+
+/*!
+ * \brief   tiffReaderClose()
+ *
+ * \param[in,out]   preader    will be set to null before returning
+ * \return  void
+ */
+void
+tiffReaderClose(L_TIFF_READER  **preader)
+{
+L_TIFF_READER  *reader;
+
+    PROCNAME("tiffReaderClose");
+
+    if (preader == NULL) {
+        L_WARNING("ptr address is null!\n", procName);
+        return;
+    }
+    if ((reader = *preader) == NULL)
+        return;
+
+    TIFFClose(reader->tif);
+    LEPT_FREE(reader->buf);
+    LEPT_FREE(reader);
+    *preader = NULL;
+}
+
+
+/*!
+ * \brief   tiffReaderGetDimensions()
+ *
+ * \param[in]    reader
+ * \param[out]   pw     [optional] image width
+ * \param[out]   ph     [optional] image height
+ * \param[out]   pd     [optional] depth of the raster that is read
+ * \return  0 if OK, 1 on error
+ */
+l_ok
+tiffReaderGetDimensions(L_TIFF_READER  *reader,
+                        l_int32        *pw,
+                        l_int32        *ph,
+                        l_int32        *pd)
+{
+    PROCNAME("tiffReaderGetDimensions");
+
+    if (pw) *pw = 0;
+    if (ph) *ph = 0;
+    if (pd) *pd = 0;
+    if (!reader)
+        return ERROR_INT("reader not defined", procName, 1);
+    if (pw) *pw = reader->w;
+    if (ph) *ph = reader->h;
+    if (pd) *pd = reader->d;
+    return 0;
+}
+
+
+/*!
+ * \brief   tiffReaderReadRows()
+ *
+ * \param[in]    reader
+ * \param[in]    nrows      number of rows requested
+ * \return  pix of the next %nrows rows, or NULL on error or if
+ *              all rows have been read
+ *
+ * <pre>
+ * Notes:
+ *      (1) Fewer than %nrows rows are returned at the bottom of the image.
+ *      (2) Each band has the colormap, resolution and text of the image,
+ *          and is postprocessed in the same way as by pixReadTiff().
+ * </pre>
+ */
+PIX *
+tiffReaderReadRows(L_TIFF_READER  *reader,
+                   l_int32         nrows)
+{
+l_int32  i, wpl;
+PIX     *pix;
+
+    PROCNAME("tiffReaderReadRows");
+
+    if (!reader)
+        return (PIX *)ERROR_PTR("reader not defined", procName, NULL);
+    if (nrows < 1)
+        return (PIX *)ERROR_PTR("nrows < 1", procName, NULL);
+    if (reader->row >= reader->h)
+        return NULL;
+
+    nrows = L_MIN(nrows, reader->h - reader->row);
+    if ((pix = pixCreate(reader->w, nrows, reader->d)) == NULL)
+        return (PIX *)ERROR_PTR("pix not made", procName, NULL);
+    if (reader->spp == 2) pixSetSpp(pix, 4);
+    wpl = pixGetWpl(pix);
+    for (i = 0; i < nrows; i++, reader->row++) {
+        if (TIFFReadScanline(reader->tif, reader->buf, reader->row, 0) < 0) {
+            pixDestroy(&pix);
+            return (PIX *)ERROR_PTR("scanline read fail", procName, NULL);
+        }
+        tiffUnpackRawRow(reader->buf, reader->rowbytes,
+                         pixGetData(pix) + i * wpl, reader->w, reader->spp);
+    }
+    if (reader->spp == 1 && reader->bps <= 8)
+        pixEndianByteSwap(pix);
+    else if (reader->spp == 1)  /* bps == 16 */
+        pixEndianTwoByteSwap(pix);
+    return tiffFinishPix(reader->tif, pix, reader->bps, reader->photometry);
+}
+
+
+/*!
+ * \brief   tiffWriterOpen()
+ *
+ * \param[in]    filename
+ * \param[in]    pixt       template for width, depth, colormap, resolution
+ *                          and text of the image
+ * \param[in]    h          height of the image to be written
+ * \param[in]    comptype   IFF_TIFF, IFF_TIFF_RLE, IFF_TIFF_PACKBITS,
+ *                          IFF_TIFF_G3, IFF_TIFF_G4,
+ *                          IFF_TIFF_LZW, IFF_TIFF_ZIP, IFF_TIFF_JPEG
+ * \return  writer, or NULL on error
+ *
+ * <pre>
+ * Notes:
+ *      (1) This opens a tiff file for writing an image of height %h,
+ *          in bands of rows with tiffWriterWriteRows().  The header is
+ *          the same as written by pixWriteTiff(), and the image is
+ *          written in a single strip, so the file is identical to
+ *          the one written by pixWriteTiff() from the full image.
+ *      (2) Use any band of the image for %pixt; it is not written.
+ * </pre>
+ */
+L_TIFF_WRITER *
+tiffWriterOpen(const char  *filename,
+               PIX         *pixt,
+               l_int32      h,
+               l_int32      comptype)
+{
+L_TIFF_WRITER  *writer;
+TIFF           *tif;
+
+    PROCNAME("tiffWriterOpen");
+
+    if (!filename)
+        return (L_TIFF_WRITER *)ERROR_PTR("filename not defined",
+                                          procName, NULL);
+    if (!pixt)
+        return (L_TIFF_WRITER *)ERROR_PTR("pixt not defined", procName, NULL);
+    if (h < 1)
+        return (L_TIFF_WRITER *)ERROR_PTR("h < 1", procName, NULL);
+    if ((comptype == IFF_TIFF_G4 || comptype == IFF_TIFF_G3 ||
+         comptype == IFF_TIFF_RLE || comptype == IFF_TIFF_PACKBITS) &&
+         pixGetDepth(pixt) != 1) {
+        L_WARNING("comptype for binary only; using lzw\n", procName);
+        comptype = IFF_TIFF_LZW;
+    }
+
+    if ((tif = openTiff(filename, "w")) == NULL)
+        return (L_TIFF_WRITER *)ERROR_PTR("tif not opened", procName, NULL);
+    tiffSetWriteTags(tif, pixt, h, comptype);
+    TIFFSetField(tif, TIFFTAG_ROWSPERSTRIP, h);
+
+    writer = (L_TIFF_WRITER *)LEPT_CALLOC(1, sizeof(L_TIFF_WRITER));
+    writer->tif = tif;
+    writer->linebuf = (l_uint8 *)LEPT_CALLOC(1, 4 * pixGetWpl(pixt));
+    writer->w = pixGetWidth(pixt);
+    writer->h = h;
+    writer->d = pixGetDepth(pixt);
+    writer->spp = pixGetSpp(pixt);
+    return writer;
+}
+
+
+/*!
+ * \brief   tiffWriterWriteRows()
+ *
+ * \param[in]    writer
+ * \param[in]    pix        next band of rows; same width and depth as
+ *                          the template
+ * \return  0 if OK, 1 on error
+ */
+l_ok
+tiffWriterWriteRows(L_TIFF_WRITER  *writer,
+                    PIX            *pix)
+{
+l_int32  w, h, d;
+
+    PROCNAME("tiffWriterWriteRows");
+
+    if (!writer)
+        return ERROR_INT("writer not defined", procName, 1);
+    if (!pix)
+        return ERROR_INT("pix not defined", procName, 1);
+    pixGetDimensions(pix, &w, &h, &d);
+    if (w != writer->w || d != writer->d)
+        return ERROR_INT("pix size differs from template", procName, 1);
+    if (writer->row + h > writer->h)
+        return ERROR_INT("too many rows", procName, 1);
+
+    pixSetPadBits(pix, 0);
+    if (tiffWriteRows(writer->tif, pix, writer->row, writer->linebuf)) {
+        writer->error = 1;
+        return ERROR_INT("scanline write fail", procName, 1);
+    }
+    writer->row += h;
+    return 0;
+}
+
+
+/*!
+ * \brief   tiffWriterClose()
+ *
+ * \param[in,out]   pwriter    will be set to null before returning
+ * \return  0 if OK, 1 on error or if not all rows were written
+ */
+l_ok
+tiffWriterClose(L_TIFF_WRITER  **pwriter)
+{
+l_int32         ret;
+L_TIFF_WRITER  *writer;
+
+    PROCNAME("tiffWriterClose");
+
+    if (!pwriter)
+        return ERROR_INT("&writer not defined", procName, 1);
+    if ((writer = *pwriter) == NULL)
+        return ERROR_INT("writer not defined", procName, 1);
+
+    ret = writer->error;
+    if (writer->row != writer->h) {
+        L_ERROR("wrote %d of %d rows\n", procName, writer->row, writer->h);
+        ret = 1;
+    }
+    TIFFClose(writer->tif);
+    LEPT_FREE(writer->linebuf);
+    LEPT_FREE(writer);
+    *pwriter = NULL;
+    return ret;
+}
+
+
+/*--------------------------------------------------------------*
+ *               Reading and writing multipage tiff             *
+ *--------------------------------------------------------------*/
+/*!
+ * \brief   pixReadFromMultipageTiff()
+ *
+ * \param[in]      fname     filename
  * \param[in,out]  poffset   set offset to 0 for first image
  * \return  pix, or NULL on error or if previous call returned the last image
  *
@@ -1537,6 +2486,352 @@ PIX         *pix;
 }
 
 
+/*--------------------------------------------------------------*
+ *            Indexed random access to multipage tiff           *
+ *--------------------------------------------------------------*/
+/*!
+ * \brief   tiffIndexCreate()
+ *
+ * \param[in]    filename    multipage tiff file
+ * \return  tindex, or NULL on error
+ *
+ * <pre>
+ * Notes:
+ *      (1) This walks the chain of image file directories once and
+ *          records the file offset of each one.  Any page can then be
+ *          located directly with TIFFSetSubDirectory(), instead of
+ *          reading every directory that precedes it.
+ *      (2) The index can be saved as a sidecar file with tiffIndexWrite()
+ *          and reused with tiffIndexRead(), so that the walk is only
+ *          done once for each tiff file.
+ * </pre>
+ */
+L_TIFFINDEX *
+tiffIndexCreate(const char  *filename)
+{
+l_int32       n;
+L_TIFFINDEX  *tindex;
+TIFF         *tif;
+
+    PROCNAME("tiffIndexCreate");
+
+    if (!filename)
+        return (L_TIFFINDEX *)ERROR_PTR("filename not defined", procName, NULL);
+
+    if ((tif = openTiff(filename, "r")) == NULL)
+        return (L_TIFFINDEX *)ERROR_PTR("tif not opened", procName, NULL);
+
+    tindex = (L_TIFFINDEX *)LEPT_CALLOC(1, sizeof(L_TIFFINDEX));
+    tindex->filesize = nbytesInFile(filename);
+    tindex->offsets = l_dnaCreate(0);
+    n = 0;
+    do {
+        l_dnaAddNumber(tindex->offsets, (l_float64)TIFFCurrentDirOffset(tif));
+        if (++n == ManyPagesInTiffFile + 1) {
+            L_WARNING("big file: more than %d pages\n", procName,
+                      ManyPagesInTiffFile);
+        }
+    } while (TIFFReadDirectory(tif) != 0);
+
+    TIFFClose(tif);
+    return tindex;
+}
+
+
+/*!
+ * \brief   tiffIndexDestroy()
+ *
+ * \param[in,out]   ptindex   will be set to null before returning
+ * \return  void
+ */
+void
+tiffIndexDestroy(L_TIFFINDEX  **ptindex)
+{
+L_TIFFINDEX  *tindex;
+
+    PROCNAME("tiffIndexDestroy");
+
+    if (ptindex == NULL) {
+        L_WARNING("ptr address is null!\n", procName);
+        return;
+    }
+    if ((tindex = *ptindex) == NULL)
+        return;
+
+    l_dnaDestroy(&tindex->offsets);
+    LEPT_FREE(tindex);
+    *ptindex = NULL;
+}
+
+
+/*!
+ * \brief   tiffIndexGetCount()
+ *
+ * \param[in]    tindex
+ * \return  number of pages in the index, or 0 on error
+ */
+l_int32
+tiffIndexGetCount(L_TIFFINDEX  *tindex)
+{
+    PROCNAME("tiffIndexGetCount");
+
+    if (!tindex)
+        return ERROR_INT("tindex not defined", procName, 0);
+    return l_dnaGetCount(tindex->offsets);
+}
+
+
+/*!
+ * \brief   tiffIndexRead()
+ *
+ * \param[in]    filename    serialized tiff index (sidecar file)
+ * \return  tindex, or NULL on error
+ */
+L_TIFFINDEX *
+tiffIndexRead(const char  *filename)
+{
+FILE         *fp;
+L_TIFFINDEX  *tindex;
+
+    PROCNAME("tiffIndexRead");
+
+    if (!filename)
+        return (L_TIFFINDEX *)ERROR_PTR("filename not defined", procName, NULL);
+
+    if ((fp = fopenReadStream(filename)) == NULL)
+        return (L_TIFFINDEX *)ERROR_PTR("stream not opened", procName, NULL);
+    tindex = tiffIndexReadStream(fp);
+    fclose(fp);
+    if (!tindex)
+        return (L_TIFFINDEX *)ERROR_PTR("tindex not read", procName, NULL);
+    return tindex;
+}
+
+
+/*!
+ * \brief   tiffIndexReadStream()
+ *
+ * \param[in]    fp    file stream
+ * \return  tindex, or NULL on error
+ */
+L_TIFFINDEX *
+tiffIndexReadStream(FILE  *fp)
+{
+l_int32       version;
+size_t        filesize;
+L_DNA        *da;
+L_TIFFINDEX  *tindex;
+
+    PROCNAME("tiffIndexReadStream");
+
+    if (!fp)
+        return (L_TIFFINDEX *)ERROR_PTR("stream not defined", procName, NULL);
+
+    if (fscanf(fp, "\nL_TiffIndex Version %d\n", &version) != 1)
+        return (L_TIFFINDEX *)ERROR_PTR("not a tiff index file",
+                                        procName, NULL);
+    if (version != TIFF_INDEX_VERSION_NUMBER)
+        return (L_TIFFINDEX *)ERROR_PTR("invalid tiff index version",
+                                        procName, NULL);
+    if (fscanf(fp, "File size = %zu\n", &filesize) != 1)
+        return (L_TIFFINDEX *)ERROR_PTR("file size not read", procName, NULL);
+    if ((da = l_dnaReadStream(fp)) == NULL)
+        return (L_TIFFINDEX *)ERROR_PTR("offsets not read", procName, NULL);
+
+    tindex = (L_TIFFINDEX *)LEPT_CALLOC(1, sizeof(L_TIFFINDEX));
+    tindex->filesize = filesize;
+    tindex->offsets = da;
+    return tindex;
+}
+
+
+/*!
+ * \brief   tiffIndexWrite()
+ *
+ * \param[in]    filename    output sidecar file
+ * \param[in]    tindex
+ * \return  0 if OK, 1 on error
+ */
+l_ok
+tiffIndexWrite(const char   *filename,
+               L_TIFFINDEX  *tindex)
+{
+l_int32  ret;
+FILE    *fp;
+
+    PROCNAME("tiffIndexWrite");
+
+    if (!filename)
+        return ERROR_INT("filename not defined", procName, 1);
+    if (!tindex)
+        return ERROR_INT("tindex not defined", procName, 1);
+
+    if ((fp = fopenWriteStream(filename, "w")) == NULL)
+        return ERROR_INT("stream not opened", procName, 1);
+    ret = tiffIndexWriteStream(fp, tindex);
+    fclose(fp);
+    if (ret)
+        return ERROR_INT("tindex not written to stream", procName, 1);
+    return 0;
+}
+
+
+/*!
+ * \brief   tiffIndexWriteStream()
+ *
+ * \param[in]    fp       file stream opened for "w"
+ * \param[in]    tindex
+ * \return  0 if OK, 1 on error
+ */
+l_ok
+tiffIndexWriteStream(FILE         *fp,
+                     L_TIFFINDEX  *tindex)
+{
+    PROCNAME("tiffIndexWriteStream");
+
+    if (!fp)
+        return ERROR_INT("stream not defined", procName, 1);
+    if (!tindex)
+        return ERROR_INT("tindex not defined", procName, 1);
+
+    fprintf(fp, "\nL_TiffIndex Version %d\n", TIFF_INDEX_VERSION_NUMBER);
+    fprintf(fp, "File size = %zu\n", tindex->filesize);
+    return l_dnaWriteStream(fp, tindex->offsets);
+}
+
+
+/*!
+ * \brief   pixReadTiffIndexed()
+ *
+ * \param[in]    filename    multipage tiff file
+ * \param[in]    tindex      index made from %filename
+ * \param[in]    page        0-based page number
+ * \return  pix, or NULL on error
+ *
+ * <pre>
+ * Notes:
+ *      (1) The page is located in constant time from its IFD offset
+ *          in the index.
+ *      (2) Each call opens its own handle to the file and the index
+ *          is only read, so different pages can be decoded
+ *          independently, e.g., by several threads sharing one index.
+ *      (3) An error is returned if the size of the file differs from
+ *          the size recorded in the index, which is then stale.
+ * </pre>
+ */
+PIX *
+pixReadTiffIndexed(const char   *filename,
+                   L_TIFFINDEX  *tindex,
+                   l_int32       page)
+{
+l_float64  offset;
+PIX       *pix;
+TIFF      *tif;
+
+    PROCNAME("pixReadTiffIndexed");
+
+    if (!filename)
+        return (PIX *)ERROR_PTR("filename not defined", procName, NULL);
+    if (!tindex)
+        return (PIX *)ERROR_PTR("tindex not defined", procName, NULL);
+    if (page < 0 || page >= l_dnaGetCount(tindex->offsets))
+        return (PIX *)ERROR_PTR("invalid page number", procName, NULL);
+    if (nbytesInFile(filename) != tindex->filesize)
+        return (PIX *)ERROR_PTR("index is stale", procName, NULL);
+
+    if ((tif = openTiff(filename, "r")) == NULL)
+        return (PIX *)ERROR_PTR("tif not opened", procName, NULL);
+    l_dnaGetDValue(tindex->offsets, page, &offset);
+    if (TIFFSetSubDirectory(tif, (toff_t)offset) == 0) {
+        TIFFClose(tif);
+        return (PIX *)ERROR_PTR("directory not found", procName, NULL);
+    }
+    pix = pixReadFromTiffStream(tif);
+    TIFFClose(tif);
+    if (!pix)
+        return (PIX *)ERROR_PTR("pix not read", procName, NULL);
+    return pix;
+}
+
+
+/*!
+ * \brief   pixaReadMultipageTiffRange()
+ *
+ * \param[in]    filename    multipage tiff file
+ * \param[in]    tindex      [optional] index made from %filename;
+ *                           can be null
+ * \param[in]    start       first page to read, 0-based
+ * \param[in]    count       number of pages to read; use 0 to read
+ *                           to the last page
+ * \return  pixa of page images, or NULL on error
+ *
+ * <pre>
+ * Notes:
+ *      (1) If %tindex is null, an index is made and discarded.  To read
+ *          several ranges from the same file, make the index once
+ *          with tiffIndexCreate() and pass it in.
+ *      (2) %count is clipped to the number of pages after %start.
+ *      (3) A single tiff handle is used for the range, and each page
+ *          is located from its IFD offset, so the cost does not
+ *          depend on the number of pages before %start.
+ * </pre>
+ */
+PIXA *
+pixaReadMultipageTiffRange(const char   *filename,
+                           L_TIFFINDEX  *tindex,
+                           l_int32       start,
+                           l_int32       count)
+{
+l_int32       i, n, end;
+l_float64     offset;
+L_TIFFINDEX  *tindex1;
+PIX          *pix;
+PIXA         *pixa;
+TIFF         *tif;
+
+    PROCNAME("pixaReadMultipageTiffRange");
+
+    if (!filename)
+        return (PIXA *)ERROR_PTR("filename not defined", procName, NULL);
+    if (count < 0)
+        return (PIXA *)ERROR_PTR("count < 0", procName, NULL);
+
+    if (tindex) {
+        if (nbytesInFile(filename) != tindex->filesize)
+            return (PIXA *)ERROR_PTR("index is stale", procName, NULL);
+        tindex1 = tindex;
+    } else if ((tindex1 = tiffIndexCreate(filename)) == NULL) {
+        return (PIXA *)ERROR_PTR("tindex not made", procName, NULL);
+    }
+    n = tiffIndexGetCount(tindex1);
+    if (start < 0 || start >= n) {
+        if (!tindex) tiffIndexDestroy(&tindex1);
+        return (PIXA *)ERROR_PTR("invalid start page", procName, NULL);
+    }
+    end = (count == 0) ? n : L_MIN(n, start + count);
+
+    if ((tif = openTiff(filename, "r")) == NULL) {
+        if (!tindex) tiffIndexDestroy(&tindex1);
+        return (PIXA *)ERROR_PTR("tif not opened", procName, NULL);
+    }
+
+    pixa = pixaCreate(end - start);
+    for (i = start; i < end; i++) {
+        l_dnaGetDValue(tindex1->offsets, i, &offset);
+        if (TIFFSetSubDirectory(tif, (toff_t)offset) == 0 ||
+            (pix = pixReadFromTiffStream(tif)) == NULL) {
+            L_WARNING("pix not read for page %d\n", procName, i);
+            continue;
+        }
+        pixaAddPix(pixa, pix, L_INSERT);
+    }
+
+    TIFFClose(tif);
+    if (!tindex) tiffIndexDestroy(&tindex1);
+    return pixa;
+}
+
+
 /*--------------------------------------------------------------*
  *                    Print info to stream                      *
  *--------------------------------------------------------------*/
@@ -2062,7 +3357,7 @@ l_int32  comptype;
 
 
 /*--------------------------------------------------------------*
- *                   Extraction of tiff g4 data                 *
+ *              Extraction of tiff g4 and jpeg data             *
  *--------------------------------------------------------------*/
 /*!
  * \brief   extractG4DataFromFile()
@@ -2167,6 +3462,167 @@ TIFF     *tif;
 }
 
 
+/*!
+ * \brief   extractTiffPageCompressedData()
+ *
+ * \param[in]    filename      multipage tiff file
+ * \param[in]    tindex        [optional] index made from %filename;
+ *                             can be null
+ * \param[in]    page          0-based page number
+ * \param[out]   pcomptype     IFF_TIFF_G4 or IFF_TIFF_JPEG if the data can
+ *                             be used directly; IFF_UNKNOWN otherwise
+ * \param[out]   pdata         compressed data for the page; null if
+ *                             %comptype is IFF_UNKNOWN
+ * \param[out]   pnbytes       size of compressed data
+ * \param[out]   pw, ph        [optional] image size
+ * \param[out]   pminisblack   [optional] boolean, for g4
+ * \param[out]   pres          [optional] x resolution, in ppi; 0 if unknown
+ * \return  0 if OK, 1 on error
+ *
+ * <pre>
+ * Notes:
+ *      (1) This copies the compressed data of one page, without
+ *          decoding it, so it can be embedded in pdf as a CCITTFax
+ *          or DCT stream.  Unlike extractG4DataFromFile(), it finds
+ *          the data from the strip offsets, so it works for any page
+ *          of any tiff file.
+ *      (2) The data is only returned when it is a complete stream for
+ *          the image, with the same raster orientation: a single strip,
+ *          not tiled, top-left orientation, and
+ *           ~ for g4: 1 bps, MSB-to-LSB fill order
+ *           ~ for jpeg: 8 bps, and either 1 spp or 3 spp YCbCr.
+ *          Otherwise, %comptype is IFF_UNKNOWN and the page must be
+ *          decoded.  That is not an error.
+ *      (3) For jpeg with the tables stored in the directory
+ *          (TIFFTAG_JPEGTABLES), the tables are spliced in front of the
+ *          strip data to make an interchange-format jpeg stream.
+ *      (4) Supplying %tindex locates the page in constant time.
+ * </pre>
+ */
+l_ok
+extractTiffPageCompressedData(const char   *filename,
+                              L_TIFFINDEX  *tindex,
+                              l_int32       page,
+                              l_int32      *pcomptype,
+                              l_uint8     **pdata,
+                              size_t       *pnbytes,
+                              l_int32      *pw,
+                              l_int32      *ph,
+                              l_int32      *pminisblack,
+                              l_int32      *pres)
+{
+l_uint8   *data, *tables, *merged;
+l_uint16   comptype, bps, spp, photometric, fillorder, orientation;
+l_uint16   planarconfig;
+l_int32    ok, ret, xres, yres;
+l_uint32   w, h, ntables;
+l_float64  offset;
+size_t     nbytes;
+tmsize_t   size;
+TIFF      *tif;
+
+    PROCNAME("extractTiffPageCompressedData");
+
+    if (!pcomptype || !pdata || !pnbytes)
+        return ERROR_INT("&comptype, &data, &nbytes not all defined",
+                         procName, 1);
+    *pcomptype = IFF_UNKNOWN;
+    *pdata = NULL;
+    *pnbytes = 0;
+    if (pw) *pw = 0;
+    if (ph) *ph = 0;
+    if (pminisblack) *pminisblack = 0;
+    if (pres) *pres = 0;
+    if (!filename)
+        return ERROR_INT("filename not defined", procName, 1);
+
+    if ((tif = openTiff(filename, "r")) == NULL)
+        return ERROR_INT("tif not opened", procName, 1);
+    if (tindex) {
+        if (page < 0 || page >= tiffIndexGetCount(tindex)) {
+            TIFFClose(tif);
+            return ERROR_INT("invalid page number", procName, 1);
+        }
+        l_dnaGetDValue(tindex->offsets, page, &offset);
+        ret = TIFFSetSubDirectory(tif, (toff_t)offset);
+    } else {
+        ret = TIFFSetDirectory(tif, page);
+    }
+    if (ret == 0) {
+        TIFFClose(tif);
+        return ERROR_INT("page not found", procName, 1);
+    }
+
+    TIFFGetFieldDefaulted(tif, TIFFTAG_COMPRESSION, &comptype);
+    TIFFGetFieldDefaulted(tif, TIFFTAG_BITSPERSAMPLE, &bps);
+    TIFFGetFieldDefaulted(tif, TIFFTAG_SAMPLESPERPIXEL, &spp);
+    TIFFGetFieldDefaulted(tif, TIFFTAG_FILLORDER, &fillorder);
+    TIFFGetFieldDefaulted(tif, TIFFTAG_PLANARCONFIG, &planarconfig);
+    TIFFGetFieldDefaulted(tif, TIFFTAG_ORIENTATION, &orientation);
+    TIFFGetField(tif, TIFFTAG_IMAGEWIDTH, &w);
+    TIFFGetField(tif, TIFFTAG_IMAGELENGTH, &h);
+    if (!TIFFGetField(tif, TIFFTAG_PHOTOMETRIC, &photometric))
+        photometric = PHOTOMETRIC_MINISWHITE;
+    if (pw) *pw = w;
+    if (ph) *ph = h;
+    if (pminisblack) *pminisblack = (photometric == PHOTOMETRIC_MINISBLACK);
+    if (pres) {
+        getTiffStreamResolution(tif, &xres, &yres);
+        *pres = xres;
+    }
+
+        /* Can the strip be used without decoding? */
+    ok = !TIFFIsTiled(tif) && TIFFNumberOfStrips(tif) == 1 &&
+         orientation == ORIENTATION_TOPLEFT;
+    if (ok && comptype == COMPRESSION_CCITTFAX4) {
+        ok = bps == 1 && spp == 1 && fillorder == FILLORDER_MSB2LSB;
+    } else if (ok && comptype == COMPRESSION_JPEG) {
+        ok = bps == 8 && planarconfig == PLANARCONFIG_CONTIG &&
+             ((spp == 1 && photometric == PHOTOMETRIC_MINISBLACK) ||
+              (spp == 3 && photometric == PHOTOMETRIC_YCBCR));
+    } else {
+        ok = FALSE;
+    }
+    if (!ok) {
+        TIFFClose(tif);
+        return 0;
+    }
+
+        /* Copy the strip */
+    if ((size = TIFFRawStripSize(tif, 0)) <= 0) {
+        TIFFClose(tif);
+        return ERROR_INT("invalid strip size", procName, 1);
+    }
+    data = (l_uint8 *)LEPT_CALLOC(size, sizeof(l_uint8));
+    if ((size = TIFFReadRawStrip(tif, 0, data, size)) <= 0) {
+        LEPT_FREE(data);
+        TIFFClose(tif);
+        return ERROR_INT("strip not read", procName, 1);
+    }
+    nbytes = size;
+
+        /* For jpeg with abbreviated strip data, splice the tables in
+         * front, dropping the EOI of the tables and the SOI of the strip */
+    if (comptype == COMPRESSION_JPEG &&
+        TIFFGetField(tif, TIFFTAG_JPEGTABLES, &ntables, &tables) &&
+        ntables > 4 && nbytes > 2) {
+        merged = (l_uint8 *)LEPT_CALLOC(ntables + nbytes - 4,
+                                        sizeof(l_uint8));
+        memcpy(merged, tables, ntables - 2);
+        memcpy(merged + ntables - 2, data + 2, nbytes - 2);
+        LEPT_FREE(data);
+        data = merged;
+        nbytes = ntables + nbytes - 4;
+    }
+    TIFFClose(tif);
+
+    *pcomptype = (comptype == COMPRESSION_JPEG) ? IFF_TIFF_JPEG : IFF_TIFF_G4;
+    *pdata = data;
+    *pnbytes = nbytes;
+    return 0;
+}
+
+
 /*--------------------------------------------------------------*
  *               Open tiff stream from file stream              *
  *--------------------------------------------------------------*/
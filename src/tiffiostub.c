@@ -56,6 +56,22 @@ PIX * pixReadStreamTiff(FILE *fp, l_int32 n)
 
 /* ----------------------------------------------------------------------*/
 
+PIX * pixReadStreamTiffRegion(FILE *fp, l_int32 n, BOX *box)
+{
+    return (PIX *)ERROR_PTR("function not present",
+                            "pixReadStreamTiffRegion", NULL);
+}
+
+/* ----------------------------------------------------------------------*/
+
+PIX * pixReadStreamTiffReduced(FILE *fp, l_int32 minw, l_int32 minh)
+{
+    return (PIX *)ERROR_PTR("function not present",
+                            "pixReadStreamTiffReduced", NULL);
+}
+
+/* ----------------------------------------------------------------------*/
+
 l_ok pixWriteTiff(const char *filename, PIX *pix, l_int32 comptype,
                   const char *modestring)
 {
@@ -88,6 +104,61 @@ l_ok pixWriteStreamTiffWA(FILE *fp, PIX *pix, l_int32 comptype,
 
 /* ----------------------------------------------------------------------*/
 
+L_TIFF_READER * tiffReaderOpen(const char *filename, l_int32 n)
+{
+    return (L_TIFF_READER *)ERROR_PTR("function not present",
+                                      "tiffReaderOpen", NULL);
+}
+
+/* ----------------------------------------------------------------------*/
+
+void tiffReaderClose(L_TIFF_READER **preader)
+{
+    L_ERROR("function not present\n", "tiffReaderClose");
+    return;
+}
+
+/* ----------------------------------------------------------------------*/
+
+l_ok tiffReaderGetDimensions(L_TIFF_READER *reader, l_int32 *pw,
+                             l_int32 *ph, l_int32 *pd)
+{
+    return ERROR_INT("function not present", "tiffReaderGetDimensions", 1);
+}
+
+/* ----------------------------------------------------------------------*/
+
+PIX * tiffReaderReadRows(L_TIFF_READER *reader, l_int32 nrows)
+{
+    return (PIX *)ERROR_PTR("function not present",
+                            "tiffReaderReadRows", NULL);
+}
+
+/* ----------------------------------------------------------------------*/
+
+L_TIFF_WRITER * tiffWriterOpen(const char *filename, PIX *pixt, l_int32 h,
+                               l_int32 comptype)
+{
+    return (L_TIFF_WRITER *)ERROR_PTR("function not present",
+                                      "tiffWriterOpen", NULL);
+}
+
+/* ----------------------------------------------------------------------*/
+
+l_ok tiffWriterWriteRows(L_TIFF_WRITER *writer, PIX *pix)
+{
+    return ERROR_INT("function not present", "tiffWriterWriteRows", 1);
+}
+
+/* ----------------------------------------------------------------------*/
+
+l_ok tiffWriterClose(L_TIFF_WRITER **pwriter)
+{
+    return ERROR_INT("function not present", "tiffWriterClose", 1);
+}
+
+/* ----------------------------------------------------------------------*/
+
 PIX * pixReadFromMultipageTiff(const char *filename, size_t *poffset)
 {
     return (PIX *)ERROR_PTR("function not present",
@@ -126,6 +197,77 @@ l_ok writeMultipageTiffSA(SARRAY *sa, const char *fileout)
 
 /* ----------------------------------------------------------------------*/
 
+L_TIFFINDEX * tiffIndexCreate(const char *filename)
+{
+    return (L_TIFFINDEX *)ERROR_PTR("function not present",
+                                    "tiffIndexCreate", NULL);
+}
+
+/* ----------------------------------------------------------------------*/
+
+void tiffIndexDestroy(L_TIFFINDEX **ptindex)
+{
+    L_ERROR("function not present\n", "tiffIndexDestroy");
+    return;
+}
+
+/* ----------------------------------------------------------------------*/
+
+l_int32 tiffIndexGetCount(L_TIFFINDEX *tindex)
+{
+    return ERROR_INT("function not present", "tiffIndexGetCount", 0);
+}
+
+/* ----------------------------------------------------------------------*/
+
+L_TIFFINDEX * tiffIndexRead(const char *filename)
+{
+    return (L_TIFFINDEX *)ERROR_PTR("function not present",
+                                    "tiffIndexRead", NULL);
+}
+
+/* ----------------------------------------------------------------------*/
+
+L_TIFFINDEX * tiffIndexReadStream(FILE *fp)
+{
+    return (L_TIFFINDEX *)ERROR_PTR("function not present",
+                                    "tiffIndexReadStream", NULL);
+}
+
+/* ----------------------------------------------------------------------*/
+
+l_ok tiffIndexWrite(const char *filename, L_TIFFINDEX *tindex)
+{
+    return ERROR_INT("function not present", "tiffIndexWrite", 1);
+}
+
+/* ----------------------------------------------------------------------*/
+
+l_ok tiffIndexWriteStream(FILE *fp, L_TIFFINDEX *tindex)
+{
+    return ERROR_INT("function not present", "tiffIndexWriteStream", 1);
+}
+
+/* ----------------------------------------------------------------------*/
+
+PIX * pixReadTiffIndexed(const char *filename, L_TIFFINDEX *tindex,
+                         l_int32 page)
+{
+    return (PIX *)ERROR_PTR("function not present",
+                            "pixReadTiffIndexed", NULL);
+}
+
+/* ----------------------------------------------------------------------*/
+
+PIXA * pixaReadMultipageTiffRange(const char *filename, L_TIFFINDEX *tindex,
+                                  l_int32 start, l_int32 count)
+{
+    return (PIXA *)ERROR_PTR("function not present",
+                             "pixaReadMultipageTiffRange", NULL);
+}
+
+/* ----------------------------------------------------------------------*/
+
 l_ok fprintTiffInfo(FILE *fpout, const char *tiffile)
 {
     return ERROR_INT("function not present", "fprintTiffInfo", 1);
@@ -191,6 +333,18 @@ l_ok extractG4DataFromFile(const char *filein, l_uint8 **pdata,
 
 /* ----------------------------------------------------------------------*/
 
+l_ok extractTiffPageCompressedData(const char *filename, L_TIFFINDEX *tindex,
+                                   l_int32 page, l_int32 *pcomptype,
+                                   l_uint8 **pdata, size_t *pnbytes,
+                                   l_int32 *pw, l_int32 *ph,
+                                   l_int32 *pminisblack, l_int32 *pres)
+{
+    return ERROR_INT("function not present",
+                     "extractTiffPageCompressedData", 1);
+}
+
+/* ----------------------------------------------------------------------*/
+
 PIX * pixReadMemTiff(const l_uint8 *cdata, size_t size, l_int32 n)
 {
     return (PIX *)ERROR_PTR("function not present", "pixReadMemTiff", NULL);
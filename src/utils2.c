@@ -73,6 +73,8 @@
  *           l_int32    l_binaryWrite()
  *           l_int32    nbytesInFile()
  *           l_int32    fnbytesInFile()
+ *           l_uint8   *l_binaryMapFile()
+ *           l_int32    l_binaryUnmapFile()
  *
  *       Copy and compare in memory
  *           l_uint8   *l_binaryCopy()
@@ -202,6 +204,11 @@
 #include <errno.h>
 #endif
 
+#if HAVE_MMAP
+#include <fcntl.h>     /* open */
+#include <sys/mman.h>  /* mmap, munmap */
+#endif  /* HAVE_MMAP */
+
 #include <string.h>
 #include <stddef.h>
 #include "allheaders.h"
@@ -1650,6 +1657,92 @@ l_int64  pos, nbytes;
 }
 
 
+/*!
+ * \brief   l_binaryMapFile()
+ *
+ * \param[in]    filename
+ * \param[out]   pnbytes    size of the mapping
+ * \return  data in a file mapping, or NULL on error
+ *
+ * <pre>
+ * Notes:
+ *      (1) The file is mapped privately: writes to the returned data
+ *          are not seen in the file or by other mappings of it.
+ *          Pages are read from the file only when they are first used.
+ *      (2) The mapping must be released with l_binaryUnmapFile(),
+ *          not with LEPT_FREE().
+ *      (3) This requires mmap(); see HAVE_MMAP in environ.h.
+ *          An empty file can not be mapped.
+ * </pre>
+ */
+l_uint8 *
+l_binaryMapFile(const char  *filename,
+                size_t      *pnbytes)
+{
+#if HAVE_MMAP
+char        *fname;
+l_int32      fd;
+void        *data;
+struct stat  st;
+#endif  /* HAVE_MMAP */
+
+    PROCNAME("l_binaryMapFile");
+
+    if (!pnbytes)
+        return (l_uint8 *)ERROR_PTR("pnbytes not defined", procName, NULL);
+    *pnbytes = 0;
+    if (!filename)
+        return (l_uint8 *)ERROR_PTR("filename not defined", procName, NULL);
+
+#if HAVE_MMAP
+    fname = genPathname(filename, NULL);
+    fd = open(fname, O_RDONLY);
+    LEPT_FREE(fname);
+    if (fd < 0)
+        return (l_uint8 *)ERROR_PTR("file not opened", procName, NULL);
+    if (fstat(fd, &st) != 0 || st.st_size == 0) {
+        close(fd);
+        return (l_uint8 *)ERROR_PTR("file is empty", procName, NULL);
+    }
+    data = mmap(NULL, st.st_size, PROT_READ | PROT_WRITE, MAP_PRIVATE,
+                fd, 0);
+    close(fd);  /* the mapping remains valid */
+    if (data == MAP_FAILED)
+        return (l_uint8 *)ERROR_PTR("file not mapped", procName, NULL);
+    *pnbytes = st.st_size;
+    return (l_uint8 *)data;
+#else
+    return (l_uint8 *)ERROR_PTR("mmap not available", procName, NULL);
+#endif  /* HAVE_MMAP */
+}
+
+
+/*!
+ * \brief   l_binaryUnmapFile()
+ *
+ * \param[in]    data      from l_binaryMapFile()
+ * \param[in]    nbytes    size of the mapping
+ * \return  0 if OK, 1 on error
+ */
+l_ok
+l_binaryUnmapFile(l_uint8  *data,
+                  size_t    nbytes)
+{
+    PROCNAME("l_binaryUnmapFile");
+
+    if (!data)
+        return ERROR_INT("data not defined", procName, 1);
+
+#if HAVE_MMAP
+    if (munmap(data, nbytes) != 0)
+        return ERROR_INT("munmap failed", procName, 1);
+    return 0;
+#else
+    return ERROR_INT("mmap not available", procName, 1);
+#endif  /* HAVE_MMAP */
+}
+
+
 /*--------------------------------------------------------------------*
  *                     Copy and compare in memory                     *
  *--------------------------------------------------------------------*/
@@ -39,6 +39,8 @@
  *            static l_int32   wshedGetHeight()
  *            static void      pushNewPixel()
  *            static void      popNewPixel()
+ *            static L_WSQUEUE *wsqueueCreate()
+ *            static void      wsqueueDestroy()
  *            static void      pushWSPixel()
  *            static void      popWSPixel()
  *            static void      debugPrintLUT()
@@ -135,13 +137,22 @@ typedef struct L_NewPixel  L_NEWPIXEL;
 /*! Wartshed pixel */
 struct L_WSPixel
 {
-    l_float32  val;    /*!< pixel value */
+    l_int32    val;    /*!< pixel value */
     l_int32    x;      /*!< x coordinate */
     l_int32    y;      /*!< y coordinate */
     l_int32    index;  /*!< label for set to which pixel belongs */
 };
 typedef struct L_WSPixel  L_WSPIXEL;
 
+/*! Priority queue of watershed pixels, held in a binary heap */
+struct L_WSQueue
+{
+    l_int32            nalloc;  /*!< size of allocated array            */
+    l_int32            n;       /*!< number of WSPixels in the heap     */
+    struct L_WSPixel  *array;   /*!< heap of WSPixels, stored by value  */
+};
+typedef struct L_WSQueue  L_WSQUEUE;
+
 
     /* Static functions for obtaining bitmap of watersheds  */
 static void wshedSaveBasin(L_WSHED *wshed, l_int32 index, l_int32 level);
@@ -164,10 +175,12 @@ static void pushNewPixel(L_QUEUE *lq, l_int32 x, l_int32 y,
                          l_int32 *pminy, l_int32 *pmaxy);
 static void popNewPixel(L_QUEUE *lq, l_int32 *px, l_int32 *py);
 
-    /* Static accessors for WSPixel on a heap */
-static void pushWSPixel(L_HEAP *lh, L_STACK *stack, l_int32 val,
+    /* Static accessors for WSPixel on a priority queue */
+static L_WSQUEUE *wsqueueCreate(void);
+static void wsqueueDestroy(L_WSQUEUE **pwsq);
+static void pushWSPixel(L_WSQUEUE *wsq, l_int32 val,
                         l_int32 x, l_int32 y, l_int32 index);
-static void popWSPixel(L_HEAP *lh, L_STACK *stack, l_int32 *pval,
+static void popWSPixel(L_WSQUEUE *wsq, l_int32 *pval,
                        l_int32 *px, l_int32 *py, l_int32 *pindex);
 
     /* Static debug print output */
@@ -326,10 +339,9 @@ l_uint32  ulabel, uval;
 void    **lines8, **linelab32;
 NUMA     *nalut, *nalevels, *nash, *namh, *nasi;
 NUMA    **links;
-L_HEAP   *lh;
+L_WSQUEUE *wsq;
 PIX      *pixmin, *pixsd;
 PIXA     *pixad;
-L_STACK  *rstack;
 PTA      *ptas, *ptao;
 
     PROCNAME("wshedApply");
@@ -341,8 +353,7 @@ PTA      *ptas, *ptao;
      *  Initialize priority queue and pixlab with seeds and minima  *
      * ------------------------------------------------------------ */
 
-    lh = lheapCreate(0, L_SORT_INCREASING);  /* remove lowest values first */
-    rstack = lstackCreate(0);  /* for reusing the WSPixels */
+    wsq = wsqueueCreate();  /* remove lowest values first */
     pixGetDimensions(wshed->pixs, &w, &h, NULL);
     lines8 = wshed->lines8;  /* wshed owns this */
     linelab32 = wshed->linelab32;  /* ditto */
@@ -354,7 +365,7 @@ PTA      *ptas, *ptao;
     for (i = 0; i < nseeds; i++) {
         ptaGetIPt(ptas, i, &x, &y);
         uval = GET_DATA_BYTE(lines8[y], x);
-        pushWSPixel(lh, rstack, (l_int32)uval, x, y, i);
+        pushWSPixel(wsq, (l_int32)uval, x, y, i);
     }
     wshed->ptas = ptas;
     nasi = numaMakeConstant(1, nseeds);  /* indicator array */
@@ -376,7 +387,7 @@ PTA      *ptas, *ptao;
     for (i = 0; i < nother; i++) {
         ptaGetIPt(ptao, i, &x, &y);
         uval = GET_DATA_BYTE(lines8[y], x);
-        pushWSPixel(lh, rstack, (l_int32)uval, x, y, nseeds + i);
+        pushWSPixel(wsq, (l_int32)uval, x, y, nseeds + i);
     }
     wshed->namh = namh;
 
@@ -407,8 +418,8 @@ PTA      *ptas, *ptao;
     nalevels = numaCreate(nseeds);
     wshed->nalevels = nalevels;  /* wshed owns this */
     L_INFO("nseeds = %d, nother = %d\n", procName, nseeds, nother);
-    while (lheapGetCount(lh) > 0) {
-        popWSPixel(lh, rstack, &val, &x, &y, &index);
+    while (wsq->n > 0) {
+        popWSPixel(wsq, &val, &x, &y, &index);
 /*        lept_stderr("x = %d, y = %d, index = %d\n", x, y, index); */
         ulabel = GET_DATA_FOUR_BYTES(linelab32[y], x);
         if (ulabel == MAX_LABEL_VALUE)
@@ -428,7 +439,7 @@ PTA      *ptas, *ptao;
                 for (j = jmin; j <= jmax; j++) {
                     if (i == y && j == x) continue;
                     uval = GET_DATA_BYTE(lines8[i], j);
-                    pushWSPixel(lh, rstack, (l_int32)uval, j, i, cindex);
+                    pushWSPixel(wsq, (l_int32)uval, j, i, cindex);
                 }
             }
         } else {  /* pixel is already labeled (differently); must resolve */
@@ -530,8 +541,7 @@ PTA      *ptas, *ptao;
     pixDestroy(&pixmin);
     pixDestroy(&pixsd);
     ptaDestroy(&ptao);
-    lheapDestroy(&lh, TRUE);
-    lstackDestroy(&rstack, TRUE);
+    wsqueueDestroy(&wsq);
     return 0;
 }
 
@@ -891,11 +901,58 @@ L_NEWPIXEL  *np;
 }
 
 
+/*
+ * \brief   wsqueueCreate()
+ *
+ * \return   wsq, or NULL on error
+ *
+ * <pre>
+ * Notes:
+ *      (1) This is a priority queue for WSPixels, which are ordered by
+ *          increasing pixel value.  It is a binary heap that holds
+ *          the WSPixels themselves, so no WSPixel is allocated or
+ *          freed while filling, and values are compared as integers.
+ *      (2) The heap is maintained exactly as L_HEAP is with
+ *          L_SORT_INCREASING, so WSPixels with equal values are removed
+ *          in the same order.  The watersheds depend on that order.
+ * </pre>
+ */
+static L_WSQUEUE *
+wsqueueCreate(void)
+{
+L_WSQUEUE  *wsq;
+
+    wsq = (L_WSQUEUE *)LEPT_CALLOC(1, sizeof(L_WSQUEUE));
+    wsq->nalloc = 1024;
+    wsq->array = (L_WSPIXEL *)LEPT_CALLOC(wsq->nalloc, sizeof(L_WSPIXEL));
+    return wsq;
+}
+
+
+/*
+ * \brief   wsqueueDestroy()
+ *
+ * \param[in,out]   pwsq   will be set to null before returning
+ * \return   void
+ */
+static void
+wsqueueDestroy(L_WSQUEUE  **pwsq)
+{
+L_WSQUEUE  *wsq;
+
+    if ((wsq = *pwsq) == NULL)
+        return;
+
+    LEPT_FREE(wsq->array);
+    LEPT_FREE(wsq);
+    *pwsq = NULL;
+}
+
+
 /*
  * \brief   pushWSPixel()
  *
- * \param[in]    lh       priority queue
- * \param[in]    stack    of reusable WSPixels
+ * \param[in]    wsq      priority queue
  * \param[in]    val      pixel value: used for ordering the heap
  * \param[in]    x, y     pixel coordinates
  * \param[in]    index    label for set to which pixel belongs
@@ -903,50 +960,59 @@ L_NEWPIXEL  *np;
  *
  * <pre>
  * Notes:
- *      (1) This is a wrapper for adding a WSPixel to a heap.  It
- *          uses the storage stack to retrieve a WSPixel.
+ *      (1) This adds a WSPixel at the end of the heap and lets it
+ *          move up while its parent has a larger value.
  * </pre>
  */
 static void
-pushWSPixel(L_HEAP   *lh,
-            L_STACK  *stack,
-            l_int32   val,
-            l_int32   x,
-            l_int32   y,
-            l_int32   index)
+pushWSPixel(L_WSQUEUE  *wsq,
+            l_int32     val,
+            l_int32     x,
+            l_int32     y,
+            l_int32     index)
 {
-L_WSPIXEL  *wsp;
+l_int32     ic, ip;  /* array index of child and parent */
+L_WSPIXEL  *array;
 
     PROCNAME("pushWSPixel");
 
-    if (!lh) {
-        L_ERROR("heap not defined\n", procName);
-        return;
-    }
-    if (!stack) {
-        L_ERROR("stack not defined\n", procName);
+    if (!wsq) {
+        L_ERROR("wsq not defined\n", procName);
         return;
     }
 
-        /* Get a wspixel to use */
-    if (lstackGetCount(stack) > 0)
-        wsp = (L_WSPIXEL *)lstackRemove(stack);
-    else
-        wsp = (L_WSPIXEL *)LEPT_CALLOC(1, sizeof(L_WSPIXEL));
+        /* If necessary, expand the allocated array by a factor of 2 */
+    if (wsq->n >= wsq->nalloc) {
+        if ((wsq->array = (L_WSPIXEL *)reallocNew((void **)&wsq->array,
+                                sizeof(L_WSPIXEL) * wsq->nalloc,
+                                2 * sizeof(L_WSPIXEL) * wsq->nalloc)) == NULL) {
+            L_ERROR("new heap array not returned\n", procName);
+            return;
+        }
+        wsq->nalloc *= 2;
+    }
 
-    wsp->val = (l_float32)val;
-    wsp->x = x;
-    wsp->y = y;
-    wsp->index = index;
-    lheapAdd(lh, wsp);
+        /* Move parents down until the new one can be inserted */
+    array = wsq->array;
+    ic = wsq->n++;
+    while (ic > 0) {
+        ip = (ic - 1) / 2;
+        if (array[ip].val <= val)
+            break;
+        array[ic] = array[ip];
+        ic = ip;
+    }
+    array[ic].val = val;
+    array[ic].x = x;
+    array[ic].y = y;
+    array[ic].index = index;
 }
 
 
 /*
  * \brief  popWSPixel()
  *
- * \param[in]     lh        priority queue
- * \param[in]     stack     of reusable WSPixels
+ * \param[in]     wsq       priority queue
  * \param[out]    pval      pixel value
  * \param[out]    px, py    pixel coordinates
  * \param[out]    pindex    label for set to which pixel belongs
@@ -954,43 +1020,69 @@ L_WSPIXEL  *wsp;
  *
  * <pre>
  * Notes:
- *      (1) This is a wrapper for removing a WSPixel from a heap,
- *          which returns the WSPixel data and saves the WSPixel
- *          on the storage stack.
+ *      (1) This removes the WSPixel at the root of the heap.  The last
+ *          WSPixel is put at the root and moves down, each time taking
+ *          the place of the smaller child, or of the left child if
+ *          they are equal, until neither child is smaller.
  * </pre>
  */
 static void
-popWSPixel(L_HEAP   *lh,
-           L_STACK  *stack,
-           l_int32  *pval,
-           l_int32  *px,
-           l_int32  *py,
-           l_int32  *pindex)
+popWSPixel(L_WSQUEUE  *wsq,
+           l_int32    *pval,
+           l_int32    *px,
+           l_int32    *py,
+           l_int32    *pindex)
 {
-L_WSPIXEL  *wsp;
+l_int32     n, ip, icl, icr;  /* array index of parent and children */
+L_WSPIXEL   last;
+L_WSPIXEL  *array;
 
     PROCNAME("popWSPixel");
 
-    if (!lh) {
-        L_ERROR("lheap not defined\n", procName);
-        return;
-    }
-    if (!stack) {
-        L_ERROR("stack not defined\n", procName);
+    if (!wsq) {
+        L_ERROR("wsq not defined\n", procName);
         return;
     }
     if (!pval || !px || !py || !pindex) {
         L_ERROR("data can't be returned\n", procName);
         return;
     }
-
-    if ((wsp = (L_WSPIXEL *)lheapRemove(lh)) == NULL)
+    if (wsq->n == 0)
         return;
-    *pval = (l_int32)wsp->val;
-    *px = wsp->x;
-    *py = wsp->y;
-    *pindex = wsp->index;
-    lstackAdd(stack, wsp);  /* save for re-use */
+
+    array = wsq->array;
+    *pval = array[0].val;
+    *px = array[0].x;
+    *py = array[0].y;
+    *pindex = array[0].index;
+
+        /* Move children up until the last one can be inserted */
+    n = --wsq->n;
+    last = array[n];
+    ip = 0;
+    while (1) {
+        icl = 2 * ip + 1;
+        if (icl >= n)
+            break;
+        icr = icl + 1;
+        if (icr >= n) {  /* only a left child */
+            if (last.val > array[icl].val) {
+                array[ip] = array[icl];
+                ip = icl;
+            }
+            break;
+        }
+        if (last.val <= array[icl].val && last.val <= array[icr].val)
+            break;
+        if (array[icl].val <= array[icr].val) {
+            array[ip] = array[icl];
+            ip = icl;
+        } else {
+            array[ip] = array[icr];
+            ip = icr;
+        }
+    }
+    array[ip] = last;
 }
 
 
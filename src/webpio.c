@@ -31,6 +31,7 @@
  *    Reading WebP
  *          PIX             *pixReadStreamWebP()
  *          PIX             *pixReadMemWebP()
+ *          PIX             *pixReadMemWebPScaled()
  *
  *    Reading WebP header
  *          l_int32          readHeaderWebP()
@@ -153,6 +154,74 @@ WebPBitstreamFeatures  features;
 }
 
 
+/*!
+ * \brief   pixReadMemWebPScaled()
+ *
+ * \param[in]  filedata    webp compressed data in memory
+ * \param[in]  filesize    number of bytes in data
+ * \param[in]  wd, hd      size of the decoded image
+ * \return  pix 32 bpp, or NULL on error
+ *
+ * <pre>
+ * Notes:
+ *      (1) The scaling is done by the webp decoder as the image is
+ *          decoded, so the full resolution image is never generated.
+ *          This is much faster than decoding at full resolution and
+ *          then scaling, for large reductions.
+ * </pre>
+ */
+PIX *
+pixReadMemWebPScaled(const l_uint8  *filedata,
+                     size_t          filesize,
+                     l_int32         wd,
+                     l_int32         hd)
+{
+l_int32    wpl, stride;
+l_uint32  *data;
+PIX       *pix;
+WebPDecoderConfig  config;
+
+    PROCNAME("pixReadMemWebPScaled");
+
+    if (!filedata)
+        return (PIX *)ERROR_PTR("filedata not defined", procName, NULL);
+    if (wd <= 0 || hd <= 0)
+        return (PIX *)ERROR_PTR("wd and hd not both > 0", procName, NULL);
+
+    if (!WebPInitDecoderConfig(&config))
+        return (PIX *)ERROR_PTR("incompatible WebP version", procName, NULL);
+    if (WebPGetFeatures(filedata, filesize, &config.input) != VP8_STATUS_OK)
+        return (PIX *)ERROR_PTR("Invalid WebP file", procName, NULL);
+
+    pix = pixCreate(wd, hd, 32);
+    pixSetInputFormat(pix, IFF_WEBP);
+    if (config.input.has_alpha) pixSetSpp(pix, 4);
+    data = pixGetData(pix);
+    wpl = pixGetWpl(pix);
+    stride = wpl * 4;
+
+        /* Decode directly into the pix raster */
+    config.options.use_scaling = 1;
+    config.options.scaled_width = wd;
+    config.options.scaled_height = hd;
+    config.output.colorspace = MODE_RGBA;
+    config.output.is_external_memory = 1;
+    config.output.u.RGBA.rgba = (uint8_t *)data;
+    config.output.u.RGBA.stride = stride;
+    config.output.u.RGBA.size = (size_t)stride * hd;
+    if (WebPDecode(filedata, filesize, &config) != VP8_STATUS_OK) {
+        WebPFreeDecBuffer(&config.output);
+        pixDestroy(&pix);
+        return (PIX *)ERROR_PTR("WebP decode failed", procName, NULL);
+    }
+    WebPFreeDecBuffer(&config.output);
+
+        /* Convert from RGBA byte order; see pixReadMemWebP() */
+    pixEndianByteSwap(pix);
+    return pix;
+}
+
+
 /*!
  * \brief   readHeaderWebP()
  *
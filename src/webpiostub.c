@@ -56,6 +56,15 @@ PIX * pixReadMemWebP(const l_uint8 *filedata, size_t filesize)
 
 /* ----------------------------------------------------------------------*/
 
+PIX * pixReadMemWebPScaled(const l_uint8 *filedata, size_t filesize,
+                           l_int32 wd, l_int32 hd)
+{
+    return (PIX * )ERROR_PTR("function not present",
+                             "pixReadMemWebPScaled", NULL);
+}
+
+/* ----------------------------------------------------------------------*/
+
 l_ok readHeaderWebP(const char *filename, l_int32 *pw, l_int32 *ph,
                        l_int32 *pspp)
 {
@@ -29,21 +29,17 @@
  * \file  zlibmem.c
  * <pre>
  *
- *      zlib operations in memory, using bbuffer
+ *      zlib operations in memory
  *          l_uint8   *zlibCompress()
  *          l_uint8   *zlibUncompress()
  *
  *
- *    This provides an example use of the byte buffer utility
- *    (see bbuffer.c for details of how the bbuffer works internally).
  *    We use zlib to compress and decompress a byte array from
- *    one memory buffer to another.  The standard method uses streams,
- *    but here we use the bbuffer as an expandable queue of pixels
- *    for both the reading and writing sides of each operation.
- *
- *    With memory mapping, one should be able to compress between
- *    memory buffers by using the file system to buffer everything in
- *    the background, but the bbuffer implementation is more portable.
+ *    one memory buffer to another.  The output is written directly
+ *    into a single allocated buffer: for compression it is sized
+ *    with deflateBound(), and for decompression it is doubled as
+ *    required.  There is no intermediate copying of the data,
+ *    so the time is spent almost entirely in zlib.
  * </pre>
  */
 
@@ -62,9 +58,8 @@
 static const l_int32  L_BUF_SIZE = 32768;
 static const l_int32  ZLIB_COMPRESSION_LEVEL = 6;
 
-#ifndef  NO_CONSOLE_IO
-#define  DEBUG     0
-#endif  /* ~NO_CONSOLE_IO */
+    /* Largest number of bytes given to zlib in a single call */
+static const size_t  L_MAX_PIECE = 0x40000000;  /* 1 GB */
 
 
 /*!
@@ -77,15 +72,13 @@ static const l_int32  ZLIB_COMPRESSION_LEVEL = 6;
  *
  * <pre>
  * Notes:
- *      (1) We repeatedly read in and fill up an input buffer,
- *          compress the data, and read it back out.  zlib
- *          uses two byte buffers internally in the z_stream
- *          data structure.  We use the bbuffers to feed data
- *          into the fixed bufferin, and feed it out of bufferout,
- *          in the same way that a pair of streams would normally
- *          be used if the data were being read from one file
- *          and written to another.  This is done iteratively,
- *          compressing L_BUF_SIZE bytes of input data at a time.
+ *      (1) The output buffer is allocated at the size given by
+ *          deflateBound(), so the data is compressed in a single
+ *          pass without intermediate copies, and as one deflate
+ *          stream without flushes.  The result is then shrunk to
+ *          the size of the compressed data.
+ *      (2) zlib counts bytes with 32-bit integers, so input larger
+ *          than 1 GB is fed in pieces.
  * </pre>
  */
 l_uint8 *
@@ -93,88 +86,57 @@ zlibCompress(l_uint8  *datain,
              size_t    nin,
              size_t   *pnout)
 {
-l_uint8    *dataout;
-l_int32     status, success;
-l_int32     flush;
-size_t      nbytes;
-l_uint8    *bufferin, *bufferout;
-L_BBUFFER  *bbin, *bbout;
-z_stream    z;
+l_uint8   *dataout, *datat;
+l_int32    status;
+size_t     bound, nleft, nout;
+z_stream   z;
 
     PROCNAME("zlibCompress");
 
+    if (!pnout)
+        return (l_uint8 *)ERROR_PTR("&nout not defined", procName, NULL);
+    *pnout = 0;
     if (!datain)
         return (l_uint8 *)ERROR_PTR("datain not defined", procName, NULL);
 
-        /* Set up fixed size buffers used in z_stream */
-    bufferin = (l_uint8 *)LEPT_CALLOC(L_BUF_SIZE, sizeof(l_uint8));
-    bufferout = (l_uint8 *)LEPT_CALLOC(L_BUF_SIZE, sizeof(l_uint8));
-
-        /* Set up bbuffers and load bbin with the data */
-    bbin = bbufferCreate(datain, nin);
-    bbout = bbufferCreate(NULL, 0);
-
-    success = TRUE;
-    if (!bufferin || !bufferout || !bbin || !bbout) {
-        L_ERROR("calloc fail for buffer\n", procName);
-        success = FALSE;
-        goto cleanup_arrays;
-    }
-
     z.zalloc = (alloc_func)0;
     z.zfree = (free_func)0;
     z.opaque = (voidpf)0;
-
-    z.next_in = bufferin;
-    z.avail_in = 0;
-    z.next_out = bufferout;
-    z.avail_out = L_BUF_SIZE;
-
-    status = deflateInit(&z, ZLIB_COMPRESSION_LEVEL);
-    if (status != Z_OK) {
-        L_ERROR("deflateInit failed\n", procName);
-        success = FALSE;
-        goto cleanup_arrays;
+    if (deflateInit(&z, ZLIB_COMPRESSION_LEVEL) != Z_OK)
+        return (l_uint8 *)ERROR_PTR("deflateInit failed", procName, NULL);
+
+        /* deflateBound() takes a uLong; add a margin for each piece */
+    if (nin <= L_MAX_PIECE)
+        bound = deflateBound(&z, nin);
+    else
+        bound = nin + nin / 1000 + 64 * (nin / L_MAX_PIECE + 1) + 1024;
+    if ((dataout = (l_uint8 *)LEPT_MALLOC(bound)) == NULL) {
+        deflateEnd(&z);
+        return (l_uint8 *)ERROR_PTR("dataout not made", procName, NULL);
     }
 
+    z.next_in = datain;
+    z.next_out = dataout;
+    nleft = nin;
+    nout = 0;
     do {
-        if (z.avail_in == 0) {
-            z.next_in = bufferin;
-            bbufferWrite(bbin, bufferin, L_BUF_SIZE, &nbytes);
-#if DEBUG
-            lept_stderr(" wrote %zu bytes to bufferin\n", nbytes);
-#endif  /* DEBUG */
-            z.avail_in = nbytes;
-        }
-        flush = (bbin->n) ? Z_SYNC_FLUSH : Z_FINISH;
-        status = deflate(&z, flush);
-#if DEBUG
-        lept_stderr(" status is %d, bytesleft = %u, totalout = %zu\n",
-                  status, z.avail_out, z.total_out);
-#endif  /* DEBUG */
-        nbytes = L_BUF_SIZE - z.avail_out;
-        if (nbytes) {
-            bbufferRead(bbout, bufferout, nbytes);
-#if DEBUG
-            lept_stderr(" read %zu bytes from bufferout\n", nbytes);
-#endif  /* DEBUG */
-        }
-        z.next_out = bufferout;
-        z.avail_out = L_BUF_SIZE;
-    } while (flush != Z_FINISH);
-
+        z.avail_in = L_MIN(nleft, L_MAX_PIECE);
+        nleft -= z.avail_in;
+        z.avail_out = L_MIN(bound - nout, L_MAX_PIECE);
+        status = deflate(&z, (nleft == 0) ? Z_FINISH : Z_NO_FLUSH);
+        nout = z.next_out - dataout;
+        nleft += z.avail_in;  /* anything not consumed */
+    } while (status == Z_OK && nout < bound);
     deflateEnd(&z);
-
-cleanup_arrays:
-    if (success) {
-        dataout = bbufferDestroyAndSaveData(&bbout, pnout);
-    } else {
-        dataout = NULL;
-        bbufferDestroy(&bbout);
+    if (status != Z_STREAM_END) {
+        LEPT_FREE(dataout);
+        return (l_uint8 *)ERROR_PTR("deflate failed", procName, NULL);
     }
-    bbufferDestroy(&bbin);
-    LEPT_FREE(bufferin);
-    LEPT_FREE(bufferout);
+
+        /* Give back the unused part of the buffer */
+    if ((datat = (l_uint8 *)LEPT_REALLOC(dataout, nout)) != NULL)
+        dataout = datat;
+    *pnout = nout;
     return dataout;
 }
 
@@ -189,7 +151,11 @@ cleanup_arrays:
  *
  * <pre>
  * Notes:
- *      (1) See zlibCompress().
+ *      (1) See zlibCompress().  The output buffer starts at a size
+ *          based on a typical compression ratio, and is doubled
+ *          as needed.
+ *      (2) As before, if the input is truncated, the data that was
+ *          uncompressed is returned.
  * </pre>
  */
 l_uint8 *
@@ -197,83 +163,67 @@ zlibUncompress(l_uint8  *datain,
                size_t    nin,
                size_t   *pnout)
 {
-l_uint8    *dataout;
-l_uint8    *bufferin, *bufferout;
-l_int32     status, success;
-size_t      nbytes;
-L_BBUFFER  *bbin, *bbout;
-z_stream    z;
+l_uint8   *dataout, *datat;
+l_int32    status;
+size_t     size, nleft, nout;
+z_stream   z;
 
     PROCNAME("zlibUncompress");
 
+    if (!pnout)
+        return (l_uint8 *)ERROR_PTR("&nout not defined", procName, NULL);
+    *pnout = 0;
     if (!datain)
         return (l_uint8 *)ERROR_PTR("datain not defined", procName, NULL);
 
-        /* Set up fixed size buffers used in z_stream */
-    bufferin = (l_uint8 *)LEPT_CALLOC(L_BUF_SIZE, sizeof(l_uint8));
-    bufferout = (l_uint8 *)LEPT_CALLOC(L_BUF_SIZE, sizeof(l_uint8));
-
-        /* Set up bbuffers and load bbin with the data */
-    bbin = bbufferCreate(datain, nin);
-    bbout = bbufferCreate(NULL, 0);
-
-    success = TRUE;
-    if (!bufferin || !bufferout || !bbin || !bbout) {
-        L_ERROR("calloc fail for buffer\n", procName);
-        success = FALSE;
-        goto cleanup_arrays;
-    }
-
     z.zalloc = (alloc_func)0;
     z.zfree = (free_func)0;
-
-    z.next_in = bufferin;
+    z.opaque = (voidpf)0;
+    z.next_in = datain;
     z.avail_in = 0;
-    z.next_out = bufferout;
-    z.avail_out = L_BUF_SIZE;
-
-    inflateInit(&z);
+    if (inflateInit(&z) != Z_OK)
+        return (l_uint8 *)ERROR_PTR("inflateInit failed", procName, NULL);
 
+    size = L_MAX(4 * nin, L_BUF_SIZE);
+    if ((dataout = (l_uint8 *)LEPT_MALLOC(size)) == NULL) {
+        inflateEnd(&z);
+        return (l_uint8 *)ERROR_PTR("dataout not made", procName, NULL);
+    }
 
-    for ( ; ; ) {
+    nleft = nin;
+    nout = 0;
+    for (;;) {
+        if (nout == size) {  /* double the size of the output buffer */
+            if ((datat = (l_uint8 *)LEPT_REALLOC(dataout, 2 * size))
+                == NULL) {
+                LEPT_FREE(dataout);
+                inflateEnd(&z);
+                return (l_uint8 *)ERROR_PTR("dataout not enlarged",
+                                            procName, NULL);
+            }
+            dataout = datat;
+            size *= 2;
+        }
         if (z.avail_in == 0) {
-            z.next_in = bufferin;
-            bbufferWrite(bbin, bufferin, L_BUF_SIZE, &nbytes);
-#if DEBUG
-            lept_stderr(" wrote %d bytes to bufferin\n", nbytes);
-#endif  /* DEBUG */
-            z.avail_in = nbytes;
+            z.avail_in = L_MIN(nleft, L_MAX_PIECE);
+            nleft -= z.avail_in;
         }
-        if (z.avail_in == 0)
+        z.next_out = dataout + nout;
+        z.avail_out = L_MIN(size - nout, L_MAX_PIECE);
+        status = inflate(&z, Z_NO_FLUSH);
+        nout = z.next_out - dataout;
+        if (status == Z_STREAM_END)
             break;
-        status = inflate(&z, Z_SYNC_FLUSH);
-#if DEBUG
-        lept_stderr(" status is %d, bytesleft = %d, totalout = %d\n",
-                status, z.avail_out, z.total_out);
-#endif  /* DEBUG */
-        nbytes = L_BUF_SIZE - z.avail_out;
-        if (nbytes) {
-            bbufferRead(bbout, bufferout, nbytes);
-#if DEBUG
-            lept_stderr(" read %d bytes from bufferout\n", nbytes);
-#endif  /* DEBUG */
-        }
-        z.next_out = bufferout;
-        z.avail_out = L_BUF_SIZE;
+        if (status != Z_OK && status != Z_BUF_ERROR)
+            break;
+        if (z.avail_in == 0 && nleft == 0 && z.avail_out > 0)
+            break;  /* truncated input */
     }
-
     inflateEnd(&z);
+    if (status != Z_STREAM_END)
+        L_WARNING("compressed data is incomplete or invalid\n", procName);
 
-cleanup_arrays:
-    if (success) {
-        dataout = bbufferDestroyAndSaveData(&bbout, pnout);
-    } else {
-        dataout = NULL;
-        bbufferDestroy(&bbout);
-    }
-    bbufferDestroy(&bbin);
-    LEPT_FREE(bufferin);
-    LEPT_FREE(bufferout);
+    *pnout = nout;
     return dataout;
 }
 